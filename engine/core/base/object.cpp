@@ -6,19 +6,13 @@
 
 namespace Echo
 {
-	static std::unordered_map<i32, Object*> g_objs;
-
 	Object::Object()
 	{
 #ifdef ECHO_EDITOR_MODE
 		m_objectEditor = nullptr;
 #endif
 
-		// begin with 1
-		static i32 id = 1;
-		m_id = id++;
-
-		g_objs[m_id] = this;
+		m_id = ObjectRegistry::instance()->add(this);
 	}
 
 	Object::~Object()
@@ -32,10 +26,9 @@ namespace Echo
         unregisterFromScript();
 		unregisterChannels();
 
-		auto it = g_objs.find(m_id);
-		if (it != g_objs.end())
+		if (getById(m_id) == this)
 		{
-			g_objs.erase(it);
+			ObjectRegistry::instance()->remove(m_id);
 		}
 		else
 		{
@@ -58,17 +51,6 @@ namespace Echo
 		return obj && obj==this ? true : false;
 	}
 
-	Object* Object::getById(i32 id)
-	{
-		auto it = g_objs.find(id);
-		if (it!=g_objs.end())
-		{
-			return it->second;
-		}
-
-		return nullptr;
-	}
-
 	const String& Object::getClassName() const
 	{
 		static String className = "Object";
@@ -78,20 +60,15 @@ namespace Echo
     void Object::registerToScript() 
     {
         if (!m_registeredToScript)
-        {
-            String globalTableName = StringUtil::Format("objs._%d", this->getId());
-            LuaBinder::instance()->registerObject(getClassName(), globalTableName.c_str(), this);
-
-            m_registeredToScript = true;
-        }
+            m_registeredToScript = LuaBinder::instance()->bindObject(this);
     }
 
     void Object::unregisterFromScript()
     {
         if (m_registeredToScript)
         {
-            String luaStr = StringUtil::Format("objs._%d = nil", getId());
-            LuaBinder::instance()->execString(luaStr);
+            LuaBinder::instance()->unbindObject(getId());
+            m_registeredToScript = false;
         }
     }
 
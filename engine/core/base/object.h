@@ -4,6 +4,7 @@
 #include "engine/core/base/class.h"
 #include "engine/core/base/property_info.h"
 #include "engine/core/base/channel.h"
+#include "engine/core/base/object_registry.h"
 #include "engine/core/editor/object_editor.h"
 
 namespace Echo
@@ -16,13 +17,13 @@ namespace Echo
 		Object();
 		virtual ~Object();
 
-		// get by id
-		static Object* getById(i32 id);
+		// get by id, nullptr once the object is deleted
+		static Object* getById(i32 id) { return ObjectRegistry::instance()->get(id); }
 
 		// is valid
 		bool isValid();
 
-		// get id
+		// get id, a generation tagged handle that is never reused while it can still resolve
 		i32 getId() const { return m_id; }
 
 		// path
@@ -108,7 +109,7 @@ namespace Echo
 		static void bindMethods();
 
 	protected:
-		i32				m_id;
+		ObjectHandle	m_id;
 		PropertyInfos	m_propertys;
         ChannelsPtr     m_chanels = nullptr;
         bool			m_registeredToScript = false;
@@ -0,0 +1,81 @@
+#include "object_registry.h"
+#include "engine/core/thread/Threading.h"
+#include "engine/core/log/Log.h"
+
+namespace Echo
+{
+	ObjectRegistry::ObjectRegistry()
+	{
+		// guards add and remove, lookups don't lock
+		m_mutex = new Mutex;
+	}
+
+	ObjectRegistry::~ObjectRegistry()
+	{
+		for (std::atomic<Slot*>& page : m_pages)
+			delete[] page.load();
+
+		delete m_mutex;
+	}
+
+	ObjectRegistry* ObjectRegistry::instance()
+	{
+		// objects are created and deleted during static init and exit, so the registry outlives them all
+		static ObjectRegistry* registry = new ObjectRegistry;
+		return registry;
+	}
+
+	ObjectRegistry::Slot& ObjectRegistry::getSlot(ui32 index)
+	{
+		std::atomic<Slot*>& page = m_pages[index / SlotsPerPage];
+		if (!page.load(std::memory_order_relaxed))
+			page.store(new Slot[SlotsPerPage], std::memory_order_release);
+
+		return page.load(std::memory_order_relaxed)[index % SlotsPerPage];
+	}
+
+	ObjectHandle ObjectRegistry::add(Object* obj)
+	{
+		MutexLock lock(*m_mutex);
+
+		ui32 index;
+		if (m_freeSlots.size() > MinFreeSlots || (m_slotCount == MaxObjects && !m_freeSlots.empty()))
+		{
+			index = m_freeSlots.front();
+			m_freeSlots.pop_front();
+		}
+		else if (m_slotCount < MaxObjects)
+		{
+			index = m_slotCount++;
+		}
+		else
+		{
+			EchoLogError("Object registry is full, %d objects alive.", m_count);
+			return 0;
+		}
+
+		Slot& slot = getSlot(index);
+		ObjectHandle handle = ObjectHandle((slot.m_generation << IndexBits) | index);
+		slot.m_object.store(obj, std::memory_order_relaxed);
+		slot.m_handle.store(handle, std::memory_order_release);
+		m_count++;
+
+		return handle;
+	}
+
+	void ObjectRegistry::remove(ObjectHandle handle)
+	{
+		MutexLock lock(*m_mutex);
+
+		ui32 index = ui32(handle) & (MaxObjects - 1);
+		if (!get(handle))
+			return;
+
+		Slot& slot = getSlot(index);
+		slot.m_handle.store(0, std::memory_order_release);
+		slot.m_object.store(nullptr, std::memory_order_relaxed);
+		slot.m_generation = (slot.m_generation + 1) & GenerationMask;
+		m_freeSlots.push_back(index);
+		m_count--;
+	}
+}
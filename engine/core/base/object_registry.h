@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include "engine/core/memory/MemAllocDef.h"
+
+namespace Echo
+{
+	class Object;
+	class Mutex;
+
+	// object handle, the low bits index a registry slot and the high bits count how often that
+	// slot was handed out. a handle of a deleted object never resolves to a newer one. 0 is invalid
+	typedef i32 ObjectHandle;
+
+	// slot map of all live objects. lookups are a lock free array access, add and remove are
+	// thread safe
+	class ObjectRegistry
+	{
+	public:
+		static const ui32 IndexBits = 20;
+		static const ui32 MaxObjects = 1 << IndexBits;
+		static const ui32 GenerationMask = (1 << (31 - IndexBits)) - 1;
+		static const ui32 SlotsPerPage = 4096;
+		static const ui32 PageCount = MaxObjects / SlotsPerPage;
+
+		// freed slots wait in a queue until this many are free, that spreads reuse so a
+		// generation wraps only after millions of deletes
+		static const ui32 MinFreeSlots = 1024;
+
+	public:
+		~ObjectRegistry();
+
+		// instance
+		static ObjectRegistry* instance();
+
+		// register obj, returns 0 when the registry is full
+		ObjectHandle add(Object* obj);
+
+		// unregister, the handle is stale from now on
+		void remove(ObjectHandle handle);
+
+		// object of handle, nullptr for stale or invalid handles
+		Object* get(ObjectHandle handle) const
+		{
+			ui32 index = ui32(handle) & (MaxObjects - 1);
+			Slot* page = m_pages[index / SlotsPerPage].load(std::memory_order_acquire);
+			if (handle > 0 && page)
+			{
+				const Slot& slot = page[index % SlotsPerPage];
+				if (slot.m_handle.load(std::memory_order_acquire) == handle)
+					return slot.m_object.load(std::memory_order_relaxed);
+			}
+
+			return nullptr;
+		}
+
+		// live object count
+		ui32 getCount() const { return m_count; }
+
+	private:
+		ObjectRegistry();
+
+		// slot
+		struct Slot
+		{
+			std::atomic<ObjectHandle>	m_handle{ 0 };
+			std::atomic<Object*>		m_object{ nullptr };
+			ui32						m_generation = 0;
+		};
+
+		// slot of index, allocates its page
+		Slot& getSlot(ui32 index);
+
+	private:
+		Mutex*				m_mutex = nullptr;
+		std::atomic<Slot*>	m_pages[PageCount] = {};
+		ui32				m_slotCount = 1;	// slot 0 is never used, so no handle is 0
+		ui32				m_count = 0;
+		deque<ui32>::type	m_freeSlots;
+	};
+}
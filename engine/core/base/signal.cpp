@@ -4,6 +4,8 @@
 #include <thirdparty/pugixml/pugixml.hpp>
 #include <thirdparty/pugixml/pugiconfig.hpp>
 #include "engine/core/scene/node.h"
+#include "engine/core/thread/Threading.h"
+#include <algorithm>
 
 namespace Echo
 {
@@ -28,13 +30,13 @@ namespace Echo
 
 	ConnectObjectClassMethod::ConnectObjectClassMethod(Signal* signal, Object* target, ClassMethodBind* method)
 		: m_signal(signal)
-		, m_targetId(target->getId())
+		, m_target(target->getId())
 		, m_method(method)
 	{}
 
 	void ConnectObjectClassMethod::emitSignal(const Variant** args, int argCount)
 	{
-        Object* target = Object::getById(m_targetId);
+        Object* target = Object::getById(m_target);
         if(target)
         {
             Variant::CallError error;
@@ -50,7 +52,7 @@ namespace Echo
 	ConnectLuaMethod::ConnectLuaMethod(Signal* signal, Object* target, const String& functionName)
 		: m_signal(signal)
 		, m_functionName(functionName)
-        , m_targetId(target->getId())
+        , m_target(target->getId())
 	{}
 
 	ConnectLuaMethod::ConnectLuaMethod(Signal* signal, const String& target, const String& functionName)
@@ -79,22 +81,45 @@ namespace Echo
     
     Object* ConnectLuaMethod::getTarget()
     {
-        if(!m_targetId && m_signal)
+        if(!m_target && m_signal)
         {
             Node* owner = ECHO_DOWN_CAST<Node*>(m_signal->getOwner());
             if(owner)
             {
                 Object* target = owner->getNode(m_targetPath.c_str());
                 if(target)
-                    m_targetId = target->getId();
+                    m_target = target->getId();
 
 				return target;
             }
         }
 
-		return Object::getById(m_targetId);
+		return Object::getById(m_target);
     }
     
+	// emits waiting for Signal::flushDeferred, one record per connect
+	struct SignalQueue
+	{
+		Mutex						m_mutex;
+		vector<Connect*>::type		m_records;
+		vector<Connect*>::type		m_flushing;
+
+		static SignalQueue& instance()
+		{
+			static SignalQueue* queue = new SignalQueue;
+			return *queue;
+		}
+
+		// drop the records of a connect before it is deleted. connects are deleted on the
+		// thread that flushes, so clearing the flushing records doesn't race the flush
+		void cancel(Connect* connect)
+		{
+			MutexLock lock(m_mutex);
+			std::replace(m_records.begin(), m_records.end(), connect, (Connect*)nullptr);
+			std::replace(m_flushing.begin(), m_flushing.end(), connect, (Connect*)nullptr);
+		}
+	};
+
     Signal::Signal(Object* owner)
         : m_owner(owner)
     {
@@ -105,6 +130,71 @@ namespace Echo
 		disconnectAll();
     }
 
+	void Signal::emit()
+	{
+		if (m_dispatchMode == DispatchMode::Immediate)
+		{
+			dispatch(nullptr, 0);
+			return;
+		}
+
+		if (!m_connects)
+			return;
+
+		// coalescing is per connect, a target emitted to twice in a frame runs once
+		SignalQueue& queue = SignalQueue::instance();
+		MutexLock lock(queue.m_mutex);
+		for (Connect* connect : *m_connects)
+		{
+			if (m_dispatchMode == DispatchMode::DeferredCoalesced)
+			{
+				if (connect->m_isQueued)
+					continue;
+
+				connect->m_isQueued = true;
+			}
+
+			queue.m_records.push_back(connect);
+		}
+	}
+
+	void Signal::dispatch(const Variant** args, int argCount)
+	{
+		// connects may disconnect themselves while running
+		for (size_t i = 0; m_connects && i < m_connects->size();)
+		{
+			Connect* connect = (*m_connects)[i];
+			connect->emitSignal(args, argCount);
+			if (m_connects && i < m_connects->size() && (*m_connects)[i] == connect)
+				i++;
+		}
+	}
+
+	void Signal::flushDeferred()
+	{
+		// emits raised while flushing wait for the next frame
+		SignalQueue& queue = SignalQueue::instance();
+		{
+			MutexLock lock(queue.m_mutex);
+			queue.m_flushing.swap(queue.m_records);
+			for (Connect* connect : queue.m_flushing)
+			{
+				if (connect)
+					connect->m_isQueued = false;
+			}
+		}
+
+		// a connect may delete later ones, or their signal, which cancels their records
+		for (size_t i = 0; i < queue.m_flushing.size(); i++)
+		{
+			Connect* connect = queue.m_flushing[i];
+			if (connect)
+				connect->emitSignal(nullptr, 0);
+		}
+
+		queue.m_flushing.clear();
+	}
+
 	bool Signal::connectClassMethod(Object* obj, ClassMethodBind* method)
 	{
         if(!m_connects)
@@ -144,6 +234,7 @@ namespace Echo
 				Connect* curConn = *it;
 				if (curConn == connect)
 				{
+					SignalQueue::instance().cancel(curConn);
 					EchoSafeDelete(curConn, Connect);
 					m_connects->erase(it);
 					break;
@@ -157,7 +248,10 @@ namespace Echo
 		if (m_connects)
 		{
 			for (Connect* conn : *m_connects)
+			{
+				SignalQueue::instance().cancel(conn);
 				EchoSafeDelete(conn, Connect);
+			}
 
 			delete m_connects; m_connects = nullptr;
 		}
@@ -172,9 +266,10 @@ namespace Echo
 				ConnectLuaMethod* luaConn = ECHO_DOWN_CAST<ConnectLuaMethod*>(*it);
                 if(luaConn)
                 {
-                    Object* luaTarget = Object::getById(luaConn->m_targetId);
+                    Object* luaTarget = Object::getById(luaConn->m_target);
                     if (luaConn && luaTarget == obj && luaConn->m_functionName == luaMethodName)
                     {
+                        SignalQueue::instance().cancel(luaConn);
                         EchoSafeDelete(luaConn, ConnectLuaMethod);
                         m_connects->erase(it);
                         break;
@@ -193,6 +288,7 @@ namespace Echo
 				ConnectLuaMethod* luaConn = ECHO_DOWN_CAST<ConnectLuaMethod*>(*it);
 				if (luaConn && luaConn->m_targetPath == obj && luaConn->m_functionName == luaMethodName)
 				{
+					SignalQueue::instance().cancel(luaConn);
 					EchoSafeDelete(luaConn, ConnectLuaMethod);
 					m_connects->erase(it);
 					break;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/core/memory/MemAllocDef.h"
+#include "object_registry.h"
 
 namespace Echo
 {
@@ -19,6 +20,9 @@ namespace Echo
         
         // save
         virtual void save(void* pugiNode) {}
+
+        // a coalesced emit for this connect waits for the flush
+        bool m_isQueued = false;
 	};
 
 	struct ConnectClassMethod : public Connect
@@ -36,7 +40,7 @@ namespace Echo
     struct ConnectObjectClassMethod : public Connect
     {
         Signal*             m_signal;
-        i32                 m_targetId;
+        ObjectHandle        m_target;
         ClassMethodBind*    m_method;
         
 		ConnectObjectClassMethod(Signal* signal, Object* target, ClassMethodBind* method);
@@ -50,7 +54,7 @@ namespace Echo
         Signal*           m_signal;
         String            m_targetPath;
         String            m_functionName;
-        i32               m_targetId = 0;
+        ObjectHandle      m_target = 0;
 
 		ConnectLuaMethod(Signal* signal, Object* target, const String& functionName);
 		ConnectLuaMethod(Signal* signal, const String& target, const String& functionName);
@@ -70,9 +74,31 @@ namespace Echo
     // A lightweight signals and slots implementation
 	class Signal
 	{
+	public:
+		enum class DispatchMode
+		{
+			Immediate,				// connects run inside emit
+			Deferred,				// every emit is queued and runs at the frame's flush
+			DeferredCoalesced,		// emits of one frame run each connect once at the flush
+		};
+
 	public:
         Signal(Object* owner);
         virtual ~Signal();
+
+		// dispatch mode. deferred signals may be emitted from any thread
+		void setDispatchMode(DispatchMode mode) { m_dispatchMode = mode; }
+		DispatchMode getDispatchMode() const { return m_dispatchMode; }
+
+		// emit without arguments by dispatch mode
+		void emit();
+
+		// run all connects now
+		void dispatch(const Variant** args, int argCount);
+
+		// run queued emits, called once per frame by Engine::tick. an emit reaches the connects
+		// the signal had when it was emitted and that are still connected
+		static void flushDeferred();
         
 		// connect
 		bool connectClassMethod(Object* obj, ClassMethodBind* method);
@@ -101,6 +127,7 @@ namespace Echo
 	protected:
         Object*                 m_owner = nullptr;
 		vector<Connect*>::type*	m_connects = nullptr;
+		DispatchMode			m_dispatchMode = DispatchMode::Immediate;
 	};
 
 	class Signal0 : public Signal
@@ -111,11 +138,7 @@ namespace Echo
 		// operate ()
 		void operator() ()
 		{
-            if(m_connects)
-            {
-                for (Connect* connect : *m_connects)
-                    connect->emitSignal(nullptr, 0);
-            }
+            emit();
 		}
 
         bool connectClassMethod(void* obj, ClassMethodBind* method)
@@ -0,0 +1,55 @@
+#include "texture_importer.h"
+#include "engine/core/editor/editor.h"
+#include "engine/core/util/PathUtil.h"
+#include "engine/core/io/IO.h"
+#include "engine/core/render/base/image/texture_cooker.h"
+
+#ifdef ECHO_EDITOR_MODE
+
+namespace Echo
+{
+	TextureImporter::TextureImporter()
+	{
+	}
+
+	TextureImporter::~TextureImporter()
+	{
+
+	}
+
+	void TextureImporter::bindMethods()
+	{
+
+	}
+
+	void TextureImporter::run(const char* targetFolder)
+	{
+		if (IO::instance()->convertFullPathToResPath(targetFolder, m_targetFoler))
+		{
+			QStringList resFiles = QFileDialog::getOpenFileNames(nullptr, "Import Textures", "", "*.png *.jpg *.jpeg *.tga *.bmp");
+			if (resFiles.empty())
+				return;
+
+			// target format
+			QStringList formats = { "PF_ETC2_RGBA", "PF_ETC2_RGB", "PF_ETC1", "PF_RGBA8_UNORM", "PF_RGB8_UNORM" };
+			const PixelFormat pixFormats[] = { PF_ETC2_RGBA, PF_ETC2_RGB, PF_ETC1, PF_RGBA8_UNORM, PF_RGB8_UNORM };
+
+			bool isOk = false;
+			QString format = QInputDialog::getItem(nullptr, "Texture Format", "Target Format", formats, 0, false, &isOk);
+			if (!isOk)
+				return;
+
+			PixelFormat targetFormat = pixFormats[formats.indexOf(format)];
+			for (const QString& qFile : resFiles)
+			{
+				String srcFile = qFile.toStdString().c_str();
+				if (!srcFile.empty())
+				{
+					String destFile = m_targetFoler + PathUtil::GetPureFilename(srcFile, false) + ".etex";
+					TextureCooker::cook(srcFile, destFile, targetFormat, true);
+				}
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "engine/core/editor/importer.h"
+
+#ifdef ECHO_EDITOR_MODE
+
+namespace Echo
+{
+	class TextureImporter : public Importer
+	{
+		ECHO_CLASS(TextureImporter, Importer)
+
+	public:
+		TextureImporter();
+		virtual ~TextureImporter();
+
+		// name
+		virtual const char* getName() override { return "Texture (*.etex)"; }
+
+		// import
+		virtual void run(const char* targetFolder) override;
+
+	private:
+		String		m_targetFoler;
+	};
+}
+#endif
@@ -25,6 +25,7 @@
 #include <QDialog>
 #include <QToolButton>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
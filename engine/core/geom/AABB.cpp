@@ -6,6 +6,17 @@ namespace Echo
 {
 	const AABB AABB::ZERO(Vector3::ZERO, Vector3::ZERO);
 
+	void AABB::TransformBatch(AABB* outBoxes, const AABB* boxes, const Matrix4* matrices, ui32 count)
+	{
+		for (ui32 i = 0; i < count; i++)
+		{
+			if (boxes[i].isValid())
+				TransformAffine(outBoxes[i], boxes[i], matrices[i]);
+			else
+				outBoxes[i].reset();
+		}
+	}
+
 	// ַbox
 	AABB AABB::fromString(const String& val)
 	{
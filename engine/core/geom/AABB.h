@@ -245,37 +245,14 @@ namespace Echo
 		{
 			AABB box;
 			if (isValid())
-			{
-				Vector3 basePoint(vMin);
-				Vector3 xLeg(vMax.x, vMin.y, vMin.z);
-				Vector3 yLeg(vMin.x, vMax.y, vMin.z);
-				Vector3 zLeg(vMin.x, vMin.y, vMax.z);
-
-				basePoint = basePoint * matrix;
-				xLeg = xLeg * matrix;
-				yLeg = yLeg * matrix;
-				zLeg = zLeg * matrix;
-
-				xLeg -= basePoint;
-				yLeg -= basePoint;
-				zLeg -= basePoint;
-
-				Vector3 farPoint(basePoint + xLeg + yLeg + zLeg);
-
-				box.vMin = basePoint;
-				box.vMax = farPoint;
-
-				box.addPoint(basePoint + xLeg);
-				box.addPoint(basePoint + yLeg);
-				box.addPoint(basePoint + zLeg);
-				box.addPoint(basePoint + xLeg + yLeg);
-				box.addPoint(basePoint + yLeg + zLeg);
-				box.addPoint(basePoint + zLeg + xLeg);
-			}
+				TransformAffine(box, *this, matrix);
 	
 			return box;
 		}
 
+		// world boxes of N local boxes, invalid boxes stay invalid
+		static void TransformBatch(AABB* outBoxes, const AABB* boxes, const Matrix4* matrices, ui32 count);
+
 		inline Real getDiagonalLenSqr() const
 		{
 			Real dx = getDX();
@@ -324,5 +301,36 @@ namespace Echo
 			default: return Vector3::INVALID;
 			}
 		}
+
+	private:
+		// center|extent form: new extent is |M| * extent, no need to transform all 8 corners
+		static void TransformAffine(AABB& out, const AABB& box, const Matrix4& matrix)
+		{
+			Vector3 center = box.getCenter();
+			Vector3 extent = (box.vMax - box.vMin) * 0.5f;
+		#ifdef ECHO_SIMD
+			Simd::Float4 row0 = Simd::load(matrix.m);
+			Simd::Float4 row1 = Simd::load(matrix.m + 4);
+			Simd::Float4 row2 = Simd::load(matrix.m + 8);
+			Simd::Float4 newCenter = Simd::madd(Simd::splat(center.x), row0, Simd::load(matrix.m + 12));
+			newCenter = Simd::madd(Simd::splat(center.y), row1, newCenter);
+			newCenter = Simd::madd(Simd::splat(center.z), row2, newCenter);
+
+			Simd::Float4 newExtent = Simd::mul(Simd::splat(extent.x), Simd::abs(row0));
+			newExtent = Simd::madd(Simd::splat(extent.y), Simd::abs(row1), newExtent);
+			newExtent = Simd::madd(Simd::splat(extent.z), Simd::abs(row2), newExtent);
+
+			Simd::store3(out.vMin.ptr(), Simd::sub(newCenter, newExtent));
+			Simd::store3(out.vMax.ptr(), Simd::add(newCenter, newExtent));
+		#else
+			Vector3 newCenter = center * matrix;
+			Vector3 newExtent;
+			newExtent.x = extent.x * Math::Abs(matrix.m00) + extent.y * Math::Abs(matrix.m10) + extent.z * Math::Abs(matrix.m20);
+			newExtent.y = extent.x * Math::Abs(matrix.m01) + extent.y * Math::Abs(matrix.m11) + extent.z * Math::Abs(matrix.m21);
+			newExtent.z = extent.x * Math::Abs(matrix.m02) + extent.y * Math::Abs(matrix.m12) + extent.z * Math::Abs(matrix.m22);
+			out.vMin = newCenter - newExtent;
+			out.vMax = newCenter + newExtent;
+		#endif
+		}
 	};
 }
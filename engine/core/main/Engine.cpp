@@ -1,6 +1,7 @@
 #include "engine/core/base/class.h"
 #include "engine/core/editor/importer.h"
 #include "engine/core/editor/importer/file_importer.h"
+#include "engine/core/editor/importer/texture_importer.h"
 #include "engine/core/main/Engine.h"
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/util/HashGenerator.h"
@@ -154,6 +155,7 @@ namespace Echo
 	#ifdef ECHO_EDITOR_MODE
 		Class::registerType<Importer>();
 		Class::registerType<FileImporter>();
+		Class::registerType<TextureImporter>();
 	#endif
        
 		CLASS_REGISTER_EDITOR(Scratch, ScratchEditor)
@@ -319,6 +321,9 @@ namespace Echo
 		Module::updateAll(m_frameTime);
 		NodeTree::instance()->update(m_frameTime);
 
+		// deferred signals queued by this frame's update
+		Signal::flushDeferred();
+
 		// input update
 		Input::instance()->update();
 
@@ -258,6 +258,33 @@ namespace Echo
 		outVec.set(x, y, z);
 	}
 
+	void Matrix4::MultiplyBatch(Matrix4* outMats, const Matrix4* a, const Matrix4* b, ui32 count)
+	{
+		for (ui32 i = 0; i < count; i++)
+			Multiply(outMats[i], a[i], b[i]);
+	}
+
+	void Matrix4::TransformVec3Batch(Vector3* outVecs, const Vector3* vecs, ui32 count, const Matrix4& matrix)
+	{
+	#ifdef ECHO_SIMD
+		Simd::Float4 row0 = Simd::load(matrix.m);
+		Simd::Float4 row1 = Simd::load(matrix.m + 4);
+		Simd::Float4 row2 = Simd::load(matrix.m + 8);
+		Simd::Float4 row3 = Simd::load(matrix.m + 12);
+		for (ui32 i = 0; i < count; i++)
+		{
+			const Vector3& v = vecs[i];
+			Simd::Float4 r = Simd::madd(Simd::splat(v.x), row0, row3);
+			r = Simd::madd(Simd::splat(v.y), row1, r);
+			r = Simd::madd(Simd::splat(v.z), row2, r);
+			Simd::store3(outVecs[i].ptr(), r);
+		}
+	#else
+		for (ui32 i = 0; i < count; i++)
+			TransformVec3(outVecs[i], vecs[i], matrix);
+	#endif
+	}
+
 	void Matrix4::TransformVec4(Vector4& outVec, const Vector4& v, const Matrix4& matrix)
 	{
 		Real x = v.x * matrix.m00 + v.y * matrix.m10 + v.z * matrix.m20 + v.w * matrix.m30;
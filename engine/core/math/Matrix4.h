@@ -2,6 +2,7 @@
 #define __ECHO_MAT4_H__
 
 #include "Vector4.h"
+#include "Simd.h"
 
 namespace Echo
 {
@@ -132,30 +133,7 @@ namespace Echo
 
 		Matrix4& operator *= (const Matrix4& rhs)
 		{
-			Matrix4 result;
-
-			result.m00 = m00 * rhs.m00 + m01 * rhs.m10 + m02 * rhs.m20 + m03 * rhs.m30;
-			result.m01 = m00 * rhs.m01 + m01 * rhs.m11 + m02 * rhs.m21 + m03 * rhs.m31;
-			result.m02 = m00 * rhs.m02 + m01 * rhs.m12 + m02 * rhs.m22 + m03 * rhs.m32;
-			result.m03 = m00 * rhs.m03 + m01 * rhs.m13 + m02 * rhs.m23 + m03 * rhs.m33;
-
-			result.m10 = m10 * rhs.m00 + m11 * rhs.m10 + m12 * rhs.m20 + m13 * rhs.m30;
-			result.m11 = m10 * rhs.m01 + m11 * rhs.m11 + m12 * rhs.m21 + m13 * rhs.m31;
-			result.m12 = m10 * rhs.m02 + m11 * rhs.m12 + m12 * rhs.m22 + m13 * rhs.m32;
-			result.m13 = m10 * rhs.m03 + m11 * rhs.m13 + m12 * rhs.m23 + m13 * rhs.m33;
-
-			result.m20 = m20 * rhs.m00 + m21 * rhs.m10 + m22 * rhs.m20 + m23 * rhs.m30;
-			result.m21 = m20 * rhs.m01 + m21 * rhs.m11 + m22 * rhs.m21 + m23 * rhs.m31;
-			result.m22 = m20 * rhs.m02 + m21 * rhs.m12 + m22 * rhs.m22 + m23 * rhs.m32;
-			result.m23 = m20 * rhs.m03 + m21 * rhs.m13 + m22 * rhs.m23 + m23 * rhs.m33;
-
-			result.m30 = m30 * rhs.m00 + m31 * rhs.m10 + m32 * rhs.m20 + m33 * rhs.m30;
-			result.m31 = m30 * rhs.m01 + m31 * rhs.m11 + m32 * rhs.m21 + m33 * rhs.m31;
-			result.m32 = m30 * rhs.m02 + m31 * rhs.m12 + m32 * rhs.m22 + m33 * rhs.m32;
-			result.m33 = m30 * rhs.m03 + m31 * rhs.m13 + m32 * rhs.m23 + m33 * rhs.m33;
-
-			*this = result;
-
+			Multiply(*this, *this, rhs);
 			return *this;
 		}
 
@@ -285,10 +263,18 @@ namespace Echo
 		{
 			Vector4 result;
 
+		#ifdef ECHO_SIMD
+			Simd::Float4 r = Simd::mul(Simd::splat(v.x), Simd::load(m.m));
+			r = Simd::madd(Simd::splat(v.y), Simd::load(m.m + 4), r);
+			r = Simd::madd(Simd::splat(v.z), Simd::load(m.m + 8), r);
+			r = Simd::madd(Simd::splat(v.w), Simd::load(m.m + 12), r);
+			Simd::store(result.m, r);
+		#else
 			result.x = v.x * m.m00 + v.y * m.m10 + v.z * m.m20 + v.w * m.m30;
 			result.y = v.x * m.m01 + v.y * m.m11 + v.z * m.m21 + v.w * m.m31;
 			result.z = v.x * m.m02 + v.y * m.m12 + v.z * m.m22 + v.w * m.m32;
 			result.w = v.x * m.m03 + v.y * m.m13 + v.z * m.m23 + v.w * m.m33;
+		#endif
 
 			return result;
 		}
@@ -307,27 +293,7 @@ namespace Echo
 		Matrix4 operator* (const Matrix4& b) const
 		{
 			Matrix4 result;
-
-			result.m00 = m00 * b.m00 + m01 * b.m10 + m02 * b.m20 + m03 * b.m30;
-			result.m01 = m00 * b.m01 + m01 * b.m11 + m02 * b.m21 + m03 * b.m31;
-			result.m02 = m00 * b.m02 + m01 * b.m12 + m02 * b.m22 + m03 * b.m32;
-			result.m03 = m00 * b.m03 + m01 * b.m13 + m02 * b.m23 + m03 * b.m33;
-
-			result.m10 = m10 * b.m00 + m11 * b.m10 + m12 * b.m20 + m13 * b.m30;
-			result.m11 = m10 * b.m01 + m11 * b.m11 + m12 * b.m21 + m13 * b.m31;
-			result.m12 = m10 * b.m02 + m11 * b.m12 + m12 * b.m22 + m13 * b.m32;
-			result.m13 = m10 * b.m03 + m11 * b.m13 + m12 * b.m23 + m13 * b.m33;
-
-			result.m20 = m20 * b.m00 + m21 * b.m10 + m22 * b.m20 + m23 * b.m30;
-			result.m21 = m20 * b.m01 + m21 * b.m11 + m22 * b.m21 + m23 * b.m31;
-			result.m22 = m20 * b.m02 + m21 * b.m12 + m22 * b.m22 + m23 * b.m32;
-			result.m23 = m20 * b.m03 + m21 * b.m13 + m22 * b.m23 + m23 * b.m33;
-
-			result.m30 = m30 * b.m00 + m31 * b.m10 + m32 * b.m20 + m33 * b.m30;
-			result.m31 = m30 * b.m01 + m31 * b.m11 + m32 * b.m21 + m33 * b.m31;
-			result.m32 = m30 * b.m02 + m31 * b.m12 + m32 * b.m22 + m33 * b.m32;
-			result.m33 = m30 * b.m03 + m31 * b.m13 + m32 * b.m23 + m33 * b.m33;
-
+			Multiply(result, *this, b);
 			return result;
 		}
 
@@ -689,6 +655,53 @@ namespace Echo
 		void			fromQuan(const Quaternion &quan);
 
 	public:
+		// out = a * b, out may be a or b
+		static void Multiply(Matrix4& out, const Matrix4& a, const Matrix4& b)
+		{
+		#ifdef ECHO_SIMD
+			Simd::Float4 b0 = Simd::load(b.m);
+			Simd::Float4 b1 = Simd::load(b.m + 4);
+			Simd::Float4 b2 = Simd::load(b.m + 8);
+			Simd::Float4 b3 = Simd::load(b.m + 12);
+			for (int i = 0; i < 16; i += 4)
+			{
+				Simd::Float4 r = Simd::mul(Simd::splat(a.m[i]), b0);
+				r = Simd::madd(Simd::splat(a.m[i + 1]), b1, r);
+				r = Simd::madd(Simd::splat(a.m[i + 2]), b2, r);
+				r = Simd::madd(Simd::splat(a.m[i + 3]), b3, r);
+				Simd::store(out.m + i, r);
+			}
+		#else
+			Matrix4 result;
+
+			result.m00 = a.m00 * b.m00 + a.m01 * b.m10 + a.m02 * b.m20 + a.m03 * b.m30;
+			result.m01 = a.m00 * b.m01 + a.m01 * b.m11 + a.m02 * b.m21 + a.m03 * b.m31;
+			result.m02 = a.m00 * b.m02 + a.m01 * b.m12 + a.m02 * b.m22 + a.m03 * b.m32;
+			result.m03 = a.m00 * b.m03 + a.m01 * b.m13 + a.m02 * b.m23 + a.m03 * b.m33;
+
+			result.m10 = a.m10 * b.m00 + a.m11 * b.m10 + a.m12 * b.m20 + a.m13 * b.m30;
+			result.m11 = a.m10 * b.m01 + a.m11 * b.m11 + a.m12 * b.m21 + a.m13 * b.m31;
+			result.m12 = a.m10 * b.m02 + a.m11 * b.m12 + a.m12 * b.m22 + a.m13 * b.m32;
+			result.m13 = a.m10 * b.m03 + a.m11 * b.m13 + a.m12 * b.m23 + a.m13 * b.m33;
+
+			result.m20 = a.m20 * b.m00 + a.m21 * b.m10 + a.m22 * b.m20 + a.m23 * b.m30;
+			result.m21 = a.m20 * b.m01 + a.m21 * b.m11 + a.m22 * b.m21 + a.m23 * b.m31;
+			result.m22 = a.m20 * b.m02 + a.m21 * b.m12 + a.m22 * b.m22 + a.m23 * b.m32;
+			result.m23 = a.m20 * b.m03 + a.m21 * b.m13 + a.m22 * b.m23 + a.m23 * b.m33;
+
+			result.m30 = a.m30 * b.m00 + a.m31 * b.m10 + a.m32 * b.m20 + a.m33 * b.m30;
+			result.m31 = a.m30 * b.m01 + a.m31 * b.m11 + a.m32 * b.m21 + a.m33 * b.m31;
+			result.m32 = a.m30 * b.m02 + a.m31 * b.m12 + a.m32 * b.m22 + a.m33 * b.m32;
+			result.m33 = a.m30 * b.m03 + a.m31 * b.m13 + a.m32 * b.m23 + a.m33 * b.m33;
+
+			out = result;
+		#endif
+		}
+
+		// batch versions for hot loops (node world matrices, skinning, culling)
+		static void		MultiplyBatch(Matrix4* outMats, const Matrix4* a, const Matrix4* b, ui32 count);
+		static void		TransformVec3Batch(Vector3* outVecs, const Vector3* vecs, ui32 count, const Matrix4& matrix);
+
 		static void		Transpose(Matrix4 &outMat, const Matrix4 &matrix);
 		static void		TransformVec3(Vector3 &outVec, const Vector3 &v, const Matrix4 &matrix);
 		static void		TransformVec4(Vector4 &outVec, const Vector4 &v, const Matrix4 &matrix);
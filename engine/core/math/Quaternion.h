@@ -116,15 +116,8 @@ namespace Echo
 
 		inline Quaternion& operator *= (const Quaternion& q)
 		{
-			float x0 = x;
-			float y0 = y;
-			float z0 = z;
-			float w0 = w;
-			x = w0 * q.x + x0 * q.w + z0 * q.y - y0 * q.z;
-			y = w0 * q.y + y0 * q.w + x0 * q.z - z0 * q.x;
-			z = w0 * q.z + z0 * q.w + y0 * q.x - x0 * q.y;
-			w = w0 * q.w - x0 * q.x - y0 * q.y - z0 * q.z;
-
+			// note: the cross terms make this q * (*this)
+			Multiply(*this, q, *this);
 			return *this;
 		}
 
@@ -230,14 +223,29 @@ namespace Echo
 		inline Quaternion operator* (const Quaternion& b) const
 		{
 			Quaternion quan;
-			quan.x = w * b.x + x * b.w + y * b.z - z *b.y;
-			quan.y = w * b.y + y * b.w + z * b.x - x *b.z;
-			quan.z = w * b.z + z * b.w + x * b.y - y *b.x;
-			quan.w = w * b.w - x * b.x - y * b.y - z * b.z;
-
+			Multiply(quan, *this, b);
 			return quan;
 		}
 
+		// out = a * b, out may be a or b
+		static inline void Multiply(Quaternion& out, const Quaternion& a, const Quaternion& b)
+		{
+		#ifdef ECHO_SIMD
+			Simd::Float4 vb = Simd::load(b.m);
+			Simd::Float4 r = Simd::mul(Simd::splat(a.w), vb);
+			r = Simd::madd(Simd::splat(a.x), Simd::mul(Simd::wzyx(vb), Simd::set(1.f, -1.f, 1.f, -1.f)), r);
+			r = Simd::madd(Simd::splat(a.y), Simd::mul(Simd::zwxy(vb), Simd::set(1.f, 1.f, -1.f, -1.f)), r);
+			r = Simd::madd(Simd::splat(a.z), Simd::mul(Simd::yxwz(vb), Simd::set(-1.f, 1.f, 1.f, -1.f)), r);
+			Simd::store(out.m, r);
+		#else
+			Real x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+			Real y = a.w * b.y + a.y * b.w + a.z * b.x - a.x * b.z;
+			Real z = a.w * b.z + a.z * b.w + a.x * b.y - a.y * b.x;
+			Real w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+			out.x = x; out.y = y; out.z = z; out.w = w;
+		#endif
+		}
+
 		inline Vector3 operator* (const Vector3& v) const
 		{
 			// nVidia SDK implementation
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "engine/core/base/type_def.h"
+
+// 4 wide float helpers used by the math core, sse on x86 and neon on arm.
+// Falls back to plain scalar code for double precision or other targets.
+#ifndef ECHO_PREC_DOUBLE
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define ECHO_SIMD_SSE
+		#include <xmmintrin.h>
+		#include <emmintrin.h>
+	#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+		#define ECHO_SIMD_NEON
+		#include <arm_neon.h>
+	#endif
+#endif
+
+#if defined(ECHO_SIMD_SSE) || defined(ECHO_SIMD_NEON)
+	#define ECHO_SIMD
+#endif
+
+#ifdef ECHO_SIMD
+namespace Echo
+{
+namespace Simd
+{
+#ifdef ECHO_SIMD_SSE
+	typedef __m128 Float4;
+
+	inline Float4 load(const Real* p) { return _mm_loadu_ps(p); }
+	inline void store(Real* p, Float4 v) { _mm_storeu_ps(p, v); }
+	inline Float4 splat(Real f) { return _mm_set1_ps(f); }
+	inline Float4 set(Real x, Real y, Real z, Real w) { return _mm_setr_ps(x, y, z, w); }
+	inline Float4 loadInt(const i32* p) { return _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)p)); }
+	inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+	inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+	inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+	inline Float4 abs(Float4 v) { return _mm_andnot_ps(_mm_set1_ps(-0.f), v); }
+	inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+	inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+
+	// bit i is set when a[i] <= b[i]
+	inline i32 lessEqualMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+
+	// valid for |v| < 2^31
+	inline Float4 floor(Float4 v)
+	{
+		Float4 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+		return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.f)));
+	}
+
+	// a * b + c
+	inline Float4 madd(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+	// x y z, w is zero
+	inline Float4 load3(const Real* p)
+	{
+		return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)p), _mm_load_ss(p + 2));
+	}
+
+	inline void store3(Real* p, Float4 v)
+	{
+		_mm_storel_pi((__m64*)p, v);
+		_mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+	}
+
+	// lane reorders used by quaternion multiply
+	inline Float4 wzyx(Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+	inline Float4 zwxy(Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+	inline Float4 yxwz(Float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+#else
+	typedef float32x4_t Float4;
+
+	inline Float4 load(const Real* p) { return vld1q_f32(p); }
+	inline void store(Real* p, Float4 v) { vst1q_f32(p, v); }
+	inline Float4 splat(Real f) { return vdupq_n_f32(f); }
+	inline Float4 set(Real x, Real y, Real z, Real w) { Real v[4] = { x, y, z, w }; return vld1q_f32(v); }
+	inline Float4 loadInt(const i32* p) { return vcvtq_f32_s32(vld1q_s32(p)); }
+	inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+	inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+	inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+	inline Float4 abs(Float4 v) { return vabsq_f32(v); }
+	inline Float4 min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+	inline Float4 max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+
+	// bit i is set when a[i] <= b[i]
+	inline i32 lessEqualMask(Float4 a, Float4 b)
+	{
+		static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+		uint32x4_t bits = vandq_u32(vcleq_f32(a, b), vld1q_u32(laneBits));
+		return i32(vgetq_lane_u32(bits, 0) | vgetq_lane_u32(bits, 1) | vgetq_lane_u32(bits, 2) | vgetq_lane_u32(bits, 3));
+	}
+
+	// valid for |v| < 2^31
+	inline Float4 floor(Float4 v)
+	{
+		Float4 t = vcvtq_f32_s32(vcvtq_s32_f32(v));
+		return vsubq_f32(t, vbslq_f32(vcgtq_f32(t, v), vdupq_n_f32(1.f), vdupq_n_f32(0.f)));
+	}
+
+	// a * b + c
+	inline Float4 madd(Float4 a, Float4 b, Float4 c) { return vmlaq_f32(c, a, b); }
+
+	// x y z, w is zero
+	inline Float4 load3(const Real* p)
+	{
+		return vcombine_f32(vld1_f32(p), vld1_lane_f32(p + 2, vdup_n_f32(0.f), 0));
+	}
+
+	inline void store3(Real* p, Float4 v)
+	{
+		vst1_f32(p, vget_low_f32(v));
+		vst1q_lane_f32(p + 2, v, 2);
+	}
+
+	// lane reorders used by quaternion multiply
+	inline Float4 yxwz(Float4 v) { return vrev64q_f32(v); }
+	inline Float4 zwxy(Float4 v) { return vextq_f32(v, v, 2); }
+	inline Float4 wzyx(Float4 v) { return zwxy(yxwz(v)); }
+#endif
+}
+}
+#endif
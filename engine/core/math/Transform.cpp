@@ -22,13 +22,18 @@ namespace Echo
 
 	void Transform::buildMatrix(Matrix4& mat) const
 	{
-		mat.makeScaling(m_scale);
-
-		Matrix4 matRot;
-		matRot.fromQuan(m_quat);
-		mat = mat * matRot;
+		// scale * rotate * translate, the scale matrix is diagonal so just scale the rotation rows
+		m_quat.toMat4(mat);
+		mat.m00 *= m_scale.x; mat.m01 *= m_scale.x; mat.m02 *= m_scale.x;
+		mat.m10 *= m_scale.y; mat.m11 *= m_scale.y; mat.m12 *= m_scale.y;
+		mat.m20 *= m_scale.z; mat.m21 *= m_scale.z; mat.m22 *= m_scale.z;
+		mat.m30 = m_pos.x;    mat.m31 = m_pos.y;    mat.m32 = m_pos.z;
+	}
 
-		mat.translate(m_pos);
+	void Transform::BuildMatrixBatch(Matrix4* outMats, const Transform* transforms, ui32 count)
+	{
+		for (ui32 i = 0; i < count; i++)
+			transforms[i].buildMatrix(outMats[i]);
 	}
 
 	void Transform::buildInvMatrix(Matrix4& invMat) const
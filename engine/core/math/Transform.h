@@ -29,5 +29,9 @@ namespace Echo
 
 		// reset
 		void reset();
+
+	public:
+		// build N matrices
+		static void BuildMatrixBatch(Matrix4* outMats, const Transform* transforms, ui32 count);
 	};
 }
\ No newline at end of file
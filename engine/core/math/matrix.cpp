@@ -1,8 +1,218 @@
 #include "matrix.h"
 #include "engine/core/log/Log.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ECHO_MATRIX_SSE2
+	#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	#define ECHO_MATRIX_NEON
+	#include <arm_neon.h>
+#endif
 
 namespace Echo
 {
+	namespace
+	{
+		// register tile and cache block sizes of the gemm, a packed kc x nc panel of b stays in l2
+		const int GemmMR = 4;
+		const int GemmNR = 4;
+		const int GemmMC = 64;
+		const int GemmKC = 256;
+		const int GemmNC = 512;
+
+		// below this many rows packing costs more than it saves
+		const int GemmSmallRows = 4;
+
+		// element (i, j) is data[i * rowStride + j * colStride]
+		struct MatrixView
+		{
+			const double*	m_data;
+			int				m_rowStride;
+			int				m_colStride;
+
+			MatrixView(const Matrix& m, bool transpose)
+				: m_data(m.data())
+				, m_rowStride(transpose ? 1 : m.getWidth())
+				, m_colStride(transpose ? m.getWidth() : 1)
+			{}
+
+			double operator() (int i, int j) const { return m_data[i * m_rowStride + j * m_colStride]; }
+		};
+
+		// a block as MR row slivers, each sliver stores MR values per k
+		void packA(const MatrixView& a, int i0, int mc, int k0, int kc, double* out)
+		{
+			for (int i = 0; i < mc; i += GemmMR)
+			{
+				for (int k = 0; k < kc; k++)
+				{
+					for (int r = 0; r < GemmMR; r++)
+						*out++ = (i + r < mc) ? a(i0 + i + r, k0 + k) : 0.0;
+				}
+			}
+		}
+
+		// b block as NR column slivers, each sliver stores NR values per k
+		void packB(const MatrixView& b, int k0, int kc, int j0, int nc, double* out)
+		{
+			for (int j = 0; j < nc; j += GemmNR)
+			{
+				for (int k = 0; k < kc; k++)
+				{
+					for (int c = 0; c < GemmNR; c++)
+						*out++ = (j + c < nc) ? b(k0 + k, j0 + j + c) : 0.0;
+				}
+			}
+		}
+
+		// c[mr x nr] += alpha * packedA * packedB
+		void microKernel(int kc, const double* pa, const double* pb, double alpha, double* c, int ldc, int mr, int nr)
+		{
+			double tile[GemmMR * GemmNR];
+
+		#if defined(ECHO_MATRIX_SSE2)
+			__m128d acc[GemmMR][2];
+			for (int r = 0; r < GemmMR; r++)
+				acc[r][0] = acc[r][1] = _mm_setzero_pd();
+
+			for (int k = 0; k < kc; k++, pa += GemmMR, pb += GemmNR)
+			{
+				__m128d b01 = _mm_loadu_pd(pb);
+				__m128d b23 = _mm_loadu_pd(pb + 2);
+				for (int r = 0; r < GemmMR; r++)
+				{
+					__m128d av = _mm_set1_pd(pa[r]);
+					acc[r][0] = _mm_add_pd(acc[r][0], _mm_mul_pd(av, b01));
+					acc[r][1] = _mm_add_pd(acc[r][1], _mm_mul_pd(av, b23));
+				}
+			}
+
+			for (int r = 0; r < GemmMR; r++)
+			{
+				_mm_storeu_pd(tile + r * GemmNR, acc[r][0]);
+				_mm_storeu_pd(tile + r * GemmNR + 2, acc[r][1]);
+			}
+		#elif defined(ECHO_MATRIX_NEON)
+			float64x2_t acc[GemmMR][2];
+			for (int r = 0; r < GemmMR; r++)
+				acc[r][0] = acc[r][1] = vdupq_n_f64(0.0);
+
+			for (int k = 0; k < kc; k++, pa += GemmMR, pb += GemmNR)
+			{
+				float64x2_t b01 = vld1q_f64(pb);
+				float64x2_t b23 = vld1q_f64(pb + 2);
+				for (int r = 0; r < GemmMR; r++)
+				{
+					acc[r][0] = vfmaq_n_f64(acc[r][0], b01, pa[r]);
+					acc[r][1] = vfmaq_n_f64(acc[r][1], b23, pa[r]);
+				}
+			}
+
+			for (int r = 0; r < GemmMR; r++)
+			{
+				vst1q_f64(tile + r * GemmNR, acc[r][0]);
+				vst1q_f64(tile + r * GemmNR + 2, acc[r][1]);
+			}
+		#else
+			std::fill(tile, tile + GemmMR * GemmNR, 0.0);
+			for (int k = 0; k < kc; k++, pa += GemmMR, pb += GemmNR)
+			{
+				for (int r = 0; r < GemmMR; r++)
+				{
+					for (int col = 0; col < GemmNR; col++)
+						tile[r * GemmNR + col] += pa[r] * pb[col];
+				}
+			}
+		#endif
+
+			for (int r = 0; r < mr; r++)
+			{
+				for (int col = 0; col < nr; col++)
+					c[r * ldc + col] += alpha * tile[r * GemmNR + col];
+			}
+		}
+
+		// c row += f * b row
+		void axpyRow(double* c, const double* b, double f, int n)
+		{
+			int j = 0;
+		#if defined(ECHO_MATRIX_SSE2)
+			__m128d fv = _mm_set1_pd(f);
+			for (; j + 4 <= n; j += 4)
+			{
+				_mm_storeu_pd(c + j, _mm_add_pd(_mm_loadu_pd(c + j), _mm_mul_pd(fv, _mm_loadu_pd(b + j))));
+				_mm_storeu_pd(c + j + 2, _mm_add_pd(_mm_loadu_pd(c + j + 2), _mm_mul_pd(fv, _mm_loadu_pd(b + j + 2))));
+			}
+		#elif defined(ECHO_MATRIX_NEON)
+			for (; j + 4 <= n; j += 4)
+			{
+				vst1q_f64(c + j, vfmaq_n_f64(vld1q_f64(c + j), vld1q_f64(b + j), f));
+				vst1q_f64(c + j + 2, vfmaq_n_f64(vld1q_f64(c + j + 2), vld1q_f64(b + j + 2), f));
+			}
+		#endif
+			for (; j < n; j++)
+				c[j] += f * b[j];
+		}
+
+		// few rows (single sample inference), stream b rows straight through
+		void gemmSmall(double* c, int m, int n, int kSize, const MatrixView& a, const MatrixView& b, double alpha)
+		{
+			for (int i = 0; i < m; i++)
+			{
+				double* cRow = c + i * n;
+				for (int k = 0; k < kSize; k++)
+				{
+					double f = alpha * a(i, k);
+					if (b.m_colStride == 1)
+					{
+						axpyRow(cRow, b.m_data + k * b.m_rowStride, f, n);
+					}
+					else
+					{
+						for (int j = 0; j < n; j++)
+							cRow[j] += f * b(k, j);
+					}
+				}
+			}
+		}
+
+		void gemmBlocked(double* c, int m, int n, int kSize, const MatrixView& a, const MatrixView& b, double alpha)
+		{
+			static thread_local vector<double>::type packedA;
+			static thread_local vector<double>::type packedB;
+			packedA.resize(GemmMC * GemmKC);
+			packedB.resize(GemmKC * (GemmNC + GemmNR));
+
+			for (int j0 = 0; j0 < n; j0 += GemmNC)
+			{
+				int nc = std::min(GemmNC, n - j0);
+				for (int k0 = 0; k0 < kSize; k0 += GemmKC)
+				{
+					int kc = std::min(GemmKC, kSize - k0);
+					packB(b, k0, kc, j0, nc, packedB.data());
+
+					for (int i0 = 0; i0 < m; i0 += GemmMC)
+					{
+						int mc = std::min(GemmMC, m - i0);
+						packA(a, i0, mc, k0, kc, packedA.data());
+
+						for (int j = 0; j < nc; j += GemmNR)
+						{
+							const double* pb = packedB.data() + (j / GemmNR) * kc * GemmNR;
+							for (int i = 0; i < mc; i += GemmMR)
+							{
+								const double* pa = packedA.data() + (i / GemmMR) * kc * GemmMR;
+								double* cTile = c + (i0 + i) * n + j0 + j;
+								microKernel(kc, pa, pb, alpha, cTile, n, std::min(GemmMR, mc - i), std::min(GemmNR, nc - j));
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
 	Matrix::Matrix()
 	{
 		reset();
@@ -12,11 +222,7 @@ namespace Echo
 		: m_height(height)
 		, m_width(width)
 	{
-		for (int i = 0; i < height; i++)
-		{
-			m_array.push_back(RealVector());
-			m_array[i].resize(width, 0.f);
-		}
+		m_data.resize(height * width, 0.0);
 	}
 
 	// reset
@@ -24,157 +230,231 @@ namespace Echo
 	{
 		m_width = 0;
 		m_height = 0;
-		m_array.clear();
+		m_data.clear();
+	}
+
+	void Matrix::resize(int height, int width)
+	{
+		m_height = height;
+		m_width = width;
+		m_data.resize(height * width);
+	}
+
+	void Matrix::fill(double value)
+	{
+		std::fill(m_data.begin(), m_data.end(), value);
 	}
 
 	// add row
 	void Matrix::addRow(const RealVector& row)
 	{
 		m_width = m_width ? m_width : static_cast<int>(row.size());
-		m_array.push_back(row);
-		m_height++;
+		if (static_cast<int>(row.size()) == m_width)
+		{
+			m_data.insert(m_data.end(), row.begin(), row.end());
+			m_height++;
+		}
+		else
+		{
+			EchoLogError("Matrix add row failed, row size is different with matrix width");
+		}
 	}
 
-	Matrix Matrix::dot(const Matrix& m) const
+	void Matrix::Gemm(Matrix& out, const Matrix& a, bool transposeA, const Matrix& b, bool transposeB, double alpha, double beta)
 	{
-		int height = getHeight();
-		int mWidth = m.getWidth();
-		Matrix result( height, mWidth);
-		if (getWidth() == m.getHeight())
+		int m = transposeA ? a.getWidth() : a.getHeight();
+		int kSize = transposeA ? a.getHeight() : a.getWidth();
+		int bk = transposeB ? b.getWidth() : b.getHeight();
+		int n = transposeB ? b.getHeight() : b.getWidth();
+		if (kSize != bk || &out == &a || &out == &b)
 		{
-			int width = result.getWidth();
-			for (int i = 0; i < height; i++)
-			{
-				for (int j = 0; j < width; j++)
-				{
-					double w = 0.f;
-					for (int h = 0; h < getWidth(); h++)
-					{
-						w += m_array[i][h] + m[h][j];
-					}
+			EchoLogError("Matrix gemm failed");
+			return;
+		}
 
-					result[i][j] = w;
-				}
-			}
+		if (beta == 0.0)
+		{
+			out.resize(m, n);
+			out.fill(0.0);
 		}
-		else
+		else if (out.getHeight() != m || out.getWidth() != n)
 		{
-			EchoLogError("Matrix dot failed");
+			EchoLogError("Matrix gemm failed, output size mismatch");
+			return;
+		}
+		else if (beta != 1.0)
+		{
+			out.multiplyInPlace(Real(beta));
 		}
 
-		return result;
+		MatrixView aView(a, transposeA);
+		MatrixView bView(b, transposeB);
+		if (m < GemmSmallRows)
+			gemmSmall(out.data(), m, n, kSize, aView, bView, alpha);
+		else
+			gemmBlocked(out.data(), m, n, kSize, aView, bView, alpha);
 	}
 
-	Matrix Matrix::add(const Matrix& m) const
+	void Matrix::DotBiasActivate(Matrix& out, Matrix* preActivation, const Matrix& input, const Matrix& weights, const Matrix& bias, Function function)
 	{
-		Matrix result = *this;
-		if (getWidth() == m.getWidth() && getHeight()==m.getHeight())
+		Matrix& z = preActivation ? *preActivation : out;
+		Gemm(z, input, false, weights, false);
+		if (bias.getWidth() != z.getWidth() || bias.getHeight() != 1)
 		{
-			for (int h = 0; h < m_height; h++)
-			{
-				for (int w = 0; w < m_width; w++)
-				{
-					result[h][w] += m[h][w];
-				}
-			}
+			EchoLogError("Matrix dot bias activate failed, bias should be a single row");
+			return;
 		}
-		else
+
+		out.resize(z.getHeight(), z.getWidth());
+		const double* b = bias.data();
+		for (int h = 0; h < z.getHeight(); h++)
 		{
-			EchoLogError("Matrix add failed");
+			double* zRow = z[h];
+			double* outRow = out[h];
+			for (int w = 0; w < z.getWidth(); w++)
+			{
+				zRow[w] += b[w];
+				outRow[w] = function ? static_cast<double>((*function)(Real(zRow[w]))) : zRow[w];
+			}
 		}
-
-		return result;
 	}
 
-	Matrix Matrix::substract(const Matrix& m) const
+	void Matrix::Transpose(Matrix& out, const Matrix& m)
 	{
-		Matrix result = *this;
-		if (getWidth() == m.getWidth() && getHeight() == m.getHeight())
+		out.resize(m.getWidth(), m.getHeight());
+
+		// tiles keep both reads and writes in cache
+		const int tile = 32;
+		for (int i0 = 0; i0 < m.getHeight(); i0 += tile)
 		{
-			for (int h = 0; h < m_height; h++)
+			for (int j0 = 0; j0 < m.getWidth(); j0 += tile)
 			{
-				for (int w = 0; w < m_width; w++)
+				for (int i = i0; i < std::min(i0 + tile, m.getHeight()); i++)
 				{
-					result[h][w] -= m[h][w];
+					for (int j = j0; j < std::min(j0 + tile, m.getWidth()); j++)
+						out[j][i] = m[i][j];
 				}
 			}
 		}
+	}
+
+	void Matrix::SumRows(Matrix& out, const Matrix& m)
+	{
+		out.resize(1, m.getWidth());
+		out.fill(0.0);
+		for (int h = 0; h < m.getHeight(); h++)
+			axpyRow(out.data(), m[h], 1.0, m.getWidth());
+	}
+
+	Matrix Matrix::dot(const Matrix& m) const
+	{
+		Matrix result(getHeight(), m.getWidth());
+		if (getWidth() == m.getHeight())
+		{
+			Gemm(result, *this, false, m, false);
+		}
 		else
 		{
-			EchoLogError("Matrix substract failed");
+			EchoLogError("Matrix dot failed");
 		}
 
 		return result;
 	}
 
-	Matrix Matrix::multiply(Real f) const
+	void Matrix::addInPlace(const Matrix& m)
 	{
-		Matrix result = *this;
-		for (int h = 0; h < m_height; h++)
+		addScaled(1.f, m);
+	}
+
+	void Matrix::substractInPlace(const Matrix& m)
+	{
+		addScaled(-1.f, m);
+	}
+
+	void Matrix::addScaled(Real f, const Matrix& m)
+	{
+		if (getWidth() == m.getWidth() && getHeight() == m.getHeight())
 		{
-			for (int w = 0; w < m_width; w++)
-			{
-				result[h][w] *= f;
-			}
+			axpyRow(data(), m.data(), f, getNumberElements());
+		}
+		else
+		{
+			EchoLogError("Matrix add failed");
 		}
-
-		return result;
 	}
 
-	Matrix Matrix::multiply(const Matrix& m) const
+	void Matrix::multiplyInPlace(const Matrix& m)
 	{
-		Matrix result = *this;
 		if (getWidth() == m.getWidth() && getHeight() == m.getHeight())
 		{
-			for (int h = 0; h < m_height; h++)
-			{
-				for (int w = 0; w < m_width; w++)
-				{
-					result[h][w] *= m[h][w];
-				}
-			}
+			for (size_t i = 0; i < m_data.size(); i++)
+				m_data[i] *= m.m_data[i];
 		}
 		else
 		{
 			EchoLogError("Matrix multiply failed");
 		}
+	}
+
+	void Matrix::multiplyInPlace(Real f)
+	{
+		for (double& value : m_data)
+			value *= f;
+	}
 
+	Matrix Matrix::add(const Matrix& m) const
+	{
+		Matrix result = *this;
+		result.addInPlace(m);
 		return result;
 	}
 
-	Matrix Matrix::transpose() const
+	Matrix Matrix::substract(const Matrix& m) const
 	{
-		Matrix result(m_width, m_height);
-		for (int i = 0; i < m_width; i++)
-		{
-			for (int j = 0; j < m_height; j++)
-			{
-				result[i][j] = m_array[j][i];
-			}
-		}
+		Matrix result = *this;
+		result.substractInPlace(m);
+		return result;
+	}
 
+	Matrix Matrix::multiply(Real f) const
+	{
+		Matrix result = *this;
+		result.multiplyInPlace(f);
+		return result;
+	}
+
+	Matrix Matrix::multiply(const Matrix& m) const
+	{
+		Matrix result = *this;
+		result.multiplyInPlace(m);
+		return result;
+	}
+
+	Matrix Matrix::transpose() const
+	{
+		Matrix result;
+		Transpose(result, *this);
 		return result;
 	}
 
 	// apply function
-	Matrix Matrix::applyFunction(Real(*function)(Real)) const
+	Matrix Matrix::applyFunction(Function function) const
+	{
+		Matrix result = *this;
+		result.applyFunctionInPlace(function);
+		return result;
+	}
+
+	void Matrix::applyFunctionInPlace(Function function)
 	{
-		Matrix result(m_height, m_width);
 		if (function)
 		{
-			for (int h = 0; h < m_height; h++)
-			{
-				for (int w = 0; w < m_width; w++)
-				{
-					result[h][w] = static_cast<double>((*function)(m_array[h][w]));
-				}
-			}
+			for (double& value : m_data)
+				value = static_cast<double>((*function)(Real(value)));
 		}
 		else
 		{
 			EchoLogError("Matrix apply function error, function is null");
 		}
-
-		return result;
 	}
-}
\ No newline at end of file
+}
@@ -6,8 +6,12 @@
 
 namespace Echo
 {
+	// dense row-major matrix, all elements live in one contiguous block
 	class Matrix
 	{
+	public:
+		typedef Real(*Function)(Real);
+
 	public:
 		Matrix();
 		Matrix(int height, int width);
@@ -19,6 +23,16 @@ namespace Echo
 		int getHeight() const { return m_height; }
 		int getNumberElements() const { return m_width * m_height; }
 
+		// resize, old content is not kept. memory is reused when possible
+		void resize(int height, int width);
+
+		// set all elements
+		void fill(double value);
+
+		// raw data
+		double* data() { return m_data.data(); }
+		const double* data() const { return m_data.data(); }
+
 		Matrix dot(const Matrix& m) const;
 		Matrix add(const Matrix& m) const;
 		Matrix substract(const Matrix& m) const;
@@ -26,19 +40,43 @@ namespace Echo
 		Matrix multiply(Real f) const;
 		Matrix transpose() const;
 
-		// operator []
-		RealVector& operator[] (int idx) { return m_array[idx]; }
-		const RealVector& operator[] (int idx) const { return m_array[idx]; }
+		// in place versions
+		void addInPlace(const Matrix& m);
+		void substractInPlace(const Matrix& m);
+		void multiplyInPlace(const Matrix& m);
+		void multiplyInPlace(Real f);
+
+		// this += f * m
+		void addScaled(Real f, const Matrix& m);
+
+		// operator [], returns the row
+		double* operator[] (int idx) { return m_data.data() + idx * m_width; }
+		const double* operator[] (int idx) const { return m_data.data() + idx * m_width; }
 
 		// apply function
-		Matrix applyFunction(Real(*function)(Real)) const;
+		Matrix applyFunction(Function function) const;
+		void applyFunctionInPlace(Function function);
 
 		// reset
 		void reset();
 
+	public:
+		// out = alpha * op(a) * op(b) + beta * out, op transposes when requested. out can't be a or b
+		static void Gemm(Matrix& out, const Matrix& a, bool transposeA, const Matrix& b, bool transposeB, double alpha = 1.0, double beta = 0.0);
+
+		// out = function(input * weights + bias), bias is a single row added to every row.
+		// preActivation receives (input * weights + bias) when not null
+		static void DotBiasActivate(Matrix& out, Matrix* preActivation, const Matrix& input, const Matrix& weights, const Matrix& bias, Function function);
+
+		// out = m^T
+		static void Transpose(Matrix& out, const Matrix& m);
+
+		// out is a single row, the sum of all rows in m
+		static void SumRows(Matrix& out, const Matrix& m);
+
 	private:
-		int						 m_height;
-		int						 m_width;
-		vector<RealVector>::type m_array;
+		int						m_height;
+		int						m_width;
+		vector<double>::type	m_data;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,75 @@
+#include "BuddyAllocator.h"
+#include <algorithm>
+
+namespace Echo
+{
+	const ui32 BuddyAllocator::InvalidOffset;
+
+	BuddyAllocator::BuddyAllocator(ui32 size, ui32 minBlockSize)
+		: m_size(size)
+		, m_minBlockSize(std::min<ui32>(minBlockSize, size))
+	{
+		ui32 levelCount = 1;
+		while (getBlockSize(levelCount - 1) > m_minBlockSize)
+			levelCount++;
+
+		m_freeBlocks.resize(levelCount);
+		m_freeBlocks[0].insert(0);
+		m_allocatedLevels.resize(m_size / m_minBlockSize, 0);
+	}
+
+	ui32 BuddyAllocator::allocate(ui32 size, ui32 alignment)
+	{
+		ui32 blockSize = std::max<ui32>(std::max<ui32>(size, alignment), m_minBlockSize);
+		if (!size || blockSize > m_size)
+			return InvalidOffset;
+
+		// deepest level whose blocks still fit
+		ui32 level = ui32(m_freeBlocks.size()) - 1;
+		while (getBlockSize(level) < blockSize)
+			level--;
+
+		// smallest free block that can be split down to it
+		i32 freeLevel = level;
+		while (freeLevel >= 0 && m_freeBlocks[freeLevel].empty())
+			freeLevel--;
+
+		if (freeLevel < 0)
+			return InvalidOffset;
+
+		ui32 offset = *m_freeBlocks[freeLevel].begin();
+		m_freeBlocks[freeLevel].erase(m_freeBlocks[freeLevel].begin());
+		for (ui32 i = freeLevel + 1; i <= level; i++)
+			m_freeBlocks[i].insert(offset + getBlockSize(i));
+
+		m_allocatedLevels[offset / m_minBlockSize] = ui8(level + 1);
+		m_usedSize += getBlockSize(level);
+
+		return offset;
+	}
+
+	void BuddyAllocator::free(ui32 offset)
+	{
+		ui8& allocatedLevel = m_allocatedLevels[offset / m_minBlockSize];
+		if (!allocatedLevel)
+			return;
+
+		ui32 level = allocatedLevel - 1;
+		allocatedLevel = 0;
+		m_usedSize -= getBlockSize(level);
+
+		while (level > 0)
+		{
+			ui32 buddy = offset ^ getBlockSize(level);
+			auto it = m_freeBlocks[level].find(buddy);
+			if (it == m_freeBlocks[level].end())
+				break;
+
+			m_freeBlocks[level].erase(it);
+			offset = std::min<ui32>(offset, buddy);
+			level--;
+		}
+
+		m_freeBlocks[level].insert(offset);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "MemAllocDef.h"
+
+namespace Echo
+{
+	// buddy allocator of offsets inside a range it doesn't own, used to sub allocate gpu memory
+	// blocks. sizes round up to powers of two, so every offset is aligned to its block size
+	class BuddyAllocator
+	{
+	public:
+		static const ui32 InvalidOffset = 0xffffffff;
+
+	public:
+		// size and minBlockSize are powers of two
+		BuddyAllocator(ui32 size, ui32 minBlockSize);
+
+		// offset of a block of at least size bytes, InvalidOffset when there is no room
+		ui32 allocate(ui32 size, ui32 alignment = 1);
+
+		// release a block, merging it with its free buddies
+		void free(ui32 offset);
+
+		// size
+		ui32 getSize() const { return m_size; }
+		ui32 getUsedSize() const { return m_usedSize; }
+		bool isEmpty() const { return m_usedSize == 0; }
+
+	private:
+		// block size of level, level 0 is the whole range
+		ui32 getBlockSize(ui32 level) const { return m_size >> level; }
+
+	private:
+		ui32						m_size;
+		ui32						m_minBlockSize;
+		ui32						m_usedSize = 0;
+		vector<set<ui32>::type>::type m_freeBlocks;		// free offsets per level
+		vector<ui8>::type			m_allocatedLevels;	// level + 1 of the block starting at each min block, 0 if none
+	};
+}
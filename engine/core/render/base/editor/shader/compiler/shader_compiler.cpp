@@ -1,5 +1,6 @@
 #include "shader_compiler.h"
 #include "engine/core/render/base/glslcc/glsl_cross_compiler.h"
+#include "engine/core/render/base/renderer.h"
 
 #ifdef ECHO_EDITOR_MODE
 
@@ -11,12 +12,25 @@ ${VS_MACROS}
 layout(binding = 0) uniform UBO
 {
 	mat4 u_WorldMatrix;
+	mat4 u_NormalMatrix;
 	mat4 u_ViewProjMatrix;
 } vs_ubo;
 
 // inputs
 layout(location = 0) in vec3 a_Position;
 
+#ifdef INSTANCING
+layout(location = INSTANCE_WORLD) in mat4 a_InstanceWorld;
+layout(location = INSTANCE_NORMAL) in mat4 a_InstanceNormal;
+layout(location = INSTANCE_COLOR) in vec4 a_InstanceColor;
+layout(location = 10) out vec4 v_InstanceColor;
+#define WORLD_MATRIX a_InstanceWorld
+#define NORMAL_MATRIX a_InstanceNormal
+#else
+#define WORLD_MATRIX vs_ubo.u_WorldMatrix
+#define NORMAL_MATRIX vs_ubo.u_NormalMatrix
+#endif
+
 #ifdef ENABLE_VERTEX_POSITION
 struct Position
 {
@@ -28,17 +42,36 @@ layout(location = 0) out Position v_Position;
 #endif
 
 #ifdef ENABLE_VERTEX_NORMAL
+#ifdef OCT_NORMALS
+layout(location = 1) in vec2 a_Normal;
+#else
 layout(location = 1) in vec3 a_Normal;
+#endif
 layout(location = 3) out vec3 v_Normal;
 layout(location = 4) out vec3 v_NormalLocal;
 
 #ifdef HAS_TANGENTS
+	#ifdef OCT_NORMALS
+	layout(location = 2) in vec2 a_Tangent;
+	#else
 	layout(location = 2) in vec4 a_Tangent;
+	#endif
 	layout(location = 5) out mat3 v_TBN;
 #endif
 
 #endif
 
+#ifdef OCT_NORMALS
+// octahedral 2x16 snorm to unit vector
+vec3 OctDecode(vec2 oct)
+{
+	vec3 dir = vec3(oct.xy, 1.0 - abs(oct.x) - abs(oct.y));
+	float t = max(-dir.z, 0.0);
+	dir.xy += vec2(dir.x >= 0.0 ? -t : t, dir.y >= 0.0 ? -t : t);
+	return normalize(dir);
+}
+#endif
+
 #ifdef ENABLE_VERTEX_COLOR
 layout(location = 3) in vec4 a_Color;
 layout(location = 6) out vec4 v_Color;
@@ -71,7 +104,7 @@ void main(void)
 	 //     \/                                      -- handled by GPU / driver
 	 // screen space  [   0,    0] to [   W,    H] /
 
-	vec4 worldPosition = vs_ubo.u_WorldMatrix * vec4(a_Position, 1.0);
+	vec4 worldPosition = WORLD_MATRIX * vec4(a_Position, 1.0);
     vec4 clipPosition = vs_ubo.u_ViewProjMatrix * worldPosition;
 
 #ifdef ENABLE_VERTEX_POSITION
@@ -83,17 +116,29 @@ void main(void)
 	gl_Position = clipPosition;
 
 #ifdef ENABLE_VERTEX_NORMAL
+	#ifdef OCT_NORMALS
+		vec3 normalL = OctDecode(a_Normal);
+	#else
+		vec3 normalL = a_Normal.xyz;
+	#endif
+
 	#ifdef HAS_TANGENTS
-		vec3 normalW = normalize(vec3(vs_ubo.u_WorldMatrix * vec4(a_Normal.xyz, 0.0)));
-		vec3 tangentW = normalize(vec3(vs_ubo.u_WorldMatrix * vec4(a_Tangent.xyz, 0.0)));
-		vec3 bitangentW = cross(normalW, tangentW) * a_Tangent.w;
+		#ifdef OCT_NORMALS
+			vec4 tangentL = vec4(OctDecode(a_Tangent), 1.0);
+		#else
+			vec4 tangentL = a_Tangent;
+		#endif
+
+		vec3 normalW = normalize(vec3(NORMAL_MATRIX * vec4(normalL, 0.0)));
+		vec3 tangentW = normalize(vec3(WORLD_MATRIX * vec4(tangentL.xyz, 0.0)));
+		vec3 bitangentW = cross(normalW, tangentW) * tangentL.w;
 		v_Normal = normalW;
 		v_TBN = mat3(tangentW, bitangentW, normalW);
 	#else // HAS_TANGENTS != 1
-		v_Normal = normalize(vec3(vs_ubo.u_WorldMatrix * vec4(a_Normal.xyz, 0.0)));
+		v_Normal = normalize(vec3(NORMAL_MATRIX * vec4(normalL, 0.0)));
 	#endif
 
-	v_NormalLocal = a_Normal;
+	v_NormalLocal = normalL;
 #endif
 
 #ifdef ENABLE_VERTEX_COLOR
@@ -109,6 +154,10 @@ void main(void)
 	v_Joint = a_Joint;
 #endif
 
+#ifdef INSTANCING
+	v_InstanceColor = a_InstanceColor;
+#endif
+
 }
 )";
 
@@ -156,6 +205,10 @@ layout(location = 8) in vec4 v_Weight;
 layout(location = 9) in vec4 v_Joint;
 #endif
 
+#ifdef INSTANCING
+layout(location = 10) in vec4 v_InstanceColor;
+#endif
+
 // outputs
 layout(location = 0) out vec4 o_FragColor;
 
@@ -347,6 +400,10 @@ ${FS_SHADER_CODE}
 	float __PerceptualRoughness = 0.5;
 #endif
 
+#ifdef INSTANCING
+	__BaseColor *= v_InstanceColor.rgb;
+#endif
+
 #ifdef ENABLE_LIGHTING_CALCULATION
 	__BaseColor = PbrLighting(v_Position.world, __BaseColor, __Normal, __Metalic, __PerceptualRoughness, fs_ubo.u_CameraPosition);
 #endif
@@ -394,6 +451,10 @@ namespace Echo
 			m_fsUniformsCode = "layout(binding = 0) uniform UBO \n{\n" + m_fsUniformsCode + "} fs_ubo;";
 		}
 
+		// the output has no preprocessor left, instancing is decided for the editor's renderer
+		if (Echo::Renderer::instance() && Echo::Renderer::instance()->isInstancingSupported())
+			addMacro("INSTANCING");
+
 		Echo::String vsCode = g_VsTemplate;
 		vsCode = Echo::StringUtil::Replace(vsCode, "${VS_MACROS}", m_macros.c_str());
 		vsCode = Echo::StringUtil::Replace(vsCode, "\t", "    ");
@@ -475,4 +536,4 @@ namespace Echo
 		m_fsCode += codeChunk;
 	}
 }
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
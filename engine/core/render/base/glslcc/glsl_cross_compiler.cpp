@@ -231,8 +231,9 @@ namespace Echo
     {
 		if (m_isNeedUpdateSpriv)
 		{
-			// initialize process (wrong place)
-			glslang::InitializeProcess();
+			// initialize once, finalizing after every compile threw the built-in symbol tables away
+			static bool isProcessInitialized = glslang::InitializeProcess();
+			(void)isProcessInitialized;
 
 			// create shader program
 			glslang::TProgram* prog = EchoNew(glslang::TProgram);
@@ -305,10 +306,7 @@ namespace Echo
 			}
 
 			// deallocate program
-			EchoSafeDelete(prog, TProgram);;
-
-			// finalize process (wrong place)
-			glslang::FinalizeProcess();
+			EchoSafeDelete(prog, TProgram);
 
 			m_isNeedUpdateSpriv = false;
 		}
@@ -416,34 +414,42 @@ namespace Echo
 
 	const char* GLSLCrossCompiler::getPreamble()
 	{
-		static std::string preambles;
-		preambles += "#extension GL_GOOGLE_include_directive : require\n";
-		preambles += "#define POSITION 0\n";
-		preambles += "#define NORMAL 1\n";
-		preambles += "#define TEXCOORD0 2\n";
-		preambles += "#define TEXCOORD1 3\n";
-		preambles += "#define TEXCOORD2 4\n";
-		preambles += "#define TEXCOORD3 5\n";
-		preambles += "#define TEXCOORD4 6\n";
-		preambles += "#define TEXCOORD5 7\n";
-		preambles += "#define TEXCOORD6 8\n";
-		preambles += "#define TEXCOORD7 9\n";
-		preambles += "#define COLOR0 10\n";
-		preambles += "#define COLOR1 11\n";
-		preambles += "#define COLOR2 12\n";
-		preambles += "#define COLOR3 13\n";
-		preambles += "#define TANGENT 14\n";
-		preambles += "#define BINORMAL 15\n";
-		preambles += "#define BLENDINDICES 16\n";
-		preambles += "#define BLENDWEIGHT 17\n";
-		preambles += "#define SV_Target0 0\n";
-		preambles += "#define SV_Target1 1\n";
-		preambles += "#define SV_Target2 2\n";
-		preambles += "#define SV_Target3 3\n";
-		preambles += "#define SV_Target4 4\n";
-		preambles += "#define SV_Target5 5\n";
-		preambles += "#define SV_Target6 6\n";
-		preambles += "#define SV_Target7 7\n";
+		// built once, compilers on worker threads share it
+		static const std::string preambles = []()
+		{
+			std::string preambles;
+			preambles += "#extension GL_GOOGLE_include_directive : require\n";
+			preambles += "#define POSITION 0\n";
+			preambles += "#define NORMAL 1\n";
+			preambles += "#define TEXCOORD0 2\n";
+			preambles += "#define TEXCOORD1 3\n";
+			preambles += "#define TEXCOORD2 4\n";
+			preambles += "#define TEXCOORD3 5\n";
+			preambles += "#define TEXCOORD4 6\n";
+			preambles += "#define TEXCOORD5 7\n";
+			preambles += "#define TEXCOORD6 8\n";
+			preambles += "#define TEXCOORD7 9\n";
+			preambles += "#define COLOR0 10\n";
+			preambles += "#define COLOR1 11\n";
+			preambles += "#define COLOR2 12\n";
+			preambles += "#define COLOR3 13\n";
+			preambles += "#define TANGENT 14\n";
+			preambles += "#define BINORMAL 15\n";
+			preambles += "#define BLENDINDICES 16\n";
+			preambles += "#define BLENDWEIGHT 17\n";
+			preambles += "#define INSTANCE_WORLD 18\n";
+			preambles += "#define INSTANCE_COLOR 22\n";
+			preambles += "#define INSTANCE_NORMAL 23\n";
+			preambles += "#define SV_Target0 0\n";
+			preambles += "#define SV_Target1 1\n";
+			preambles += "#define SV_Target2 2\n";
+			preambles += "#define SV_Target3 3\n";
+			preambles += "#define SV_Target4 4\n";
+			preambles += "#define SV_Target5 5\n";
+			preambles += "#define SV_Target6 6\n";
+			preambles += "#define SV_Target7 7\n";
+			return preambles;
+		}();
 
 		return preambles.c_str();
 	}
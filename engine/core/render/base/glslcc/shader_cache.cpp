@@ -0,0 +1,137 @@
+#include "shader_cache.h"
+#include "engine/core/io/IO.h"
+#include "engine/core/log/Log.h"
+
+namespace Echo
+{
+    static const ui32 g_magic = 0x43485345; // "ESHC"
+
+    // fnv-1a
+    static ui64 hash(const void* data, size_t size, ui64 value)
+    {
+        const Byte* bytes = static_cast<const Byte*>(data);
+        for (size_t i = 0; i < size; i++)
+            value = (value ^ bytes[i]) * 0x100000001b3ull;
+
+        return value;
+    }
+
+    ShaderCache* ShaderCache::instance()
+    {
+        static ShaderCache* inst = EchoNew(ShaderCache);
+        return inst;
+    }
+
+    bool ShaderCache::get(const String& vs, const String& fs, Target target, Entry& entry)
+    {
+        String file = getFile(vs, fs, target);
+        if (load(file, vs, fs, target, entry))
+            return true;
+
+        if (compile(vs, fs, target, entry))
+        {
+            save(file, vs, fs, target, entry);
+            return true;
+        }
+
+        return false;
+    }
+
+    String ShaderCache::getFile(const String& vs, const String& fs, Target target)
+    {
+        ui32 header[] = { Version, ui32(target), ui32(vs.size()), ui32(fs.size()) };
+
+        ui64 value = hash(header, sizeof(header), 0xcbf29ce484222325ull);
+        value = hash(vs.data(), vs.size(), value);
+        value = hash(fs.data(), fs.size(), value);
+
+        return StringUtil::Format("User://shader_cache/%08x%08x.bin", ui32(value >> 32), ui32(value));
+    }
+
+    bool ShaderCache::compile(const String& vs, const String& fs, Target target, Entry& entry)
+    {
+        GLSLCrossCompiler compiler;
+        compiler.setInput(vs.c_str(), fs.c_str(), nullptr);
+
+        static const GLSLCrossCompiler::ShaderLanguage languages[] = { GLSLCrossCompiler::GLES, GLSLCrossCompiler::GLES, GLSLCrossCompiler::GLSL, GLSLCrossCompiler::MSL };
+        for (int i = GLSLCrossCompiler::VS; i <= GLSLCrossCompiler::FS; i++)
+        {
+            GLSLCrossCompiler::ShaderType type = GLSLCrossCompiler::ShaderType(i);
+            entry.m_spirv[i] = compiler.getSPIRV(type);
+            if (entry.m_spirv[i].empty())
+                return false;
+
+            if (target != SPIRV)
+                entry.m_output[i] = compiler.getOutput(languages[target], type);
+        }
+
+        return true;
+    }
+
+    bool ShaderCache::load(const String& file, const String& vs, const String& fs, Target target, Entry& entry)
+    {
+        if (!IO::instance()->isExist(file))
+            return false;
+
+        MemoryReader reader(file);
+        const ui32* words = reader.getData<const ui32*>();
+        size_t count = reader.getSize() / sizeof(ui32);
+        size_t pos = 5;
+
+        // a hash collision still has to match the source sizes
+        if (count < pos || words[0] != g_magic || words[1] != Version || words[2] != ui32(target) || words[3] != vs.size() || words[4] != fs.size())
+            return false;
+
+        for (int i = GLSLCrossCompiler::VS; i <= GLSLCrossCompiler::FS; i++)
+        {
+            if (pos + 2 > count)
+                return false;
+
+            size_t spirvSize = words[pos++];
+            if (pos + spirvSize + 1 > count)
+                return false;
+
+            entry.m_spirv[i].assign(words + pos, words + pos + spirvSize);
+            pos += spirvSize;
+
+            size_t outputSize = words[pos++];
+            if (pos + (outputSize + 3) / 4 > count)
+                return false;
+
+            entry.m_output[i].assign(reinterpret_cast<const char*>(words + pos), outputSize);
+            pos += (outputSize + 3) / 4;
+        }
+
+        return true;
+    }
+
+    void ShaderCache::save(const String& file, const String& vs, const String& fs, Target target, const Entry& entry)
+    {
+        vector<ui32>::type words = { g_magic, Version, ui32(target), ui32(vs.size()), ui32(fs.size()) };
+        for (int i = GLSLCrossCompiler::VS; i <= GLSLCrossCompiler::FS; i++)
+        {
+            words.push_back(ui32(entry.m_spirv[i].size()));
+            words.insert(words.end(), entry.m_spirv[i].begin(), entry.m_spirv[i].end());
+
+            // output padded to whole words
+            const String& output = entry.m_output[i];
+            size_t pos = words.size();
+            words.push_back(ui32(output.size()));
+            words.resize(pos + 1 + (output.size() + 3) / 4, 0);
+            std::memcpy(words.data() + pos + 1, output.data(), output.size());
+        }
+
+        DataStream* stream = IO::instance()->open(file, DataStream::WRITE);
+        if (stream && stream->isWriteable())
+        {
+            stream->write(words.data(), words.size() * sizeof(ui32));
+            stream->close();
+        }
+        else
+        {
+            EchoLogWarning("shader cache [%s] can't be written", file.c_str());
+        }
+
+        EchoSafeDelete(stream, DataStream);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "glsl_cross_compiler.h"
+
+namespace Echo
+{
+    /**
+     * Compiled shaders kept in the user directory, keyed by a hash of the final sources (macros
+     * already inserted), the target and the compiler version. A permutation that was built once
+     * skips glslang and spirv-cross in every later run
+     */
+    class ShaderCache
+    {
+    public:
+        // bump when compiler options or the glslang|spirv-cross versions change
+        static const ui32 Version = 4;
+
+        // what the sources are compiled to
+        enum Target
+        {
+            SPIRV = 0,  // vulkan
+            GLES,
+            GLSL,
+            MSL,
+        };
+
+        // compiled permutation
+        struct Entry
+        {
+            vector<ui32>::type  m_spirv[GLSLCrossCompiler::Total];
+            String              m_output[GLSLCrossCompiler::Total];    // empty for SPIRV
+        };
+
+    public:
+        // instance
+        static ShaderCache* instance();
+
+        // load a compiled permutation, compiling and storing it on a miss
+        bool get(const String& vs, const String& fs, Target target, Entry& entry);
+
+    private:
+        ShaderCache() {}
+
+        // cache file of a permutation
+        static String getFile(const String& vs, const String& fs, Target target);
+
+        // compile
+        static bool compile(const String& vs, const String& fs, Target target, Entry& entry);
+
+        // load|save
+        static bool load(const String& file, const String& vs, const String& fs, Target target, Entry& entry);
+        static void save(const String& file, const String& vs, const String& fs, Target target, const Entry& entry);
+    };
+}
@@ -5,6 +5,7 @@
 #include <engine/core/io/stream/MemoryDataStream.h>
 #include "image.h"
 #include "image_resampler.h"
+#include "pixel_kernels.h"
 #include "image_codec.h"
 #include "image_codec_mgr.h"
 #include <thirdparty/FreeImage/FreeImage.h>
@@ -578,7 +579,12 @@ namespace Echo
 						case 1: LinearResamplerByte<1>::Scale(src, temp); break;
 						case 2: LinearResamplerByte<2>::Scale(src, temp); break;
 						case 3: LinearResamplerByte<3>::Scale(src, temp); break;
-						case 4: LinearResamplerByte<4>::Scale(src, temp); break;
+						case 4:
+							{
+								if (!ScaleByKernels(src, temp))
+									LinearResamplerByte<4>::Scale(src, temp);
+							}
+							break;
 						default:
 							{
 								// never reached
@@ -611,6 +617,34 @@ namespace Echo
 		return true;
 	}
 
+	bool Image::ScaleByKernels(const PixelBox &src, const PixelBox &dst)
+	{
+		bool isUnsignedByte4 = src.pixFmt == PF_RGBA8_UNORM || src.pixFmt == PF_RGBA8_UINT || src.pixFmt == PF_BGRA8_UNORM;
+		if (!isUnsignedByte4 || src.pixFmt != dst.pixFmt || src.pData == dst.pData || src.getDepth() != 1 || dst.getDepth() != 1 || !src.isConsecutive() || !dst.isConsecutive())
+			return false;
+
+		const Byte* srcptr = static_cast<const Byte*>(src.pData) + (src.left + src.top * src.rowPitch) * 4;
+		Byte* dstptr = static_cast<Byte*>(dst.pData) + (dst.left + dst.top * dst.rowPitch) * 4;
+		ui32 srcWidth = src.getWidth();
+		ui32 srcHeight = src.getHeight();
+		ui32 dstWidth = dst.getWidth();
+		ui32 dstHeight = dst.getHeight();
+
+		// exact half size is a mip step, use the 2x2 box filter
+		if (dstWidth == std::max<ui32>(srcWidth / 2, 1) && dstHeight == std::max<ui32>(srcHeight / 2, 1) && (srcWidth > 1 || srcHeight > 1))
+			PixelKernels::mipReduce(srcptr, srcWidth, srcHeight, dstptr);
+		else
+			PixelKernels::bilinearScale(srcptr, srcWidth, srcHeight, dstptr, dstWidth, dstHeight);
+
+		return true;
+	}
+
+	void Image::premultiplyAlpha()
+	{
+		if (m_data && (m_format == PF_RGBA8_UNORM || m_format == PF_BGRA8_UNORM))
+			PixelKernels::premultiplyAlpha(m_data, m_data, m_width * m_height * m_depth);
+	}
+
 	Byte* Image::getData() const
 	{
 		return m_data;
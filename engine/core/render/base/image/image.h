@@ -89,6 +89,9 @@ namespace Echo
 		// convert format
 		bool convertFormat(PixelFormat targetFormat);
 
+		// rgb *= alpha (rgba8|bgra8 only)
+		void premultiplyAlpha();
+
 		static String getImageFormatExt(ImageFormat imgFmt);
 		static ImageFormat GetImageFormat(const String &filename);
 		static ImageFormat GetImageFormatByExt(const String &imgExt);
@@ -105,6 +108,10 @@ namespace Echo
 		*/
 		static bool	Scale(const PixelBox &src, const PixelBox &dst, ImageFilter filter = IMGFILTER_BILINEAR);
 
+	private:
+		// simd path of bilinear scale for consecutive 2d rgba8 boxes
+		static bool ScaleByKernels(const PixelBox &src, const PixelBox &dst);
+
 	public:
 		// Get sub atla
 		Image* getAtla(ui32 face, ui32 mipmap, ui32 left, ui32 top, ui32 width, ui32 height);
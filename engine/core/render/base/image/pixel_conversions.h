@@ -2,6 +2,7 @@
 
 #include <engine/core/base/echo_def.h>
 #include "pixel_util.h"
+#include "pixel_kernels.h"
 
 namespace Echo
 {
@@ -264,8 +265,38 @@ namespace Echo
 
 #define CASECONVERTER(type) case type::ID : PixelBoxConverter<type>::Conversion(src, dst); return true;
 
+	// consecutive rgba8 boxes go through the simd kernels
+	inline bool DoKernelConversion(const PixelBox &src, const PixelBox &dst)
+	{
+		if (!src.isConsecutive() || !dst.isConsecutive())
+			return false;
+
+		const ui32 count = src.getWidth() * src.getHeight() * src.getDepth();
+		const Byte* srcptr = static_cast<const Byte*>(src.pData) + (src.left + src.top * src.rowPitch + src.front * src.slicePitch) * PixelUtil::GetPixelSize(src.pixFmt);
+		Byte* dstptr = static_cast<Byte*>(dst.pData) + (dst.left + dst.top * dst.rowPitch + dst.front * dst.slicePitch) * PixelUtil::GetPixelSize(dst.pixFmt);
+		switch (FMTCONVERTERID(src.pixFmt, dst.pixFmt))
+		{
+		case RGBA8UNORM_TO_BGRA8UNORM::ID:
+		case BGRA8UNORM_TO_RGBA8UNORM::ID:
+			PixelKernels::swizzleRB(srcptr, dstptr, count);
+			return true;
+		case FMTCONVERTERID(PF_RGBA8_UNORM, PF_RGB8_UNORM):
+		case FMTCONVERTERID(PF_BGRA8_UNORM, PF_BGR8_UNORM):
+			PixelKernels::rgba8ToRgb8(srcptr, dstptr, count);
+			return true;
+		case FMTCONVERTERID(PF_RGBA8_UNORM, PF_RGBA32_FLOAT):
+			PixelKernels::rgba8ToFloat(srcptr, reinterpret_cast<float*>(dstptr), count);
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	inline bool DoOptimizedConversion(const PixelBox &src, const PixelBox &dst)
 	{;
+	if (DoKernelConversion(src, dst))
+		return true;
+
 	switch(FMTCONVERTERID(src.pixFmt, dst.pixFmt))
 	{
 		// Register converters here
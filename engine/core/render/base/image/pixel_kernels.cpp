@@ -0,0 +1,669 @@
+#include "pixel_kernels.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define ECHO_PIXEL_KERNELS_X86
+	#include <emmintrin.h>
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define ECHO_TARGET_SSE2
+		#define ECHO_TARGET_AVX2
+	#else
+		#define ECHO_TARGET_SSE2 __attribute__((target("sse2")))
+		#define ECHO_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define ECHO_PIXEL_KERNELS_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace Echo
+{
+	typedef void(*ConvertKernel)(const Byte* src, Byte* dst, ui32 count);
+	typedef void(*FloatKernel)(const Byte* src, float* dst, ui32 count);
+	typedef void(*MipReduceKernel)(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst);
+	typedef void(*ScaleKernel)(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst, ui32 dstWidth, ui32 dstHeight);
+
+	struct PixelKernelTable
+	{
+		PixelKernels::Isa	m_isa = PixelKernels::Isa::Scalar;
+		ConvertKernel		m_swizzleRB = nullptr;
+		ConvertKernel		m_rgba8ToRgb8 = nullptr;
+		FloatKernel			m_rgba8ToFloat = nullptr;
+		ConvertKernel		m_premultiplyAlpha = nullptr;
+		MipReduceKernel		m_mipReduce = nullptr;
+		ScaleKernel			m_bilinearScale = nullptr;
+	};
+
+	// bilinear weights use 7 bits, so every intermediate value fits a signed 16 bit lane
+	static const i32 BilinearShift = 7;
+	static const i32 BilinearOne = 1 << BilinearShift;
+	static const i32 BilinearHalf = BilinearOne >> 1;
+
+	struct BilinearCoord
+	{
+		ui32	m_p1;
+		ui32	m_p2;
+		i32		m_weight;
+	};
+
+	// pixel centers are aligned, the same way LinearResamplerByte does
+	static void buildBilinearCoords(ui32 srcSize, ui32 dstSize, vector<BilinearCoord>::type& coords)
+	{
+		coords.resize(dstSize);
+		for (ui32 i = 0; i < dstSize; i++)
+		{
+			i64 pos = i64((2 * ui64(i) + 1) * srcSize * BilinearOne / (2 * ui64(dstSize))) - BilinearHalf;
+			pos = std::max<i64>(pos, 0);
+			coords[i].m_p1 = std::min<ui32>(ui32(pos >> BilinearShift), srcSize - 1);
+			coords[i].m_p2 = std::min<ui32>(coords[i].m_p1 + 1, srcSize - 1);
+			coords[i].m_weight = i32(pos & (BilinearOne - 1));
+		}
+	}
+
+	static inline i32 bilinearLerp(i32 a, i32 b, i32 weight)
+	{
+		return a + (((b - a) * weight + BilinearHalf) >> BilinearShift);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// scalar
+
+	static void swizzleRBScalar(const Byte* src, Byte* dst, ui32 count)
+	{
+		for (ui32 i = 0; i < count; i++, src += 4, dst += 4)
+		{
+			Byte r = src[0];
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = r;
+			dst[3] = src[3];
+		}
+	}
+
+	static void rgba8ToRgb8Scalar(const Byte* src, Byte* dst, ui32 count)
+	{
+		for (ui32 i = 0; i < count; i++, src += 4, dst += 3)
+		{
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+		}
+	}
+
+	static void rgba8ToFloatScalar(const Byte* src, float* dst, ui32 count)
+	{
+		const float scale = 1.f / 255.f;
+		for (ui32 i = 0; i < count * 4; i++)
+			dst[i] = src[i] * scale;
+	}
+
+	static inline Byte premultiply(ui32 color, ui32 alpha)
+	{
+		ui32 t = color * alpha + 128;
+		return Byte((t + (t >> 8)) >> 8);
+	}
+
+	static void premultiplyAlphaScalar(const Byte* src, Byte* dst, ui32 count)
+	{
+		for (ui32 i = 0; i < count; i++, src += 4, dst += 4)
+		{
+			ui32 alpha = src[3];
+			dst[0] = premultiply(src[0], alpha);
+			dst[1] = premultiply(src[1], alpha);
+			dst[2] = premultiply(src[2], alpha);
+			dst[3] = Byte(alpha);
+		}
+	}
+
+	static void mipReduceRowScalar(const Byte* row0, const Byte* row1, ui32 srcWidth, Byte* dst, ui32 begin, ui32 end)
+	{
+		for (ui32 x = begin; x < end; x++)
+		{
+			ui32 x0 = std::min(x * 2, srcWidth - 1) * 4;
+			ui32 x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+			for (ui32 c = 0; c < 4; c++)
+				dst[x * 4 + c] = Byte((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+		}
+	}
+
+	static void mipReduceScalar(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst)
+	{
+		ui32 dstWidth = std::max<ui32>(srcWidth >> 1, 1);
+		ui32 dstHeight = std::max<ui32>(srcHeight >> 1, 1);
+		for (ui32 y = 0; y < dstHeight; y++)
+		{
+			const Byte* row0 = src + std::min(y * 2, srcHeight - 1) * srcWidth * 4;
+			const Byte* row1 = src + std::min(y * 2 + 1, srcHeight - 1) * srcWidth * 4;
+			mipReduceRowScalar(row0, row1, srcWidth, dst + y * dstWidth * 4, 0, dstWidth);
+		}
+	}
+
+	static void bilinearScaleScalar(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst, ui32 dstWidth, ui32 dstHeight)
+	{
+		vector<BilinearCoord>::type xCoords, yCoords;
+		buildBilinearCoords(srcWidth, dstWidth, xCoords);
+		buildBilinearCoords(srcHeight, dstHeight, yCoords);
+		for (ui32 y = 0; y < dstHeight; y++)
+		{
+			const Byte* row1 = src + yCoords[y].m_p1 * srcWidth * 4;
+			const Byte* row2 = src + yCoords[y].m_p2 * srcWidth * 4;
+			for (ui32 x = 0; x < dstWidth; x++, dst += 4)
+			{
+				const BilinearCoord& xc = xCoords[x];
+				for (ui32 c = 0; c < 4; c++)
+				{
+					i32 left = bilinearLerp(row1[xc.m_p1 * 4 + c], row2[xc.m_p1 * 4 + c], yCoords[y].m_weight);
+					i32 right = bilinearLerp(row1[xc.m_p2 * 4 + c], row2[xc.m_p2 * 4 + c], yCoords[y].m_weight);
+					dst[c] = Byte(bilinearLerp(left, right, xc.m_weight));
+				}
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// sse2 | avx2
+
+#ifdef ECHO_PIXEL_KERNELS_X86
+	ECHO_TARGET_SSE2 static void swizzleRBSSE2(const Byte* src, Byte* dst, ui32 count)
+	{
+		const __m128i maskGA = _mm_set1_epi32(0xFF00FF00);
+		const __m128i maskLow = _mm_set1_epi32(0x000000FF);
+		ui32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i px = _mm_loadu_si128((const __m128i*)(src + i * 4));
+			__m128i r = _mm_slli_epi32(_mm_and_si128(px, maskLow), 16);
+			__m128i b = _mm_and_si128(_mm_srli_epi32(px, 16), maskLow);
+			_mm_storeu_si128((__m128i*)(dst + i * 4), _mm_or_si128(_mm_and_si128(px, maskGA), _mm_or_si128(r, b)));
+		}
+
+		swizzleRBScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	ECHO_TARGET_SSE2 static void rgba8ToFloatSSE2(const Byte* src, float* dst, ui32 count)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 scale = _mm_set1_ps(1.f / 255.f);
+		ui32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i px = _mm_loadu_si128((const __m128i*)(src + i * 4));
+			__m128i lo = _mm_unpacklo_epi8(px, zero);
+			__m128i hi = _mm_unpackhi_epi8(px, zero);
+			_mm_storeu_ps(dst + i * 4 + 0,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+			_mm_storeu_ps(dst + i * 4 + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+			_mm_storeu_ps(dst + i * 4 + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+			_mm_storeu_ps(dst + i * 4 + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+		}
+
+		rgba8ToFloatScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	ECHO_TARGET_SSE2 static inline __m128i premultiplySSE2(__m128i px16, __m128i keepRGB, __m128i alphaOne)
+	{
+		__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		alpha = _mm_or_si128(_mm_and_si128(alpha, keepRGB), alphaOne);
+		__m128i t = _mm_add_epi16(_mm_mullo_epi16(px16, alpha), _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+	}
+
+	ECHO_TARGET_SSE2 static void premultiplyAlphaSSE2(const Byte* src, Byte* dst, ui32 count)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i keepRGB = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+		const __m128i alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+		ui32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i px = _mm_loadu_si128((const __m128i*)(src + i * 4));
+			__m128i lo = premultiplySSE2(_mm_unpacklo_epi8(px, zero), keepRGB, alphaOne);
+			__m128i hi = premultiplySSE2(_mm_unpackhi_epi8(px, zero), keepRGB, alphaOne);
+			_mm_storeu_si128((__m128i*)(dst + i * 4), _mm_packus_epi16(lo, hi));
+		}
+
+		premultiplyAlphaScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	ECHO_TARGET_SSE2 static void mipReduceSSE2(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst)
+	{
+		if (srcWidth < 2 || srcHeight < 2)
+		{
+			mipReduceScalar(src, srcWidth, srcHeight, dst);
+			return;
+		}
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i two = _mm_set1_epi16(2);
+		ui32 dstWidth = srcWidth >> 1;
+		ui32 dstHeight = srcHeight >> 1;
+		for (ui32 y = 0; y < dstHeight; y++)
+		{
+			const Byte* row0 = src + (y * 2) * srcWidth * 4;
+			const Byte* row1 = row0 + srcWidth * 4;
+			Byte* dstRow = dst + y * dstWidth * 4;
+
+			ui32 x = 0;
+			for (; x + 2 <= dstWidth; x += 2)
+			{
+				__m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+				__m128i b = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+				lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+				hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+				__m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+				_mm_storel_epi64((__m128i*)(dstRow + x * 4), _mm_packus_epi16(sum, sum));
+			}
+
+			mipReduceRowScalar(row0, row1, srcWidth, dstRow, x, dstWidth);
+		}
+	}
+
+	ECHO_TARGET_SSE2 static void bilinearScaleSSE2(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst, ui32 dstWidth, ui32 dstHeight)
+	{
+		vector<BilinearCoord>::type xCoords, yCoords;
+		buildBilinearCoords(srcWidth, dstWidth, xCoords);
+		buildBilinearCoords(srcHeight, dstHeight, yCoords);
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i half = _mm_set1_epi16(BilinearHalf);
+		const ui32* pixels = (const ui32*)src;
+		for (ui32 y = 0; y < dstHeight; y++)
+		{
+			const ui32* row1 = pixels + yCoords[y].m_p1 * srcWidth;
+			const ui32* row2 = pixels + yCoords[y].m_p2 * srcWidth;
+			const __m128i wy = _mm_set1_epi16(i16(yCoords[y].m_weight));
+			for (ui32 x = 0; x < dstWidth; x++, dst += 4)
+			{
+				const BilinearCoord& xc = xCoords[x];
+				__m128i px = _mm_set_epi32(row2[xc.m_p2], row2[xc.m_p1], row1[xc.m_p2], row1[xc.m_p1]);
+				__m128i top = _mm_unpacklo_epi8(px, zero);
+				__m128i bottom = _mm_unpackhi_epi8(px, zero);
+
+				// vertical then horizontal, same order as the scalar kernel
+				__m128i lr = _mm_add_epi16(top, _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(bottom, top), wy), half), BilinearShift));
+				__m128i diff = _mm_sub_epi16(_mm_srli_si128(lr, 8), lr);
+				__m128i result = _mm_add_epi16(lr, _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(diff, _mm_set1_epi16(i16(xc.m_weight))), half), BilinearShift));
+				i32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+				std::memcpy(dst, &packed, 4);
+			}
+		}
+	}
+
+	ECHO_TARGET_AVX2 static void swizzleRBAVX2(const Byte* src, Byte* dst, ui32 count)
+	{
+		const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+												 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		ui32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i px = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+			_mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_shuffle_epi8(px, shuffle));
+		}
+
+		swizzleRBScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	ECHO_TARGET_AVX2 static void rgba8ToRgb8AVX2(const Byte* src, Byte* dst, ui32 count)
+	{
+		const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+												 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+		ui32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i px = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+			__m256i rgb = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(px, shuffle), compact);
+			_mm_storeu_si128((__m128i*)(dst + i * 3), _mm256_castsi256_si128(rgb));
+			_mm_storel_epi64((__m128i*)(dst + i * 3 + 16), _mm256_extracti128_si256(rgb, 1));
+		}
+
+		rgba8ToRgb8Scalar(src + i * 4, dst + i * 3, count - i);
+	}
+
+	ECHO_TARGET_AVX2 static void rgba8ToFloatAVX2(const Byte* src, float* dst, ui32 count)
+	{
+		const __m256 scale = _mm256_set1_ps(1.f / 255.f);
+		ui32 i = 0;
+		for (; i + 2 <= count; i += 2)
+		{
+			__m256i px = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i * 4)));
+			_mm256_storeu_ps(dst + i * 4, _mm256_mul_ps(_mm256_cvtepi32_ps(px), scale));
+		}
+
+		rgba8ToFloatScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	ECHO_TARGET_AVX2 static void mipReduceAVX2(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst)
+	{
+		if (srcWidth < 2 || srcHeight < 2)
+		{
+			mipReduceScalar(src, srcWidth, srcHeight, dst);
+			return;
+		}
+
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i two = _mm256_set1_epi16(2);
+		ui32 dstWidth = srcWidth >> 1;
+		ui32 dstHeight = srcHeight >> 1;
+		for (ui32 y = 0; y < dstHeight; y++)
+		{
+			const Byte* row0 = src + (y * 2) * srcWidth * 4;
+			const Byte* row1 = row0 + srcWidth * 4;
+			Byte* dstRow = dst + y * dstWidth * 4;
+
+			ui32 x = 0;
+			for (; x + 4 <= dstWidth; x += 4)
+			{
+				__m256i a = _mm256_loadu_si256((const __m256i*)(row0 + x * 8));
+				__m256i b = _mm256_loadu_si256((const __m256i*)(row1 + x * 8));
+				__m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+				__m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+				lo = _mm256_add_epi16(lo, _mm256_srli_si256(lo, 8));
+				hi = _mm256_add_epi16(hi, _mm256_srli_si256(hi, 8));
+				__m256i sum = _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), two), 2);
+				__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), _MM_SHUFFLE(3, 1, 2, 0));
+				_mm_storeu_si128((__m128i*)(dstRow + x * 4), _mm256_castsi256_si128(packed));
+			}
+
+			mipReduceRowScalar(row0, row1, srcWidth, dstRow, x, dstWidth);
+		}
+	}
+#endif
+
+	//////////////////////////////////////////////////////////////////////////
+	// neon
+
+#ifdef ECHO_PIXEL_KERNELS_NEON
+	static void swizzleRBNEON(const Byte* src, Byte* dst, ui32 count)
+	{
+		ui32 i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			uint8x16x4_t px = vld4q_u8(src + i * 4);
+			uint8x16_t r = px.val[0];
+			px.val[0] = px.val[2];
+			px.val[2] = r;
+			vst4q_u8(dst + i * 4, px);
+		}
+
+		swizzleRBScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	static void rgba8ToRgb8NEON(const Byte* src, Byte* dst, ui32 count)
+	{
+		ui32 i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			uint8x16x4_t px = vld4q_u8(src + i * 4);
+			uint8x16x3_t rgb = { { px.val[0], px.val[1], px.val[2] } };
+			vst3q_u8(dst + i * 3, rgb);
+		}
+
+		rgba8ToRgb8Scalar(src + i * 4, dst + i * 3, count - i);
+	}
+
+	static void rgba8ToFloatNEON(const Byte* src, float* dst, ui32 count)
+	{
+		const float32x4_t scale = vdupq_n_f32(1.f / 255.f);
+		ui32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			uint8x16_t px = vld1q_u8(src + i * 4);
+			uint16x8_t lo = vmovl_u8(vget_low_u8(px));
+			uint16x8_t hi = vmovl_u8(vget_high_u8(px));
+			vst1q_f32(dst + i * 4 + 0,  vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+			vst1q_f32(dst + i * 4 + 4,  vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+			vst1q_f32(dst + i * 4 + 8,  vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+			vst1q_f32(dst + i * 4 + 12, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+		}
+
+		rgba8ToFloatScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	static inline uint8x8_t premultiplyNEON(uint8x8_t color, uint8x8_t alpha)
+	{
+		uint16x8_t t = vaddq_u16(vmull_u8(color, alpha), vdupq_n_u16(128));
+		return vaddhn_u16(t, vshrq_n_u16(t, 8));
+	}
+
+	static void premultiplyAlphaNEON(const Byte* src, Byte* dst, ui32 count)
+	{
+		ui32 i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t px = vld4_u8(src + i * 4);
+			px.val[0] = premultiplyNEON(px.val[0], px.val[3]);
+			px.val[1] = premultiplyNEON(px.val[1], px.val[3]);
+			px.val[2] = premultiplyNEON(px.val[2], px.val[3]);
+			vst4_u8(dst + i * 4, px);
+		}
+
+		premultiplyAlphaScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+	static void mipReduceNEON(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst)
+	{
+		if (srcWidth < 2 || srcHeight < 2)
+		{
+			mipReduceScalar(src, srcWidth, srcHeight, dst);
+			return;
+		}
+
+		ui32 dstWidth = srcWidth >> 1;
+		ui32 dstHeight = srcHeight >> 1;
+		for (ui32 y = 0; y < dstHeight; y++)
+		{
+			const Byte* row0 = src + (y * 2) * srcWidth * 4;
+			const Byte* row1 = row0 + srcWidth * 4;
+			Byte* dstRow = dst + y * dstWidth * 4;
+
+			ui32 x = 0;
+			for (; x + 2 <= dstWidth; x += 2)
+			{
+				uint8x16_t a = vld1q_u8(row0 + x * 8);
+				uint8x16_t b = vld1q_u8(row1 + x * 8);
+				uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+				uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+				uint16x8_t sum = vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)), vadd_u16(vget_low_u16(hi), vget_high_u16(hi)));
+				vst1_u8(dstRow + x * 4, vrshrn_n_u16(sum, 2));
+			}
+
+			mipReduceRowScalar(row0, row1, srcWidth, dstRow, x, dstWidth);
+		}
+	}
+
+	static void bilinearScaleNEON(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst, ui32 dstWidth, ui32 dstHeight)
+	{
+		vector<BilinearCoord>::type xCoords, yCoords;
+		buildBilinearCoords(srcWidth, dstWidth, xCoords);
+		buildBilinearCoords(srcHeight, dstHeight, yCoords);
+
+		const int16x8_t half = vdupq_n_s16(BilinearHalf);
+		const ui32* pixels = (const ui32*)src;
+		for (ui32 y = 0; y < dstHeight; y++)
+		{
+			const ui32* row1 = pixels + yCoords[y].m_p1 * srcWidth;
+			const ui32* row2 = pixels + yCoords[y].m_p2 * srcWidth;
+			const i16 wy = i16(yCoords[y].m_weight);
+			for (ui32 x = 0; x < dstWidth; x++, dst += 4)
+			{
+				const BilinearCoord& xc = xCoords[x];
+				ui32 quad[4] = { row1[xc.m_p1], row1[xc.m_p2], row2[xc.m_p1], row2[xc.m_p2] };
+				uint8x16_t px = vld1q_u8((const Byte*)quad);
+				int16x8_t top = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(px)));
+				int16x8_t bottom = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(px)));
+
+				int16x8_t lr = vaddq_s16(top, vshrq_n_s16(vaddq_s16(vmulq_n_s16(vsubq_s16(bottom, top), wy), half), BilinearShift));
+				int16x4_t left = vget_low_s16(lr);
+				int16x4_t diff = vsub_s16(vget_high_s16(lr), left);
+				int16x4_t result = vadd_s16(left, vshr_n_s16(vadd_s16(vmul_n_s16(diff, i16(xc.m_weight)), vget_low_s16(half)), BilinearShift));
+				uint8x8_t packed = vqmovun_s16(vcombine_s16(result, result));
+				vst1_lane_u32((uint32_t*)quad, vreinterpret_u32_u8(packed), 0);
+				std::memcpy(dst, quad, 4);
+			}
+		}
+	}
+#endif
+
+	//////////////////////////////////////////////////////////////////////////
+	// dispatch
+
+	static bool isIsaSupported(PixelKernels::Isa isa)
+	{
+		switch (isa)
+		{
+		case PixelKernels::Isa::Scalar:	return true;
+	#ifdef ECHO_PIXEL_KERNELS_X86
+		#ifdef _MSC_VER
+		case PixelKernels::Isa::SSE2:
+			{
+				int info[4];
+				__cpuid(info, 1);
+				return (info[3] & (1 << 26)) != 0;
+			}
+		case PixelKernels::Isa::AVX2:
+			{
+				int info[4];
+				__cpuid(info, 1);
+				bool osxsave = (info[2] & (1 << 27)) != 0;
+				if (!osxsave || (_xgetbv(0) & 6) != 6)
+					return false;
+
+				__cpuidex(info, 7, 0);
+				return (info[1] & (1 << 5)) != 0;
+			}
+		#else
+		case PixelKernels::Isa::SSE2:	return __builtin_cpu_supports("sse2");
+		case PixelKernels::Isa::AVX2:	return __builtin_cpu_supports("avx2");
+		#endif
+	#endif
+	#ifdef ECHO_PIXEL_KERNELS_NEON
+		case PixelKernels::Isa::NEON:	return true;
+	#endif
+		default:						return false;
+		}
+	}
+
+	static void buildKernelTable(PixelKernels::Isa isa, PixelKernelTable& table)
+	{
+		table = PixelKernelTable();
+		table.m_isa = PixelKernels::Isa::Scalar;
+		table.m_swizzleRB = swizzleRBScalar;
+		table.m_rgba8ToRgb8 = rgba8ToRgb8Scalar;
+		table.m_rgba8ToFloat = rgba8ToFloatScalar;
+		table.m_premultiplyAlpha = premultiplyAlphaScalar;
+		table.m_mipReduce = mipReduceScalar;
+		table.m_bilinearScale = bilinearScaleScalar;
+
+	#ifdef ECHO_PIXEL_KERNELS_X86
+		if ((isa == PixelKernels::Isa::SSE2 || isa == PixelKernels::Isa::AVX2) && isIsaSupported(PixelKernels::Isa::SSE2))
+		{
+			table.m_isa = PixelKernels::Isa::SSE2;
+			table.m_swizzleRB = swizzleRBSSE2;
+			table.m_rgba8ToFloat = rgba8ToFloatSSE2;
+			table.m_premultiplyAlpha = premultiplyAlphaSSE2;
+			table.m_mipReduce = mipReduceSSE2;
+			table.m_bilinearScale = bilinearScaleSSE2;
+		}
+
+		// avx2 only overrides the kernels which gain from 256 bits or byte shuffles
+		if (isa == PixelKernels::Isa::AVX2 && isIsaSupported(PixelKernels::Isa::AVX2))
+		{
+			table.m_isa = PixelKernels::Isa::AVX2;
+			table.m_swizzleRB = swizzleRBAVX2;
+			table.m_rgba8ToRgb8 = rgba8ToRgb8AVX2;
+			table.m_rgba8ToFloat = rgba8ToFloatAVX2;
+			table.m_mipReduce = mipReduceAVX2;
+		}
+	#endif
+
+	#ifdef ECHO_PIXEL_KERNELS_NEON
+		if (isa == PixelKernels::Isa::NEON)
+		{
+			table.m_isa = PixelKernels::Isa::NEON;
+			table.m_swizzleRB = swizzleRBNEON;
+			table.m_rgba8ToRgb8 = rgba8ToRgb8NEON;
+			table.m_rgba8ToFloat = rgba8ToFloatNEON;
+			table.m_premultiplyAlpha = premultiplyAlphaNEON;
+			table.m_mipReduce = mipReduceNEON;
+			table.m_bilinearScale = bilinearScaleNEON;
+		}
+	#endif
+	}
+
+	static PixelKernelTable& getKernelTable()
+	{
+		static PixelKernelTable table = []()
+		{
+			PixelKernelTable result;
+			buildKernelTable(PixelKernels::getBestIsa(), result);
+			return result;
+		}();
+
+		return table;
+	}
+
+	PixelKernels::Isa PixelKernels::getIsa()
+	{
+		return getKernelTable().m_isa;
+	}
+
+	PixelKernels::Isa PixelKernels::getBestIsa()
+	{
+		if (isIsaSupported(Isa::NEON))	return Isa::NEON;
+		if (isIsaSupported(Isa::AVX2))	return Isa::AVX2;
+		if (isIsaSupported(Isa::SSE2))	return Isa::SSE2;
+
+		return Isa::Scalar;
+	}
+
+	const char* PixelKernels::getIsaName(Isa isa)
+	{
+		switch (isa)
+		{
+		case Isa::SSE2:		return "SSE2";
+		case Isa::AVX2:		return "AVX2";
+		case Isa::NEON:		return "NEON";
+		default:			return "Scalar";
+		}
+	}
+
+	void PixelKernels::setIsa(Isa isa)
+	{
+		buildKernelTable(isIsaSupported(isa) ? isa : getBestIsa(), getKernelTable());
+	}
+
+	void PixelKernels::swizzleRB(const Byte* src, Byte* dst, ui32 count)
+	{
+		getKernelTable().m_swizzleRB(src, dst, count);
+	}
+
+	void PixelKernels::rgba8ToRgb8(const Byte* src, Byte* dst, ui32 count)
+	{
+		getKernelTable().m_rgba8ToRgb8(src, dst, count);
+	}
+
+	void PixelKernels::rgba8ToFloat(const Byte* src, float* dst, ui32 count)
+	{
+		getKernelTable().m_rgba8ToFloat(src, dst, count);
+	}
+
+	void PixelKernels::premultiplyAlpha(const Byte* src, Byte* dst, ui32 count)
+	{
+		getKernelTable().m_premultiplyAlpha(src, dst, count);
+	}
+
+	void PixelKernels::mipReduce(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst)
+	{
+		getKernelTable().m_mipReduce(src, srcWidth, srcHeight, dst);
+	}
+
+	void PixelKernels::bilinearScale(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst, ui32 dstWidth, ui32 dstHeight)
+	{
+		getKernelTable().m_bilinearScale(src, srcWidth, srcHeight, dst, dstWidth, dstHeight);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "engine/core/memory/MemAllocDef.h"
+
+namespace Echo
+{
+	// SIMD kernels for the hot rgba8 pixel loops (import, atlas, mip generation).
+	// The instruction set is picked once at runtime, every kernel has a scalar
+	// fallback which produces bit identical results.
+	class PixelKernels
+	{
+	public:
+		enum class Isa
+		{
+			Scalar,
+			SSE2,
+			AVX2,
+			NEON,
+		};
+
+	public:
+		// current|best instruction set
+		static Isa getIsa();
+		static Isa getBestIsa();
+		static const char* getIsaName(Isa isa);
+
+		// force an instruction set (for benchmarks), falls back to the best supported one
+		static void setIsa(Isa isa);
+
+		// rgba8 <-> bgra8
+		static void swizzleRB(const Byte* src, Byte* dst, ui32 count);
+
+		// rgba8 -> rgb8 (bgra8 -> bgr8)
+		static void rgba8ToRgb8(const Byte* src, Byte* dst, ui32 count);
+
+		// rgba8 -> rgba32 float [0, 1]
+		static void rgba8ToFloat(const Byte* src, float* dst, ui32 count);
+
+		// rgb *= alpha, src and dst may be the same buffer
+		static void premultiplyAlpha(const Byte* src, Byte* dst, ui32 count);
+
+		// 2x2 box filter, dst size is max(1, srcWidth/2) x max(1, srcHeight/2)
+		static void mipReduce(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst);
+
+		// bilinear resample of a consecutive rgba8 image
+		static void bilinearScale(const Byte* src, ui32 srcWidth, ui32 srcHeight, Byte* dst, ui32 dstWidth, ui32 dstHeight);
+	};
+}
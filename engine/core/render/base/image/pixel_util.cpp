@@ -118,6 +118,7 @@ namespace Echo
 			case PF_PVRTC1_4bpp_RGBA:
 			case PF_PVRTC_RGBA_4444:	return Math::Max(4 * width * height * depth / 8, static_cast<ui32>(32));
 
+			case PF_ETC1:
 			case PF_ETC2_RGB:			return (ui32)(Math::Ceil(width / 4.0) * Math::Ceil(height / 4.0) * 8);
 			case PF_ETC2_RGBA:			return (ui32)(Math::Ceil(width / 4.0) * Math::Ceil(height / 4.0) * 16);
 
@@ -0,0 +1,402 @@
+#include "engine/core/log/Log.h"
+#include "engine/core/util/PathUtil.h"
+#include "engine/core/io/IO.h"
+#include "texture_cooker.h"
+#include "texture_loader.h"
+#include "image.h"
+
+namespace Echo
+{
+	// ETC1 intensity modifiers, index by pixel index value {a, b, -a, -b}
+	static const i32 g_etcModifiers[8][4] =
+	{
+		{  2,   8,  -2,   -8 },
+		{  5,  17,  -5,  -17 },
+		{  9,  29,  -9,  -29 },
+		{ 13,  42, -13,  -42 },
+		{ 18,  60, -18,  -60 },
+		{ 24,  80, -24,  -80 },
+		{ 33, 106, -33, -106 },
+		{ 47, 183, -47, -183 },
+	};
+
+	// EAC alpha modifiers
+	static const i32 g_eacModifiers[16][8] =
+	{
+		{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+		{ -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+		{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+		{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+		{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+		{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+		{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+		{ -2, -6,  -8, -10, 1, 5, 7,  9 },
+		{ -2, -5,  -8, -10, 1, 4, 7,  9 },
+		{ -2, -4,  -8, -10, 1, 3, 7,  9 },
+		{ -2, -5,  -7, -10, 1, 4, 6,  9 },
+		{ -3, -4,  -7, -10, 2, 3, 6,  9 },
+		{ -1, -2,  -3, -10, 0, 1, 2,  9 },
+		{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
+		{ -3, -5,  -7,  -9, 2, 4, 6,  8 },
+	};
+
+	static inline i32 clampByte(i32 value)
+	{
+		return value < 0 ? 0 : (value > 255 ? 255 : value);
+	}
+
+	static void writeBigEndian64(ui64 bits, Byte* out)
+	{
+		for (i32 i = 0; i < 8; i++)
+			out[i] = Byte((bits >> (56 - i * 8)) & 0xff);
+	}
+
+	// find the best intensity table for one sub block, returns squared error
+	static i32 encodeEtcSubBlock(const Byte block[16][4], const i32 base[3], bool flip, i32 subBlock, ui32& table, ui32 indices[16])
+	{
+		i32 bestError = INT_MAX;
+		for (ui32 t = 0; t < 8; t++)
+		{
+			i32 error = 0;
+			ui32 tableIndices[16] = { 0 };
+			for (i32 y = 0; y < 4; y++)
+			{
+				for (i32 x = 0; x < 4; x++)
+				{
+					if ((flip ? y / 2 : x / 2) != subBlock)
+						continue;
+
+					const Byte* pixel = block[y * 4 + x];
+					i32 bestPixelError = INT_MAX;
+					for (ui32 m = 0; m < 4; m++)
+					{
+						i32 dr = clampByte(base[0] + g_etcModifiers[t][m]) - pixel[0];
+						i32 dg = clampByte(base[1] + g_etcModifiers[t][m]) - pixel[1];
+						i32 db = clampByte(base[2] + g_etcModifiers[t][m]) - pixel[2];
+						i32 pixelError = dr * dr + dg * dg + db * db;
+						if (pixelError < bestPixelError)
+						{
+							bestPixelError = pixelError;
+							tableIndices[x * 4 + y] = m;
+						}
+					}
+
+					error += bestPixelError;
+				}
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				table = t;
+				for (i32 i = 0; i < 16; i++)
+				{
+					if ((flip ? (i % 4) / 2 : (i / 4) / 2) == subBlock)
+						indices[i] = tableIndices[i];
+				}
+			}
+		}
+
+		return bestError;
+	}
+
+	// ETC1 block (individual or differential mode), also a valid ETC2 RGB block
+	static void encodeEtc1Block(const Byte block[16][4], Byte* out)
+	{
+		ui64 bestBits = 0;
+		i32  bestError = INT_MAX;
+		for (i32 flip = 0; flip < 2; flip++)
+		{
+			float average[2][3] = { { 0.f } };
+			for (i32 y = 0; y < 4; y++)
+			{
+				for (i32 x = 0; x < 4; x++)
+				{
+					i32 sub = flip ? y / 2 : x / 2;
+					for (i32 c = 0; c < 3; c++)
+						average[sub][c] += block[y * 4 + x][c] / 8.f;
+				}
+			}
+
+			// try differential mode first, it has more color precision
+			i32 quant[2][3];
+			bool differential = true;
+			for (i32 c = 0; c < 3; c++)
+			{
+				quant[0][c] = i32(average[0][c] * 31.f / 255.f + 0.5f);
+				quant[1][c] = i32(average[1][c] * 31.f / 255.f + 0.5f);
+				i32 delta = quant[1][c] - quant[0][c];
+				if (delta < -4 || delta > 3)
+					differential = false;
+			}
+
+			i32 base[2][3];
+			for (i32 c = 0; c < 3; c++)
+			{
+				if (differential)
+				{
+					base[0][c] = (quant[0][c] << 3) | (quant[0][c] >> 2);
+					base[1][c] = (quant[1][c] << 3) | (quant[1][c] >> 2);
+				}
+				else
+				{
+					quant[0][c] = i32(average[0][c] * 15.f / 255.f + 0.5f);
+					quant[1][c] = i32(average[1][c] * 15.f / 255.f + 0.5f);
+					base[0][c] = (quant[0][c] << 4) | quant[0][c];
+					base[1][c] = (quant[1][c] << 4) | quant[1][c];
+				}
+			}
+
+			ui32 tables[2] = { 0, 0 };
+			ui32 indices[16] = { 0 };
+			i32 error = encodeEtcSubBlock(block, base[0], flip != 0, 0, tables[0], indices)
+					  + encodeEtcSubBlock(block, base[1], flip != 0, 1, tables[1], indices);
+			if (error < bestError)
+			{
+				ui64 bits = 0;
+				if (differential)
+				{
+					bits |= ui64(quant[0][0]) << 59 | ui64((quant[1][0] - quant[0][0]) & 7) << 56;
+					bits |= ui64(quant[0][1]) << 51 | ui64((quant[1][1] - quant[0][1]) & 7) << 48;
+					bits |= ui64(quant[0][2]) << 43 | ui64((quant[1][2] - quant[0][2]) & 7) << 40;
+				}
+				else
+				{
+					bits |= ui64(quant[0][0]) << 60 | ui64(quant[1][0]) << 56;
+					bits |= ui64(quant[0][1]) << 52 | ui64(quant[1][1]) << 48;
+					bits |= ui64(quant[0][2]) << 44 | ui64(quant[1][2]) << 40;
+				}
+
+				bits |= ui64(tables[0]) << 37 | ui64(tables[1]) << 34;
+				bits |= ui64(differential ? 1 : 0) << 33 | ui64(flip) << 32;
+				for (i32 i = 0; i < 16; i++)
+					bits |= ui64(indices[i] >> 1) << (16 + i) | ui64(indices[i] & 1) << i;
+
+				bestError = error;
+				bestBits = bits;
+			}
+		}
+
+		writeBigEndian64(bestBits, out);
+	}
+
+	// EAC alpha block of ETC2 RGBA8
+	static void encodeEacAlphaBlock(const Byte block[16][4], Byte* out)
+	{
+		i32 minAlpha = 255, maxAlpha = 0;
+		for (i32 i = 0; i < 16; i++)
+		{
+			minAlpha = std::min<i32>(minAlpha, block[i][3]);
+			maxAlpha = std::max<i32>(maxAlpha, block[i][3]);
+		}
+
+		ui32 bestBase = minAlpha, bestMultiplier = 1, bestTable = 13;
+		ui32 bestIndices[16] = { 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4 };
+		if (minAlpha != maxAlpha)
+		{
+			i32 bestError = INT_MAX;
+			for (ui32 t = 0; t < 16; t++)
+			{
+				const i32* modifiers = g_eacModifiers[t];
+				i32 modifierRange = modifiers[7] - modifiers[3];
+				i32 estimate = (maxAlpha - minAlpha + modifierRange - 1) / modifierRange;
+				for (i32 multiplier = std::max(estimate - 1, 1); multiplier <= std::min(estimate + 1, 15); multiplier++)
+				{
+					i32 base = clampByte(((minAlpha + maxAlpha) - (modifiers[7] + modifiers[3]) * multiplier) / 2);
+
+					i32 error = 0;
+					ui32 indices[16];
+					for (i32 y = 0; y < 4; y++)
+					{
+						for (i32 x = 0; x < 4; x++)
+						{
+							i32 alpha = block[y * 4 + x][3];
+							i32 bestPixelError = INT_MAX;
+							for (ui32 m = 0; m < 8; m++)
+							{
+								i32 delta = clampByte(base + modifiers[m] * multiplier) - alpha;
+								if (delta * delta < bestPixelError)
+								{
+									bestPixelError = delta * delta;
+									indices[x * 4 + y] = m;
+								}
+							}
+
+							error += bestPixelError;
+						}
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						bestBase = base;
+						bestMultiplier = multiplier;
+						bestTable = t;
+						std::memcpy(bestIndices, indices, sizeof(indices));
+					}
+				}
+			}
+		}
+
+		ui64 bits = ui64(bestBase) << 56 | ui64(bestMultiplier) << 52 | ui64(bestTable) << 48;
+		for (i32 i = 0; i < 16; i++)
+			bits |= ui64(bestIndices[i]) << (45 - i * 3);
+
+		writeBigEndian64(bits, out);
+	}
+
+	bool TextureCooker::isFormatSupported(PixelFormat targetFormat)
+	{
+		switch (targetFormat)
+		{
+		case PF_ETC1:
+		case PF_ETC2_RGB:
+		case PF_ETC2_RGBA:	return true;
+		default:			return !PixelUtil::IsCompressed(targetFormat) && !PixelUtil::IsDepth(targetFormat) && PixelUtil::GetPixelSize(targetFormat) > 0;
+		}
+	}
+
+	bool TextureCooker::encodeLevel(const Byte* rgba, ui32 width, ui32 height, PixelFormat targetFormat, Byte* out)
+	{
+		if (!PixelUtil::IsCompressed(targetFormat))
+		{
+			PixelUtil::BulkPixelConversion((void*)rgba, PF_RGBA8_UNORM, out, targetFormat, width * height);
+			return true;
+		}
+
+		ui32 blockSize = targetFormat == PF_ETC2_RGBA ? 16 : 8;
+		ui32 blocksX = (width + 3) / 4;
+		ui32 blocksY = (height + 3) / 4;
+		for (ui32 by = 0; by < blocksY; by++)
+		{
+			for (ui32 bx = 0; bx < blocksX; bx++)
+			{
+				// gather block, edge pixels are replicated for non multiple of 4 sizes
+				Byte block[16][4];
+				for (ui32 y = 0; y < 4; y++)
+				{
+					ui32 sy = std::min(by * 4 + y, height - 1);
+					for (ui32 x = 0; x < 4; x++)
+					{
+						ui32 sx = std::min(bx * 4 + x, width - 1);
+						std::memcpy(block[y * 4 + x], rgba + (sy * width + sx) * 4, 4);
+					}
+				}
+
+				Byte* dst = out + (by * blocksX + bx) * blockSize;
+				if (targetFormat == PF_ETC2_RGBA)
+				{
+					encodeEacAlphaBlock(block, dst);
+					encodeEtc1Block(block, dst + 8);
+				}
+				else
+				{
+					encodeEtc1Block(block, dst);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool TextureCooker::cook(const Image& image, PixelFormat targetFormat, bool generateMipmaps, Buffer& out)
+	{
+		if (!isFormatSupported(targetFormat))
+		{
+			EchoLogError("TextureCooker: unsupported target format [%s].", PixelUtil::GetPixelFormatName(targetFormat).c_str());
+			return false;
+		}
+
+		if (PixelUtil::IsCompressed(image.getPixelFormat()) || image.getDepth() > 1 || image.getNumFaces() > 1)
+		{
+			EchoLogError("TextureCooker: only uncompressed 2d source images can be cooked.");
+			return false;
+		}
+
+		ui32 width = image.getWidth();
+		ui32 height = image.getHeight();
+		ui32 numMipmaps = 1;
+		if (generateMipmaps)
+		{
+			while ((std::max(width, height) >> numMipmaps) > 0)
+				numMipmaps++;
+		}
+
+		// level table
+		CookedTextureHeader header;
+		header.m_pixelFormat = targetFormat;
+		header.m_width = width;
+		header.m_height = height;
+		header.m_numMipmaps = numMipmaps;
+		header.m_payloadOffset = (sizeof(CookedTextureHeader) + numMipmaps * sizeof(CookedTextureLevel) + 15) & ~15;
+
+		vector<CookedTextureLevel>::type levels(numMipmaps);
+		ui32 offset = header.m_payloadOffset;
+		for (ui32 i = 0; i < numMipmaps; i++)
+		{
+			levels[i].m_width = std::max<ui32>(width >> i, 1);
+			levels[i].m_height = std::max<ui32>(height >> i, 1);
+			levels[i].m_offset = offset;
+			levels[i].m_size = PixelUtil::GetMemorySize(levels[i].m_width, levels[i].m_height, 1, targetFormat);
+			offset = (offset + levels[i].m_size + 15) & ~15;
+		}
+
+		out.allocate(offset);
+		std::memset(out.getData(), 0, offset);
+		std::memcpy(out.getData(), &header, sizeof(header));
+		std::memcpy(out.getData() + sizeof(header), levels.data(), numMipmaps * sizeof(CookedTextureLevel));
+
+		// each level is resampled from the previous one in rgba8
+		vector<Byte>::type prevLevel(width * height * 4);
+		PixelBox srcBox(width, height, 1, image.getPixelFormat(), image.getData());
+		PixelBox topBox(width, height, 1, PF_RGBA8_UNORM, prevLevel.data());
+		PixelUtil::BulkPixelConversion(srcBox, topBox);
+
+		vector<Byte>::type curLevel;
+		for (ui32 i = 0; i < numMipmaps; i++)
+		{
+			const CookedTextureLevel& level = levels[i];
+			if (i > 0)
+			{
+				const CookedTextureLevel& prev = levels[i - 1];
+				curLevel.resize(level.m_width * level.m_height * 4);
+				PixelBox prevBox(prev.m_width, prev.m_height, 1, PF_RGBA8_UNORM, prevLevel.data());
+				PixelBox curBox(level.m_width, level.m_height, 1, PF_RGBA8_UNORM, curLevel.data());
+				Image::Scale(prevBox, curBox, Image::IMGFILTER_BILINEAR);
+				prevLevel.swap(curLevel);
+			}
+
+			if (!encodeLevel(prevLevel.data(), level.m_width, level.m_height, targetFormat, out.getData() + level.m_offset))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool TextureCooker::cook(const String& srcFile, const String& dstFile, PixelFormat targetFormat, bool generateMipmaps)
+	{
+		Image* image = Image::loadFromFile(srcFile);
+		if (!image)
+		{
+			EchoLogError("TextureCooker: load image [%s] failed.", srcFile.c_str());
+			return false;
+		}
+
+		Buffer cooked;
+		bool result = cook(*image, targetFormat, generateMipmaps, cooked);
+		EchoSafeDelete(image, Image);
+
+		if (result)
+		{
+			String fullPath = PathUtil::IsAbsolutePath(dstFile) ? dstFile : IO::instance()->convertResPathToFullPath(dstFile);
+			if (!PathUtil::EnsureDir(PathUtil::GetFileDirPath(fullPath)) || !PathUtil::WriteData(fullPath, cooked.getData(), cooked.getSize()))
+			{
+				EchoLogError("TextureCooker: write [%s] failed.", dstFile.c_str());
+				return false;
+			}
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "engine/core/util/Buffer.h"
+#include "pixel_format.h"
+
+namespace Echo
+{
+	class Image;
+	class TextureCooker
+	{
+	public:
+		// cook source image (.png .jpg ...) into a gpu ready .etex file
+		static bool cook(const String& srcFile, const String& dstFile, PixelFormat targetFormat, bool generateMipmaps = true);
+
+		// cook image into memory, the image itself is not modified
+		static bool cook(const Image& image, PixelFormat targetFormat, bool generateMipmaps, Buffer& out);
+
+		// is the target format supported by cook
+		static bool isFormatSupported(PixelFormat targetFormat);
+
+	private:
+		// encode one rgba8 mip level into target format
+		static bool encodeLevel(const Byte* rgba, ui32 width, ui32 height, PixelFormat targetFormat, Byte* out);
+	};
+}
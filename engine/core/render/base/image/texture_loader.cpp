@@ -146,4 +146,32 @@ namespace Echo
 
 		return 0;
 	}
+
+	const CookedTextureLevel* etexValidate(const void* data, ui32 size, const CookedTextureHeader*& header)
+	{
+		header = nullptr;
+		if (!data || size < sizeof(CookedTextureHeader))
+			return nullptr;
+
+		const CookedTextureHeader* cooked = static_cast<const CookedTextureHeader*>(data);
+		if (cooked->m_identifier != TEXTURE_COOKED_ETEX || cooked->m_version != cs_cooked_texture_version)
+			return nullptr;
+
+		if (cooked->m_pixelFormat == PF_UNKNOWN || cooked->m_pixelFormat >= PF_COUNT || !cooked->m_numMipmaps)
+			return nullptr;
+
+		ui32 tableEnd = sizeof(CookedTextureHeader) + cooked->m_numMipmaps * sizeof(CookedTextureLevel);
+		if (tableEnd > size)
+			return nullptr;
+
+		const CookedTextureLevel* levels = reinterpret_cast<const CookedTextureLevel*>(static_cast<const Byte*>(data) + sizeof(CookedTextureHeader));
+		for (ui32 i = 0; i < cooked->m_numMipmaps; i++)
+		{
+			if (levels[i].m_offset < tableEnd || levels[i].m_offset + levels[i].m_size > size)
+				return nullptr;
+		}
+
+		header = cooked;
+		return levels;
+	}
 }
@@ -15,6 +15,7 @@ namespace Echo
 	#define	TEXTURE_COMPRESSED_ETC1			FourCC<'E', 'T', 'C', '1'>::value		
 	#define TEXTURE_COMPRESSED_DDS			FourCC<'D', 'D', 'S', ' '>::value		
 	#define TEXTURE_COMPRESSED_COMMON		FourCC<'C', 'O', 'M', 'M'>::value
+	#define TEXTURE_COOKED_ETEX				FourCC<'E', 'T', 'E', 'X'>::value
 
 	const ui32 c_pvrtex3_ident = TEXTURE_COMPRESSED_PVR3;
 
@@ -163,6 +164,33 @@ namespace Echo
 
 	};
 
+	// Echo cooked texture (.etex), written by TextureCooker.
+	// layout : header | level table (numMipmaps entries) | pixel payload (16 bytes aligned per level)
+	struct CookedTextureHeader
+	{
+		ui32				m_identifier = TEXTURE_COOKED_ETEX;
+		ui32				m_version = 1;
+		ui32				m_pixelFormat = PF_UNKNOWN;
+		ui32				m_width = 0;
+		ui32				m_height = 0;
+		ui32				m_depth = 1;
+		ui32				m_numMipmaps = 1;
+		ui32				m_payloadOffset = 0;
+	};
+
+	struct CookedTextureLevel
+	{
+		ui32				m_width;
+		ui32				m_height;
+		ui32				m_offset;			// offset from the beginning of the file
+		ui32				m_size;
+	};
+
+	static const ui32 cs_cooked_texture_version = 1;
+
+	// validate a cooked texture held in memory, returns the level table on success
+	const CookedTextureLevel* etexValidate(const void* data, ui32 size, const CookedTextureHeader*& header);
+
 	static const ui8 cs_etc1_identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
 	static const ui32 cs_big_endian = 0x04030201;
 	static const ui32 cs_little_endian = 0x01020304;
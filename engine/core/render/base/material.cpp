@@ -117,8 +117,11 @@ namespace Echo
 		CLASS_BIND_METHOD(Material, getShaderPath, DEF_METHOD("getShaderPath"));
 		CLASS_BIND_METHOD(Material, setShaderPath, DEF_METHOD("setShaderPath"));
 		CLASS_BIND_METHOD(Material, getRenderStage, DEF_METHOD("getRenderStage"));
+		CLASS_BIND_METHOD(Material, isInstancing, DEF_METHOD("isInstancing"));
+		CLASS_BIND_METHOD(Material, setInstancing, DEF_METHOD("setInstancing"));
 
 		CLASS_REGISTER_PROPERTY(Material, "Shader", Variant::Type::ResourcePath, "getShaderPath", "setShaderPath");
+		CLASS_REGISTER_PROPERTY(Material, "Instancing", Variant::Type::Bool, "isInstancing", "setInstancing");
 	}
 
 	void Material::setMacros(const String& macros) 
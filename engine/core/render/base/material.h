@@ -84,6 +84,10 @@ namespace Echo
 		// render stage
 		const String& getRenderStage();
 
+		// renderables sharing mesh and material are drawn with one instanced call, unless disabled
+		bool isInstancing() const { return m_isInstancing; }
+		void setInstancing(bool isInstancing) { m_isInstancing = isInstancing; }
+
 		// set shader
 		void setShaderPath(const ResourcePath& path);
 		const ResourcePath& getShaderPath() const { return m_shaderPath; }
@@ -125,6 +129,7 @@ namespace Echo
 		StringArray			m_macros;
 		ShaderProgramPtr	m_shaderProgram;
 		UniformValueMap		m_uniformValues;
+		bool				m_isInstancing = true;
 	};
 	typedef ResRef<Material> MaterialPtr;
 }
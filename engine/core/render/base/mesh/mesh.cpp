@@ -58,13 +58,13 @@ namespace Echo
 			Word vertIdx1 = indices[baseIdx + 1];
 			Word vertIdx2 = indices[baseIdx + 2];
 
-			const Vector3& pos0 = m_vertData.getPosition(vertIdx0);
-			const Vector3& pos1 = m_vertData.getPosition(vertIdx1);
-			const Vector3& pos2 = m_vertData.getPosition(vertIdx2);
+			Vector3 pos0 = m_vertData.getPosition(vertIdx0);
+			Vector3 pos1 = m_vertData.getPosition(vertIdx1);
+			Vector3 pos2 = m_vertData.getPosition(vertIdx2);
 
-			const Vector2& uv0 = m_vertData.getUV0(vertIdx0);
-			const Vector2& uv1 = m_vertData.getUV0(vertIdx1);
-			const Vector2& uv2 = m_vertData.getUV0(vertIdx2);
+			Vector2 uv0 = m_vertData.getUV0(vertIdx0);
+			Vector2 uv1 = m_vertData.getUV0(vertIdx1);
+			Vector2 uv2 = m_vertData.getUV0(vertIdx2);
 
 			Vector3 deltaPos1 = pos1 - pos0;
 			Vector3 deltaPos2 = pos2 - pos0;
@@ -97,6 +97,7 @@ namespace Echo
 	{
 		m_indices.clear();
 		m_indices.shrink_to_fit();
+		m_lods.clear();
 
 		EchoSafeDelete(m_vertexBuffer, GPUBuffer);
 		EchoSafeDelete(m_indexBuffer, GPUBuffer);
@@ -133,9 +134,19 @@ namespace Echo
 		return (Word*)m_indices.data();
 	}
 
+	ui32 Mesh::selectLod(float screenRadius, float maxErrorPixels) const
+	{
+		// lods are ordered by growing error
+		ui32 lod = 0;
+		for (size_t i = 0; i < m_lods.size() && m_lods[i].m_error * screenRadius <= maxErrorPixels; i++)
+			lod = ui32(i) + 1;
+
+		return lod;
+	}
+
 	ui32 Mesh::getMemeoryUsage() const
 	{
-		return m_vertData.getVertexStride()*m_vertData.getVertexCount() + m_idxCount*m_idxStride;
+		return m_vertData.getVertexStride()*m_vertData.getVertexCount() + ui32(m_indices.size());
 	}
 
 	void Mesh::generateTangentData(bool useNormalMap)
@@ -167,7 +178,7 @@ namespace Echo
 
 	void Mesh::buildIndexBuffer()
 	{
-		Buffer indexBuff(m_idxCount*m_idxStride, m_indices.data());
+		Buffer indexBuff(ui32(m_indices.size()), m_indices.data());
 		if (m_isDynamicIndicesBuffer)
 		{
 			if (!m_indexBuffer)
@@ -208,6 +219,7 @@ namespace Echo
 		// load indices
 		m_idxCount = indicesCount;
 		m_idxStride = indicesStride;
+		m_lods.clear();
 		if (m_idxCount)
 		{
 			const Byte* indicesInByte = (const Byte*)indices;
@@ -218,6 +230,30 @@ namespace Echo
 		}
 	}
 
+	void Mesh::updateIndices(ui32 indicesCount, ui32 indicesStride, const void* indices, const vector<Lod>::type& lods)
+	{
+		updateIndices(indicesCount, indicesStride, indices);
+
+		// lod 0 draws through the regular index range
+		if (!lods.empty())
+		{
+			m_idxCount = lods[0].m_indexCount;
+			m_lods.assign(lods.begin() + 1, lods.end());
+		}
+	}
+
+	void Mesh::copyIndices(const Mesh& other)
+	{
+		m_topologyType = other.m_topologyType;
+		m_startIdx = other.m_startIdx;
+		m_idxCount = other.m_idxCount;
+		m_idxStride = other.m_idxStride;
+		m_indices = other.m_indices;
+		m_lods = other.m_lods;
+		if (!m_indices.empty())
+			buildIndexBuffer();
+	}
+
 	void Mesh::updateVertexs(const MeshVertexFormat& format, ui32 vertCount, const Byte* vertices)
 	{
 		m_vertData.set(format, vertCount);
@@ -238,6 +274,18 @@ namespace Echo
 		}
 	}
 
+	void Mesh::updateVertexs(const MeshVertexFormat& format, ui32 vertCount, const Byte* vertices, const AABB& box)
+	{
+		m_vertData.set(format, vertCount);
+		m_box = box;
+		if (vertCount)
+		{
+			memcpy(m_vertData.getVertices(), vertices, vertCount * m_vertData.getVertexStride());
+
+			buildVertexBuffer();
+		}
+	}
+
 	void Mesh::updateVertexs(const MeshVertexData& vertexData)
 	{
 		m_vertData = vertexData;
@@ -276,6 +324,17 @@ namespace Echo
 					XmlBinaryReader::Data indicesData;
 					reader.getData("Indices", indicesData);
 
+					// lods, the first one covers the full mesh
+					vector<Mesh::Lod>::type lods;
+					for (pugi::xml_node lodNode = root.child("lods").child("lod"); lodNode; lodNode = lodNode.next_sibling("lod"))
+					{
+						Mesh::Lod lod;
+						lod.m_startIndex = lodNode.attribute("start").as_uint();
+						lod.m_indexCount = lodNode.attribute("count").as_uint();
+						lod.m_error = lodNode.attribute("error").as_float();
+						lods.emplace_back(lod);
+					}
+
 					// parse vertex
 					XmlBinaryReader::Data positionData, normalData, colorData, uv0Data, blendingData;
 					reader.getData("Position", positionData);
@@ -327,10 +386,19 @@ namespace Echo
 						}
 					}
 
+					// encodings are stored decoded, compact meshes are re-encoded on load
+					MeshVertexFormat encodedFormat = vertFormat;
+					encodedFormat.m_positionEncoding = magic_enum::enum_cast<VertexEncoding>(vertex.attribute("position").as_string()).value_or(VE_FLOAT);
+					encodedFormat.m_normalEncoding = magic_enum::enum_cast<VertexEncoding>(vertex.attribute("normal").as_string()).value_or(VE_FLOAT);
+					encodedFormat.m_uvEncoding = magic_enum::enum_cast<VertexEncoding>(vertex.attribute("uv").as_string()).value_or(VE_FLOAT);
+					encodedFormat.m_weightEncoding = magic_enum::enum_cast<VertexEncoding>(vertex.attribute("weight").as_string()).value_or(VE_FLOAT);
+					if (encodedFormat.isCompact())
+						vertexData.convert(encodedFormat);
+
 					// set indices data
 					if (!indicesData.isEmpty())
 					{
-						res->updateIndices(indicesCount, indicesStride, indicesData.m_data.data());
+						res->updateIndices(indicesCount, indicesStride, indicesData.m_data.data(), lods);
 					}
 
 					// set vertex data
@@ -354,13 +422,34 @@ namespace Echo
 
 		// indices
 		pugi::xml_node indices = root.append_child("indices");
-		indices.append_attribute("count").set_value(getIndexCount());
+		indices.append_attribute("count").set_value(getIndexStride() ? ui32(m_indices.size()) / getIndexStride() : 0);
 		indices.append_attribute("stride").set_value(getIndexStride());
-		writer.addData("Indices", StringUtil::Format("Byte%d", getIndexStride()).c_str(), getIndices(), getIndexCount() * getIndexStride());
+		writer.addData("Indices", StringUtil::Format("Byte%d", getIndexStride()).c_str(), getIndices(), ui32(m_indices.size()));
+
+		// lods
+		if (!m_lods.empty())
+		{
+			pugi::xml_node lods = root.append_child("lods");
+			for (ui32 i = 0; i < getLodCount(); i++)
+			{
+				pugi::xml_node lod = lods.append_child("lod");
+				lod.append_attribute("start").set_value(getLodStartIndex(i));
+				lod.append_attribute("count").set_value(getLodIndexCount(i));
+				lod.append_attribute("error").set_value(i ? m_lods[i - 1].m_error : 0.f);
+			}
+		}
 
 		// vertex
 		pugi::xml_node vertex = root.append_child("vertex");
 		vertex.append_attribute("count").set_value(m_vertData.getVertexCount());
+		if (m_vertData.getFormat().isCompact())
+		{
+			const MeshVertexFormat& format = m_vertData.getFormat();
+			vertex.append_attribute("position").set_value(std::string(magic_enum::enum_name(format.m_positionEncoding)).c_str());
+			vertex.append_attribute("normal").set_value(std::string(magic_enum::enum_name(format.m_normalEncoding)).c_str());
+			vertex.append_attribute("uv").set_value(std::string(magic_enum::enum_name(format.m_uvEncoding)).c_str());
+			vertex.append_attribute("weight").set_value(std::string(magic_enum::enum_name(format.m_weightEncoding)).c_str());
+		}
 
 		// positions
 		{
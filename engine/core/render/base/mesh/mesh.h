@@ -29,6 +29,14 @@ namespace Echo
 			TT_TRIANGLESTRIP,
 		};
 
+		// simplified level of detail, indexes the same vertices as lod 0
+		struct Lod
+		{
+			ui32	m_startIndex = 0;
+			ui32	m_indexCount = 0;
+			float	m_error = 0.f;		// geometric error relative to the mesh radius
+		};
+
 	public:
 		Mesh() {}
 		~Mesh();
@@ -76,6 +84,14 @@ namespace Echo
 		// get indices
 		Word* getIndices() const;
 
+		// lods, lod 0 is the full mesh
+		ui32 getLodCount() const { return ui32(m_lods.size()) + 1; }
+		ui32 getLodStartIndex(ui32 lod) const { return lod && lod <= m_lods.size() ? m_lods[lod - 1].m_startIndex : m_startIdx; }
+		ui32 getLodIndexCount(ui32 lod) const { return lod && lod <= m_lods.size() ? m_lods[lod - 1].m_indexCount : m_idxCount; }
+
+		// coarsest lod whose error covers at most maxErrorPixels for a mesh radius of screenRadius pixels
+		ui32 selectLod(float screenRadius, float maxErrorPixels = 1.f) const;
+
 		// is valid
 		bool isValid() const { return getFaceCount() > 0; }
 
@@ -106,10 +122,19 @@ namespace Echo
 		// update indices data
 		void updateIndices(ui32 indicesCount, ui32 indicesStride, const void* indices);
 
+		// update indices data with lods appended, lods[0] describes the full mesh
+		void updateIndices(ui32 indicesCount, ui32 indicesStride, const void* indices, const vector<Lod>::type& lods);
+
+		// share the topology, indices and lods of another mesh, for meshes with their own vertices
+		void copyIndices(const Mesh& other);
+
 		// update vertex data
 		void updateVertexs(const MeshVertexFormat& format, ui32 vertCount, const Byte* vertices);
 		void updateVertexs(const MeshVertexData& vertexData);
 
+		// update vertex data whose bounding box is already known, skips the per vertex scan
+		void updateVertexs(const MeshVertexFormat& format, ui32 vertCount, const Byte* vertices, const AABB& box);
+
 		// clear
 		void clear();
 
@@ -142,6 +167,7 @@ namespace Echo
 		ui32						m_idxCount = 0;
 		ui32						m_idxStride = 0;
 		vector<Byte>::type			m_indices;
+		vector<Lod>::type			m_lods;
 		MeshVertexData				m_vertData;
 		bool						m_isDynamicVertexBuffer = false;
 		GPUBuffer*					m_vertexBuffer = nullptr;
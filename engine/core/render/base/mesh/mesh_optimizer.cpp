@@ -0,0 +1,599 @@
+#include "mesh_optimizer.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace Echo
+{
+	// cache size the triangle order is scored against
+	static const i32 ScoreCacheSize = 32;
+
+	// lods stop simplifying before the error passes this fraction of the mesh radius
+	static const float MaxLodError = 0.1f;
+
+	// score of a vertex for the next triangle, -1 once all of its triangles are out
+	static float VertexScore(i32 cachePosition, ui32 remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+			return -1.f;
+
+		float score = 0.f;
+		if (cachePosition >= 0)
+		{
+			// vertices of the last triangle get a fixed score, otherwise the next one would just reuse them
+			if (cachePosition < 3)
+				score = 0.75f;
+			else
+				score = std::pow(1.f - float(cachePosition - 3) / float(ScoreCacheSize - 3), 1.5f);
+		}
+
+		// vertices with few triangles left are finished early
+		return score + 2.f / std::sqrt(float(remainingTriangles));
+	}
+
+	// vertex to triangle adjacency, triangles of vertex v are adjacency[offsets[v]] up to adjacency[offsets[v + 1]]
+	static void BuildAdjacency(const ui32* indices, ui32 indexCount, ui32 vertexCount, vector<ui32>::type& offsets, vector<ui32>::type& adjacency)
+	{
+		offsets.assign(vertexCount + 1, 0);
+		for (ui32 i = 0; i < indexCount; i++)
+			offsets[indices[i] + 1]++;
+
+		for (ui32 v = 0; v < vertexCount; v++)
+			offsets[v + 1] += offsets[v];
+
+		vector<ui32>::type fill(offsets.begin(), offsets.end() - 1);
+		adjacency.resize(indexCount);
+		for (ui32 i = 0; i < indexCount; i++)
+			adjacency[fill[indices[i]]++] = i / 3;
+	}
+
+	// plane quadric, the error of a point is its weighted squared distance to the accumulated planes
+	struct Quadric
+	{
+		float	m_a2 = 0.f, m_ab = 0.f, m_ac = 0.f, m_ad = 0.f;
+		float	m_b2 = 0.f, m_bc = 0.f, m_bd = 0.f;
+		float	m_c2 = 0.f, m_cd = 0.f;
+		float	m_d2 = 0.f;
+		float	m_weight = 0.f;
+
+		void addPlane(const Vector3& normal, float d, float weight)
+		{
+			m_a2 += normal.x * normal.x * weight;
+			m_ab += normal.x * normal.y * weight;
+			m_ac += normal.x * normal.z * weight;
+			m_ad += normal.x * d * weight;
+			m_b2 += normal.y * normal.y * weight;
+			m_bc += normal.y * normal.z * weight;
+			m_bd += normal.y * d * weight;
+			m_c2 += normal.z * normal.z * weight;
+			m_cd += normal.z * d * weight;
+			m_d2 += d * d * weight;
+			m_weight += weight;
+		}
+
+		void add(const Quadric& q)
+		{
+			m_a2 += q.m_a2; m_ab += q.m_ab; m_ac += q.m_ac; m_ad += q.m_ad;
+			m_b2 += q.m_b2; m_bc += q.m_bc; m_bd += q.m_bd;
+			m_c2 += q.m_c2; m_cd += q.m_cd;
+			m_d2 += q.m_d2;
+			m_weight += q.m_weight;
+		}
+
+		float error(const Vector3& p) const
+		{
+			float rx = m_a2 * p.x + m_ab * p.y + m_ac * p.z + m_ad;
+			float ry = m_ab * p.x + m_b2 * p.y + m_bc * p.z + m_bd;
+			float rz = m_ac * p.x + m_bc * p.y + m_c2 * p.z + m_cd;
+			float result = rx * p.x + ry * p.y + rz * p.z + m_ad * p.x + m_bd * p.y + m_cd * p.z + m_d2;
+
+			return m_weight > 0.f ? std::abs(result) / m_weight : 0.f;
+		}
+	};
+
+	void MeshOptimizer::optimize(Mesh* mesh, MeshVertexData& vertices, const void* indices, ui32 indexCount, ui32 indexStride, ui32 lodCount)
+	{
+		vector<ui32>::type lodIndices(indexCount);
+		for (ui32 i = 0; i < indexCount; i++)
+		{
+			if (indexStride == sizeof(ui32))		lodIndices[i] = ((const ui32*)indices)[i];
+			else if (indexStride == sizeof(Word))	lodIndices[i] = ((const Word*)indices)[i];
+			else									lodIndices[i] = ((const Byte*)indices)[i];
+
+			// broken input is kept as it is
+			if (lodIndices[i] >= vertices.getVertexCount())
+			{
+				mesh->updateIndices(indexCount, indexStride, indices);
+				return;
+			}
+		}
+
+		optimizeVertexCache(lodIndices.data(), indexCount, vertices.getVertexCount());
+		optimizeOverdraw(lodIndices.data(), indexCount, vertices);
+		optimizeVertexFetch(vertices, lodIndices.data(), indexCount);
+
+		// every level halves the previous one and indexes the same vertices
+		vector<Mesh::Lod>::type lods(1);
+		lods[0].m_indexCount = indexCount;
+
+		vector<ui32>::type allIndices = lodIndices;
+		vector<ui32>::type simplified;
+		float error = 0.f;
+		for (ui32 i = 1; i < lodCount; i++)
+		{
+			ui32 previousCount = ui32(lodIndices.size());
+			error += simplify(simplified, lodIndices.data(), previousCount, vertices, previousCount / 6 * 3, MaxLodError);
+
+			// a level that barely shrinks isn't worth its memory
+			if (simplified.empty() || simplified.size() > previousCount * 3 / 4)
+				break;
+
+			optimizeVertexCache(simplified.data(), ui32(simplified.size()), vertices.getVertexCount());
+
+			Mesh::Lod lod;
+			lod.m_startIndex = ui32(allIndices.size());
+			lod.m_indexCount = ui32(simplified.size());
+			lod.m_error = error;
+			lods.emplace_back(lod);
+
+			allIndices.insert(allIndices.end(), simplified.begin(), simplified.end());
+			lodIndices.swap(simplified);
+		}
+
+		if (vertices.getVertexCount() <= 65535)
+		{
+			vector<Word>::type wordIndices(allIndices.begin(), allIndices.end());
+			mesh->updateIndices(ui32(wordIndices.size()), sizeof(Word), wordIndices.data(), lods);
+		}
+		else
+		{
+			mesh->updateIndices(ui32(allIndices.size()), sizeof(ui32), allIndices.data(), lods);
+		}
+	}
+
+	void MeshOptimizer::optimizeVertexCache(ui32* indices, ui32 indexCount, ui32 vertexCount)
+	{
+		ui32 triangleCount = indexCount / 3;
+		if (!triangleCount)
+			return;
+
+		vector<ui32>::type source(indices, indices + triangleCount * 3);
+
+		// live triangles of each vertex sit at the front of its adjacency range
+		vector<ui32>::type offsets;
+		vector<ui32>::type adjacency;
+		BuildAdjacency(source.data(), triangleCount * 3, vertexCount, offsets, adjacency);
+
+		vector<ui32>::type remaining(vertexCount);
+		vector<float>::type scores(vertexCount);
+		vector<i32>::type cachePositions(vertexCount, -1);
+		for (ui32 v = 0; v < vertexCount; v++)
+		{
+			remaining[v] = offsets[v + 1] - offsets[v];
+			scores[v] = VertexScore(-1, remaining[v]);
+		}
+
+		vector<bool>::type isEmitted(triangleCount, false);
+		i32 cache[ScoreCacheSize + 3];
+		i32 cacheCount = 0;
+		ui32 scanCursor = 0;
+		i32 bestTriangle = -1;
+		for (ui32 emitted = 0; emitted < triangleCount; emitted++)
+		{
+			// nothing in the cache touches a live triangle, continue in source order
+			if (bestTriangle < 0)
+			{
+				while (isEmitted[scanCursor])
+					scanCursor++;
+
+				bestTriangle = i32(scanCursor);
+			}
+
+			const ui32* triangle = &source[bestTriangle * 3];
+			isEmitted[bestTriangle] = true;
+			indices[emitted * 3 + 0] = triangle[0];
+			indices[emitted * 3 + 1] = triangle[1];
+			indices[emitted * 3 + 2] = triangle[2];
+
+			// retire the triangle from its vertices
+			for (ui32 k = 0; k < 3; k++)
+			{
+				ui32 v = triangle[k];
+				ui32* live = &adjacency[offsets[v]];
+				for (ui32 i = 0; i < remaining[v]; i++)
+				{
+					if (live[i] == ui32(bestTriangle))
+					{
+						std::swap(live[i], live[remaining[v] - 1]);
+						remaining[v]--;
+						break;
+					}
+				}
+			}
+
+			// the triangle's vertices move to the front of the lru cache
+			i32 newCache[ScoreCacheSize + 3];
+			i32 newCount = 0;
+			for (ui32 k = 0; k < 3; k++)
+			{
+				if (std::find(newCache, newCache + newCount, i32(triangle[k])) == newCache + newCount)
+					newCache[newCount++] = triangle[k];
+			}
+
+			for (i32 i = 0; i < cacheCount; i++)
+			{
+				if (cache[i] != i32(triangle[0]) && cache[i] != i32(triangle[1]) && cache[i] != i32(triangle[2]))
+					newCache[newCount++] = cache[i];
+			}
+
+			for (i32 i = 0; i < newCount; i++)
+			{
+				i32 v = newCache[i];
+				cachePositions[v] = i < ScoreCacheSize ? i : -1;
+				scores[v] = VertexScore(cachePositions[v], remaining[v]);
+			}
+
+			cacheCount = std::min<i32>(newCount, ScoreCacheSize);
+			std::copy(newCache, newCache + cacheCount, cache);
+
+			// best live triangle around the cache
+			bestTriangle = -1;
+			float bestScore = -1.f;
+			for (i32 i = 0; i < cacheCount; i++)
+			{
+				ui32 v = cache[i];
+				for (ui32 j = 0; j < remaining[v]; j++)
+				{
+					ui32 t = adjacency[offsets[v] + j];
+					float score = scores[source[t * 3 + 0]] + scores[source[t * 3 + 1]] + scores[source[t * 3 + 2]];
+					if (score > bestScore)
+					{
+						bestScore = score;
+						bestTriangle = i32(t);
+					}
+				}
+			}
+		}
+	}
+
+	void MeshOptimizer::optimizeOverdraw(ui32* indices, ui32 indexCount, const MeshVertexData& vertices)
+	{
+		ui32 triangleCount = indexCount / 3;
+		ui32 vertexCount = vertices.getVertexCount();
+		if (!triangleCount)
+			return;
+
+		// a cluster starts where a triangle misses the cache with all three vertices, so sorting
+		// whole clusters keeps the cache order inside them
+		const ui32 cacheSize = 16;
+		vector<ui32>::type timestamps(vertexCount, 0);
+		vector<ui32>::type clusterStarts;
+		ui32 time = cacheSize + 1;
+		for (ui32 t = 0; t < triangleCount; t++)
+		{
+			ui32 misses = 0;
+			for (ui32 k = 0; k < 3; k++)
+			{
+				ui32 v = indices[t * 3 + k];
+				if (time - timestamps[v] > cacheSize)
+				{
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+
+			if (t == 0 || misses == 3)
+				clusterStarts.emplace_back(t);
+		}
+
+		clusterStarts.emplace_back(triangleCount);
+
+		// mesh center
+		Vector3 meshCenter = Vector3::ZERO;
+		for (ui32 i = 0; i < triangleCount * 3; i++)
+			meshCenter += vertices.getPosition(indices[i]);
+
+		meshCenter /= float(triangleCount * 3);
+
+		// clusters facing away from the center draw first, they tend to occlude the rest
+		struct Cluster
+		{
+			ui32	m_start;
+			ui32	m_end;
+			float	m_sortKey;
+		};
+
+		vector<Cluster>::type clusters;
+		for (size_t c = 0; c + 1 < clusterStarts.size(); c++)
+		{
+			Vector3 center = Vector3::ZERO;
+			Vector3 normal = Vector3::ZERO;
+			float area = 0.f;
+			for (ui32 t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+			{
+				Vector3 p0 = vertices.getPosition(indices[t * 3 + 0]);
+				Vector3 p1 = vertices.getPosition(indices[t * 3 + 1]);
+				Vector3 p2 = vertices.getPosition(indices[t * 3 + 2]);
+				Vector3 triangleNormal = (p1 - p0).cross(p2 - p0);
+				float triangleArea = triangleNormal.len();
+
+				center += (p0 + p1 + p2) * (triangleArea / 3.f);
+				normal += triangleNormal;
+				area += triangleArea;
+			}
+
+			center = area > 0.f ? center / area : vertices.getPosition(indices[clusterStarts[c] * 3]);
+			float normalLen = normal.len();
+			float sortKey = normalLen > 0.f ? (center - meshCenter).dot(normal / normalLen) : 0.f;
+			clusters.push_back({ clusterStarts[c], clusterStarts[c + 1], sortKey });
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.m_sortKey > b.m_sortKey; });
+
+		vector<ui32>::type source(indices, indices + triangleCount * 3);
+		ui32* dst = indices;
+		for (const Cluster& cluster : clusters)
+		{
+			std::copy(source.begin() + cluster.m_start * 3, source.begin() + cluster.m_end * 3, dst);
+			dst += (cluster.m_end - cluster.m_start) * 3;
+		}
+	}
+
+	void MeshOptimizer::optimizeVertexFetch(MeshVertexData& vertices, ui32* indices, ui32 indexCount)
+	{
+		ui32 vertexCount = vertices.getVertexCount();
+		vector<ui32>::type remap(vertexCount, ~0u);
+		ui32 usedCount = 0;
+		for (ui32 i = 0; i < indexCount; i++)
+		{
+			ui32& newIndex = remap[indices[i]];
+			if (newIndex == ~0u)
+				newIndex = usedCount++;
+
+			indices[i] = newIndex;
+		}
+
+		// same format and quantization, only the order changes
+		MeshVertexData result = vertices;
+		result.set(vertices.getFormat(), usedCount);
+
+		ui32 stride = vertices.getVertexStride();
+		for (ui32 v = 0; v < vertexCount; v++)
+		{
+			if (remap[v] != ~0u)
+				std::memcpy(result.getVertice(remap[v]), vertices.getVertice(v), stride);
+		}
+
+		vertices = result;
+	}
+
+	float MeshOptimizer::calcAcmr(const ui32* indices, ui32 indexCount, ui32 vertexCount, ui32 cacheSize)
+	{
+		ui32 triangleCount = indexCount / 3;
+		if (!triangleCount)
+			return 0.f;
+
+		// fifo cache, a vertex is inside while fewer than cacheSize others were loaded after it
+		vector<ui32>::type timestamps(vertexCount, 0);
+		ui32 time = cacheSize + 1;
+		ui32 misses = 0;
+		for (ui32 i = 0; i < triangleCount * 3; i++)
+		{
+			ui32 v = indices[i];
+			if (time - timestamps[v] > cacheSize)
+			{
+				timestamps[v] = time++;
+				misses++;
+			}
+		}
+
+		return float(misses) / float(triangleCount);
+	}
+
+	float MeshOptimizer::simplify(vector<ui32>::type& result, const ui32* indices, ui32 indexCount, const MeshVertexData& vertices, ui32 targetIndexCount, float targetError)
+	{
+		ui32 vertexCount = vertices.getVertexCount();
+		result.assign(indices, indices + indexCount / 3 * 3);
+		if (result.size() <= targetIndexCount || !vertexCount)
+			return 0.f;
+
+		// positions relative to the bounds, so errors come out relative to the radius
+		vector<Vector3>::type points(vertexCount);
+		AABB box;
+		box.reset();
+		for (ui32 v = 0; v < vertexCount; v++)
+		{
+			points[v] = vertices.getPosition(v);
+			box.addPoint(points[v]);
+		}
+
+		Vector3 center = box.getCenter();
+		float radius = std::max<float>(box.getDiagonalLen() * 0.5f, 1e-6f);
+		for (Vector3& point : points)
+			point = (point - center) / radius;
+
+		// vertices sharing their position with another one sit on an attribute seam, they stay in place
+		vector<bool>::type isLocked(vertexCount, false);
+		{
+			vector<ui32>::type order(vertexCount);
+			for (ui32 v = 0; v < vertexCount; v++)
+				order[v] = v;
+
+			auto less = [&points](ui32 a, ui32 b)
+			{
+				const Vector3& pa = points[a];
+				const Vector3& pb = points[b];
+				return pa.x != pb.x ? pa.x < pb.x : (pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z);
+			};
+
+			std::sort(order.begin(), order.end(), less);
+			for (ui32 i = 1; i < vertexCount; i++)
+			{
+				if (points[order[i]] == points[order[i - 1]])
+				{
+					isLocked[order[i]] = true;
+					isLocked[order[i - 1]] = true;
+				}
+			}
+		}
+
+		// so do open borders, an edge without its twin in the opposite direction
+		{
+			std::unordered_set<ui64> edges;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (ui32 k = 0; k < 3; k++)
+					edges.insert((ui64(result[i + k]) << 32) | result[i + (k + 1) % 3]);
+			}
+
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (ui32 k = 0; k < 3; k++)
+				{
+					ui32 a = result[i + k];
+					ui32 b = result[i + (k + 1) % 3];
+					if (!edges.count((ui64(b) << 32) | a))
+					{
+						isLocked[a] = true;
+						isLocked[b] = true;
+					}
+				}
+			}
+		}
+
+		// area weighted plane quadrics
+		vector<Quadric>::type quadrics(vertexCount);
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			const Vector3& p0 = points[result[i + 0]];
+			Vector3 normal = (points[result[i + 1]] - p0).cross(points[result[i + 2]] - p0);
+			float area = normal.len();
+			if (area > 0.f)
+			{
+				normal /= area;
+				float d = -normal.dot(p0);
+				for (ui32 k = 0; k < 3; k++)
+					quadrics[result[i + k]].addPlane(normal, d, area * 0.5f);
+			}
+		}
+
+		struct Collapse
+		{
+			ui32	m_from;
+			ui32	m_to;
+			float	m_error;
+		};
+
+		float errorLimit = targetError * targetError;
+		float resultError = 0.f;
+		vector<ui32>::type remap(vertexCount);
+		vector<bool>::type isDirty(vertexCount);
+		vector<ui32>::type offsets;
+		vector<ui32>::type adjacency;
+		vector<Collapse>::type collapses;
+		while (result.size() > targetIndexCount)
+		{
+			ui32 triangleCount = ui32(result.size() / 3);
+			BuildAdjacency(result.data(), ui32(result.size()), vertexCount, offsets, adjacency);
+
+			// candidates, every inner edge once in its cheaper direction
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (ui32 k = 0; k < 3; k++)
+				{
+					ui32 a = result[i + k];
+					ui32 b = result[i + (k + 1) % 3];
+					if (a > b || (isLocked[a] && isLocked[b]))
+						continue;
+
+					Quadric quadric = quadrics[a];
+					quadric.add(quadrics[b]);
+
+					float errorToB = isLocked[a] ? Math::MAX_REAL : quadric.error(points[b]);
+					float errorToA = isLocked[b] ? Math::MAX_REAL : quadric.error(points[a]);
+					if (errorToB <= errorToA)
+						collapses.push_back({ a, b, errorToB });
+					else
+						collapses.push_back({ b, a, errorToA });
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.m_error < b.m_error; });
+
+			// each collapse removes about two triangles
+			ui32 maxCollapses = (triangleCount - targetIndexCount / 3) / 2 + 1;
+			ui32 collapsedCount = 0;
+			for (ui32 v = 0; v < vertexCount; v++)
+				remap[v] = v;
+
+			std::fill(isDirty.begin(), isDirty.end(), false);
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.m_error > errorLimit)
+					break;
+
+				if (isDirty[collapse.m_from] || isDirty[collapse.m_to])
+					continue;
+
+				// the triangles that stay may not flip or turn too far
+				bool isFlipped = false;
+				for (ui32 j = offsets[collapse.m_from]; j < offsets[collapse.m_from + 1] && !isFlipped; j++)
+				{
+					const ui32* triangle = &result[adjacency[j] * 3];
+					if (triangle[0] == collapse.m_to || triangle[1] == collapse.m_to || triangle[2] == collapse.m_to)
+						continue;
+
+					Vector3 p[3], q[3];
+					for (ui32 k = 0; k < 3; k++)
+					{
+						p[k] = points[triangle[k]];
+						q[k] = triangle[k] == collapse.m_from ? points[collapse.m_to] : p[k];
+					}
+
+					Vector3 oldNormal = (p[1] - p[0]).cross(p[2] - p[0]);
+					Vector3 newNormal = (q[1] - q[0]).cross(q[2] - q[0]);
+					isFlipped = oldNormal.dot(newNormal) <= 0.25f * oldNormal.len() * newNormal.len();
+				}
+
+				if (isFlipped)
+					continue;
+
+				remap[collapse.m_from] = collapse.m_to;
+				quadrics[collapse.m_to].add(quadrics[collapse.m_from]);
+
+				// triangles around the removed vertex change, keep their vertices out of this pass
+				for (ui32 j = offsets[collapse.m_from]; j < offsets[collapse.m_from + 1]; j++)
+				{
+					const ui32* triangle = &result[adjacency[j] * 3];
+					isDirty[triangle[0]] = isDirty[triangle[1]] = isDirty[triangle[2]] = true;
+				}
+
+				resultError = std::max<float>(resultError, collapse.m_error);
+				if (++collapsedCount >= maxCollapses)
+					break;
+			}
+
+			if (!collapsedCount)
+				break;
+
+			// apply, triangles that became lines drop out
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				ui32 a = remap[result[i + 0]];
+				ui32 b = remap[result[i + 1]];
+				ui32 c = remap[result[i + 2]];
+				if (a != b && b != c && a != c)
+				{
+					result[write++] = a;
+					result[write++] = b;
+					result[write++] = c;
+				}
+			}
+
+			result.resize(write);
+		}
+
+		return std::sqrt(resultError);
+	}
+}
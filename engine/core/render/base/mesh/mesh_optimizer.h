@@ -0,0 +1,35 @@
+#pragma once
+
+#include "mesh.h"
+
+namespace Echo
+{
+	// import time reordering and simplification of indexed triangle lists. indices are 32 bit
+	// while working and narrowed again when handed to the mesh
+	class MeshOptimizer
+	{
+	public:
+		static const ui32 DefaultLodCount = 4;
+
+		// optimize indices and vertices for the gpu caches, build lodCount - 1 simplified levels and
+		// upload the indices to mesh. vertices are reordered, upload them afterwards
+		static void optimize(Mesh* mesh, MeshVertexData& vertices, const void* indices, ui32 indexCount, ui32 indexStride, ui32 lodCount = DefaultLodCount);
+
+		// reorder triangles for the post transform cache, Forsyth's linear speed algorithm
+		static void optimizeVertexCache(ui32* indices, ui32 indexCount, ui32 vertexCount);
+
+		// sort cache sized clusters of triangles so outward facing ones draw first
+		static void optimizeOverdraw(ui32* indices, ui32 indexCount, const MeshVertexData& vertices);
+
+		// reorder vertices by first use and drop unused ones, indices are remapped
+		static void optimizeVertexFetch(MeshVertexData& vertices, ui32* indices, ui32 indexCount);
+
+		// average transformed vertices per triangle with a fifo cache
+		static float calcAcmr(const ui32* indices, ui32 indexCount, ui32 vertexCount, ui32 cacheSize = 16);
+
+		// quadric error edge collapse onto existing vertices, so the result indexes the same vertex
+		// buffer. stops at targetIndexCount or before the error passes targetError, both the target
+		// and the returned error are relative to the mesh radius
+		static float simplify(vector<ui32>::type& result, const ui32* indices, ui32 indexCount, const MeshVertexData& vertices, ui32 targetIndexCount, float targetError);
+	};
+}
@@ -0,0 +1,101 @@
+#include "mesh_skinning.h"
+#include "engine/core/math/Simd.h"
+
+namespace Echo
+{
+	// weighted sum of the four joint matrices of a vertex, joint indices are packed in bytes
+	static void BlendJoints(Matrix4& result, const Matrix4* joints, ui32 jointCount, Dword packedJoints, const Vector4& weights)
+	{
+	#ifdef ECHO_SIMD
+		Simd::Float4 rows[4] = { Simd::splat(0.f), Simd::splat(0.f), Simd::splat(0.f), Simd::splat(0.f) };
+		for (i32 i = 0; i < 4; i++)
+		{
+			ui32 joint = (packedJoints >> (i * 8)) & 0xff;
+			if (joint < jointCount && weights.m[i] != 0.f)
+			{
+				Simd::Float4 weight = Simd::splat(weights.m[i]);
+				for (i32 row = 0; row < 4; row++)
+					rows[row] = Simd::madd(weight, Simd::load(joints[joint].m + row * 4), rows[row]);
+			}
+		}
+
+		for (i32 row = 0; row < 4; row++)
+			Simd::store(result.m + row * 4, rows[row]);
+	#else
+		std::memset(result.m, 0, sizeof(result.m));
+		for (i32 i = 0; i < 4; i++)
+		{
+			ui32 joint = (packedJoints >> (i * 8)) & 0xff;
+			if (joint < jointCount && weights.m[i] != 0.f)
+			{
+				for (i32 j = 0; j < 16; j++)
+					result.m[j] += weights.m[i] * joints[joint].m[j];
+			}
+		}
+	#endif
+	}
+
+	// xyz of a direction through the blended matrix
+	static Vector3 TransformDirection(const Vector3& direction, const Matrix4& matrix)
+	{
+		Vector4 result = Vector4(direction, 0.f) * matrix;
+		return Vector3(result.x, result.y, result.z);
+	}
+
+	MeshVertexFormat MeshSkinning::getSkinnedFormat(const MeshVertexFormat& format)
+	{
+		MeshVertexFormat result = format;
+		result.m_isUseBlendingData = false;
+		result.m_positionEncoding = VE_FLOAT;
+		result.m_normalEncoding = VE_FLOAT;
+		result.build();
+
+		return result;
+	}
+
+	void MeshSkinning::prepare(const MeshVertexData& input, MeshVertexData& output)
+	{
+		const MeshVertexFormat& format = input.getFormat();
+		output.set(getSkinnedFormat(format), input.getVertexCount());
+		for (ui32 i = 0; i < input.getVertexCount(); i++)
+		{
+			if (format.m_isUseVertexColor)
+				output.setColor(i, input.getColor(i));
+
+			if (format.m_isUseUV)
+				output.setUV0(i, input.getUV0(i));
+
+			if (format.m_isUseLightmapUV)
+				output.setUV1(i, input.getUV1(i));
+		}
+	}
+
+	AABB MeshSkinning::skin(const MeshVertexData& input, const Matrix4* joints, ui32 jointCount, MeshVertexData& output)
+	{
+		const MeshVertexFormat& format = input.getFormat();
+
+		AABB box;
+		box.reset();
+
+		Matrix4 blended;
+		for (ui32 i = 0; i < input.getVertexCount(); i++)
+		{
+			BlendJoints(blended, joints, jointCount, input.getJoint(i), input.getWeight(i));
+
+			Vector4 position = Vector4(input.getPosition(i), 1.f) * blended;
+			output.setPosition(i, Vector3(position.x, position.y, position.z));
+			box.addPoint(Vector3(position.x, position.y, position.z));
+
+			if (format.m_isUseNormal)
+				output.setNormal(i, TransformDirection(input.getNormal(i), blended));
+
+			if (format.m_isUseTangentBinormal)
+			{
+				output.setTangent(i, TransformDirection(input.getTangent(i), blended));
+				output.setBinormal(i, TransformDirection(input.getBinormal(i), blended));
+			}
+		}
+
+		return box;
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "mesh_vertex_data.h"
+
+namespace Echo
+{
+	// cpu vertex skinning, for targets whose vertex shaders are too slow for a joint palette.
+	// the skinned copy drops the blend data and keeps positions and directions as floats
+	class MeshSkinning
+	{
+	public:
+		// format of the skinned copy of format
+		static MeshVertexFormat getSkinnedFormat(const MeshVertexFormat& format);
+
+		// set output to the skinned format and copy the attributes skinning doesn't change
+		static void prepare(const MeshVertexData& input, MeshVertexData& output);
+
+		// blend positions, normals, tangents and binormals of input by the joint matrices into a
+		// prepared output. joints outside the palette don't contribute, returns the skinned bounds
+		static AABB skin(const MeshVertexData& input, const Matrix4* joints, ui32 jointCount, MeshVertexData& output);
+	};
+}
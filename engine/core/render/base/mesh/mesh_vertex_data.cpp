@@ -1,4 +1,7 @@
 #include "mesh_vertex_data.h"
+#include "engine/core/render/base/image/pixel_util.h"
+#include "engine/core/math/Function.h"
+#include <algorithm>
 
 namespace Echo
 {
@@ -7,45 +10,81 @@ namespace Echo
 
 	}
 
-	void MeshVertexFormat::build()
+	// vertex format of an encoded attribute
+	static PixelFormat GetEncodedFormat(VertexSemantic semantic, VertexEncoding encoding)
 	{
-		m_posOffset = 0;
-		m_normalOffset = m_posOffset + sizeof(Vector3);
-		m_colorOffset = m_normalOffset + (m_isUseNormal ? sizeof(Vector3) : 0);
-		m_uv0Offset = m_colorOffset + (m_isUseVertexColor ? sizeof(Dword) : 0);
-		m_uv1Offset = m_uv0Offset + (m_isUseUV ? sizeof(Vector2) : 0);
-		m_boneIndicesOffset = m_uv1Offset + (m_isUseLightmapUV ? sizeof(Vector2) : 0);
-		m_boneWeightsOffset = m_boneIndicesOffset + (m_isUseBlendingData ? sizeof(Dword) : 0);
-		m_tangentOffset = m_boneWeightsOffset + (m_isUseBlendingData ? sizeof(Vector4) : 0);
-		m_stride = m_tangentOffset + (m_isUseTangentBinormal ? sizeof(Vector3) * 2 : 0);
+		switch (semantic)
+		{
+		case VS_POSITION:		return encoding == VE_UNORM16 ? PF_RGBA16_UNORM : (encoding == VE_HALF ? PF_RGBA16_FLOAT : PF_RGB32_FLOAT);
+		case VS_NORMAL:
+		case VS_TANGENT:
+		case VS_BINORMAL:		return encoding == VE_OCT16 ? PF_RG16_SNORM : PF_RGB32_FLOAT;
+		case VS_COLOR:			return PF_RGBA8_UNORM;
+		case VS_TEXCOORD0:
+		case VS_TEXCOORD1:		return encoding == VE_HALF ? PF_RG16_FLOAT : PF_RG32_FLOAT;
+		case VS_BLENDINDICES:	return PF_RGBA8_UINT;
+		case VS_BLENDWEIGHTS:	return encoding == VE_UNORM8 ? PF_RGBA8_UNORM : PF_RGBA32_FLOAT;
+		default:				return PF_UNKNOWN;
+		}
+	}
 
+	void MeshVertexFormat::build()
+	{
 		m_vertexElements.clear();
 
-		m_vertexElements.emplace_back(VS_POSITION, PF_RGB32_FLOAT);
+		// elements are packed in order, backends derive the offsets from the pixel sizes the same way
+		ui32 offset = 0;
+		auto addElement = [&](VertexSemantic semantic, VertexEncoding encoding) -> Byte
+		{
+			PixelFormat pixFmt = GetEncodedFormat(semantic, encoding);
+			m_vertexElements.emplace_back(semantic, pixFmt);
+
+			Byte elementOffset = Byte(offset);
+			offset += PixelUtil::GetPixelSize(pixFmt);
+			return elementOffset;
+		};
+
+		m_posOffset = addElement(VS_POSITION, m_positionEncoding);
 
 		if (m_isUseNormal)
-			m_vertexElements.emplace_back(VS_NORMAL, PF_RGB32_FLOAT);
+			m_normalOffset = addElement(VS_NORMAL, m_normalEncoding);
 
 		if (m_isUseVertexColor)
-			m_vertexElements.emplace_back(VS_COLOR, PF_RGBA8_UNORM);
+			m_colorOffset = addElement(VS_COLOR, VE_FLOAT);
 
 		if (m_isUseUV)
-			m_vertexElements.emplace_back(VS_TEXCOORD0, PF_RG32_FLOAT);
+			m_uv0Offset = addElement(VS_TEXCOORD0, m_uvEncoding);
 
 		if (m_isUseLightmapUV)
-			m_vertexElements.emplace_back(VS_TEXCOORD1, PF_RG32_FLOAT);
+			m_uv1Offset = addElement(VS_TEXCOORD1, m_uvEncoding);
 
 		if (m_isUseBlendingData)
 		{
-			m_vertexElements.emplace_back(VS_BLENDINDICES, PF_RGBA8_UINT);
-			m_vertexElements.emplace_back(VS_BLENDWEIGHTS, PF_RGBA32_FLOAT);
+			m_boneIndicesOffset = addElement(VS_BLENDINDICES, VE_FLOAT);
+			m_boneWeightsOffset = addElement(VS_BLENDWEIGHTS, m_weightEncoding);
 		}
 
 		if (m_isUseTangentBinormal)
 		{
-			m_vertexElements.emplace_back(VS_TANGENT, PF_RGB32_FLOAT);
-			m_vertexElements.emplace_back(VS_BINORMAL, PF_RGB32_FLOAT);
+			m_tangentOffset = addElement(VS_TANGENT, m_normalEncoding);
+			m_binormalOffset = addElement(VS_BINORMAL, m_normalEncoding);
 		}
+
+		m_stride = offset;
+	}
+
+	void MeshVertexFormat::useCompactEncodings()
+	{
+		// skinning runs on the stored positions before the world matrix, so skinned meshes can't be quantized
+		m_positionEncoding = m_isUseBlendingData ? VE_HALF : VE_UNORM16;
+		m_normalEncoding = VE_OCT16;
+		m_uvEncoding = VE_HALF;
+		m_weightEncoding = VE_UNORM8;
+	}
+
+	bool MeshVertexFormat::isCompact() const
+	{
+		return m_positionEncoding != VE_FLOAT || m_normalEncoding != VE_FLOAT || m_uvEncoding != VE_FLOAT || m_weightEncoding != VE_FLOAT;
 	}
 
 	bool MeshVertexFormat::isVertexUsage(VertexSemantic semantic) const
@@ -76,6 +115,12 @@ namespace Echo
 		m_uv1Offset = 0;
 		m_boneIndicesOffset = 0;
 		m_boneWeightsOffset = 0;
+		m_tangentOffset = 0;
+		m_binormalOffset = 0;
+		m_positionEncoding = VE_FLOAT;
+		m_normalEncoding = VE_FLOAT;
+		m_uvEncoding = VE_FLOAT;
+		m_weightEncoding = VE_FLOAT;
 	}
 
 	MeshVertexData::MeshVertexData()
@@ -120,16 +165,195 @@ namespace Echo
 		return m_format.isVertexUsage(semantic);
 	}
 
-	Vector3& MeshVertexData::getPosition(Word index)
+	// octahedral mapping of a unit vector to 2x16 snorm
+	static void EncodeOct(Byte* dst, const Vector3& dir)
+	{
+		float len = std::abs(dir.x) + std::abs(dir.y) + std::abs(dir.z);
+		Vector2 oct = len > 0.f ? Vector2(dir.x / len, dir.y / len) : Vector2::ZERO;
+		if (len > 0.f && dir.z < 0.f)
+		{
+			oct = Vector2((1.f - std::abs(oct.y)) * (oct.x >= 0.f ? 1.f : -1.f),
+						  (1.f - std::abs(oct.x)) * (oct.y >= 0.f ? 1.f : -1.f));
+		}
+
+		i16* result = (i16*)dst;
+		result[0] = i16(std::round(Math::Clamp(oct.x, -1.f, 1.f) * 32767.f));
+		result[1] = i16(std::round(Math::Clamp(oct.y, -1.f, 1.f) * 32767.f));
+	}
+
+	static Vector3 DecodeOct(const Byte* src)
+	{
+		const i16* oct = (const i16*)src;
+		Vector3 dir(std::max<float>(oct[0] / 32767.f, -1.f), std::max<float>(oct[1] / 32767.f, -1.f), 0.f);
+		dir.z = 1.f - std::abs(dir.x) - std::abs(dir.y);
+
+		float t = std::max<float>(-dir.z, 0.f);
+		dir.x += dir.x >= 0.f ? -t : t;
+		dir.y += dir.y >= 0.f ? -t : t;
+		dir.normalize();
+
+		return dir;
+	}
+
+	static void EncodeDirection(Byte* dst, VertexEncoding encoding, const Vector3& dir)
+	{
+		if (encoding == VE_OCT16)
+			EncodeOct(dst, dir);
+		else
+			*(Vector3*)dst = dir;
+	}
+
+	static Vector3 DecodeDirection(const Byte* src, VertexEncoding encoding)
+	{
+		return encoding == VE_OCT16 ? DecodeOct(src) : *(const Vector3*)src;
+	}
+
+	static void EncodeUV(Byte* dst, VertexEncoding encoding, const Vector2& uv)
+	{
+		if (encoding == VE_HALF)
+		{
+			ui16* result = (ui16*)dst;
+			result[0] = Math::FloatToHalf(uv.x);
+			result[1] = Math::FloatToHalf(uv.y);
+		}
+		else
+		{
+			*(Vector2*)dst = uv;
+		}
+	}
+
+	static Vector2 DecodeUV(const Byte* src, VertexEncoding encoding)
+	{
+		if (encoding == VE_HALF)
+		{
+			const ui16* uv = (const ui16*)src;
+			return Vector2(Math::HalfToFloat(uv[0]), Math::HalfToFloat(uv[1]));
+		}
+
+		return *(const Vector2*)src;
+	}
+
+	void MeshVertexData::convert(const MeshVertexFormat& format)
+	{
+		MeshVertexFormat encodedFormat = m_format;
+		encodedFormat.m_positionEncoding = format.m_positionEncoding;
+		encodedFormat.m_normalEncoding = format.m_normalEncoding;
+		encodedFormat.m_uvEncoding = format.m_uvEncoding;
+		encodedFormat.m_weightEncoding = format.m_weightEncoding;
+
+		MeshVertexData result;
+		result.set(encodedFormat, m_count);
+		if (result.isQuantized())
+		{
+			AABB box;
+			box.reset();
+			for (ui32 i = 0; i < m_count; i++)
+				box.addPoint(getPosition(i));
+
+			result.setQuantizeBounds(box);
+		}
+
+		for (ui32 i = 0; i < m_count; i++)
+		{
+			ui32 index = i;
+			result.setPosition(i, getPosition(index));
+
+			if (m_format.m_isUseNormal)
+				result.setNormal(i, getNormal(index));
+
+			if (m_format.m_isUseVertexColor)
+				result.setColor(i, getColor(index));
+
+			if (m_format.m_isUseUV)
+				result.setUV0(i, getUV0(index));
+
+			if (m_format.m_isUseLightmapUV)
+				result.setUV1(i, getUV1(index));
+
+			if (m_format.m_isUseBlendingData)
+			{
+				result.setJoint(i, getJoint(index));
+				result.setWeight(i, getWeight(index));
+			}
+
+			if (m_format.m_isUseTangentBinormal)
+			{
+				result.setTangent(i, getTangent(index));
+				result.setBinormal(i, getBinormal(index));
+			}
+		}
+
+		*this = result;
+	}
+
+	void MeshVertexData::setQuantizeBounds(const AABB& box)
+	{
+		// one scale for all axes keeps the dequantize transform free of shear for normals
+		Vector3 extent = box.vMax - box.vMin;
+		float scale = std::max<float>(std::max<float>(extent.x, extent.y), extent.z);
+		m_quantizeOffset = box.vMin;
+		m_quantizeScale = scale > 0.f ? scale : 1.f;
+	}
+
+	Matrix4 MeshVertexData::getDequantizeMatrix() const
+	{
+		Matrix4 result = Matrix4::IDENTITY;
+		if (isQuantized())
+		{
+			result.m00 = m_quantizeScale;
+			result.m11 = m_quantizeScale;
+			result.m22 = m_quantizeScale;
+			result.m30 = m_quantizeOffset.x;
+			result.m31 = m_quantizeOffset.y;
+			result.m32 = m_quantizeOffset.z;
+		}
+
+		return result;
+	}
+
+	Vector3 MeshVertexData::getPosition(ui32 index) const
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_POSITION));
 
-		return *(Vector3*)(getVertice(index) + m_format.m_posOffset);
+		const Byte* src = getAttribute(index, m_format.m_posOffset);
+		if (m_format.m_positionEncoding == VE_UNORM16)
+		{
+			const ui16* position = (const ui16*)src;
+			return m_quantizeOffset + Vector3(position[0], position[1], position[2]) * (m_quantizeScale / 65535.f);
+		}
+		else if (m_format.m_positionEncoding == VE_HALF)
+		{
+			const ui16* position = (const ui16*)src;
+			return Vector3(Math::HalfToFloat(position[0]), Math::HalfToFloat(position[1]), Math::HalfToFloat(position[2]));
+		}
+
+		return *(const Vector3*)src;
 	}
 
 	void MeshVertexData::setPosition(int idx, const Vector3& pos)
 	{
-		*(Vector3*)(getVertice(idx) + m_format.m_posOffset) = pos;
+		Byte* dst = getAttribute(idx, m_format.m_posOffset);
+		if (m_format.m_positionEncoding == VE_UNORM16)
+		{
+			Vector3 quantized = (pos - m_quantizeOffset) / m_quantizeScale;
+			ui16* position = (ui16*)dst;
+			position[0] = ui16(std::round(Math::Clamp(quantized.x, 0.f, 1.f) * 65535.f));
+			position[1] = ui16(std::round(Math::Clamp(quantized.y, 0.f, 1.f) * 65535.f));
+			position[2] = ui16(std::round(Math::Clamp(quantized.z, 0.f, 1.f) * 65535.f));
+			position[3] = 65535;
+		}
+		else if (m_format.m_positionEncoding == VE_HALF)
+		{
+			ui16* position = (ui16*)dst;
+			position[0] = Math::FloatToHalf(pos.x);
+			position[1] = Math::FloatToHalf(pos.y);
+			position[2] = Math::FloatToHalf(pos.z);
+			position[3] = Math::FloatToHalf(1.f);
+		}
+		else
+		{
+			*(Vector3*)dst = pos;
+		}
 	}
 
 	void MeshVertexData::setColor(i32 idx, Dword color)
@@ -138,67 +362,139 @@ namespace Echo
 			*(Dword*)(getVertice(idx) + m_format.m_colorOffset) = color;
 	}
 
-	void MeshVertexData::setJoint(int idx, Dword weight)
+	Dword MeshVertexData::getJoint(ui32 index) const
+	{
+		EchoAssert(index < m_count && isVertexUsage(VS_BLENDINDICES));
+
+		return *(const Dword*)getAttribute(index, m_format.m_boneIndicesOffset);
+	}
+
+	void MeshVertexData::setJoint(int idx, Dword joint)
 	{
 		if(m_format.m_isUseBlendingData)
-			*(Dword*)(getVertice(idx) + m_format.m_boneIndicesOffset) = weight;
+			*(Dword*)(getVertice(idx) + m_format.m_boneIndicesOffset) = joint;
+	}
+
+	Vector4 MeshVertexData::getWeight(ui32 index) const
+	{
+		EchoAssert(index < m_count && isVertexUsage(VS_BLENDWEIGHTS));
+
+		const Byte* src = getAttribute(index, m_format.m_boneWeightsOffset);
+		if (m_format.m_weightEncoding == VE_UNORM8)
+			return Vector4(src[0], src[1], src[2], src[3]) / 255.f;
+
+		return *(const Vector4*)src;
 	}
 
-	void MeshVertexData::setWeight(int idx, const Vector4& joint)
+	void MeshVertexData::setWeight(int idx, const Vector4& weight)
 	{
 		if (m_format.m_isUseBlendingData)
-			*(Vector4*)(getVertice(idx) + m_format.m_boneWeightsOffset) = joint;
+		{
+			Byte* dst = getAttribute(idx, m_format.m_boneWeightsOffset);
+			if (m_format.m_weightEncoding == VE_UNORM8)
+			{
+				// rounding error goes to the largest weight so the bytes still add up to 255
+				i32 total = 0;
+				i32 largest = 0;
+				for (i32 i = 0; i < 4; i++)
+				{
+					dst[i] = Byte(std::round(Math::Clamp(weight[i], 0.f, 1.f) * 255.f));
+					total += dst[i];
+					largest = dst[i] > dst[largest] ? i : largest;
+				}
+
+				if (total > 0)
+					dst[largest] = Byte(Math::Clamp(dst[largest] + 255 - total, 0, 255));
+			}
+			else
+			{
+				*(Vector4*)dst = weight;
+			}
+		}
 	}
 
-	const Vector3& MeshVertexData::getNormal(Word index)
+	Vector3 MeshVertexData::getNormal(ui32 index) const
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_NORMAL));
 
-		return *(Vector3*)(getVertice(index) + m_format.m_normalOffset);
+		return DecodeDirection(getAttribute(index, m_format.m_normalOffset), m_format.m_normalEncoding);
 	}
 
 	void MeshVertexData::setNormal(int idx, const Vector3& normal)
 	{
-		Vector3::Normalize(*(Vector3*)(getVertice(idx) + m_format.m_normalOffset),normal);
+		Vector3 unitNormal;
+		Vector3::Normalize(unitNormal, normal);
+		EncodeDirection(getAttribute(idx, m_format.m_normalOffset), m_format.m_normalEncoding, unitNormal);
 	}
 
-	Dword& MeshVertexData::getColor(Word index)
+	Dword& MeshVertexData::getColor(ui32 index)
 	{
 		EchoAssert(index < m_count && VS_COLOR);
 
 		return *(Dword*)(getVertice(index) + m_format.m_colorOffset);
 	}
 
-	const Vector2& MeshVertexData::getUV0(Word index)
+	Dword MeshVertexData::getColor(ui32 index) const
+	{
+		EchoAssert(index < m_count && isVertexUsage(VS_COLOR));
+
+		return *(const Dword*)getAttribute(index, m_format.m_colorOffset);
+	}
+
+	Vector2 MeshVertexData::getUV0(ui32 index) const
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_TEXCOORD0));
 
-		return *(Vector2*)(getVertice(index) + m_format.m_uv0Offset);
+		return DecodeUV(getAttribute(index, m_format.m_uv0Offset), m_format.m_uvEncoding);
 	}
 
 	void MeshVertexData::setUV0(int idx, const Vector2& uv0)
 	{
-		*(Vector2*)(getVertice(idx) + m_format.m_uv0Offset) = uv0;
+		EncodeUV(getAttribute(idx, m_format.m_uv0Offset), m_format.m_uvEncoding, uv0);
 	}
 
-	const Vector2& MeshVertexData::getUV1(Word index)
+	Vector2 MeshVertexData::getUV1(ui32 index) const
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_TEXCOORD1));
 
-		return *(Vector2*)(getVertice(index) + m_format.m_uv1Offset);
+		return DecodeUV(getAttribute(index, m_format.m_uv1Offset), m_format.m_uvEncoding);
+	}
+
+	void MeshVertexData::setUV1(int idx, const Vector2& uv1)
+	{
+		EncodeUV(getAttribute(idx, m_format.m_uv1Offset), m_format.m_uvEncoding, uv1);
 	}
 
-	Vector3& MeshVertexData::getTangent(Word index)
+	Vector3 MeshVertexData::getTangent(ui32 index) const
 	{
 		EchoAssert(index < m_count && isVertexUsage(VS_TANGENT));
 
-		return *(Vector3*)(getVertice(index) + m_format.m_tangentOffset);
+		return DecodeDirection(getAttribute(index, m_format.m_tangentOffset), m_format.m_normalEncoding);
+	}
+
+	void MeshVertexData::setTangent(int idx, const Vector3& tangent)
+	{
+		EncodeDirection(getAttribute(idx, m_format.m_tangentOffset), m_format.m_normalEncoding, tangent);
+	}
+
+	Vector3 MeshVertexData::getBinormal(ui32 index) const
+	{
+		EchoAssert(index < m_count && isVertexUsage(VS_BINORMAL));
+
+		return DecodeDirection(getAttribute(index, m_format.m_binormalOffset), m_format.m_normalEncoding);
+	}
+
+	void MeshVertexData::setBinormal(int idx, const Vector3& binormal)
+	{
+		EncodeDirection(getAttribute(idx, m_format.m_binormalOffset), m_format.m_normalEncoding, binormal);
 	}
 
 	void MeshVertexData::reset()
 	{
 		m_count = 0;
 		m_vertices.clear();
+		m_quantizeOffset = Vector3::ZERO;
+		m_quantizeScale = 1.f;
 	}
 
 	ByteArray MeshVertexData::getPositions()
@@ -223,7 +519,7 @@ namespace Echo
 		Byte* dataPtr = (Byte*)(&result[0]);
 		for (size_t i = 0; i < m_count; ++i)
 		{
-			const Vector3& normal = getNormal(i);
+			Vector3 normal = getNormal(i);
 			dataPtr[i * 3 + 0] = (normal.x + 1.f) * 0.5f * 255;
 			dataPtr[i * 3 + 1] = (normal.y + 1.f) * 0.5f * 255;
 			dataPtr[i * 3 + 2] = (normal.z + 1.f) * 0.5f * 255;
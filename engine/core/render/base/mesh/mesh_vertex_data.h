@@ -32,6 +32,16 @@ namespace Echo
 	};
 	typedef vector<VertexElement>::type	VertexElementList;
 
+	// storage of a vertex attribute, compact encodings are expanded by the input assembler
+	enum VertexEncoding
+	{
+		VE_FLOAT = 0,		// 32 bit floats
+		VE_HALF,			// 16 bit floats. positions and uvs
+		VE_UNORM16,			// 16 bit normalized inside the mesh bounds. positions
+		VE_OCT16,			// octahedral 2x16 snorm. normals, tangents and binormals
+		VE_UNORM8,			// 8 bit normalized. blend weights
+	};
+
 	struct MeshVertexFormat
 	{
 		bool		        m_isUseNormal = false;
@@ -49,6 +59,11 @@ namespace Echo
 		Byte		        m_boneIndicesOffset = 0;
 		Byte		        m_boneWeightsOffset = 0;
 		Byte		        m_tangentOffset = 0;
+		Byte		        m_binormalOffset = 0;
+		VertexEncoding		m_positionEncoding = VE_FLOAT;
+		VertexEncoding		m_normalEncoding = VE_FLOAT;		// normal, tangent and binormal
+		VertexEncoding		m_uvEncoding = VE_FLOAT;			// both uv sets
+		VertexEncoding		m_weightEncoding = VE_FLOAT;
 		VertexElementList	m_vertexElements;
 
 		MeshVertexFormat();
@@ -56,6 +71,10 @@ namespace Echo
 		// Build
 		void build();
 
+		// 16 bit positions, octahedral normals, half uvs and 8 bit weights
+		void useCompactEncodings();
+		bool isCompact() const;
+
 		// Is used
 		bool isVertexUsage(VertexSemantic semantic) const;
 
@@ -87,33 +106,52 @@ namespace Echo
 		// is Vertex use
 		bool isVertexUsage(VertexSemantic semantic) const;
 
+		// re-encode every vertex with the encodings of format, usage stays
+		void convert(const MeshVertexFormat& format);
+
+		// VE_UNORM16 positions are stored inside this box, set it before writing positions
+		void setQuantizeBounds(const AABB& box);
+		bool isQuantized() const { return m_format.m_positionEncoding == VE_UNORM16; }
+
+		// turns stored positions into local positions
+		Matrix4 getDequantizeMatrix() const;
+
 		// Position
-		Vector3& getPosition(Word index);
+		Vector3 getPosition(ui32 index) const;
 		void setPosition(int idx, const Vector3& pos);
 
 		// Normal
-		const Vector3& getNormal(Word index);
+		Vector3 getNormal(ui32 index) const;
 		void setNormal(int idx, const Vector3& normal);
 
 		// Color
-		Dword& getColor(Word index);
+		Dword& getColor(ui32 index);
+		Dword getColor(ui32 index) const;
 		void setColor(i32 idx, Dword color);
 
 		// UV0
-		const Vector2& getUV0(Word index);
+		Vector2 getUV0(ui32 index) const;
 		void setUV0(int idx, const Vector2& uv0);
 
 		// UV1
-		const Vector2& getUV1(Word index);
+		Vector2 getUV1(ui32 index) const;
+		void setUV1(int idx, const Vector2& uv1);
 
-		 // set skin weight
-		void setJoint(int idx, Dword weight);
+		// skin joint
+		Dword getJoint(ui32 index) const;
+		void setJoint(int idx, Dword joint);
 
-		// set skin joint
-		void setWeight(int idx, const Vector4& joint);
+		// skin weight
+		Vector4 getWeight(ui32 index) const;
+		void setWeight(int idx, const Vector4& weight);
 
 		// tangent
-		Vector3& getTangent(Word index);
+		Vector3 getTangent(ui32 index) const;
+		void setTangent(int idx, const Vector3& tangent);
+
+		// binormal
+		Vector3 getBinormal(ui32 index) const;
+		void setBinormal(int idx, const Vector3& binormal);
 
 		// reset
 		void reset();
@@ -124,9 +162,16 @@ namespace Echo
 		ByteArray getNormals();
 		ByteArray getUV0s();
 
+	private:
+		// attribute address
+		Byte* getAttribute(i32 idx, Byte offset) { return m_vertices.data() + idx * m_format.m_stride + offset; }
+		const Byte* getAttribute(i32 idx, Byte offset) const { return m_vertices.data() + idx * m_format.m_stride + offset; }
+
 	private:
 		ui32				m_count;
 		MeshVertexFormat	m_format;
 		ByteArray			m_vertices;
+		Vector3				m_quantizeOffset = Vector3::ZERO;
+		float				m_quantizeScale = 1.f;
 	};
 }
@@ -22,28 +22,96 @@ namespace Echo
 		CLASS_REGISTER_PROPERTY(RenderQueue, "Sort", Variant::Type::Bool, "isSort", "setSort");
 	}
 
+	// opaque depth tested draws give the same image in any order
+	static bool isOrderIndependent(Renderable* renderable)
+	{
+		ShaderProgram* shader = renderable->getMaterial() ? renderable->getMaterial()->getShader() : nullptr;
+		if (!shader)
+			return false;
+
+		const DepthStencilState::DepthStencilDesc& depthDesc = shader->getDepthStencilState()->getDesc();
+		return !shader->getBlendState()->getDesc().bBlendEnable && depthDesc.bDepthEnable && depthDesc.bWriteDepth;
+	}
+
+	// renderables that can share one instanced draw, skinned meshes bind a joint palette per node
+	// a run binds the uniforms of its first renderable, only the instance stream differs per draw
+	static bool hasPerDrawUniforms(Renderable* renderable)
+	{
+		return renderable->m_node && renderable->m_node->hasPerDrawUniforms();
+	}
+
+	static bool isInstancable(Renderable* a, Renderable* b)
+	{
+		return a->m_mesh == b->m_mesh && a->m_material == b->m_material && a->m_lod == b->m_lod && a->m_material && a->m_material->isInstancing() && a->m_mesh && !a->m_mesh->isSkin() && !hasPerDrawUniforms(a) && !hasPerDrawUniforms(b);
+	}
+
+	void RenderQueue::sortByInstance(vector<Renderable*>::type& renderables)
+	{
+		std::stable_sort(renderables.begin(), renderables.end(), [](Renderable* a, Renderable* b) -> bool
+		{
+			ui64 keyA = a->getRenderStateKey();
+			ui64 keyB = b->getRenderStateKey();
+			if (keyA != keyB) return keyA < keyB;
+			if (a->m_material != b->m_material) return a->m_material < b->m_material;
+			if (a->m_mesh != b->m_mesh) return a->m_mesh < b->m_mesh;
+			return a->m_lod < b->m_lod;
+		});
+	}
+
+	ui32 RenderQueue::getInstanceRun(Renderable* const* renderables, ui32 count)
+	{
+		ui32 run = count ? 1 : 0;
+		while (run < count && isInstancable(renderables[0], renderables[run]))
+			run++;
+
+		return run;
+	}
+
 	void RenderQueue::render()
 	{
 		Renderer* render = Renderer::instance();
 		if (render)
 		{
+			vector<Renderable*>::type renderables;
+			renderables.reserve(m_renderables.size());
+			bool isOrderFree = true;
+			for (RenderableID id : m_renderables)
+			{
+				Renderable* renderable = render->getRenderable(id);
+				if (renderable)
+				{
+					renderables.emplace_back(renderable);
+					isOrderFree = isOrderFree && isOrderIndependent(renderable);
+				}
+			}
+
 			// sort
 			if (m_sort)
 			{
-				std::sort(m_renderables.begin(), m_renderables.end(), [](RenderableID a, RenderableID b) -> bool
+				std::sort(renderables.begin(), renderables.end(), [](Renderable* a, Renderable* b) -> bool
 				{
-					Renderable* renderableA = Renderer::instance()->getRenderable(a);
-					Renderable* renderableB = Renderer::instance()->getRenderable(b);
-					return renderableA && renderableB ? renderableA->getNode()->getWorldPosition().z < renderableB->getNode()->getWorldPosition().z : false;
+					// equal depths keep draws with the same states together
+					Real depthA = a->getNode()->getWorldPosition().z;
+					Real depthB = b->getNode()->getWorldPosition().z;
+					return depthA != depthB ? depthA < depthB : a->getRenderStateKey() < b->getRenderStateKey();
 				});
 			}
+			else if (isOrderFree)
+			{
+				sortByInstance(renderables);
+			}
 
-			// render
-			for (RenderableID id : m_renderables)
+			// render, runs of the same mesh and material in one call
+			ui32 count = ui32(renderables.size());
+			for (ui32 i = 0; i < count;)
 			{
-				Renderable* renderable = Renderer::instance()->getRenderable(id);
-				if (renderable)
-					render->draw(renderable);
+				ui32 run = getInstanceRun(&renderables[i], count - i);
+				if (run > 1)
+					render->drawInstanced(&renderables[i], run);
+				else
+					render->draw(renderables[i]);
+
+				i += run;
 			}
 		}
 
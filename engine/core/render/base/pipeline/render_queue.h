@@ -25,6 +25,13 @@ namespace Echo
 		void setSort(bool isSort) { m_sort = isSort; }
 		bool isSort() const { return m_sort; }
 
+	public:
+		// group by states, then material, mesh and lod, so equal draws become instanced runs
+		static void sortByInstance(vector<Renderable*>::type& renderables);
+
+		// number of renderables at the front sharing one instanced draw with the first
+		static ui32 getInstanceRun(Renderable* const* renderables, ui32 count);
+
 	protected:
 		bool							m_sort;
 		vector<RenderableID>::type		m_renderables;
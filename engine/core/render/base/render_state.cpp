@@ -3,6 +3,25 @@
 
 namespace Echo
 {
+	// fnv-1a field by field, descs have padding so they can't be hashed as a whole
+	class DescHasher
+	{
+	public:
+		template<typename T> DescHasher& operator<<(const T& value)
+		{
+			const Byte* bytes = reinterpret_cast<const Byte*>(&value);
+			for (size_t i = 0; i < sizeof(T); i++)
+				m_hash = (m_hash ^ bytes[i]) * 0x100000001b3ull;
+
+			return *this;
+		}
+
+		ui64 get() const { return m_hash; }
+
+	private:
+		ui64	m_hash = 0xcbf29ce484222325ull;
+	};
+
 	RenderState::RenderState()
 	{
 	}
@@ -25,6 +44,30 @@ namespace Echo
 		return m_desc;
 	}
 
+	bool BlendState::BlendDesc::operator==(const BlendDesc& rhs) const
+	{
+		return bBlendEnable == rhs.bBlendEnable &&
+			srcBlend == rhs.srcBlend &&
+			dstBlend == rhs.dstBlend &&
+			blendOP == rhs.blendOP &&
+			srcAlphaBlend == rhs.srcAlphaBlend &&
+			dstAlphaBlend == rhs.dstAlphaBlend &&
+			alphaBlendOP == rhs.alphaBlendOP &&
+			colorWriteMask == rhs.colorWriteMask &&
+			bA2CEnable == rhs.bA2CEnable &&
+			bIndependBlendEnable == rhs.bIndependBlendEnable &&
+			blendFactor == rhs.blendFactor;
+	}
+
+	ui64 BlendState::BlendDesc::hash() const
+	{
+		DescHasher hasher;
+		hasher << bBlendEnable << srcBlend << dstBlend << blendOP << srcAlphaBlend << dstAlphaBlend << alphaBlendOP << colorWriteMask;
+		hasher << bA2CEnable << bIndependBlendEnable << blendFactor.r << blendFactor.g << blendFactor.b << blendFactor.a;
+
+		return hasher.get();
+	}
+
 	DepthStencilState::DepthStencilState(const DepthStencilDesc& desc)
 		: m_desc(desc)
 	{
@@ -39,6 +82,39 @@ namespace Echo
 		return m_desc;
 	}
 
+	bool DepthStencilState::DepthStencilDesc::operator==(const DepthStencilDesc& rhs) const
+	{
+		return bDepthEnable == rhs.bDepthEnable &&
+			bWriteDepth == rhs.bWriteDepth &&
+			depthFunc == rhs.depthFunc &&
+			bFrontStencilEnable == rhs.bFrontStencilEnable &&
+			frontStencilFunc == rhs.frontStencilFunc &&
+			frontStencilReadMask == rhs.frontStencilReadMask &&
+			frontStencilWriteMask == rhs.frontStencilWriteMask &&
+			frontStencilFailOP == rhs.frontStencilFailOP &&
+			frontStencilDepthFailOP == rhs.frontStencilDepthFailOP &&
+			frontStencilPassOP == rhs.frontStencilPassOP &&
+			frontStencilRef == rhs.frontStencilRef &&
+			bBackStencilEnable == rhs.bBackStencilEnable &&
+			backStencilFunc == rhs.backStencilFunc &&
+			backStencilReadMask == rhs.backStencilReadMask &&
+			backStencilWriteMask == rhs.backStencilWriteMask &&
+			backStencilFailOP == rhs.backStencilFailOP &&
+			backStencilDepthFailOP == rhs.backStencilDepthFailOP &&
+			backStencilPassOP == rhs.backStencilPassOP &&
+			backStencilRef == rhs.backStencilRef;
+	}
+
+	ui64 DepthStencilState::DepthStencilDesc::hash() const
+	{
+		DescHasher hasher;
+		hasher << bDepthEnable << bWriteDepth << depthFunc;
+		hasher << bFrontStencilEnable << frontStencilFunc << frontStencilReadMask << frontStencilWriteMask << frontStencilFailOP << frontStencilDepthFailOP << frontStencilPassOP << frontStencilRef;
+		hasher << bBackStencilEnable << backStencilFunc << backStencilReadMask << backStencilWriteMask << backStencilFailOP << backStencilDepthFailOP << backStencilPassOP << backStencilRef;
+
+		return hasher.get();
+	}
+
 	RasterizerState::RasterizerState(const RasterizerDesc& desc)
 		: m_desc(desc)
 	{
@@ -53,6 +129,28 @@ namespace Echo
 		return m_desc;
 	}
 
+	bool RasterizerState::RasterizerDesc::operator==(const RasterizerDesc& rhs) const
+	{
+		return polygonMode == rhs.polygonMode &&
+			shadeModel == rhs.shadeModel &&
+			cullMode == rhs.cullMode &&
+			bFrontFaceCCW == rhs.bFrontFaceCCW &&
+			depthBias == rhs.depthBias &&
+			depthBiasFactor == rhs.depthBiasFactor &&
+			bDepthClip == rhs.bDepthClip &&
+			bScissor == rhs.bScissor &&
+			bMultisample == rhs.bMultisample &&
+			lineWidth == rhs.lineWidth;
+	}
+
+	ui64 RasterizerState::RasterizerDesc::hash() const
+	{
+		DescHasher hasher;
+		hasher << polygonMode << shadeModel << cullMode << bFrontFaceCCW << depthBias << depthBiasFactor << bDepthClip << bScissor << bMultisample << lineWidth;
+
+		return hasher.get();
+	}
+
 	SamplerState::SamplerState(const SamplerDesc& desc)
 		: m_desc(desc)
 	{
@@ -66,4 +164,29 @@ namespace Echo
 	{
 		return m_desc;
 	}
+
+	bool SamplerState::SamplerDesc::operator==(const SamplerDesc& rhs) const
+	{
+		return minFilter == rhs.minFilter &&
+			magFilter == rhs.magFilter &&
+			mipFilter == rhs.mipFilter &&
+			addrUMode == rhs.addrUMode &&
+			addrVMode == rhs.addrVMode &&
+			addrWMode == rhs.addrWMode &&
+			maxAnisotropy == rhs.maxAnisotropy &&
+			cmpFunc == rhs.cmpFunc &&
+			borderColor == rhs.borderColor &&
+			minLOD == rhs.minLOD &&
+			maxLOD == rhs.maxLOD &&
+			mipLODBias == rhs.mipLODBias;
+	}
+
+	ui64 SamplerState::SamplerDesc::hash() const
+	{
+		DescHasher hasher;
+		hasher << minFilter << magFilter << mipFilter << addrUMode << addrVMode << addrWMode << maxAnisotropy << cmpFunc;
+		hasher << borderColor.r << borderColor.g << borderColor.b << borderColor.a << minLOD << maxLOD << mipLODBias;
+
+		return hasher.get();
+	}
 }
@@ -6,10 +6,22 @@ namespace Echo
 {
 	class RenderState
 	{
+		friend class Renderer;
+
 	public:
 		RenderState();
 		virtual ~RenderState();
 
+		// state types interned by the renderer
+		enum StateType
+		{
+			ST_BLEND,
+			ST_DEPTH_STENCIL,
+			ST_RASTERIZER,
+			ST_SAMPLER,
+			ST_MAX
+		};
+
 		enum ColorMask
 		{
 			CMASK_NONE		= 0x00000000,
@@ -33,6 +45,19 @@ namespace Echo
 			CF_NOT_EQUAL,
 			CF_MAXNUM
 		};
+
+	public:
+		// id among the interned states of the same type, small enough for sort keys, 0 if not interned
+		ui32 getId() const { return m_id; }
+
+		// hash of the desc
+		ui64 getHash() const { return m_hash; }
+
+	protected:
+		StateType	m_type = ST_MAX;
+		ui32		m_id = 0;
+		ui64		m_hash = 0;
+		i32			m_refCount = 0;
 	};
 
 	class BlendState: public RenderState
@@ -107,6 +132,9 @@ namespace Echo
 			{
 				reset();
 			}
+
+			bool operator==(const BlendDesc& rhs) const;
+			ui64 hash() const;
 		};
 
 		BlendState(const BlendDesc& desc);
@@ -198,6 +226,9 @@ namespace Echo
 			{
 				reset();
 			}
+
+			bool operator==(const DepthStencilDesc& rhs) const;
+			ui64 hash() const;
 		};
 
 		DepthStencilState(const DepthStencilDesc& desc);
@@ -270,6 +301,9 @@ namespace Echo
 			{
 				reset();
 			}
+
+			bool operator==(const RasterizerDesc& rhs) const;
+			ui64 hash() const;
 		};
 
 		RasterizerState(const RasterizerDesc& desc);
@@ -344,17 +378,8 @@ namespace Echo
 				maxLOD		= Math::MAX_FLOAT;
 				mipLODBias	= 0.0f;
 			}
-			bool operator==(const SamplerDesc& rhs) const
-			{
-				return minFilter == rhs.minFilter &&
-					magFilter == rhs.magFilter &&
-					mipFilter == rhs.mipFilter &&
-					addrUMode == rhs.addrUMode &&
-					addrWMode == rhs.addrWMode &&
-					maxAnisotropy == rhs.maxAnisotropy &&
-					cmpFunc == rhs.cmpFunc &&
-					borderColor == rhs.borderColor;
-			}
+			bool operator==(const SamplerDesc& rhs) const;
+			ui64 hash() const;
 		};
 
 	public:
@@ -42,4 +42,39 @@ namespace Echo
 			RenderPipeline::current()->addRenderable(m_material->getRenderStage(), getIdentifier());
 		}
 	}
+
+	Matrix4 Renderable::buildNormalMatrix(const Matrix4& world)
+	{
+		Matrix4 result = world;
+		result.noTranslate();
+		result.detInverse();
+		result.transpose();
+
+		return result;
+	}
+
+	ui64 Renderable::getRenderStateKey()
+	{
+		ShaderProgram* shader = m_material ? m_material->getShader() : nullptr;
+		return shader ? shader->getRenderStateKey() : 0;
+	}
+
+	const void* Renderable::getGlobalUniformValue(const String& name)
+	{
+		if (!m_node)
+			return nullptr;
+
+		if (name == "u_WorldMatrix" && m_mesh && m_mesh->getVertices().isQuantized())
+		{
+			m_dequantizedWorld = m_mesh->getVertices().getDequantizeMatrix() * m_node->getWorldMatrix();
+			return &m_dequantizedWorld;
+		}
+		else if (name == "u_NormalMatrix")
+		{
+			m_normalMatrix = buildNormalMatrix(m_node->getWorldMatrix());
+			return &m_normalMatrix;
+		}
+
+		return m_node->getGlobalUniformValue(name);
+	}
 }
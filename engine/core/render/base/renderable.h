@@ -37,9 +37,27 @@ namespace Echo
 		void setNode( Render* node) { m_node = node; }
 		Render* getNode() { return m_node; }
 
+		// mesh lod to draw
+		void setLod(ui32 lod) { m_lod = lod; }
+		ui32 getLod() const { return m_lod; }
+
+		// per instance tint, shaders read it from a_InstanceColor
+		void setInstanceColor(const Color& color) { m_instanceColor = color; }
+		const Color& getInstanceColor() const { return m_instanceColor; }
+
 		// submit to renderqueue
 		void submitToRenderQueue();
 
+		// render state ids of the material's shader, sorting by it groups draws that bind the same states
+		ui64 getRenderStateKey();
+
+		// node uniforms, the world matrix of a quantized mesh also dequantizes its positions.
+		// u_NormalMatrix is the inverse transpose of the node's world matrix, without the dequantize
+		const void* getGlobalUniformValue(const String& name);
+
+		// inverse transpose, correct for normals under non-uniform scale
+		static Matrix4 buildNormalMatrix(const Matrix4& world);
+
 	protected:
 		Renderable(int identifier);
 		virtual ~Renderable();
@@ -49,6 +67,10 @@ namespace Echo
 		Render*			m_node = nullptr;
 		MeshPtr			m_mesh;
 		MaterialPtr		m_material;
+		Matrix4			m_dequantizedWorld;
+		Matrix4			m_normalMatrix;
+		ui32			m_lod = 0;
+		Color			m_instanceColor = Color::WHITE;
 	};
 	typedef ui32 RenderableID;
 }
@@ -94,6 +94,133 @@ namespace Echo
 			EchoSafeDelete(it->second, Renderable);
 		}
 		m_renderables.clear();
+
+		destroyRenderStates();
+		g_render = nullptr;
+	}
+
+	template<typename T, typename Desc, typename Create>
+	T* Renderer::internRenderState(RenderState::StateType type, const Desc& desc, Create create)
+	{
+		RenderStateTable& table = m_renderStates[type];
+
+		ui64 hash = desc.hash();
+		auto range = table.m_states.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			T* state = static_cast<T*>(it->second);
+			if (state->getDesc() == desc)
+			{
+				state->m_refCount++;
+				return state;
+			}
+		}
+
+		T* state = create();
+		state->m_type = type;
+		state->m_hash = hash;
+		state->m_refCount = 1;
+
+		// ids of released states are reused so they stay small
+		if (!table.m_freeIds.empty())
+		{
+			state->m_id = table.m_freeIds.back();
+			table.m_freeIds.pop_back();
+		}
+		else
+		{
+			state->m_id = table.m_nextId++;
+		}
+
+		table.m_states.emplace(hash, state);
+
+		return state;
+	}
+
+	RasterizerState* Renderer::getRasterizerState(const RasterizerState::RasterizerDesc& desc)
+	{
+		return internRenderState<RasterizerState>(RenderState::ST_RASTERIZER, desc, [&]() { return createRasterizerState(desc); });
+	}
+
+	DepthStencilState* Renderer::getDepthStencilState(const DepthStencilState::DepthStencilDesc& desc)
+	{
+		return internRenderState<DepthStencilState>(RenderState::ST_DEPTH_STENCIL, desc, [&]() { return createDepthStencilState(desc); });
+	}
+
+	BlendState* Renderer::getBlendState(const BlendState::BlendDesc& desc)
+	{
+		return internRenderState<BlendState>(RenderState::ST_BLEND, desc, [&]() { return createBlendState(desc); });
+	}
+
+	const SamplerState* Renderer::getSamplerState(const SamplerState::SamplerDesc& desc)
+	{
+		return internRenderState<SamplerState>(RenderState::ST_SAMPLER, desc, [&]() { return createSamplerState(desc); });
+	}
+
+	void Renderer::releaseRenderState(const RenderState* constState)
+	{
+		RenderState* state = const_cast<RenderState*>(constState);
+		if (state && state->m_type != RenderState::ST_MAX && --state->m_refCount <= 0)
+		{
+			RenderStateTable& table = m_renderStates[state->m_type];
+			auto range = table.m_states.equal_range(state->m_hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second == state)
+				{
+					table.m_states.erase(it);
+					break;
+				}
+			}
+
+			table.m_freeIds.push_back(state->m_id);
+			onRenderStateDestroyed(state);
+			EchoSafeDelete(state, RenderState);
+		}
+	}
+
+	MultisampleState* Renderer::getMultisampleState()
+	{
+		if (!m_multisampleState)
+			m_multisampleState = createMultisampleState();
+
+		return m_multisampleState;
+	}
+
+	void Renderer::destroyRenderStates()
+	{
+		for (RenderStateTable& table : m_renderStates)
+		{
+			for (auto& it : table.m_states)
+			{
+				onRenderStateDestroyed(it.second);
+				EchoSafeDelete(it.second, RenderState);
+			}
+
+			table.m_states.clear();
+			table.m_freeIds.clear();
+			table.m_nextId = 1;
+		}
+
+		EchoSafeDelete(m_multisampleState, MultisampleState);
+	}
+
+	void Renderer::drawInstanced(Renderable** renderables, ui32 count)
+	{
+		for (ui32 i = 0; i < count; i++)
+			draw(renderables[i]);
+	}
+
+	void Renderer::buildInstanceData(Renderable** renderables, ui32 count, InstanceData* instances)
+	{
+		for (ui32 i = 0; i < count; i++)
+		{
+			const Matrix4* world = (const Matrix4*)renderables[i]->getGlobalUniformValue("u_WorldMatrix");
+			const Matrix4* normal = (const Matrix4*)renderables[i]->getGlobalUniformValue("u_NormalMatrix");
+			instances[i].m_world = world ? *world : Matrix4::IDENTITY;
+			instances[i].m_normal = normal ? *normal : Matrix4::IDENTITY;
+			instances[i].m_color = renderables[i]->getInstanceColor();
+		}
 	}
 
 	bool Renderer::isFullscreen() const
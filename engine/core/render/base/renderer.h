@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include "device_features.h"
 #include "render_state.h"
 #include "texture.h"
@@ -36,6 +37,14 @@ namespace Echo
 
 		static Color BGCOLOR;
 
+		// per instance vertex data of instanced draws, a_InstanceWorld, a_InstanceNormal and a_InstanceColor
+		struct InstanceData
+		{
+			Matrix4		m_world;
+			Matrix4		m_normal;
+			Color		m_color;
+		};
+
 	public:
 		Renderer();
 		virtual ~Renderer();
@@ -91,12 +100,15 @@ namespace Echo
 		virtual FrameBufferOffScreen* createFrameBufferOffScreen(ui32 width, ui32 height) = 0;
 		virtual FrameBufferWindow* createFrameBufferWindow() = 0;
 
-		// create states
-		virtual RasterizerState* createRasterizerState(const RasterizerState::RasterizerDesc& desc) = 0;
-		virtual DepthStencilState* createDepthStencilState(const DepthStencilState::DepthStencilDesc& desc) = 0;
-		virtual BlendState*	createBlendState(const BlendState::BlendDesc& desc) = 0;
-        virtual MultisampleState* createMultisampleState() = 0;
-		virtual const SamplerState*	getSamplerState(const SamplerState::SamplerDesc& desc) = 0;
+		// interned states, equal descs share one object. every get has to be paired with a release
+		RasterizerState* getRasterizerState(const RasterizerState::RasterizerDesc& desc);
+		DepthStencilState* getDepthStencilState(const DepthStencilState::DepthStencilDesc& desc);
+		BlendState* getBlendState(const BlendState::BlendDesc& desc);
+		const SamplerState* getSamplerState(const SamplerState::SamplerDesc& desc);
+		void releaseRenderState(const RenderState* state);
+
+		// shared multisample state
+		MultisampleState* getMultisampleState();
 
 		// renderable operate
 		virtual Renderable* createRenderable()=0;
@@ -110,6 +122,13 @@ namespace Echo
 		// draw
 		virtual void draw(Renderable* renderable) = 0;
 
+		// draw renderables sharing mesh, material and lod. shaders that read the world matrix from the
+		// a_InstanceWorld attribute get one instanced draw, the default draws them one by one
+		virtual void drawInstanced(Renderable** renderables, ui32 count);
+
+		// the backend feeds a_InstanceWorld and a_InstanceColor, shaders are built with INSTANCING
+		virtual bool isInstancingSupported() const { return false; }
+
     public:
         // screen width and height
         virtual ui32 getWindowWidth() = 0;
@@ -125,6 +144,36 @@ namespace Echo
 		// present
 		virtual bool present()=0;
 
+	protected:
+		// create states
+		virtual RasterizerState* createRasterizerState(const RasterizerState::RasterizerDesc& desc) = 0;
+		virtual DepthStencilState* createDepthStencilState(const DepthStencilState::DepthStencilDesc& desc) = 0;
+		virtual BlendState*	createBlendState(const BlendState::BlendDesc& desc) = 0;
+        virtual MultisampleState* createMultisampleState() = 0;
+		virtual SamplerState* createSamplerState(const SamplerState::SamplerDesc& desc) = 0;
+
+		// destroy interned states, while the device is still alive
+		void destroyRenderStates();
+
+		// an interned state is about to be deleted, backends drop the pointers they cache to it
+		virtual void onRenderStateDestroyed(RenderState* state) {}
+
+		// world matrices, normal matrices and colors of the renderables
+		static void buildInstanceData(Renderable** renderables, ui32 count, InstanceData* instances);
+
+	private:
+		// interned states of one type
+		struct RenderStateTable
+		{
+			std::unordered_multimap<ui64, RenderState*>	m_states;
+			vector<ui32>::type							m_freeIds;
+			ui32										m_nextId = 1;
+		};
+
+		// find or create
+		template<typename T, typename Desc, typename Create>
+		T* internRenderState(RenderState::StateType type, const Desc& desc, Create create);
+
 		// start mipmap
 		void setStartMipmap(ui32 mipmap) { m_startMipmap = mipmap; }
 		ui32 getStartMipmap() const { return m_startMipmap; }
@@ -134,6 +183,8 @@ namespace Echo
 		std::map<ui32, Renderable*>	m_renderables;
 		ui32				m_startMipmap = 0;
 		DeviceFeature		m_deviceFeature;
+		RenderStateTable	m_renderStates[RenderState::ST_MAX];
+		MultisampleState*	m_multisampleState = nullptr;
 	};
     
     // initialize Renderer
@@ -8,7 +8,7 @@
 #include "image/pixel_format.h"
 #include "engine/core/io/IO.h"
 #include <thirdparty/pugixml/pugixml.hpp>
-#include "glslcc/glsl_cross_compiler.h"
+#include "glslcc/shader_cache.h"
 
 static const char* g_2dVsCode = R"(#version 450
 
@@ -74,6 +74,7 @@ static Echo::String g_3dVsCode = R"(#version 450
 layout(binding = 0) uniform UBO
 {
     mat4 u_WorldMatrix;
+    mat4 u_NormalMatrix;
     mat4 u_ViewProjMatrix;
 } vs_ubo;
 
@@ -83,22 +84,57 @@ layout(location = 0) in vec3 a_Position;
 // outputs
 layout(location = 0) out vec3 v_Position;
 
+#ifdef INSTANCING
+layout(location = INSTANCE_WORLD) in mat4 a_InstanceWorld;
+layout(location = INSTANCE_NORMAL) in mat4 a_InstanceNormal;
+layout(location = INSTANCE_COLOR) in vec4 a_InstanceColor;
+layout(location = 2) out vec4 v_InstanceColor;
+#define WORLD_MATRIX a_InstanceWorld
+#define NORMAL_MATRIX a_InstanceNormal
+#else
+#define WORLD_MATRIX vs_ubo.u_WorldMatrix
+#define NORMAL_MATRIX vs_ubo.u_NormalMatrix
+#endif
+
 #ifdef HAS_NORMALS
+#ifdef OCT_NORMALS
+layout(location = 1) in vec2 a_Normal;
+#else
 layout(location = 1) in vec3 a_Normal;
+#endif
 layout(location = 1) out vec3 v_Normal;
 #endif
 
+#ifdef OCT_NORMALS
+// octahedral 2x16 snorm to unit vector
+vec3 OctDecode(vec2 oct)
+{
+	vec3 dir = vec3(oct.xy, 1.0 - abs(oct.x) - abs(oct.y));
+	float t = max(-dir.z, 0.0);
+	dir.xy += vec2(dir.x >= 0.0 ? -t : t, dir.y >= 0.0 ? -t : t);
+	return normalize(dir);
+}
+#endif
+
 void main(void)
 {
     vec4 position = vec4(a_Position, 1.0);
-    position = vs_ubo.u_WorldMatrix * position;
+    position = WORLD_MATRIX * position;
 
     gl_Position = vs_ubo.u_ViewProjMatrix * position;
 
     v_Position  = position.xyz / position.w;
 
 #ifdef HAS_NORMALS
-	v_Normal = normalize(vec3(vs_ubo.u_WorldMatrix * vec4(a_Normal.xyz, 0.0)));
+#ifdef OCT_NORMALS
+	v_Normal = normalize(vec3(NORMAL_MATRIX * vec4(OctDecode(a_Normal), 0.0)));
+#else
+	v_Normal = normalize(vec3(NORMAL_MATRIX * vec4(a_Normal.xyz, 0.0)));
+#endif
+#endif
+
+#ifdef INSTANCING
+	v_InstanceColor = a_InstanceColor;
 #endif
 }
 )";
@@ -114,6 +150,10 @@ layout(location = 0) in vec3  v_Position;
 layout(location = 1) in vec3 v_Normal;
 #endif
 
+#ifdef INSTANCING
+layout(location = 2) in vec4 v_InstanceColor;
+#endif
+
 // outputs
 layout(location = 0) out vec4 o_FragColor;
 
@@ -142,6 +182,10 @@ void main(void)
 {
 	vec3 __BaseColor = SRgbToLinear(vec3(0.75));
 
+#ifdef INSTANCING
+	__BaseColor *= v_InstanceColor.rgb;
+#endif
+
 #ifdef HAS_NORMALS
     vec3 _lightDir = normalize(vec3(1.0, 1.0, 1.0));
     vec3 _lightColor = SRgbToLinear(vec3(1.2, 1.2, 1.2));
@@ -159,27 +203,17 @@ namespace Echo
     {
         if (type == "glsl")
         {
-            // convert to metal
-            if (Renderer::instance()->getType() == Renderer::Type::Metal)
+            // convert to metal|gles, through the compiled shader cache
+            if (Renderer::instance()->getType() == Renderer::Type::Metal || Renderer::instance()->getType() == Renderer::Type::OpenGLES)
             {
-                GLSLCrossCompiler glslCompiler;
+                ShaderCache::Target target = Renderer::instance()->getType() == Renderer::Type::Metal ? ShaderCache::MSL : ShaderCache::GLES;
 
-                // set input
-                glslCompiler.setInput(vsSrc.c_str(), psSrc.c_str(), nullptr);
+                ShaderCache::Entry entry;
+                ShaderCache::instance()->get(vsSrc, psSrc, target, entry);
 
-                vsSrc = glslCompiler.getOutput(Echo::GLSLCrossCompiler::ShaderLanguage::MSL, Echo::GLSLCrossCompiler::ShaderType::VS).c_str();
-                psSrc = glslCompiler.getOutput(Echo::GLSLCrossCompiler::ShaderLanguage::MSL, Echo::GLSLCrossCompiler::ShaderType::FS).c_str();
+                vsSrc = entry.m_output[GLSLCrossCompiler::ShaderType::VS];
+                psSrc = entry.m_output[GLSLCrossCompiler::ShaderType::FS];
             }
-			else if (Renderer::instance()->getType() == Renderer::Type::OpenGLES)
-			{
-				GLSLCrossCompiler glslCompiler;
-
-				// set input
-				glslCompiler.setInput(vsSrc.c_str(), psSrc.c_str(), nullptr);
-
-				vsSrc = glslCompiler.getOutput(Echo::GLSLCrossCompiler::ShaderLanguage::GLES, Echo::GLSLCrossCompiler::ShaderType::VS).c_str();
-				psSrc = glslCompiler.getOutput(Echo::GLSLCrossCompiler::ShaderLanguage::GLES, Echo::GLSLCrossCompiler::ShaderType::FS).c_str();
-			}
         }
         else
         {
@@ -273,9 +307,9 @@ namespace Echo
 
 	void ShaderProgram::clear()
 	{
-		EchoSafeDelete(m_blendState, BlendState);
-		EchoSafeDelete(m_depthState, DepthStencilState);
-		EchoSafeDelete(m_rasterizerState, RasterizerState);
+		setBlendState(nullptr);
+		setDepthStencilState(nullptr);
+		setRasterizerState(nullptr);
 	}
     
     Res* ShaderProgram::create()
@@ -315,6 +349,10 @@ namespace Echo
         String finalMacros; finalMacros.reserve(512);
         for (const String& macro : m_macros)
             finalMacros += "#define " + macro + "\n";
+
+        // world matrix and color per instance
+        if (Renderer::instance()->isInstancingSupported())
+            finalMacros += "#define INSTANCING\n";
         
         if (!finalMacros.empty())
         {
@@ -443,7 +481,7 @@ namespace Echo
     { 
         if (m_cullMode.setValue(option.getValue()))
         {
-            m_rasterizerState = nullptr;
+            setRasterizerState(nullptr);
         }
     }
 
@@ -451,10 +489,34 @@ namespace Echo
 	{
 		if (m_blendMode.setValue(option.getValue()))
 		{
-			m_blendState = nullptr;
+			setBlendState(nullptr);
 		}
 	}
 
+    void ShaderProgram::setBlendState(BlendState* blendState)
+    {
+        if (m_blendState && Renderer::instance())
+            Renderer::instance()->releaseRenderState(m_blendState);
+
+        m_blendState = blendState;
+    }
+
+    void ShaderProgram::setDepthStencilState(DepthStencilState* depthState)
+    {
+        if (m_depthState && Renderer::instance())
+            Renderer::instance()->releaseRenderState(m_depthState);
+
+        m_depthState = depthState;
+    }
+
+    void ShaderProgram::setRasterizerState(RasterizerState* rasterState)
+    {
+        if (m_rasterizerState && Renderer::instance())
+            Renderer::instance()->releaseRenderState(m_rasterizerState);
+
+        m_rasterizerState = rasterState;
+    }
+
     BlendState* ShaderProgram::getBlendState()
     { 
         if (!m_blendState)
@@ -467,7 +529,7 @@ namespace Echo
 				desc.dstBlend = BlendState::BF_INV_SRC_ALPHA;
             }
 
-            m_blendState = Renderer::instance()->createBlendState(desc);
+            m_blendState = Renderer::instance()->getBlendState(desc);
         }
 
         return m_blendState; 
@@ -478,7 +540,7 @@ namespace Echo
         if (!m_depthState)
         {
             DepthStencilState::DepthStencilDesc desc;
-            m_depthState = Renderer::instance()->createDepthStencilState(desc);
+            m_depthState = Renderer::instance()->getDepthStencilState(desc);
         }
 
         return m_depthState; 
@@ -490,7 +552,7 @@ namespace Echo
         {
             RasterizerState::RasterizerDesc desc;
             desc.cullMode = magic_enum::enum_cast<RasterizerState::CullMode>(m_cullMode.getValue().c_str()).value_or(RasterizerState::CullMode::CULL_NONE);
-            m_rasterizerState = Renderer::instance()->createRasterizerState(desc);
+            m_rasterizerState = Renderer::instance()->getRasterizerState(desc);
         }
 
         return m_rasterizerState; 
@@ -500,11 +562,16 @@ namespace Echo
     {
         if (!m_multiSampleState)
         {
-            m_multiSampleState = Renderer::instance()->createMultisampleState();
+            m_multiSampleState = Renderer::instance()->getMultisampleState();
         }
 
         return m_multiSampleState;
     }
+
+    ui64 ShaderProgram::getRenderStateKey()
+    {
+        return (ui64(getBlendState()->getId()) << 32) | (ui64(getDepthStencilState()->getId()) << 16) | ui64(getRasterizerState()->getId());
+    }
     
     void ShaderProgram::setUniform( const char* name, const void* value, ShaderParamType uniformType, ui32 count)
     {
@@ -553,7 +620,11 @@ namespace Echo
 		}
 		else if (StringUtil::StartWith(shaderPath, "_echo_default_3d_shader_"))
 		{
-            return ShaderProgram::getDefault3D({"HAS_NORMALS"});
+            StringArray macros = { "HAS_NORMALS" };
+            if (shaderPath.find("OCT_NORMALS") != String::npos)
+                macros.emplace_back("OCT_NORMALS");
+
+            return ShaderProgram::getDefault3D(macros);
 		}
 
 		return nullptr;
@@ -575,8 +646,7 @@ namespace Echo
             DepthStencilState::DepthStencilDesc depthDesc;
             depthDesc.bDepthEnable = false;
             depthDesc.bWriteDepth = false;
-            DepthStencilState* depthState = Renderer::instance()->createDepthStencilState(depthDesc);
-            shader->setDepthStencilState(depthState);
+            shader->setDepthStencilState(Renderer::instance()->getDepthStencilState(depthDesc));
 
             // reaster state
             shader->setCullMode("CULL_NONE");
@@ -606,8 +676,7 @@ namespace Echo
 			DepthStencilState::DepthStencilDesc depthDesc;
 			depthDesc.bDepthEnable = true;
 			depthDesc.bWriteDepth = true;
-			DepthStencilState* depthState = Renderer::instance()->createDepthStencilState(depthDesc);
-			shader->setDepthStencilState(depthState);
+			shader->setDepthStencilState(Renderer::instance()->getDepthStencilState(depthDesc));
 
 			// reaster state
 			shader->setCullMode("CULL_NONE");
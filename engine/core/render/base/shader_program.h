@@ -153,22 +153,25 @@ namespace Echo
 		virtual bool setPropertyValue(const String& propertyName, const Variant& propertyValue) override;
         
     public:
-        // blend sate
+        // blend sate, set takes over a reference of an interned state
         BlendState* getBlendState();
-        void setBlendState(BlendState* blendState) { m_blendState = blendState; }
+        void setBlendState(BlendState* blendState);
         
         // depth state
         DepthStencilState* getDepthStencilState();
-        void setDepthStencilState(DepthStencilState* depthState) { m_depthState = depthState; }
+        void setDepthStencilState(DepthStencilState* depthState);
         
         // raster state
         RasterizerState* getRasterizerState();
-        void setRasterizerState(RasterizerState* rasterState) { m_rasterizerState = rasterState; }
+        void setRasterizerState(RasterizerState* rasterState);
         
         // sample state
         MultisampleState* getMultisampleState();
         void setMultisampleState(MultisampleState* sampleState) { m_multiSampleState = sampleState; }
 
+        // ids of the render states packed for sort keys, equal keys bind equal states
+        ui64 getRenderStateKey();
+
     public:
 		// cull mode
 		const StringOption& getCullMode() const { return m_cullMode; }
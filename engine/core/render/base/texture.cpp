@@ -27,6 +27,8 @@ namespace Echo
 
 	Texture::~Texture()
 	{
+		if (m_samplerState && Renderer::instance())
+			Renderer::instance()->releaseRenderState(m_samplerState);
 	}
 
 	void Texture::bindMethods()
@@ -83,7 +85,11 @@ namespace Echo
 
 	void Texture::setSamplerState(const SamplerState::SamplerDesc& desc)
 	{
-		m_samplerState = Renderer::instance()->getSamplerState(desc);
+		const SamplerState* samplerState = Renderer::instance()->getSamplerState(desc);
+		if (m_samplerState)
+			Renderer::instance()->releaseRenderState(m_samplerState);
+
+		m_samplerState = samplerState;
 	}
 
 	size_t Texture::calculateSize() const
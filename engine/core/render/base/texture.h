@@ -11,7 +11,7 @@ namespace Echo
 {
 	class Texture : public Res
 	{
-		ECHO_RES(Texture, Res, ".png|.jpeg|.bmp|.tga|.jpg", nullptr, Texture::load);
+		ECHO_RES(Texture, Res, ".png|.jpeg|.bmp|.tga|.jpg|.etex", nullptr, Texture::load);
 
 		friend class Renderer;
 		friend class FrameBuffer;
@@ -128,6 +128,7 @@ namespace Echo
 			case PF_RG16_SNORM:			return GL_SHORT;
 			case PF_RG16_UINT:			return GL_UNSIGNED_SHORT;
 			case PF_RG16_SINT:			return GL_SHORT;
+			case PF_RG16_FLOAT:			return g_halfFloatDataType;
 
 			case PF_RGB16_UNORM:		return GL_UNSIGNED_SHORT;
 			case PF_RGB16_SNORM:		return GL_SHORT;
@@ -138,6 +139,8 @@ namespace Echo
 			case PF_RGBA16_SNORM:		return GL_SHORT;
 			case PF_RGBA16_UINT:		return GL_UNSIGNED_SHORT;
 			case PF_RGBA16_SINT:		return GL_SHORT;
+			case PF_RGBA16_FLOAT:		return g_halfFloatDataType;
+
 			case PF_R32_UNORM:			return GL_UNSIGNED_INT;
 			case PF_R32_SNORM:			return GL_INT;
 			case PF_R32_UINT:			return GL_UNSIGNED_INT;
@@ -12,6 +12,7 @@
 #include "base/pipeline/render_pipeline.h"
 #include "gles_gpu_buffer.h"
 #include "base/view_port.h"
+#include "engine/core/main/FrameState.h"
 
 namespace Echo
 {
@@ -156,7 +157,8 @@ namespace Echo
 
 	void GLESRenderer::cleanSystemResource()
 	{
-		EchoSafeDeleteContainer(m_vecSamlerStates, GLESSamplerState);
+		EchoSafeDelete(m_instanceBuffer, GPUBuffer);
+		destroyRenderStates();
 	}
 
 	void GLESRenderer::setViewport(Viewport* pViewport)
@@ -262,6 +264,7 @@ namespace Echo
 				glesRenderable->bindShaderParams();
 				shaderProgram->bindUniforms();
 				shaderProgram->bindRenderable(renderable);
+				bindInstanceAttributes(shaderProgram, &renderable, 1);
 
 				// set the type of primitive that should be rendered from this vertex buffer
 				GLenum glTopologyType = GLES2Mapping::MapPrimitiveTopology(Mesh::TT_LINELIST);
@@ -294,14 +297,31 @@ namespace Echo
 
 	void GLESRenderer::draw(Renderable* renderable)
 	{
+		drawInstanced(&renderable, 1);
+	}
+
+	void GLESRenderer::drawInstanced(Renderable** renderables, ui32 count)
+	{
+		GLESShaderProgram* shaderProgram = ECHO_DOWN_CAST<GLESShaderProgram*>(renderables[0]->getMaterial()->getShader());
+
+		// instanced draws need gles3 and a shader reading a_InstanceWorld, wireframes are drawn one by one
+		bool isInstancing = shaderProgram && shaderProgram->getInstanceWorldLocation() != -1 && m_deviceFeature.supportGLES30() && m_settings.m_polygonMode == RasterizerState::PM_FILL;
+		if (count > 1 && !isInstancing)
+		{
+			for (ui32 i = 0; i < count; i++)
+				drawInstanced(&renderables[i], 1);
+
+			return;
+		}
+
+		Renderable* renderable = renderables[0];
+
 #ifdef ECHO_EDITOR_MODE
 		if (drawWireframe(renderable))
 			return;
 #endif
 
 		GLESRenderable* glesRenderable = (GLESRenderable*)renderable;
-
-        GLESShaderProgram* shaderProgram = ECHO_DOWN_CAST<GLESShaderProgram*>(renderable->getMaterial()->getShader());
 		if (shaderProgram)
 		{
 			shaderProgram->bind();
@@ -309,6 +329,7 @@ namespace Echo
 			glesRenderable->bindShaderParams();
 			shaderProgram->bindUniforms();
 			shaderProgram->bindRenderable(renderable);
+			bindInstanceAttributes(shaderProgram, renderables, count);
 
 			MeshPtr mesh = renderable->getMesh();
 
@@ -326,13 +347,20 @@ namespace Echo
 				else											idxType = GL_UNSIGNED_BYTE;
 
 				// index count
-				ui32 idxCount = mesh->getIndexCount();
+				ui32 idxCount = mesh->getLodIndexCount(renderable->getLod());
 
 				// index offset
-				Byte* idxOffset = 0; idxOffset += mesh->getStartIndex() * mesh->getIndexStride();
+				Byte* idxOffset = 0; idxOffset += mesh->getLodStartIndex(renderable->getLod()) * mesh->getIndexStride();
 
 				// draw
-				OGLESDebug(glDrawElements(glTopologyType, idxCount, idxType, idxOffset));
+				if (count > 1)
+				{
+					OGLESDebug(glDrawElementsInstanced(glTopologyType, idxCount, idxType, idxOffset, count));
+				}
+				else
+				{
+					OGLESDebug(glDrawElements(glTopologyType, idxCount, idxType, idxOffset));
+				}
 			}
 			else	// no using index buffer
 			{
@@ -340,7 +368,14 @@ namespace Echo
 				if (vertCount > 0)
 				{
 					ui32 startVert = mesh->getStartVertex();
-					OGLESDebug(glDrawArrays(glTopologyType, startVert, vertCount));
+					if (count > 1)
+					{
+						OGLESDebug(glDrawArraysInstanced(glTopologyType, startVert, vertCount, count));
+					}
+					else
+					{
+						OGLESDebug(glDrawArrays(glTopologyType, startVert, vertCount));
+					}
 				}
 				else
 				{
@@ -348,7 +383,12 @@ namespace Echo
 				}
 			}
 
+			if (count > 1)
+				unbindInstanceAttributes(shaderProgram);
+
 			shaderProgram->unbind();
+
+			FrameState::instance()->incrDrawCallTimes(1);
 		}
 	}
 
@@ -374,6 +414,100 @@ namespace Echo
 		mat.m30 = matProj.m30;	mat.m31 = matProj.m31;	mat.m32 = 2 * matProj.m32;	mat.m33 = matProj.m33;
 	}
 
+	void GLESRenderer::bindInstanceAttributes(GLESShaderProgram* shaderProgram, Renderable** renderables, ui32 count)
+	{
+		GLint instanceWorld = shaderProgram->getInstanceWorldLocation();
+		GLint instanceNormal = shaderProgram->getInstanceNormalLocation();
+		GLint instanceColor = shaderProgram->getInstanceColorLocation();
+		if (instanceWorld == -1 && instanceNormal == -1 && instanceColor == -1)
+			return;
+
+		m_instanceData.resize(count);
+		buildInstanceData(renderables, count, m_instanceData.data());
+
+		// a single draw reads constant attributes, gles2 only has those
+		if (count == 1)
+		{
+			const InstanceData& instance = m_instanceData[0];
+			bindInstanceMatrix(instanceWorld, &instance.m_world, 0);
+			bindInstanceMatrix(instanceNormal, &instance.m_normal, 0);
+
+			if (instanceColor != -1)
+			{
+				disableAttribLocation(instanceColor);
+				OGLESDebug(glVertexAttrib4fv(instanceColor, (const GLfloat*)&instance.m_color));
+			}
+
+			return;
+		}
+
+		Buffer instanceBuff(count * sizeof(InstanceData), m_instanceData.data());
+		if (!m_instanceBuffer)
+			m_instanceBuffer = createVertexBuffer(GPUBuffer::GBU_DYNAMIC, instanceBuff);
+		else
+			m_instanceBuffer->updateData(instanceBuff);
+
+		((GLESGPUBuffer*)m_instanceBuffer)->bindBuffer();
+
+		bindInstanceMatrix(instanceWorld, nullptr, offsetof(InstanceData, m_world));
+		bindInstanceMatrix(instanceNormal, nullptr, offsetof(InstanceData, m_normal));
+
+		if (instanceColor != -1)
+		{
+			OGLESDebug(glVertexAttribPointer(instanceColor, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (GLvoid*)offsetof(InstanceData, m_color)));
+			OGLESDebug(glVertexAttribDivisor(instanceColor, 1));
+			enableAttribLocation(instanceColor);
+		}
+	}
+
+	void GLESRenderer::unbindInstanceAttributes(GLESShaderProgram* shaderProgram)
+	{
+		// later draws may feed these locations from a mesh
+		unbindInstanceMatrix(shaderProgram->getInstanceWorldLocation());
+		unbindInstanceMatrix(shaderProgram->getInstanceNormalLocation());
+
+		GLint instanceColor = shaderProgram->getInstanceColorLocation();
+		if (instanceColor != -1)
+		{
+			OGLESDebug(glVertexAttribDivisor(instanceColor, 0));
+			disableAttribLocation(instanceColor);
+		}
+	}
+
+	void GLESRenderer::bindInstanceMatrix(GLint location, const Matrix4* matrix, size_t offset)
+	{
+		if (location == -1)
+			return;
+
+		// a mat4 takes four locations, one column each. constant for a single draw, else read from the bound instance buffer
+		for (GLint i = 0; i < 4; i++)
+		{
+			if (matrix)
+			{
+				disableAttribLocation(location + i);
+				OGLESDebug(glVertexAttrib4fv(location + i, matrix->m + i * 4));
+			}
+			else
+			{
+				OGLESDebug(glVertexAttribPointer(location + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (GLvoid*)(offset + i * sizeof(Vector4))));
+				OGLESDebug(glVertexAttribDivisor(location + i, 1));
+				enableAttribLocation(location + i);
+			}
+		}
+	}
+
+	void GLESRenderer::unbindInstanceMatrix(GLint location)
+	{
+		if (location == -1)
+			return;
+
+		for (GLint i = 0; i < 4; i++)
+		{
+			OGLESDebug(glVertexAttribDivisor(location + i, 0));
+			disableAttribLocation(location + i);
+		}
+	}
+
 	void GLESRenderer::enableAttribLocation(ui32 attribLocation)
 	{
 		if (!m_isVertexAttribArrayEnable[attribLocation])
@@ -442,20 +576,9 @@ namespace Echo
 		return EchoNew(GLESBlendState(desc));
 	}
 
-	const SamplerState* GLESRenderer::getSamplerState(const SamplerState::SamplerDesc& desc)
+	SamplerState* GLESRenderer::createSamplerState(const SamplerState::SamplerDesc& desc)
 	{
-		// is exist
-		for (std::set<GLESSamplerState*>::iterator it = m_vecSamlerStates.begin(); it != m_vecSamlerStates.end(); it++)
-		{
-			if ((*it)->getDesc() == desc)
-				return *it;
-		}
-
-		// new one
-		GLESSamplerState* pState = EchoNew(GLESSamplerState(desc));
-		m_vecSamlerStates.insert(pState);
-
-		return pState;
+		return EchoNew(GLESSamplerState(desc));
 	}
 
 	bool GLESRenderer::bindShaderProgram(GLESShaderProgram* program)
@@ -716,4 +839,15 @@ namespace Echo
 			m_blendState = state;
 		}
 	}
+
+	void GLESRenderer::onRenderStateDestroyed(RenderState* state)
+	{
+		// the gl state stays as it was, the next set applies its whole desc
+		if (state == m_blendState)
+			m_blendState = nullptr;
+		else if (state == m_depthStencilState)
+			m_depthStencilState = nullptr;
+		else if (state == m_rasterizerState)
+			m_rasterizerState = nullptr;
+	}
 }
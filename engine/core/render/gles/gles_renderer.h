@@ -32,7 +32,7 @@ namespace Echo
 	{
 		typedef vector<GLuint>::type			TexUintList;
 		typedef vector<SamplerState*>::type		SamplerList;
-		typedef array<bool, 9>					NineBoolArray;
+		typedef array<bool, 16>					AttribEnableArray;
 
 	public:
 		GLESRenderer();
@@ -56,6 +56,8 @@ namespace Echo
 
 		// draw
 		virtual void draw(Renderable* renderable) override;
+		virtual void drawInstanced(Renderable** renderables, ui32 count) override;
+		virtual bool isInstancingSupported() const override { return true; }
 
 		// draw in WireFrame mode
 		bool drawWireframe(Renderable* renderable);
@@ -84,7 +86,7 @@ namespace Echo
 		virtual DepthStencilState* createDepthStencilState(const DepthStencilState::DepthStencilDesc& desc) override;
 		virtual BlendState*	createBlendState(const BlendState::BlendDesc& desc) override;
         virtual MultisampleState* createMultisampleState() override { return nullptr; }
-		const SamplerState*	getSamplerState(const SamplerState::SamplerDesc& desc) override;
+		virtual SamplerState* createSamplerState(const SamplerState::SamplerDesc& desc) override;
 	
 		// frame buffer
 		virtual FrameBufferOffScreen* createFrameBufferOffScreen(ui32 width, ui32 height);
@@ -114,6 +116,10 @@ namespace Echo
 		virtual void setDepthStencilState(DepthStencilState* pState);
 		virtual void setBlendState(BlendState* pState);
 
+	protected:
+		// forget the current state, a state interned later may reuse its address
+		virtual void onRenderStateDestroyed(RenderState* state) override;
+
 	protected:
 		//  interal implement
 		virtual Renderable* createRenderable() override;
@@ -124,6 +130,12 @@ namespace Echo
 		// bind texture to slot
 		void bindTexture(GLenum slot, GLenum target, GLuint texture, bool needReset = false);
 
+		// per instance attributes, constant for a single draw and divisor 1 arrays for instanced draws
+		void bindInstanceAttributes(GLESShaderProgram* shaderProgram, Renderable** renderables, ui32 count);
+		void unbindInstanceAttributes(GLESShaderProgram* shaderProgram);
+		void bindInstanceMatrix(GLint location, const Matrix4* matrix, size_t offset);
+		void unbindInstanceMatrix(GLint location);
+
 		bool initializeImpl(const Settings& config);
 		void destroyImpl();
 		virtual void createSystemResource();
@@ -142,8 +154,9 @@ namespace Echo
 		String						m_gpuDesc;
 		ui32						m_screenWidth = 0;
 		ui32						m_screenHeight = 0;
-		std::set<GLESSamplerState*> m_vecSamlerStates;
-		NineBoolArray				m_isVertexAttribArrayEnable;
+		AttribEnableArray			m_isVertexAttribArrayEnable;
+		GPUBuffer*					m_instanceBuffer = nullptr;
+		vector<InstanceData>::type	m_instanceData;
 
 #ifdef ECHO_EDITOR_MODE
 		GPUBuffer*					m_wireFrameIndexBuffer = nullptr;
@@ -136,6 +136,10 @@ namespace Echo
 			}
 		}
 
+		m_instanceWorldLocation = OGLESDebug(glGetAttribLocation(m_glesProgram, "a_InstanceWorld"));
+		m_instanceNormalLocation = OGLESDebug(glGetAttribLocation(m_glesProgram, "a_InstanceNormal"));
+		m_instanceColorLocation = OGLESDebug(glGetAttribLocation(m_glesProgram, "a_InstanceColor"));
+
 		m_isLinked = true;
 
 		return true;
@@ -39,6 +39,11 @@ namespace Echo
 		// get attribute location
 		i32 getAtrribLocation(VertexSemantic vertexSemantic);
 
+		// locations of the per instance world matrix, normal matrix and color, -1 if the shader doesn't declare them
+		GLint getInstanceWorldLocation() const { return m_instanceWorldLocation; }
+		GLint getInstanceNormalLocation() const { return m_instanceNormalLocation; }
+		GLint getInstanceColorLocation() const { return m_instanceColorLocation; }
+
 		// Create
 		virtual bool createShaderProgram(const String& vsContent, const String& psContent) override;
 		void clearShaderProgram();
@@ -53,5 +58,8 @@ namespace Echo
 		GLESRenderable*	m_preRenderable;				// Geomerty
 		AttribLocationArray	m_attribLocationMapping;		// Attribute location
 		GLuint				m_glesProgram = 0;
+		GLint				m_instanceWorldLocation = -1;
+		GLint				m_instanceNormalLocation = -1;
+		GLint				m_instanceColorLocation = -1;
 	};
 }
@@ -105,6 +105,9 @@ namespace Echo
 		MemoryReader memReader(getPath());
 		if (memReader.getSize())
 		{
+			if (memReader.getSize() >= sizeof(ui32) && *memReader.getData<ui32*>() == TEXTURE_COOKED_ETEX)
+				return loadCooked(memReader.getData<Byte*>(), memReader.getSize());
+
 			Image* image = Image::createFromMemory(Buffer(memReader.getSize(), memReader.getData<ui8*>(), false), Image::GetImageFormat(getPath()));
 			if (image)
 			{
@@ -144,6 +147,41 @@ namespace Echo
 		return false;
 	}
 
+	bool GLESTexture2D::loadCooked(const Byte* data, ui32 size)
+	{
+		const CookedTextureHeader* header = nullptr;
+		const CookedTextureLevel* levels = etexValidate(data, size, header);
+		if (!levels)
+		{
+			EchoLogError("Invalid cooked texture [%s].", getPath().c_str());
+			return false;
+		}
+
+		m_pixFmt = PixelFormat(header->m_pixelFormat);
+		m_isCompressed = PixelUtil::IsCompressed(m_pixFmt);
+		m_compressType = Texture::CompressType_Unknown;
+		m_width = header->m_width;
+		m_height = header->m_height;
+		m_depth = header->m_depth;
+		m_numMipmaps = m_isMipMapEnable ? header->m_numMipmaps : 1;
+
+		// mip chain is prebuilt, no decode and no resample
+		for (ui32 level = 0; level < m_numMipmaps; level++)
+		{
+			const CookedTextureLevel& cookedLevel = levels[level];
+			set2DSurfaceData(level, m_pixFmt, m_usage, cookedLevel.m_width, cookedLevel.m_height, Buffer(cookedLevel.m_size, (void*)(data + cookedLevel.m_offset), false));
+		}
+
+		if (m_numMipmaps > 1)
+		{
+			OGLESDebug(glBindTexture(GL_TEXTURE_2D, m_glesTexture));
+			OGLESDebug(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_numMipmaps - 1));
+			OGLESDebug(glBindTexture(GL_TEXTURE_2D, 0));
+		}
+
+		return true;
+	}
+
 	bool GLESTexture2D::unload()
 	{
 		if (m_glesTexture)
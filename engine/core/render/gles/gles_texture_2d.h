@@ -23,6 +23,9 @@ namespace Echo
 		// load
 		virtual bool load() override;
 
+		// load cooked texture (.etex), every level is uploaded as is
+		bool loadCooked(const Byte* data, ui32 size);
+
 		// unload
 		bool unload();
 
@@ -40,6 +40,11 @@ namespace Echo
             case PF_RG32_FLOAT:     return MTLVertexFormatFloat2;
             case PF_RGBA8_UNORM:    return MTLVertexFormatUChar4Normalized;
             case PF_RGBA8_SNORM:    return MTLVertexFormatChar4Normalized;
+            case PF_RGBA8_UINT:     return MTLVertexFormatUChar4;
+            case PF_RG16_SNORM:     return MTLVertexFormatShort2Normalized;
+            case PF_RG16_FLOAT:     return MTLVertexFormatHalf2;
+            case PF_RGBA16_UNORM:   return MTLVertexFormatUShort4Normalized;
+            case PF_RGBA16_FLOAT:   return MTLVertexFormatHalf4;
             case PF_RGB32_FLOAT:    return MTLVertexFormatFloat3;
             case PF_RGBA32_FLOAT:   return MTLVertexFormatFloat4;
             default:  EchoLogError("MapingVertexFormat failed");  return MTLVertexFormatInvalid;
@@ -113,6 +118,10 @@ namespace Echo
         case PF_D16_UNORM:              return MTLPixelFormatDepth16Unorm;
         case PF_D24_UNORM_S8_UINT:      return MTLPixelFormatX24_Stencil8;
         case PF_D32_FLOAT:              return MTLPixelFormatDepth32Float;
+
+        case PF_ETC1:
+        case PF_ETC2_RGB:               return MTLPixelFormatETC2_RGB8;
+        case PF_ETC2_RGBA:              return MTLPixelFormatEAC_RGBA8;
         default:
             {
                 EchoAssertX("Unsupported pixel format [%s].", PixelUtil::GetPixelFormatName(pixFmt).c_str());
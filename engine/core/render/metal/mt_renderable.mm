@@ -89,7 +89,7 @@ namespace Echo
                 Material::UniformValue* uniformValue = m_material->getUniform(uniform->m_name);
                 if (uniform->m_type != SPT_TEXTURE)
                 {
-                    const void* value = m_node ? m_node->getGlobalUniformValue(uniform->m_name) : nullptr;
+                    const void* value = getGlobalUniformValue(uniform->m_name);
                     if (!value) value = uniformValue->getValue();
 
                     shaderProgram->setUniform(uniform->m_name.c_str(), value, uniform->m_type, uniform->m_count);
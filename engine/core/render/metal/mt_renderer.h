@@ -40,7 +40,7 @@ namespace Echo
         virtual DepthStencilState* createDepthStencilState(const DepthStencilState::DepthStencilDesc& desc)override;
         virtual BlendState* createBlendState(const BlendState::BlendDesc& desc) override;
         virtual MultisampleState* createMultisampleState() override { return nullptr; }
-        virtual const SamplerState* getSamplerState(const SamplerState::SamplerDesc& desc) override;
+        virtual SamplerState* createSamplerState(const SamplerState::SamplerDesc& desc) override;
         
         // create shaders
         virtual ShaderProgram* createShaderProgram() override;
@@ -90,7 +90,7 @@ namespace Echo
         return EchoNew(MTBlendState(desc));
     }
 
-    const SamplerState* MTRenderer::getSamplerState(const SamplerState::SamplerDesc& desc)
+    SamplerState* MTRenderer::createSamplerState(const SamplerState::SamplerDesc& desc)
     {
         return EchoNew(MTSamplerState(desc));
     }
@@ -139,10 +139,10 @@ namespace Echo
                 else                                                idxType = MTLIndexTypeUInt16;
 
                 // index count
-                ui32 idxCount = mesh->getIndexCount();
+                ui32 idxCount = mesh->getLodIndexCount(renderable->getLod());
 
                 // index offset
-                NSUInteger idxOffset = mesh->getStartIndex() * mesh->getIndexStride();
+                NSUInteger idxOffset = mesh->getLodStartIndex(renderable->getLod()) * mesh->getIndexStride();
 
                 [m_metalRenderCommandEncoder setRenderPipelineState: mtRenderable->getMetalRenderPipelineState()];
                 [m_metalRenderCommandEncoder setVertexBuffer:mtRenderable->getMetalVertexBuffer() offset:0 atIndex:1];
@@ -24,6 +24,9 @@ namespace Echo
         // load
         virtual bool load() override;
         
+        // load cooked texture (.etex), every level is uploaded as is
+        bool loadCooked(const Byte* data, ui32 size);
+        
         // reset
         void reset();
         
@@ -3,7 +3,9 @@
 #include "mt_renderer.h"
 #include "mt_render_state.h"
 #include "engine/core/io/IO.h"
+#include "engine/core/log/Log.h"
 #include "base/image/image.h"
+#include "base/image/texture_loader.h"
 
 namespace Echo
 {
@@ -38,6 +40,9 @@ namespace Echo
         MemoryReader memReader(getPath());
         if (memReader.getSize())
         {
+            if (memReader.getSize() >= sizeof(ui32) && *memReader.getData<ui32*>() == TEXTURE_COOKED_ETEX)
+                return loadCooked(memReader.getData<Byte*>(), memReader.getSize());
+            
             Buffer commonTextureBuffer(memReader.getSize(), memReader.getData<ui8*>(), false);
             Image* image = Image::createFromMemory(commonTextureBuffer, Image::GetImageFormat(getPath()));
             if (image)
@@ -66,6 +71,64 @@ namespace Echo
         return false;
     }
 
+    bool MTTexture2D::loadCooked(const Byte* data, ui32 size)
+    {
+        const CookedTextureHeader* header = nullptr;
+        const CookedTextureLevel* levels = etexValidate(data, size, header);
+        if (!levels)
+        {
+            EchoLogError("Invalid cooked texture [%s].", getPath().c_str());
+            return false;
+        }
+        
+        // metal doesn't support rgb format, cook these textures to rgba
+        PixelFormat pixFmt = PixelFormat(header->m_pixelFormat);
+        MTLPixelFormat mtPixelFormat = MTMapping::MapPixelFormat(pixFmt);
+        if (mtPixelFormat == MTLPixelFormatInvalid)
+        {
+            EchoLogError("Cooked texture [%s] has a pixel format metal can't sample.", getPath().c_str());
+            return false;
+        }
+        
+        reset();
+        
+        m_pixFmt = pixFmt;
+        m_isCompressed = PixelUtil::IsCompressed(m_pixFmt);
+        m_compressType = Texture::CompressType_Unknown;
+        m_width = header->m_width;
+        m_height = header->m_height;
+        m_depth = header->m_depth;
+        m_numMipmaps = m_isMipMapEnable ? header->m_numMipmaps : 1;
+        
+        m_mtTextureDescriptor = [[MTLTextureDescriptor alloc] init];
+        m_mtTextureDescriptor.pixelFormat = mtPixelFormat;
+        m_mtTextureDescriptor.width = m_width;
+        m_mtTextureDescriptor.height = m_height;
+        m_mtTextureDescriptor.mipmapLevelCount = m_numMipmaps;
+        
+        id<MTLDevice> device = MTRenderer::instance()->getMetalDevice();
+        if(device)
+            m_mtTexture = [device newTextureWithDescriptor:m_mtTextureDescriptor];
+        
+        if(!m_mtTexture)
+            return false;
+        
+        // mip chain is prebuilt, no decode and no resample
+        for (ui32 level = 0; level < m_numMipmaps; level++)
+        {
+            const CookedTextureLevel& cookedLevel = levels[level];
+            
+            // compressed rows are rows of 4x4 blocks
+            ui32 rows = m_isCompressed ? (cookedLevel.m_height + 3) / 4 : cookedLevel.m_height;
+            ui32 bytesPerRow = cookedLevel.m_size / std::max<ui32>(rows, 1);
+            
+            MTLRegion region = { { 0, 0, 0 }, { cookedLevel.m_width, cookedLevel.m_height, 1}};
+            [m_mtTexture replaceRegion:region mipmapLevel:level withBytes:data + cookedLevel.m_offset bytesPerRow:bytesPerRow];
+        }
+        
+        return true;
+    }
+
     void MTTexture2D::setSurfaceData(int level, PixelFormat pixFmt, Dword usage, ui32 width, ui32 height, const Buffer& buff)
     {
         reset();
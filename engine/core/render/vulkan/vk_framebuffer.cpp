@@ -55,6 +55,11 @@ namespace Echo
 
             vkCmdBeginRenderPass(getVkCommandbuffer(), &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
+            // viewport and scissor are dynamic states of every pipeline
+            VkRect2D scissor = { { 0, 0 }, { ui32(m_vkViewport.width), ui32(m_vkViewport.height) } };
+            vkCmdSetViewport(getVkCommandbuffer(), 0, 1, &m_vkViewport);
+            vkCmdSetScissor(getVkCommandbuffer(), 0, 1, &scissor);
+
             return true;
         }
 
@@ -126,9 +131,11 @@ namespace Echo
 
     void VKFramebuffer::createVkDescriptorPool()
     {
-        array<VkDescriptorPoolSize, 1> typeCounts;
+        array<VkDescriptorPoolSize, 2> typeCounts;
         typeCounts[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         typeCounts[0].descriptorCount = 512;
+        typeCounts[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        typeCounts[1].descriptorCount = 512;
 
         // For additional type you need to add new entries in the type count list
         //typeCounts[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -220,6 +227,11 @@ namespace Echo
     {
         VKDebug(vkAcquireNextImageKHR(VKRenderer::instance()->getVkDevice(), m_vkSwapChain, Math::MAX_UI64, m_vkImageAvailableSemaphore, VK_NULL_HANDLE, &m_imageIndex));
 
+        // wait until the command buffer of this image has finished before recording it again, which
+        // also frees the ring buffer space its draws used
+        VKDebug(vkWaitForFences(VKRenderer::instance()->getVkDevice(), 1, &m_waitFences[m_imageIndex], VK_TRUE, UINT64_MAX));
+        VKRenderer::instance()->getRingBuffer()->beginFrame(m_imageIndex);
+
         return VKFramebuffer::begin(backgroundColor, depthValue, clearStencil, stencilValue);
     }
 
@@ -351,8 +363,7 @@ namespace Echo
         // end command buffer before submit
         VKDebug(vkEndCommandBuffer(getVkCommandbuffer()));
 
-        // Use a fence to wait until the command buffer has finished execution before using it again
-        VKDebug(vkWaitForFences(VKRenderer::instance()->getVkDevice(), 1, &m_waitFences[m_imageIndex], VK_TRUE, UINT64_MAX));
+        // the fence was waited for in begin
         VKDebug(vkResetFences(VKRenderer::instance()->getVkDevice(), 1, &m_waitFences[m_imageIndex]));
 
         // wait stage flags
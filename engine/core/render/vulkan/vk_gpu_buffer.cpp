@@ -4,26 +4,6 @@
 
 namespace Echo
 {
-    static ui32 findMemoryType(VkPhysicalDevice vkPhysicalDevice, ui32 typeBits, VkFlags requirementsMask)
-    {
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(vkPhysicalDevice, &memProperties);
-
-        for (ui32 i = 0; i < memProperties.memoryTypeCount; i++)
-        {
-            if ((typeBits & 1) == 1)
-            {
-                if ((memProperties.memoryTypes[i].propertyFlags & requirementsMask) == requirementsMask)
-                    return i;
-            }
-
-            typeBits >>= 1;
-        }
-
-        // no memory types matched, return failure
-        return 0;
-    }
-
     VKBuffer::VKBuffer(GPUBufferType type, Dword usage, const Buffer& buff)
         : GPUBuffer(type, usage, buff)
     {
@@ -37,15 +17,20 @@ namespace Echo
 
     bool VKBuffer::updateData(const Buffer& buff)
     {
-        if (create(buff.getSize()))
+        if (isDynamic())
         {
-            VKDebug(vkBindBufferMemory(VKRenderer::instance()->getVkDevice(), m_vkBuffer, m_vkBufferMemory, 0));
+            // copied to the ring buffer when a draw uses it
+            m_dynamicData.assign(buff.getData(), buff.getData() + buff.getSize());
+            m_size = buff.getSize();
+            m_isUploaded = false;
+
+            return true;
+        }
 
-            // filling the buffer
-            void* data = nullptr;
-            VKDebug(vkMapMemory(VKRenderer::instance()->getVkDevice(), m_vkBufferMemory, 0, buff.getSize(), 0, &data));
-            memcpy(data, buff.getData(), buff.getSize());
-            vkUnmapMemory(VKRenderer::instance()->getVkDevice(), m_vkBufferMemory);
+        if (create(buff.getSize()))
+        {
+            // static memory stays mapped
+            std::memcpy(m_allocation.m_data, buff.getData(), buff.getSize());
 
             return true;
         }
@@ -58,33 +43,58 @@ namespace Echo
 
     }
 
+    VkBuffer VKBuffer::getVkBuffer()
+    {
+        if (isDynamic() && (!m_isUploaded || m_uploadFrame != VKRenderer::instance()->getRingBuffer()->getFrameNumber()))
+            uploadToRingBuffer();
+
+        return m_vkBuffer;
+    }
+
+    void VKBuffer::uploadToRingBuffer()
+    {
+        VKRenderer* vkRenderer = VKRenderer::instance();
+        ui32 alignment = m_type == GBT_UNIFORM ? ui32(vkRenderer->getVkDeviceLimits().minUniformBufferOffsetAlignment) : 16;
+
+        VKRingBuffer::Allocation allocation;
+        if (!m_dynamicData.empty() && vkRenderer->getRingBuffer()->upload(m_dynamicData.data(), m_size, std::max<ui32>(alignment, 1), allocation))
+        {
+            m_vkBuffer = allocation.m_vkBuffer;
+            m_vkOffset = allocation.m_offset;
+        }
+
+        m_uploadFrame = vkRenderer->getRingBuffer()->getFrameNumber();
+        m_isUploaded = true;
+    }
+
     bool VKBuffer::create(ui32 sizeInBytes)
     {
         if (!m_vkBuffer || m_size != sizeInBytes)
         {
             clear();
 
+            VkDevice vkDevice = VKRenderer::instance()->getVkDevice();
+
             VkBufferCreateInfo createInfo = {};
             createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
             createInfo.size = sizeInBytes;
             createInfo.usage = VKMapping::MapGpuBufferUsageFlags(m_type);
 
-            if (VK_SUCCESS == vkCreateBuffer(VKRenderer::instance()->getVkDevice(), &createInfo, nullptr, &m_vkBuffer))
+            if (VK_SUCCESS == vkCreateBuffer(vkDevice, &createInfo, nullptr, &m_vkBuffer))
             {
                 VkMemoryRequirements memRequirements;
-                vkGetBufferMemoryRequirements(VKRenderer::instance()->getVkDevice(), m_vkBuffer, &memRequirements);
+                vkGetBufferMemoryRequirements(vkDevice, m_vkBuffer, &memRequirements);
 
-                VkMemoryAllocateInfo allocInfo = {};
-                allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-                allocInfo.pNext = nullptr;
-                allocInfo.memoryTypeIndex = 0;
-                allocInfo.allocationSize = memRequirements.size;
-                allocInfo.memoryTypeIndex = findMemoryType(VKRenderer::instance()->getVkPhysicalDevice(), memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                // sub allocated from a shared block instead of a dedicated allocation per buffer
+                if (VKRenderer::instance()->getMemoryAllocator()->allocate(memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_allocation))
+                {
+                    VKDebug(vkBindBufferMemory(vkDevice, m_vkBuffer, m_allocation.m_vkMemory, m_allocation.m_offset));
 
-                VKDebug(vkAllocateMemory(VKRenderer::instance()->getVkDevice(), &allocInfo, nullptr, &m_vkBufferMemory));
+                    m_size = sizeInBytes;
+                    return true;
+                }
 
-                m_size = sizeInBytes;
-                return true;
+                clear();
             }
 
             EchoLogError("vulkan crete gpu buffer failed");
@@ -96,14 +106,14 @@ namespace Echo
 
     void VKBuffer::clear()
     {
-        if (m_vkBuffer)
+        if (m_vkBuffer && !isDynamic())
         {
             VKRenderer* vkRenderer = ECHO_DOWN_CAST<VKRenderer*>(Renderer::instance());
             vkDestroyBuffer(vkRenderer->getVkDevice(), m_vkBuffer, nullptr);
-            vkFreeMemory(vkRenderer->getVkDevice(), m_vkBufferMemory, nullptr);
-            m_vkBuffer = VK_NULL_HANDLE;
+            vkRenderer->getMemoryAllocator()->free(m_allocation);
         }
 
+        m_vkBuffer = VK_NULL_HANDLE;
         m_size = 0;
     }
 }
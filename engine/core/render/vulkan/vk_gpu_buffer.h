@@ -2,6 +2,7 @@
 
 #include <engine/core/render/base/gpu_buffer.h>
 #include "vk_render_base.h"
+#include "vk_memory_allocator.h"
 
 namespace Echo
 {
@@ -14,8 +15,12 @@ namespace Echo
         bool updateData(const Buffer& buff);
         void bindBuffer();
 
-        // get vk buffer
-        VkBuffer getVkBuffer() { return m_vkBuffer; }
+        // dynamic buffers live in the ring buffer and are copied there again in every frame they are used
+        bool isDynamic() const { return (m_usage & GBU_CPU_WRITE) != 0; }
+
+        // get vk buffer for the current frame, call before getVkOffset
+        VkBuffer getVkBuffer();
+        VkDeviceSize getVkOffset() const { return m_vkOffset; }
 
     private:
         // create
@@ -24,8 +29,15 @@ namespace Echo
         // clear
         void clear();
 
+        // copy dynamic data to the ring buffer
+        void uploadToRingBuffer();
+
     private:
-        VkBuffer        m_vkBuffer = VK_NULL_HANDLE;
-        VkDeviceMemory  m_vkBufferMemory = VK_NULL_HANDLE;
+        VkBuffer            m_vkBuffer = VK_NULL_HANDLE;
+        VkDeviceSize        m_vkOffset = 0;
+        VKAllocation        m_allocation;
+        vector<Byte>::type  m_dynamicData;
+        ui64                m_uploadFrame = 0;
+        bool                m_isUploaded = false;
     };
 }
@@ -54,6 +54,11 @@ namespace Echo
         case PF_RG32_FLOAT:     return VK_FORMAT_R32G32_SFLOAT;
         case PF_RGBA8_UNORM:    return VK_FORMAT_R8G8B8A8_UNORM;
         case PF_RGBA8_SNORM:    return VK_FORMAT_R8G8B8A8_SNORM;
+        case PF_RGBA8_UINT:     return VK_FORMAT_R8G8B8A8_UINT;
+        case PF_RG16_SNORM:     return VK_FORMAT_R16G16_SNORM;
+        case PF_RG16_FLOAT:     return VK_FORMAT_R16G16_SFLOAT;
+        case PF_RGBA16_UNORM:   return VK_FORMAT_R16G16B16A16_UNORM;
+        case PF_RGBA16_FLOAT:   return VK_FORMAT_R16G16B16A16_SFLOAT;
         case PF_RGB32_FLOAT:    return VK_FORMAT_R32G32B32_SFLOAT;
         case PF_RGBA32_FLOAT:   return VK_FORMAT_R32G32B32A32_SFLOAT;
         default:  EchoLogError("MapingVertexFormat failed");  return VK_FORMAT_UNDEFINED;
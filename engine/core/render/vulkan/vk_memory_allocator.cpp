@@ -0,0 +1,171 @@
+#include "vk_memory_allocator.h"
+#include "vk_renderer.h"
+
+namespace Echo
+{
+    VKMemoryAllocator::~VKMemoryAllocator()
+    {
+        cleanup();
+    }
+
+    bool VKMemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VKAllocation& allocation)
+    {
+        i32 memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+        if (memoryType < 0)
+        {
+            EchoLogError("vulkan no memory type matches the requested properties");
+            return false;
+        }
+
+        if (requirements.size > BlockSize / 2)
+        {
+            i32 block = createBlock(memoryType, requirements.size, true);
+            if (block < 0)
+                return false;
+
+            allocation.m_vkMemory = m_blocks[block].m_vkMemory;
+            allocation.m_offset = 0;
+            allocation.m_data = m_blocks[block].m_data;
+            allocation.m_block = block;
+            return true;
+        }
+
+        // try existing blocks first, a new block is the last resort
+        for (size_t i = 0; i < m_blocks.size(); i++)
+        {
+            if (m_blocks[i].m_allocator && m_blocks[i].m_memoryType == ui32(memoryType) && subAllocate(ui32(i), requirements, allocation))
+                return true;
+        }
+
+        i32 block = createBlock(memoryType, BlockSize, false);
+        return block >= 0 && subAllocate(block, requirements, allocation);
+    }
+
+    bool VKMemoryAllocator::subAllocate(ui32 index, const VkMemoryRequirements& requirements, VKAllocation& allocation)
+    {
+        Block& block = m_blocks[index];
+        ui32 offset = block.m_allocator->allocate(ui32(requirements.size), ui32(requirements.alignment));
+        if (offset != BuddyAllocator::InvalidOffset)
+        {
+            allocation.m_vkMemory = block.m_vkMemory;
+            allocation.m_offset = offset;
+            allocation.m_data = block.m_data ? block.m_data + offset : nullptr;
+            allocation.m_block = index;
+            return true;
+        }
+
+        return false;
+    }
+
+    void VKMemoryAllocator::free(VKAllocation& allocation)
+    {
+        if (allocation.m_vkMemory)
+        {
+            Block& block = m_blocks[allocation.m_block];
+            if (block.m_allocator)
+            {
+                block.m_allocator->free(ui32(allocation.m_offset));
+
+                // keep one empty block per memory type around, so alternating alloc and free doesn't thrash
+                if (block.m_allocator->isEmpty())
+                {
+                    for (size_t i = 0; i < m_blocks.size(); i++)
+                    {
+                        if (i != allocation.m_block && m_blocks[i].m_allocator && m_blocks[i].m_memoryType == block.m_memoryType)
+                        {
+                            destroyBlock(allocation.m_block);
+                            break;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                destroyBlock(allocation.m_block);
+            }
+
+            allocation = VKAllocation();
+        }
+    }
+
+    void VKMemoryAllocator::cleanup()
+    {
+        for (size_t i = 0; i < m_blocks.size(); i++)
+            destroyBlock(ui32(i));
+
+        m_blocks.clear();
+        m_freeBlocks.clear();
+    }
+
+    i32 VKMemoryAllocator::findMemoryType(ui32 typeBits, VkMemoryPropertyFlags properties)
+    {
+        VkPhysicalDeviceMemoryProperties memProperties;
+        vkGetPhysicalDeviceMemoryProperties(VKRenderer::instance()->getVkPhysicalDevice(), &memProperties);
+
+        for (ui32 i = 0; i < memProperties.memoryTypeCount; i++)
+        {
+            if ((typeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+
+        return -1;
+    }
+
+    i32 VKMemoryAllocator::createBlock(ui32 memoryType, VkDeviceSize size, bool dedicated)
+    {
+        VkDevice vkDevice = VKRenderer::instance()->getVkDevice();
+
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryType;
+
+        Block block;
+        block.m_memoryType = memoryType;
+        if (VK_SUCCESS != vkAllocateMemory(vkDevice, &allocInfo, nullptr, &block.m_vkMemory))
+        {
+            EchoLogError("vulkan allocate memory of %d bytes failed", ui32(size));
+            return -1;
+        }
+
+        VkPhysicalDeviceMemoryProperties memProperties;
+        vkGetPhysicalDeviceMemoryProperties(VKRenderer::instance()->getVkPhysicalDevice(), &memProperties);
+        if (memProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            void* data = nullptr;
+            VKDebug(vkMapMemory(vkDevice, block.m_vkMemory, 0, VK_WHOLE_SIZE, 0, &data));
+            block.m_data = (Byte*)data;
+        }
+
+        if (!dedicated)
+            block.m_allocator = EchoNew(BuddyAllocator(ui32(size), MinAllocationSize));
+
+        if (!m_freeBlocks.empty())
+        {
+            ui32 index = m_freeBlocks.back();
+            m_freeBlocks.pop_back();
+            m_blocks[index] = block;
+            return index;
+        }
+
+        m_blocks.push_back(block);
+        return i32(m_blocks.size() - 1);
+    }
+
+    void VKMemoryAllocator::destroyBlock(ui32 index)
+    {
+        Block& block = m_blocks[index];
+        if (block.m_vkMemory)
+        {
+            VkDevice vkDevice = VKRenderer::instance()->getVkDevice();
+            if (block.m_data)
+                vkUnmapMemory(vkDevice, block.m_vkMemory);
+
+            vkFreeMemory(vkDevice, block.m_vkMemory, nullptr);
+            EchoSafeDelete(block.m_allocator, BuddyAllocator);
+
+            block = Block();
+            m_freeBlocks.push_back(index);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "engine/core/memory/BuddyAllocator.h"
+#include "vk_render_base.h"
+
+namespace Echo
+{
+    // a range of device memory handed out by VKMemoryAllocator
+    struct VKAllocation
+    {
+        VkDeviceMemory  m_vkMemory = VK_NULL_HANDLE;
+        VkDeviceSize    m_offset = 0;
+        Byte*           m_data = nullptr;       // mapped address, host visible memory only
+        ui32            m_block = 0;
+    };
+
+    // sub allocates large device memory blocks with a buddy allocator, so resources don't each
+    // pay for a vkAllocateMemory. host visible blocks stay mapped for their whole lifetime
+    class VKMemoryAllocator
+    {
+    public:
+        static const ui32 BlockSize = 32 * 1024 * 1024;
+        static const ui32 MinAllocationSize = 256;
+
+    public:
+        VKMemoryAllocator() {}
+        ~VKMemoryAllocator();
+
+        // allocate, requests larger than a block get dedicated memory
+        bool allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, VKAllocation& allocation);
+        void free(VKAllocation& allocation);
+
+        // release all blocks, the device must be idle
+        void cleanup();
+
+    private:
+        // block
+        struct Block
+        {
+            VkDeviceMemory  m_vkMemory = VK_NULL_HANDLE;
+            Byte*           m_data = nullptr;
+            ui32            m_memoryType = 0;
+            BuddyAllocator* m_allocator = nullptr;     // nullptr for dedicated memory
+        };
+
+        // find memory type
+        i32 findMemoryType(ui32 typeBits, VkMemoryPropertyFlags properties);
+
+        // create block
+        i32 createBlock(ui32 memoryType, VkDeviceSize size, bool dedicated);
+        void destroyBlock(ui32 index);
+
+        // allocate from a block
+        bool subAllocate(ui32 index, const VkMemoryRequirements& requirements, VKAllocation& allocation);
+
+    private:
+        vector<Block>::type     m_blocks;
+        vector<ui32>::type      m_freeBlocks;
+    };
+}
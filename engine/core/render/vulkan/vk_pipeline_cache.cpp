@@ -0,0 +1,423 @@
+#include "vk_pipeline_cache.h"
+#include "vk_renderer.h"
+#include "vk_mapping.h"
+#include "vk_shader_program.h"
+#include "vk_render_state.h"
+#include "engine/core/io/IO.h"
+
+namespace Echo
+{
+    static const char* g_pipelineCacheFile = "User://vk_pipeline_cache.bin";
+    static const char* g_pipelineRecordsFile = "User://vk_pipelines.txt";
+
+    VKPipelineCache::~VKPipelineCache()
+    {
+        cleanup();
+    }
+
+    void VKPipelineCache::init()
+    {
+        load();
+
+        m_isRunning = true;
+        m_prewarmThread.Start(&VKPipelineCache::prewarmThread, this);
+    }
+
+    void VKPipelineCache::cleanup()
+    {
+        if (m_isRunning)
+        {
+            {
+                EE_LOCK_MUTEX(m_mutex)
+                m_isRunning = false;
+                m_prewarmQueue.clear();
+            }
+
+            m_prewarmEvent.SetEvent();
+            m_prewarmThread.Join();
+        }
+
+        if (m_vkPipelineCache)
+        {
+            save();
+
+            VkDevice vkDevice = VKRenderer::instance()->getVkDevice();
+            for (auto& it : m_pipelines)
+                vkDestroyPipeline(vkDevice, it.second.m_vkPipeline, nullptr);
+
+            vkDestroyPipelineCache(vkDevice, m_vkPipelineCache, nullptr);
+            m_vkPipelineCache = VK_NULL_HANDLE;
+        }
+
+        m_pipelines.clear();
+        m_prewarmedPrograms.clear();
+    }
+
+    VkPipeline VKPipelineCache::getVkPipeline(const PipelineDesc& desc)
+    {
+        if (!desc.m_program || !desc.m_program->isLinked() || !desc.m_vkRenderPass)
+            return VK_NULL_HANDLE;
+
+        PipelineBuild build;
+        build.m_key = makeKey(desc);
+        {
+            EE_LOCK_MUTEX(m_mutex)
+            auto it = m_pipelines.find(build.m_key);
+            if (it != m_pipelines.end())
+                return it->second.m_vkPipeline;
+        }
+
+        if (!prepareBuild(desc, build))
+            return VK_NULL_HANDLE;
+
+        VkPipeline vkPipeline = addPipeline(build, createVkPipeline(build));
+        if (vkPipeline && !desc.m_program->getPath().empty())
+        {
+            if (m_records.insert(makeRecord(desc)).second)
+                m_isRecordsDirty = true;
+
+            prewarm(desc);
+        }
+
+        return vkPipeline;
+    }
+
+    void VKPipelineCache::removeProgram(VKShaderProgram* program)
+    {
+        {
+            EE_LOCK_MUTEX(m_mutex)
+            for (auto it = m_prewarmQueue.begin(); it != m_prewarmQueue.end();)
+                it = it->m_program == program ? m_prewarmQueue.erase(it) : it + 1;
+
+            m_prewarmedPrograms.erase(program);
+        }
+
+        // wait for a build of this program that is already running
+        {
+            EE_LOCK_MUTEX(m_buildMutex)
+        }
+
+        EE_LOCK_MUTEX(m_mutex)
+        for (auto it = m_pipelines.begin(); it != m_pipelines.end();)
+        {
+            if (it->second.m_program == program)
+            {
+                vkDestroyPipeline(VKRenderer::instance()->getVkDevice(), it->second.m_vkPipeline, nullptr);
+                it = m_pipelines.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    String VKPipelineCache::makeKey(const PipelineDesc& desc)
+    {
+        ShaderProgram* program = desc.m_program;
+        // interned states are keyed by desc hash, a released state's address may be reused by another desc
+        String key = StringUtil::Format("%p|%p|%llx|%llx|%llx|%p|%d|%d|", program, desc.m_vkRenderPass, (unsigned long long)program->getBlendState()->getHash(), (unsigned long long)program->getRasterizerState()->getHash(),
+            (unsigned long long)program->getDepthStencilState()->getHash(), program->getMultisampleState(), desc.m_topology, desc.m_vertexStride);
+        for (const VertexElement& element : desc.m_vertexElements)
+            key += StringUtil::Format("%d:%d,", element.m_semantic, element.m_pixFmt);
+
+        return key;
+    }
+
+    String VKPipelineCache::makeRecord(const PipelineDesc& desc)
+    {
+        String record = StringUtil::Format("%s|%d|%d|", desc.m_program->getPath().c_str(), desc.m_topology, desc.m_vertexStride);
+        for (const VertexElement& element : desc.m_vertexElements)
+            record += StringUtil::Format("%d:%d,", element.m_semantic, element.m_pixFmt);
+
+        return record;
+    }
+
+    bool VKPipelineCache::parseRecord(const String& record, PipelineDesc& desc, String& shaderPath)
+    {
+        StringArray fields = StringUtil::Split(record, "|");
+        if (fields.size() < 3)
+            return false;
+
+        shaderPath = fields[0];
+        desc.m_topology = Mesh::TopologyType(StringUtil::ParseI32(fields[1]));
+        desc.m_vertexStride = StringUtil::ParseI32(fields[2]);
+        desc.m_vertexElements.clear();
+        if (fields.size() > 3)
+        {
+            for (const String& element : StringUtil::Split(fields[3], ","))
+            {
+                StringArray values = StringUtil::Split(element, ":");
+                if (values.size() == 2)
+                    desc.m_vertexElements.emplace_back(VertexSemantic(StringUtil::ParseI32(values[0])), PixelFormat(StringUtil::ParseI32(values[1])));
+            }
+        }
+
+        return true;
+    }
+
+    bool VKPipelineCache::prepareBuild(const PipelineDesc& desc, PipelineBuild& build)
+    {
+        VKShaderProgram* program = desc.m_program;
+        build.m_key = makeKey(desc);
+        build.m_program = program;
+        build.m_vkRenderPass = desc.m_vkRenderPass;
+        build.m_vkTopology = VKMapping::MapPrimitiveTopology(desc.m_topology);
+        build.m_vertexStride = desc.m_vertexStride;
+        VKBlendState* blendState = ECHO_DOWN_CAST<VKBlendState*>(program->getBlendState());
+        build.m_vkBlendState = *blendState->getVkCreateInfo();
+        build.m_vkBlendAttachment = *blendState->getVkAttachmentState();
+        build.m_vkRasterizationState = *ECHO_DOWN_CAST<VKRasterizerState*>(program->getRasterizerState())->getVkCreateInfo();
+        build.m_vkDepthStencilState = *ECHO_DOWN_CAST<VKDepthStencilState*>(program->getDepthStencilState())->getVkCreateInfo();
+        build.m_vkMultisampleState = *ECHO_DOWN_CAST<VKMultisampleState*>(program->getMultisampleState())->getVkCreateInfo();
+
+        // vertex attributes by semantic, reflection isn't thread safe so it happens here
+        build.m_vkAttributes.clear();
+        const spirv_cross::Compiler* compiler = program->getSpirvShaderCompiler(ShaderProgram::VS);
+        spirv_cross::ShaderResources vertexShaderResources = program->getSpirvShaderResources(ShaderProgram::VS);
+        ui32 elementOffset = 0;
+        for (const VertexElement& element : desc.m_vertexElements)
+        {
+            String attributeName = VKMapping::MapVertexSemanticString(element.m_semantic);
+            for (auto& resource : vertexShaderResources.stage_inputs)
+            {
+                if (resource.name == attributeName)
+                {
+                    VkVertexInputAttributeDescription attributeDescription;
+                    attributeDescription.binding = compiler->get_decoration(resource.id, spv::DecorationBinding);
+                    attributeDescription.location = compiler->get_decoration(resource.id, spv::DecorationLocation);
+                    attributeDescription.format = VKMapping::MapVertexFormat(element.m_pixFmt);
+                    attributeDescription.offset = elementOffset;
+                    build.m_vkAttributes.emplace_back(attributeDescription);
+                    break;
+                }
+            }
+
+            elementOffset += PixelUtil::GetPixelSize(element.m_pixFmt);
+        }
+
+        // world matrix, normal matrix and color per instance from binding 1, a mat4 takes four locations
+        build.m_isInstancing = program->isInstancing();
+        for (auto& resource : vertexShaderResources.stage_inputs)
+        {
+            if (resource.name == "a_InstanceWorld")
+            {
+                ui32 location = compiler->get_decoration(resource.id, spv::DecorationLocation);
+                for (ui32 i = 0; i < 4; i++)
+                    build.m_vkAttributes.push_back({ location + i, 1, VK_FORMAT_R32G32B32A32_SFLOAT, ui32(offsetof(Renderer::InstanceData, m_world) + i * sizeof(Vector4)) });
+            }
+            else if (resource.name == "a_InstanceNormal")
+            {
+                ui32 location = compiler->get_decoration(resource.id, spv::DecorationLocation);
+                for (ui32 i = 0; i < 4; i++)
+                    build.m_vkAttributes.push_back({ location + i, 1, VK_FORMAT_R32G32B32A32_SFLOAT, ui32(offsetof(Renderer::InstanceData, m_normal) + i * sizeof(Vector4)) });
+            }
+            else if (resource.name == "a_InstanceColor")
+            {
+                ui32 location = compiler->get_decoration(resource.id, spv::DecorationLocation);
+                build.m_vkAttributes.push_back({ location, 1, VK_FORMAT_R32G32B32A32_SFLOAT, ui32(offsetof(Renderer::InstanceData, m_color)) });
+            }
+        }
+
+        return program->isLinked();
+    }
+
+    VkPipeline VKPipelineCache::createVkPipeline(const PipelineBuild& build)
+    {
+        array<VkVertexInputBindingDescription, 2> vertexInputBindings = {};
+        vertexInputBindings[0].binding = 0;
+        vertexInputBindings[0].stride = build.m_vertexStride;
+        vertexInputBindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        vertexInputBindings[1].binding = 1;
+        vertexInputBindings[1].stride = sizeof(Renderer::InstanceData);
+        vertexInputBindings[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo = {};
+        vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputStateCreateInfo.vertexBindingDescriptionCount = build.m_isInstancing ? 2 : 1;
+        vertexInputStateCreateInfo.pVertexBindingDescriptions = vertexInputBindings.data();
+        vertexInputStateCreateInfo.vertexAttributeDescriptionCount = build.m_vkAttributes.size();
+        vertexInputStateCreateInfo.pVertexAttributeDescriptions = build.m_vkAttributes.data();
+
+        VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo = {};
+        pipelineInputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        pipelineInputAssemblyStateCreateInfo.topology = build.m_vkTopology;
+
+        // viewport and scissor are dynamic, so pipelines don't depend on the window size
+        VkPipelineViewportStateCreateInfo viewportState = {};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        array<VkDynamicState, 2> dynamicStateEnables = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+        VkPipelineDynamicStateCreateInfo dynamicState = {};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = dynamicStateEnables.size();
+        dynamicState.pDynamicStates = dynamicStateEnables.data();
+
+        VkGraphicsPipelineCreateInfo pipelineInfo = {};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.layout = build.m_program->getVkPipelineLayout();
+        pipelineInfo.renderPass = build.m_vkRenderPass;
+        pipelineInfo.stageCount = build.m_program->getVkShaderStageCreateInfo().size();
+        pipelineInfo.pStages = build.m_program->getVkShaderStageCreateInfo().data();
+        pipelineInfo.pVertexInputState = &vertexInputStateCreateInfo;
+        pipelineInfo.pInputAssemblyState = &pipelineInputAssemblyStateCreateInfo;
+        pipelineInfo.pViewportState = &viewportState;
+        // the blend state points at the attachment copy of this build
+        VkPipelineColorBlendStateCreateInfo blendState = build.m_vkBlendState;
+        blendState.pAttachments = &build.m_vkBlendAttachment;
+
+        pipelineInfo.pDepthStencilState = &build.m_vkDepthStencilState;
+        pipelineInfo.pRasterizationState = &build.m_vkRasterizationState;
+        pipelineInfo.pMultisampleState = &build.m_vkMultisampleState;
+        pipelineInfo.pColorBlendState = &blendState;
+        pipelineInfo.pDynamicState = &dynamicState;
+
+        // the pipeline cache is synchronized by the driver, so the prewarm thread shares it
+        VkPipeline vkPipeline = VK_NULL_HANDLE;
+        VKDebug(vkCreateGraphicsPipelines(VKRenderer::instance()->getVkDevice(), m_vkPipelineCache, 1, &pipelineInfo, nullptr, &vkPipeline));
+
+        return vkPipeline;
+    }
+
+    VkPipeline VKPipelineCache::addPipeline(const PipelineBuild& build, VkPipeline vkPipeline)
+    {
+        if (!vkPipeline)
+            return VK_NULL_HANDLE;
+
+        EE_LOCK_MUTEX(m_mutex)
+        auto it = m_pipelines.find(build.m_key);
+        if (it != m_pipelines.end())
+        {
+            vkDestroyPipeline(VKRenderer::instance()->getVkDevice(), vkPipeline, nullptr);
+            return it->second.m_vkPipeline;
+        }
+
+        Pipeline& pipeline = m_pipelines[build.m_key];
+        pipeline.m_vkPipeline = vkPipeline;
+        pipeline.m_program = build.m_program;
+
+        return vkPipeline;
+    }
+
+    void VKPipelineCache::prewarm(const PipelineDesc& desc)
+    {
+        if (!m_isRunning || !m_prewarmedPrograms.insert(desc.m_program).second)
+            return;
+
+        const String& shaderPath = desc.m_program->getPath();
+        for (const String& record : m_records)
+        {
+            PipelineDesc recordDesc = desc;
+            String recordShaderPath;
+            if (parseRecord(record, recordDesc, recordShaderPath) && recordShaderPath == shaderPath)
+            {
+                PipelineBuild build;
+                if (prepareBuild(recordDesc, build))
+                {
+                    EE_LOCK_MUTEX(m_mutex)
+                    if (m_pipelines.find(build.m_key) == m_pipelines.end())
+                        m_prewarmQueue.push_back(build);
+                }
+            }
+        }
+
+        m_prewarmEvent.SetEvent();
+    }
+
+    void VKPipelineCache::prewarmThread(void* param)
+    {
+        VKPipelineCache* cache = (VKPipelineCache*)param;
+        while (true)
+        {
+            cache->m_prewarmEvent.WaitEvent();
+
+            // compile until the queue is empty, the build mutex is taken before a build leaves the queue
+            while (true)
+            {
+                EE_LOCK_MUTEX(cache->m_buildMutex)
+
+                PipelineBuild build;
+                {
+                    EE_LOCK_MUTEX(cache->m_mutex)
+                    if (!cache->m_isRunning)
+                        return;
+
+                    if (cache->m_prewarmQueue.empty())
+                        break;
+
+                    build = cache->m_prewarmQueue.front();
+                    cache->m_prewarmQueue.pop_front();
+                }
+
+                cache->addPipeline(build, cache->createVkPipeline(build));
+            }
+        }
+    }
+
+    void VKPipelineCache::load()
+    {
+        VkPipelineCacheCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+        // only hand the driver data written by the same device and driver
+        vector<Byte>::type initialData;
+        if (IO::instance()->isExist(g_pipelineCacheFile))
+        {
+            MemoryReader reader(g_pipelineCacheFile);
+            if (reader.getSize() >= 16 + VK_UUID_SIZE)
+            {
+                const VkPhysicalDeviceProperties& properties = VKRenderer::instance()->getVkDeviceProperties();
+                const ui32* header = reader.getData<const ui32*>();
+                if (header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header[2] == properties.vendorID && header[3] == properties.deviceID &&
+                    std::memcmp(header + 4, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0)
+                {
+                    initialData.assign(reader.getData<const Byte*>(), reader.getData<const Byte*>() + reader.getSize());
+                }
+            }
+        }
+
+        createInfo.initialDataSize = initialData.size();
+        createInfo.pInitialData = initialData.data();
+        VKDebug(vkCreatePipelineCache(VKRenderer::instance()->getVkDevice(), &createInfo, nullptr, &m_vkPipelineCache));
+
+        // vertex layouts shaders were drawn with
+        if (IO::instance()->isExist(g_pipelineRecordsFile))
+        {
+            for (const String& record : StringUtil::Split(IO::instance()->loadFileToString(g_pipelineRecordsFile), "\r\n"))
+                m_records.insert(record);
+        }
+    }
+
+    void VKPipelineCache::save()
+    {
+        size_t size = 0;
+        VkDevice vkDevice = VKRenderer::instance()->getVkDevice();
+        if (VK_SUCCESS == vkGetPipelineCacheData(vkDevice, m_vkPipelineCache, &size, nullptr) && size)
+        {
+            vector<Byte>::type data(size);
+            if (VK_SUCCESS == vkGetPipelineCacheData(vkDevice, m_vkPipelineCache, &size, data.data()))
+            {
+                DataStream* stream = IO::instance()->open(g_pipelineCacheFile, DataStream::WRITE);
+                if (stream && stream->isWriteable())
+                {
+                    stream->write(data.data(), size);
+                    stream->close();
+                }
+
+                EchoSafeDelete(stream, DataStream);
+            }
+        }
+
+        if (m_isRecordsDirty)
+        {
+            String records;
+            for (const String& record : m_records)
+                records += record + "\n";
+
+            IO::instance()->saveStringToFile(g_pipelineRecordsFile, records);
+            m_isRecordsDirty = false;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <unordered_map>
+#include "engine/core/thread/Threading.h"
+#include "base/mesh/mesh.h"
+#include "vk_render_base.h"
+
+namespace Echo
+{
+    class VKShaderProgram;
+
+    // graphics pipelines shared by every renderable with the same shader, states, vertex layout
+    // and render pass. compiled pipelines go through a VkPipelineCache saved to the user directory,
+    // and the vertex layouts a shader was drawn with are recorded, so the next run can build them
+    // in the background as soon as the shader is first used
+    class VKPipelineCache
+    {
+    public:
+        // what a pipeline is built from
+        struct PipelineDesc
+        {
+            VKShaderProgram*    m_program = nullptr;
+            VkRenderPass        m_vkRenderPass = VK_NULL_HANDLE;
+            Mesh::TopologyType  m_topology = Mesh::TT_TRIANGLELIST;
+            ui32                m_vertexStride = 0;
+            VertexElementList   m_vertexElements;
+        };
+
+    public:
+        VKPipelineCache() {}
+        ~VKPipelineCache();
+
+        // load the cache and start the prewarm thread, the device has to exist
+        void init();
+
+        // save the cache and destroy all pipelines, the device must be idle
+        void cleanup();
+
+        // shared pipeline for desc, compiled on first request
+        VkPipeline getVkPipeline(const PipelineDesc& desc);
+
+        // destroy the pipelines of a shader program that is going away
+        void removeProgram(VKShaderProgram* program);
+
+    private:
+        // everything vkCreateGraphicsPipelines needs, gathered on the main thread
+        struct PipelineBuild
+        {
+            String                                              m_key;
+            VKShaderProgram*                                    m_program = nullptr;
+            VkRenderPass                                        m_vkRenderPass = VK_NULL_HANDLE;
+            VkPrimitiveTopology                                 m_vkTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            ui32                                                m_vertexStride = 0;
+            bool                                                m_isInstancing = false;
+            vector<VkVertexInputAttributeDescription>::type     m_vkAttributes;
+            // copies, render states are freed when released while a prewarm build is queued
+            VkPipelineColorBlendStateCreateInfo                 m_vkBlendState = {};
+            VkPipelineColorBlendAttachmentState                 m_vkBlendAttachment = {};
+            VkPipelineRasterizationStateCreateInfo              m_vkRasterizationState = {};
+            VkPipelineDepthStencilStateCreateInfo               m_vkDepthStencilState = {};
+            VkPipelineMultisampleStateCreateInfo                m_vkMultisampleState = {};
+        };
+
+        // pipeline
+        struct Pipeline
+        {
+            VkPipeline          m_vkPipeline = VK_NULL_HANDLE;
+            VKShaderProgram*    m_program = nullptr;
+        };
+
+        // key of desc
+        static String makeKey(const PipelineDesc& desc);
+
+        // record line of desc, shader path, topology, stride and vertex elements
+        static String makeRecord(const PipelineDesc& desc);
+        static bool parseRecord(const String& record, PipelineDesc& desc, String& shaderPath);
+
+        // gather
+        bool prepareBuild(const PipelineDesc& desc, PipelineBuild& build);
+
+        // compile
+        VkPipeline createVkPipeline(const PipelineBuild& build);
+
+        // add a compiled pipeline, returns the one kept when another thread was faster
+        VkPipeline addPipeline(const PipelineBuild& build, VkPipeline vkPipeline);
+
+        // queue the recorded layouts of a shader for the prewarm thread
+        void prewarm(const PipelineDesc& desc);
+
+        // prewarm thread
+        static void prewarmThread(void* cache);
+
+        // load|save
+        void load();
+        void save();
+
+    private:
+        VkPipelineCache                             m_vkPipelineCache = VK_NULL_HANDLE;
+        std::unordered_map<String, Pipeline>        m_pipelines;
+        set<String>::type                           m_records;
+        set<VKShaderProgram*>::type                 m_prewarmedPrograms;
+        bool                                        m_isRecordsDirty = false;
+        deque<PipelineBuild>::type                  m_prewarmQueue;
+        Mutex                                       m_mutex;            // pipelines and prewarm queue
+        Mutex                                       m_buildMutex;       // held while the prewarm thread compiles
+        ThreadEvent                                 m_prewarmEvent;
+        Thread                                      m_prewarmThread;
+        bool                                        m_isRunning = false;
+    };
+}
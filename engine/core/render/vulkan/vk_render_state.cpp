@@ -6,14 +6,14 @@ namespace Echo
     VKBlendState::VKBlendState(const BlendDesc &desc)
         : BlendState(desc)
     {
-        VkPipelineColorBlendAttachmentState blendAttachState = {};
-        blendAttachState.colorWriteMask = 0xf;
+        m_vkAttachmentState = {};
+        m_vkAttachmentState.colorWriteMask = 0xf;
 
         m_vkCreateInfo = {};
         m_vkCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         m_vkCreateInfo.logicOp = VK_LOGIC_OP_COPY;
         m_vkCreateInfo.attachmentCount = 1;
-        m_vkCreateInfo.pAttachments = &blendAttachState;
+        m_vkCreateInfo.pAttachments = &m_vkAttachmentState;
     }
 
     VKDepthStencilState::VKDepthStencilState(const DepthStencilDesc& desc)
@@ -13,9 +13,11 @@ namespace Echo
 
         // get vk create info
         const VkPipelineColorBlendStateCreateInfo* getVkCreateInfo() { return &m_vkCreateInfo; }
+        const VkPipelineColorBlendAttachmentState* getVkAttachmentState() { return &m_vkAttachmentState; }
 
     private:
         VkPipelineColorBlendStateCreateInfo     m_vkCreateInfo;
+        VkPipelineColorBlendAttachmentState     m_vkAttachmentState;
 	};
 	
 	class VKDepthStencilState : public DepthStencilState
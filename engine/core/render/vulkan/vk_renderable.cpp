@@ -21,112 +21,25 @@ namespace Echo
 
     void VKRenderable::createVkPipeline()
     {
-        destroyVkPipeline();
-
         VKShaderProgram* vkShaderProgram = ECHO_DOWN_CAST<VKShaderProgram*>(m_material->getShader());
-        if (m_mesh && vkShaderProgram && vkShaderProgram->isLinked() && VKFramebuffer::current())
+        if (m_mesh && vkShaderProgram && VKFramebuffer::current())
         {
-            VKFramebuffer* vkFrameBuffer = VKFramebuffer::current();
-
-            VkVertexInputBindingDescription vertexInputBinding = {};
-            vertexInputBinding.binding = 0;
-            vertexInputBinding.stride = m_mesh->getVertexStride();
-            vertexInputBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-            vector<VkVertexInputAttributeDescription>::type viAttributeDescriptions;
-            buildVkVertexInputAttributeDescriptions(vkShaderProgram, m_mesh->getVertexElements(), viAttributeDescriptions);
-
-            VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo = {};
-            vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-            vertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
-            vertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexInputBinding;
-            vertexInputStateCreateInfo.vertexAttributeDescriptionCount = viAttributeDescriptions.size();
-            vertexInputStateCreateInfo.pVertexAttributeDescriptions = viAttributeDescriptions.data();
-
-            VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo = {};
-            pipelineInputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-            pipelineInputAssemblyStateCreateInfo.topology = VKMapping::MapPrimitiveTopology(m_mesh->getTopologyType());
-
-            vector<VkDynamicState>::type dynamicStateEnables = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-            VkPipelineDynamicStateCreateInfo dynamicState = {};
-            dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-            dynamicState.dynamicStateCount = dynamicStateEnables.size();
-            dynamicState.pDynamicStates = dynamicStateEnables.data();
-
-            VkGraphicsPipelineCreateInfo pipelineInfo = {};
-            pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-            pipelineInfo.layout = vkShaderProgram->getVkPipelineLayout();
-            pipelineInfo.renderPass = vkFrameBuffer->getVkRenderPass();
-            pipelineInfo.stageCount = vkShaderProgram->getVkShaderStageCreateInfo().size();
-            pipelineInfo.pStages = vkShaderProgram->getVkShaderStageCreateInfo().data();
-            pipelineInfo.pVertexInputState = &vertexInputStateCreateInfo;
-            pipelineInfo.pInputAssemblyState = &pipelineInputAssemblyStateCreateInfo;
-            pipelineInfo.pViewportState = vkFrameBuffer->getVkViewportStateCreateInfo();
-            pipelineInfo.pDepthStencilState = getVkDepthStencilStateCrateInfo();
-            pipelineInfo.pRasterizationState = getVkRasterizationStateCreateInfo();
-            pipelineInfo.pMultisampleState = getVkMultiSampleStateCreateInfo();
-            pipelineInfo.pColorBlendState = getVkColorBlendStateCreateInfo();
-            pipelineInfo.pDynamicState = &dynamicState;
-
-            VKDebug(vkCreateGraphicsPipelines(VKRenderer::instance()->getVkDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_vkPipeline));
+            // pipelines with the same shader, states, vertex layout and render pass are shared
+            VKPipelineCache::PipelineDesc desc;
+            desc.m_program = vkShaderProgram;
+            desc.m_vkRenderPass = VKFramebuffer::current()->getVkRenderPass();
+            desc.m_topology = m_mesh->getTopologyType();
+            desc.m_vertexStride = m_mesh->getVertexStride();
+            desc.m_vertexElements = m_mesh->getVertexElements();
+
+            m_vkPipeline = VKRenderer::instance()->getPipelineCache()->getVkPipeline(desc);
         }
-    }
-
-    void VKRenderable::destroyVkPipeline()
-    {
-        if (m_vkPipeline)
+        else
         {
-            vkDestroyPipeline(VKRenderer::instance()->getVkDevice(), m_vkPipeline, nullptr);
             m_vkPipeline = VK_NULL_HANDLE;
         }
     }
 
-    bool VKRenderable::getVkVertexAttributeBySemantic(VertexSemantic semantic, spirv_cross::Resource& oResource)
-    {
-        String attributeName = VKMapping::MapVertexSemanticString(semantic);
-        VKShaderProgram* vkShaderProgram = ECHO_DOWN_CAST<VKShaderProgram*>(m_material->getShader());
-        if (vkShaderProgram && vkShaderProgram->isLinked())
-        {
-            spirv_cross::ShaderResources vertexShaderResources = vkShaderProgram->getSpirvShaderResources(ShaderProgram::VS);
-            for (auto& resource : vertexShaderResources.stage_inputs)
-            {
-                if (resource.name == attributeName)
-                {
-                    oResource = resource;
-                    return true;
-                }
-            }
-        }
-
-        return false;
-    }
-
-    void VKRenderable::buildVkVertexInputAttributeDescriptions(VKShaderProgram* vkShaderProgram, const VertexElementList& vertElements, vector<VkVertexInputAttributeDescription>::type& viAttributeDescriptions)
-    {
-        if (!vertElements.empty())
-        {
-            const i32 bufferIdx = 1;
-            ui32 elementOffset = 0;
-            for (size_t i = 0; i < vertElements.size(); i++)
-            {
-                spirv_cross::Resource spirvResource = {};
-                if (getVkVertexAttributeBySemantic(vertElements[i].m_semantic, spirvResource))
-                {
-                    const spirv_cross::Compiler* compiler = vkShaderProgram->getSpirvShaderCompiler(ShaderProgram::VS);
-
-                    VkVertexInputAttributeDescription attributeDescription;
-                    attributeDescription.binding = compiler->get_decoration(spirvResource.id, spv::DecorationBinding);
-                    attributeDescription.location = compiler->get_decoration(spirvResource.id, spv::DecorationLocation);
-                    attributeDescription.format = VKMapping::MapVertexFormat(vertElements[i].m_pixFmt);
-                    attributeDescription.offset = elementOffset;
-                    viAttributeDescriptions.emplace_back(attributeDescription);
-                }
-
-                elementOffset += PixelUtil::GetPixelSize(vertElements[i].m_pixFmt);
-            }
-        }
-    }
-
     void VKRenderable::bindRenderState()
     {
 
@@ -144,7 +57,7 @@ namespace Echo
                 Material::UniformValue* uniformValue = m_material->getUniform(uniform->m_name);
 				if (uniform->m_type != SPT_TEXTURE)
 				{
-					const void* value = m_node ? m_node->getGlobalUniformValue(uniform->m_name) : nullptr;
+					const void* value = getGlobalUniformValue(uniform->m_name);
 					if (!value) value = uniformValue->getValue();
 
                     vkShaderProgram->setUniform(uniform->m_name.c_str(), value, uniform->m_type, uniform->m_count);
@@ -172,39 +85,16 @@ namespace Echo
         VKBuffer* vertexBuffer = ECHO_DOWN_CAST<VKBuffer*>(m_mesh->getVertexBuffer());
         if (vertexBuffer)
         {
-            VkDeviceSize offsets[1] = { 0 };
             VkBuffer vkBuffer = vertexBuffer->getVkBuffer();
+            VkDeviceSize offsets[1] = { vertexBuffer->getVkOffset() };
             vkCmdBindVertexBuffers(VKFramebuffer::current()->getVkCommandbuffer(), 0, 1, &vkBuffer, offsets);
         }
 
         VKBuffer* indexBuffer = ECHO_DOWN_CAST<VKBuffer*>(m_mesh->getIndexBuffer());
         if (indexBuffer)
         {
-            vkCmdBindIndexBuffer(VKFramebuffer::current()->getVkCommandbuffer(), indexBuffer->getVkBuffer(), 0, VK_INDEX_TYPE_UINT32);
+            VkBuffer vkBuffer = indexBuffer->getVkBuffer();
+            vkCmdBindIndexBuffer(VKFramebuffer::current()->getVkCommandbuffer(), vkBuffer, indexBuffer->getVkOffset(), m_mesh->getIndexStride() == sizeof(ui32) ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16);
         }
     }
-
-    const VkPipelineColorBlendStateCreateInfo* VKRenderable::getVkColorBlendStateCreateInfo()
-    {
-        VKBlendState* vkState = ECHO_DOWN_CAST<VKBlendState*>( m_material->getShader()->getBlendState());
-        return vkState->getVkCreateInfo();
-    }
-
-    const VkPipelineRasterizationStateCreateInfo* VKRenderable::getVkRasterizationStateCreateInfo()
-    {
-        VKRasterizerState* vkState = ECHO_DOWN_CAST<VKRasterizerState*>(m_material->getShader()->getRasterizerState());
-        return vkState->getVkCreateInfo();
-    }
-
-    const VkPipelineDepthStencilStateCreateInfo* VKRenderable::getVkDepthStencilStateCrateInfo()
-    {
-        VKDepthStencilState* vkState = ECHO_DOWN_CAST<VKDepthStencilState*>(m_material->getShader()->getDepthStencilState());
-        return vkState->getVkCreateInfo();
-    }
-
-    const VkPipelineMultisampleStateCreateInfo* VKRenderable::getVkMultiSampleStateCreateInfo()
-    {
-        VKMultisampleState* vkState = ECHO_DOWN_CAST<VKMultisampleState*>(m_material->getShader()->getMultisampleState());
-        return vkState->getVkCreateInfo();
-    }
 }
@@ -17,9 +17,8 @@ namespace Echo
         void bindShaderParams();
         void bindGeometry();
 
-        // create|destroy vk pipeline
+        // get shared vk pipeline from the pipeline cache
         void createVkPipeline();
-        void destroyVkPipeline();
 
     public:
         // get vk pipeline
@@ -29,25 +28,6 @@ namespace Echo
         // link shader and program
         virtual void setMesh(MeshPtr mesh) override;
 
-	private:
-        // build vertex input attribute
-        void buildVkVertexInputAttributeDescriptions(VKShaderProgram* vkShaderProgram, const VertexElementList& vertElements, vector<VkVertexInputAttributeDescription>::type& viAttributeDescriptions);
-
-        // get vertex attribute by semantic
-        bool getVkVertexAttributeBySemantic(VertexSemantic semantic, spirv_cross::Resource& oResource);
-
-        // get blend state create info
-        const VkPipelineColorBlendStateCreateInfo* getVkColorBlendStateCreateInfo();
-
-        // get rasterization state create info
-        const VkPipelineRasterizationStateCreateInfo* getVkRasterizationStateCreateInfo();
-
-        // get depth stencil state create info
-        const VkPipelineDepthStencilStateCreateInfo* getVkDepthStencilStateCrateInfo();
-
-        // get multisample state create creteinfo
-        const VkPipelineMultisampleStateCreateInfo* getVkMultiSampleStateCreateInfo();
-
 	private:
 		VkPipeline          m_vkPipeline = VK_NULL_HANDLE;
 	};
@@ -7,6 +7,7 @@
 #include "vk_gpu_buffer.h"
 #include "vk_framebuffer.h"
 #include "vk_texture.h"
+#include "engine/core/main/FrameState.h"
 
 namespace Echo
 {
@@ -19,6 +20,14 @@ namespace Echo
 
     VKRenderer::~VKRenderer()
     {
+        if (m_vkDevice)
+            vkDeviceWaitIdle(m_vkDevice);
+
+        m_pipelineCache.cleanup();
+        m_ringBuffer.cleanup();
+        m_memoryAllocator.cleanup();
+        destroyRenderStates();
+
 		m_validation.cleanup();
 		vkDestroyDevice(m_vkDevice, nullptr);
 		vkDestroyInstance(m_vkInstance, nullptr);
@@ -41,6 +50,10 @@ namespace Echo
 
 		createVkCommandPool();
 
+        m_ringBuffer.init(&m_memoryAllocator);
+
+        m_pipelineCache.init();
+
         return true;
     }
 
@@ -103,7 +116,7 @@ namespace Echo
         return EchoNew(VKMultisampleState);
     }
 
-    const SamplerState* VKRenderer::getSamplerState(const SamplerState::SamplerDesc& desc)
+    SamplerState* VKRenderer::createSamplerState(const SamplerState::SamplerDesc& desc)
     {
         return EchoNew(VKSamplerState(desc));
     }
@@ -213,6 +226,7 @@ namespace Echo
 		// output error
 		if(m_vkPhysicalDevice!=VK_NULL_HANDLE)
 		{
+			vkGetPhysicalDeviceProperties(m_vkPhysicalDevice, &m_vkDeviceProperties);
 			enumerateQueueFamalies();
 		}
 		else
@@ -320,10 +334,24 @@ namespace Echo
 
     void VKRenderer::draw(Renderable* renderable)
     {
-        VKRenderable* vkRenderable = ECHO_DOWN_CAST<VKRenderable*>(renderable);
+        drawInstanced(&renderable, 1);
+    }
+
+    void VKRenderer::drawInstanced(Renderable** renderables, ui32 count)
+    {
+        VKRenderable* vkRenderable = ECHO_DOWN_CAST<VKRenderable*>(renderables[0]);
+        VKShaderProgram* vkShaderProgram = ECHO_DOWN_CAST<VKShaderProgram*>(vkRenderable->getMaterial()->getShader());
         if (vkRenderable->getVkPipeline())
         {
-            ShaderProgram* shaderProgram = renderable->getMaterial()->getShader();
+            // shaders without the instance attribute take a draw per renderable
+            if (count > 1 && !vkShaderProgram->isInstancing())
+            {
+                for (ui32 i = 0; i < count; i++)
+                    drawInstanced(&renderables[i], 1);
+
+                return;
+            }
+
             VKFramebuffer* vkFramebuffer = VKFramebuffer::current();
             VkCommandBuffer vkCommandbuffer = vkFramebuffer->getVkCommandbuffer();
 
@@ -331,21 +359,36 @@ namespace Echo
             vkRenderable->bindShaderParams();
             vkRenderable->bindGeometry();
 
-			MeshPtr mesh = renderable->getMesh();
+            // world matrices and colors of the run, streamed through the ring buffer
+            if (vkShaderProgram->isInstancing())
+            {
+                VKRingBuffer::Allocation allocation;
+                if (!m_ringBuffer.allocate(count * sizeof(InstanceData), 16, allocation))
+                    return;
+
+                buildInstanceData(renderables, count, (InstanceData*)allocation.m_data);
+
+                VkDeviceSize offset = allocation.m_offset;
+                vkCmdBindVertexBuffers(vkCommandbuffer, 1, 1, &allocation.m_vkBuffer, &offset);
+            }
+
+			MeshPtr mesh = vkRenderable->getMesh();
             if (mesh->getIndexBuffer())
             {
-                ui32 idxCount = mesh->getIndexCount();
-                ui32 idxOffset = mesh->getStartIndex();
+                ui32 idxCount = mesh->getLodIndexCount(vkRenderable->getLod());
+                ui32 idxOffset = mesh->getLodStartIndex(vkRenderable->getLod());
 
-                vkCmdDrawIndexed(vkCommandbuffer, idxCount, 1, idxOffset, 0, 0);
+                vkCmdDrawIndexed(vkCommandbuffer, idxCount, count, idxOffset, 0, 0);
             }
             else
             {
                 ui32 vertCount = mesh->getVertexCount();
                 ui32 startVert = mesh->getStartVertex();
 
-                vkCmdDraw(vkCommandbuffer, vertCount, 1, startVert, 0);
+                vkCmdDraw(vkCommandbuffer, vertCount, count, startVert, 0);
             }
+
+            FrameState::instance()->incrDrawCallTimes(1);
         }
     }
 
@@ -4,6 +4,9 @@
 #include "vk_render_base.h"
 #include "vk_validation.h"
 #include "vk_framebuffer.h"
+#include "vk_memory_allocator.h"
+#include "vk_ring_buffer.h"
+#include "vk_pipeline_cache.h"
 
 namespace Echo
 {
@@ -45,7 +48,7 @@ namespace Echo
         virtual DepthStencilState* createDepthStencilState(const DepthStencilState::DepthStencilDesc& desc)override;
         virtual BlendState* createBlendState(const BlendState::BlendDesc& desc) override;
         virtual MultisampleState* createMultisampleState() override;
-        virtual const SamplerState* getSamplerState(const SamplerState::SamplerDesc& desc) override;
+        virtual SamplerState* createSamplerState(const SamplerState::SamplerDesc& desc) override;
 
         // create shaders
         virtual ShaderProgram* createShaderProgram() override;
@@ -66,6 +69,8 @@ namespace Echo
 
 		// draw
         virtual void draw(Renderable* renderable) override;
+        virtual void drawInstanced(Renderable** renderables, ui32 count) override;
+        virtual bool isInstancingSupported() const override { return true; }
 
 		// present
         virtual bool present() override;
@@ -104,6 +109,19 @@ namespace Echo
         // get clear command buffer
         VkCommandPool getVkCommandPool() { return m_vkCommandPool; }
 
+        // get device properties
+        const VkPhysicalDeviceProperties& getVkDeviceProperties() const { return m_vkDeviceProperties; }
+        const VkPhysicalDeviceLimits& getVkDeviceLimits() const { return m_vkDeviceProperties.limits; }
+
+        // device memory
+        VKMemoryAllocator* getMemoryAllocator() { return &m_memoryAllocator; }
+
+        // per frame upload memory
+        VKRingBuffer* getRingBuffer() { return &m_ringBuffer; }
+
+        // shared graphics pipelines
+        VKPipelineCache* getPipelineCache() { return &m_pipelineCache; }
+
 	private:
 		// create vk instance
 		void createVkInstance();
@@ -133,10 +151,14 @@ namespace Echo
 		VkInstance			m_vkInstance;
 		ExtensionProperties	m_vkExtensions;
         VkPhysicalDevice    m_vkPhysicalDevice = nullptr;
+        VkPhysicalDeviceProperties m_vkDeviceProperties = {};
         QueueFamilies       m_vkQueueFamilies;
         VkDevice            m_vkDevice = nullptr;
 		VKValidation		m_validation;
         VkQueue             m_vkGraphicsQueue = nullptr;
 		VkCommandPool		m_vkCommandPool;
+        VKMemoryAllocator   m_memoryAllocator;
+        VKRingBuffer        m_ringBuffer;
+        VKPipelineCache     m_pipelineCache;
 	};
 }
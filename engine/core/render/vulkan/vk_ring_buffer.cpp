@@ -0,0 +1,155 @@
+#include "vk_ring_buffer.h"
+#include "vk_renderer.h"
+
+namespace Echo
+{
+    VKRingBuffer::~VKRingBuffer()
+    {
+        cleanup();
+    }
+
+    void VKRingBuffer::init(VKMemoryAllocator* allocator)
+    {
+        m_allocator = allocator;
+        createBuffer(DefaultSize);
+    }
+
+    void VKRingBuffer::cleanup()
+    {
+        releaseRetiredBuffers(Math::MAX_UI64);
+
+        if (m_vkBuffer)
+        {
+            vkDestroyBuffer(VKRenderer::instance()->getVkDevice(), m_vkBuffer, nullptr);
+            m_allocator->free(m_allocation);
+            m_vkBuffer = VK_NULL_HANDLE;
+        }
+    }
+
+    void VKRingBuffer::beginFrame(ui32 frameIndex)
+    {
+        // close the frame that was recording
+        if (m_frameIndex >= 0)
+            m_frames[m_frameIndex].m_end = m_head;
+
+        if (frameIndex >= m_frames.size())
+            m_frames.resize(frameIndex + 1);
+
+        // the gpu finishes frames in submission order, so all older frames are done as well
+        Frame& frame = m_frames[frameIndex];
+        if (frame.m_frameNumber)
+        {
+            m_tail = std::max<ui64>(m_tail, frame.m_end);
+            releaseRetiredBuffers(frame.m_frameNumber);
+        }
+
+        m_frameIndex = frameIndex;
+        frame.m_frameNumber = ++m_frameNumber;
+        frame.m_end = m_head;
+    }
+
+    bool VKRingBuffer::allocate(ui32 size, ui32 alignment, Allocation& allocation)
+    {
+        if (!m_vkBuffer)
+            return false;
+
+        ui64 offset = (m_head + alignment - 1) & ~ui64(alignment - 1);
+
+        // a range never straddles the end of the buffer
+        if (offset % m_size + size > m_size)
+            offset += m_size - offset % m_size;
+
+        if (offset + size - m_tail > m_size)
+        {
+            ui32 newSize = m_size * 2;
+            while (newSize < size * 2)
+                newSize *= 2;
+
+            if (!createBuffer(newSize))
+                return false;
+
+            offset = 0;
+        }
+
+        m_head = offset + size;
+
+        allocation.m_vkBuffer = m_vkBuffer;
+        allocation.m_offset = ui32(offset % m_size);
+        allocation.m_data = m_allocation.m_data + allocation.m_offset;
+
+        return true;
+    }
+
+    bool VKRingBuffer::upload(const void* data, ui32 size, ui32 alignment, Allocation& allocation)
+    {
+        if (allocate(size, alignment, allocation))
+        {
+            std::memcpy(allocation.m_data, data, size);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool VKRingBuffer::createBuffer(ui32 size)
+    {
+        VkDevice vkDevice = VKRenderer::instance()->getVkDevice();
+
+        VkBufferCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.size = size;
+        createInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+
+        VkBuffer vkBuffer = VK_NULL_HANDLE;
+        if (VK_SUCCESS == vkCreateBuffer(vkDevice, &createInfo, nullptr, &vkBuffer))
+        {
+            VkMemoryRequirements memRequirements;
+            vkGetBufferMemoryRequirements(vkDevice, vkBuffer, &memRequirements);
+
+            VKAllocation allocation;
+            if (m_allocator->allocate(memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, allocation))
+            {
+                VKDebug(vkBindBufferMemory(vkDevice, vkBuffer, allocation.m_vkMemory, allocation.m_offset));
+
+                // draws recorded this frame still read the old buffer
+                if (m_vkBuffer)
+                    m_retiredBuffers.push_back({ m_vkBuffer, m_allocation, m_frameNumber });
+
+                m_vkBuffer = vkBuffer;
+                m_allocation = allocation;
+                m_size = size;
+                m_head = 0;
+                m_tail = 0;
+                for (Frame& frame : m_frames)
+                    frame.m_end = 0;
+
+                return true;
+            }
+
+            vkDestroyBuffer(vkDevice, vkBuffer, nullptr);
+        }
+
+        EchoLogError("vulkan create ring buffer of %d bytes failed", size);
+        return false;
+    }
+
+    void VKRingBuffer::releaseRetiredBuffers(ui64 completedFrame)
+    {
+        for (size_t i = 0; i < m_retiredBuffers.size();)
+        {
+            RetiredBuffer& retired = m_retiredBuffers[i];
+            if (retired.m_frameNumber <= completedFrame)
+            {
+                vkDestroyBuffer(VKRenderer::instance()->getVkDevice(), retired.m_vkBuffer, nullptr);
+                m_allocator->free(retired.m_allocation);
+
+                retired = m_retiredBuffers.back();
+                m_retiredBuffers.pop_back();
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+}
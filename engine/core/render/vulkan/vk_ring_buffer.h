@@ -0,0 +1,82 @@
+#pragma once
+
+#include "vk_memory_allocator.h"
+
+namespace Echo
+{
+    // persistently mapped buffer for vertices, indices and uniforms that change every frame.
+    // the write position runs round the buffer, space is reclaimed once the fence of the frame
+    // that used it has signaled. when a frame would catch up with the gpu the buffer doubles
+    class VKRingBuffer
+    {
+    public:
+        static const ui32 DefaultSize = 4 * 1024 * 1024;
+
+        // a range written this frame
+        struct Allocation
+        {
+            VkBuffer        m_vkBuffer = VK_NULL_HANDLE;
+            ui32            m_offset = 0;
+            Byte*           m_data = nullptr;
+        };
+
+    public:
+        VKRingBuffer() {}
+        ~VKRingBuffer();
+
+        // create, the allocator has to outlive the ring buffer
+        void init(VKMemoryAllocator* allocator);
+        void cleanup();
+
+        // a frame starts recording into the command buffer of frameIndex, whose fence the caller
+        // has waited for, everything written by the previous use of frameIndex is free again
+        void beginFrame(ui32 frameIndex);
+
+        // frame number, increases with every beginFrame
+        ui64 getFrameNumber() const { return m_frameNumber; }
+
+        // allocate size bytes for the current frame, alignment is a power of two
+        bool allocate(ui32 size, ui32 alignment, Allocation& allocation);
+
+        // copy data for the current frame
+        bool upload(const void* data, ui32 size, ui32 alignment, Allocation& allocation);
+
+        // current buffer, changes when the ring grows
+        VkBuffer getVkBuffer() const { return m_vkBuffer; }
+
+    private:
+        // create the buffer, the previous one is kept until the gpu is done with it
+        bool createBuffer(ui32 size);
+
+        // destroy buffers retired by frames that have completed
+        void releaseRetiredBuffers(ui64 completedFrame);
+
+    private:
+        // buffer replaced by a larger one
+        struct RetiredBuffer
+        {
+            VkBuffer        m_vkBuffer;
+            VKAllocation    m_allocation;
+            ui64            m_frameNumber;
+        };
+
+        // frame slot
+        struct Frame
+        {
+            ui64            m_frameNumber = 0;
+            ui64            m_end = 0;          // write position when the frame was done
+        };
+
+    private:
+        VKMemoryAllocator*              m_allocator = nullptr;
+        VkBuffer                        m_vkBuffer = VK_NULL_HANDLE;
+        VKAllocation                    m_allocation;
+        ui32                            m_size = 0;
+        ui64                            m_head = 0;         // write position, never wraps
+        ui64                            m_tail = 0;         // oldest position the gpu may still read
+        ui64                            m_frameNumber = 0;
+        i32                             m_frameIndex = -1;
+        vector<Frame>::type             m_frames;
+        vector<RetiredBuffer>::type     m_retiredBuffers;
+    };
+}
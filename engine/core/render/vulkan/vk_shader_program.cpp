@@ -1,7 +1,7 @@
 #include "vk_shader_program.h"
 #include "vk_renderer.h"
 #include "vk_mapping.h"
-#include "base/glslcc/glsl_cross_compiler.h"
+#include "base/glslcc/shader_cache.h"
 
 namespace Echo
 {
@@ -32,6 +32,7 @@ namespace Echo
     VKShaderProgram::~VKShaderProgram()
     {
         VKRenderer* vkRenderer = ECHO_DOWN_CAST<VKRenderer*>(Renderer::instance());
+        vkRenderer->getPipelineCache()->removeProgram(this);
 
         vkDestroyShaderModule(vkRenderer->getVkDevice(), m_vkVertexShader, nullptr);
         vkDestroyShaderModule(vkRenderer->getVkDevice(), m_vkFragmentShader, nullptr);
@@ -39,16 +40,20 @@ namespace Echo
 
     bool VKShaderProgram::createShaderProgram(const String& vsSrc, const String& psSrc)
     {
-        GLSLCrossCompiler glslCompiler;
-        glslCompiler.setInput(vsSrc.c_str(), psSrc.c_str(), nullptr);
+        ShaderCache::Entry entry;
+        ShaderCache::instance()->get(vsSrc, psSrc, ShaderCache::SPIRV, entry);
 
-        bool isCreateVSSucceed = createShader(glslCompiler.getSPIRV(GLSLCrossCompiler::ShaderType::VS), m_vkVertexShader, m_vertexShaderCompiler);
-        bool isCreateFSSucceed = createShader(glslCompiler.getSPIRV(GLSLCrossCompiler::ShaderType::FS), m_vkFragmentShader, m_fragmentShaderCompiler);
+        bool isCreateVSSucceed = createShader(entry.m_spirv[GLSLCrossCompiler::ShaderType::VS], m_vkVertexShader, m_vertexShaderCompiler);
+        bool isCreateFSSucceed = createShader(entry.m_spirv[GLSLCrossCompiler::ShaderType::FS], m_vkFragmentShader, m_fragmentShaderCompiler);
         m_isLinked = isCreateVSSucceed && isCreateFSSucceed;
 
         // create shader stage
         if (m_isLinked)
         {
+            m_isInstancing = false;
+            for (const spirv_cross::Resource& resource : m_vertexShaderCompiler->get_shader_resources().stage_inputs)
+                m_isInstancing = m_isInstancing || resource.name == "a_InstanceWorld";
+
             m_vkShaderStagesCreateInfo.assign({});
             m_vkShaderStagesCreateInfo[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
             m_vkShaderStagesCreateInfo[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
@@ -88,12 +93,11 @@ namespace Echo
         Buffer fragmentUniformBuffer(m_fragmentShaderUniformBytes.size(), m_fragmentShaderUniformBytes.data(), false);
         m_vkFragmentShaderUniformBuffer = EchoNew(VKBuffer(GPUBuffer::GPUBufferType::GBT_UNIFORM, GPUBuffer::GBU_DYNAMIC, fragmentUniformBuffer));
 
-        // Store information in the uniform's descriptor that is used by the descriptor set
-        m_vkShaderUniformBufferDescriptors[ShaderType::VS].buffer = m_vkVertexShaderUniformBuffer->getVkBuffer();
+        // uniforms are written to the ring buffer for every draw, the descriptors point at its start
+        // and each bind passes the dynamic offset
         m_vkShaderUniformBufferDescriptors[ShaderType::VS].offset = 0;
         m_vkShaderUniformBufferDescriptors[ShaderType::VS].range = m_vkVertexShaderUniformBuffer->getSize();
 
-        m_vkShaderUniformBufferDescriptors[ShaderType::FS].buffer = m_vkFragmentShaderUniformBuffer->getVkBuffer();
         m_vkShaderUniformBufferDescriptors[ShaderType::FS].offset = 0;
         m_vkShaderUniformBufferDescriptors[ShaderType::FS].range = m_vkFragmentShaderUniformBuffer->getSize();
     }
@@ -130,6 +134,11 @@ namespace Echo
 
     void VKShaderProgram::createVkDescriptorSet()
     {
+        // sets recorded earlier this frame keep pointing at the old ring buffer, so new ones are allocated
+        m_vkDescriptorBuffer = VKRenderer::instance()->getRingBuffer()->getVkBuffer();
+        m_vkShaderUniformBufferDescriptors[ShaderType::VS].buffer = m_vkDescriptorBuffer;
+        m_vkShaderUniformBufferDescriptors[ShaderType::FS].buffer = m_vkDescriptorBuffer;
+
         VkDescriptorSetAllocateInfo allocInfo = {};
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocInfo.descriptorPool = VKFramebuffer::current()->getVkDescriptorPool();
@@ -149,7 +158,7 @@ namespace Echo
                 writeDescriptorSets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
                 writeDescriptorSets[i].dstSet = m_vkDescriptorSets[i];
                 writeDescriptorSets[i].descriptorCount = 1;
-                writeDescriptorSets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                writeDescriptorSets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
                 writeDescriptorSets[i].pBufferInfo = &m_vkShaderUniformBufferDescriptors[i];
                 writeDescriptorSets[i].dstBinding = 0;
             }
@@ -166,7 +175,7 @@ namespace Echo
     {
         VkDescriptorSetLayoutBinding layoutBindings;
         layoutBindings.binding = 0;
-        layoutBindings.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        layoutBindings.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         layoutBindings.descriptorCount = 1;
         layoutBindings.stageFlags = type == ShaderType::VS ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
         layoutBindings.pImmutableSamplers = nullptr;
@@ -249,11 +258,28 @@ namespace Echo
 
     void VKShaderProgram::bindUniforms()
     {
-        // update uniform VkBuffer by memory
-        updateVkUniformBuffer();
+        if (!m_vkVertexShaderUniformBuffer || !m_vkFragmentShaderUniformBuffer)
+            return;
+
+        // update uniform VkBuffer by memory, both stages have to land in the same ring buffer, so
+        // upload again if it grew in between
+        VKRingBuffer* ringBuffer = VKRenderer::instance()->getRingBuffer();
+        for (i32 i = 0; i < 2; i++)
+        {
+            VkBuffer vkBuffer = ringBuffer->getVkBuffer();
+            updateVkUniformBuffer();
+            m_vkVertexShaderUniformBuffer->getVkBuffer();
+            m_vkFragmentShaderUniformBuffer->getVkBuffer();
+            if (vkBuffer == ringBuffer->getVkBuffer())
+                break;
+        }
+
+        if (m_vkDescriptorBuffer != ringBuffer->getVkBuffer())
+            createVkDescriptorSet();
 
         // Bind descriptor sets describing shader binding points
-        vkCmdBindDescriptorSets(VKFramebuffer::current()->getVkCommandbuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 0, m_vkDescriptorSets.size(), m_vkDescriptorSets.data(), 0, nullptr);
+        array<ui32, 2> dynamicOffsets = { ui32(m_vkVertexShaderUniformBuffer->getVkOffset()), ui32(m_vkFragmentShaderUniformBuffer->getVkOffset()) };
+        vkCmdBindDescriptorSets(VKFramebuffer::current()->getVkCommandbuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, m_vkPipelineLayout, 0, m_vkDescriptorSets.size(), m_vkDescriptorSets.data(), dynamicOffsets.size(), dynamicOffsets.data());
     }
 
     const spirv_cross::ShaderResources VKShaderProgram::getSpirvShaderResources(ShaderType type)
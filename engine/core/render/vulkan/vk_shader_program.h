@@ -17,6 +17,9 @@ namespace Echo
         // is valid
         bool isLinked() const { return m_isLinked; }
 
+        // the vertex shader reads the world matrix from the per instance a_InstanceWorld attribute
+        bool isInstancing() const { return m_isInstancing; }
+
         // bind
         void bindUniforms();
 
@@ -61,6 +64,7 @@ namespace Echo
 
 	private:
 		bool			                m_isLinked = false;
+        bool                            m_isInstancing = false;
 		VkShaderModule	                m_vkVertexShader = VK_NULL_HANDLE;
 		VkShaderModule	                m_vkFragmentShader = VK_NULL_HANDLE;
         spirv_cross::Compiler*          m_vertexShaderCompiler = nullptr;
@@ -73,6 +77,7 @@ namespace Echo
         array<VkDescriptorBufferInfo, 2>m_vkShaderUniformBufferDescriptors;
         array<VkDescriptorSetLayout, 2> m_vkDescriptorSetLayouts = {};
         array<VkDescriptorSet, 2>       m_vkDescriptorSets = {};
+        VkBuffer                        m_vkDescriptorBuffer = VK_NULL_HANDLE;     // ring buffer the descriptor sets point at
         VkPipelineLayout                m_vkPipelineLayout = VK_NULL_HANDLE;
 	};
 }
@@ -77,9 +77,51 @@ namespace Echo
         m_children.clear();
 	}
 
+	ui32 Node::m_treeVersion = 1;
+
 	Node::~Node()
 	{
 		m_script.release(this);
+
+		m_treeVersion++;
+	}
+
+	void Node::setName(const String& name)
+	{
+		if (m_name != name)
+		{
+			if (m_parent)
+				m_parent->unindexChild(this);
+
+			m_name = name;
+			if (m_parent)
+				m_parent->indexChild(this);
+
+			m_treeVersion++;
+		}
+	}
+
+	void Node::indexChild(Node* child)
+	{
+		// the first child keeps a name that is used twice
+		m_childIndex.emplace(child->m_name, child);
+	}
+
+	void Node::unindexChild(Node* child)
+	{
+		auto it = m_childIndex.find(child->m_name);
+		if (it != m_childIndex.end() && it->second == child)
+		{
+			m_childIndex.erase(it);
+			for (Node* sibling : m_children)
+			{
+				if (sibling != child && sibling->m_name == child->m_name)
+				{
+					m_childIndex.emplace(sibling->m_name, sibling);
+					break;
+				}
+			}
+		}
 	}
 
 	void Node::rotate(const Quaternion& rot)
@@ -185,13 +227,8 @@ namespace Echo
 
 	Node* Node::getChild(const char* name)
 	{
-		for (Node* child : m_children)
-		{
-			if (child->getName() == name)
-				return child;
-		}
-
-		return nullptr;
+		auto it = m_childIndex.find(name);
+		return it != m_childIndex.end() ? it->second : nullptr;
 	}
 
 	i32 Node::getChildIdx(Node* node)
@@ -217,17 +254,22 @@ namespace Echo
 
 	void Node::insertChild(ui32 idx, Node* node)
 	{
-		// make sure the name is unique in current layer
-		int    id = 1;
-		String name = node->getName();
-		while (isChildExist(node->getName()))
+		// make sure the name is unique in current layer, the smallest free suffix is used
+		if (isChildExist(node->getName()))
 		{
-			id++;
-			node->setName(StringUtil::Format("%s%d", name.c_str(), id));
+			String name = node->getName();
+			i32 id = 1;
+			do
+			{
+				id++;
+				node->m_name = StringUtil::Format("%s%d", name.c_str(), id);
+			} while (isChildExist(node->m_name));
 		}
 
 		node->m_parent = this;
 		m_children.insert(m_children.begin() + idx, node);
+		indexChild(node);
+		m_treeVersion++;
 
 		needUpdate();
 	}
@@ -241,13 +283,7 @@ namespace Echo
 
 	bool Node::isChildExist(const String& name)
 	{
-		for (Node* child : m_children)
-		{
-			if (child->getName() == name)
-				return true;
-		}
-
-		return false;
+		return m_childIndex.find(name) != m_childIndex.end();
 	}
 
 	void Node::addChild(Node* node)
@@ -262,6 +298,8 @@ namespace Echo
 			if (*it == node)
 			{
 				m_children.erase(it);
+				unindexChild(node);
+				m_treeVersion++;
 				return true;
 			}
 		}
@@ -494,30 +532,15 @@ namespace Echo
 				}
 				else
 				{
-					bool haveGrandson = false;
-					char firstName[256];
-					for (int i = 0; i <= pathLen; i++)
-					{
-						if (*path == '/')
-						{
-							firstName[i] = '\0';
-							path++;
-							haveGrandson = true;
-							break;
-						}
-						else
-						{
-							firstName[i] = *path;
-							path++;
-						}
-					}
+					const char* separator = strchr(path, '/');
+					auto it = separator ? m_childIndex.find(String(path, separator)) : m_childIndex.find(path);
 
-					Node* child = getChild(firstName);
+					Node* child = it != m_childIndex.end() ? it->second : nullptr;
 					if (child)
 					{
-						if (haveGrandson)
+						if (separator)
 						{
-							return child->getNode(path);
+							return child->getNode(separator + 1);
 						}
 						else
 						{
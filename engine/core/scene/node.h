@@ -3,6 +3,7 @@
 #include <engine/core/math/Math.h>
 #include "engine/core/geom/AABB.h"
 #include "engine/core/base/object.h"
+#include <unordered_map>
 
 namespace Echo
 {
@@ -35,7 +36,7 @@ namespace Echo
 		virtual ~Node();
 
 		// name
-		void setName(const String& name) { m_name = name; }
+		void setName(const String& name);
 		const String& getName() const { return m_name; }
 
 		// path
@@ -136,6 +137,9 @@ namespace Echo
 		String getNodePath() const;
 		String getNodePathRelativeTo(const Node* baseNode) const;
 
+		// changes whenever a node is added, removed or renamed, so resolved paths know when to retry
+		static ui32 getTreeVersion() { return m_treeVersion; }
+
 		// queue free
 		virtual void queueFree() override;
 
@@ -161,6 +165,10 @@ namespace Echo
 		// register to script
 		virtual void registerToScript() override;
 
+		// child name index
+		void indexChild(Node* child);
+		void unindexChild(Node* child);
+
 	protected:
         // dirty update flag
 		void needUpdate();
@@ -184,6 +192,8 @@ namespace Echo
 		Matrix4			m_matWorld;			        // cached derived transform as a 4x4 matrix
 		AABB			m_localAABB;		        // local aabb
 		LuaScript		m_script;			        // bind script
+		std::unordered_map<String, Node*>	m_childIndex;			// children by name
+		static ui32		m_treeVersion;
 	};
     
     // get node by path
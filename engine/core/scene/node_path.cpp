@@ -1,6 +1,7 @@
 #include "node_path.h"
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/log/Log.h"
+#include "node.h"
 
 namespace Echo
 {
@@ -19,9 +20,27 @@ namespace Echo
 	bool NodePath::setPath(const String& path)
 	{
 		m_path = path;
+		m_treeVersion = 0;
 		return true;
 	}
 
+	Node* NodePath::getNode(Node* base) const
+	{
+		if (!base || m_path.empty())
+			return nullptr;
+
+		if (m_treeVersion != Node::getTreeVersion() || m_base != base->getId())
+		{
+			Node* target = base->getNode(m_path.c_str());
+			m_base = base->getId();
+			m_target = target ? target->getId() : 0;
+			m_treeVersion = Node::getTreeVersion();
+			return target;
+		}
+
+		return ECHO_DOWN_CAST<Node*>(Object::getById(m_target));
+	}
+
 	bool NodePath::isSupportType(const String& ext)
 	{
 		if (m_supportTypes.empty())
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "engine/core/util/StringUtil.h"
+#include "engine/core/base/object_registry.h"
 
 namespace Echo
 {
+	class Node;
 	class NodePath
 	{
 	public:
@@ -19,8 +21,14 @@ namespace Echo
 
 		bool isEmpty() const { return m_path.empty(); }
 
+		// target relative to base, the result is cached until the node tree changes
+		Node* getNode(Node* base) const;
+
 	private:
 		String			m_path;
 		String			m_supportTypes;		// node types, seperate by '|'
+		mutable ObjectHandle	m_base = 0;
+		mutable ObjectHandle	m_target = 0;
+		mutable ui32			m_treeVersion = 0;	// Node::getTreeVersion() of the cached result
 	};
 }
\ No newline at end of file
@@ -60,6 +60,29 @@ namespace Echo
 		return camera;
 	}
 
+	float Render::getScreenRadius()
+	{
+		Camera* camera = getCamera();
+		const AABB& localAABB = getLocalAABB();
+		if (!camera || !localAABB.isValid())
+			return Math::MAX_REAL;
+
+		AABB worldAABB = localAABB.transform(getWorldMatrix());
+		float radius = worldAABB.getDiagonalLen() * 0.5f;
+		if (camera->getProjectionMode() == Camera::ProjMode::PM_PERSPECTIVE)
+		{
+			// inside the bounding sphere the full mesh is always wanted
+			float distance = (worldAABB.getCenter() - camera->getPosition()).len();
+			if (distance <= radius)
+				return Math::MAX_REAL;
+
+			return radius / (distance * std::tan(camera->getFov() * 0.5f)) * camera->getHeight() * 0.5f;
+		}
+
+		// orthographic views show width * scale world units across width pixels
+		return camera->getScale() > 0.f ? radius / camera->getScale() : Math::MAX_REAL;
+	}
+
 	void Render::update(float delta, bool bUpdateChildren)
 	{
 		if (!m_isEnable)
@@ -39,6 +39,9 @@ namespace Echo
 		// get camera
 		Camera* getCamera();
 
+		// radius of the world bounding sphere in pixels, used to pick mesh lods
+		float getScreenRadius();
+
 		// update
 		virtual void update(float delta, bool bUpdateChildren) override;
 
@@ -46,6 +49,9 @@ namespace Echo
 		// get global uniforms
 		virtual void* getGlobalUniformValue(const String& name);
 
+		// uniforms beyond the world and normal matrices that differ per node, instanced draws can't carry them
+		virtual bool hasPerDrawUniforms() { return false; }
+
 	protected:
 		i32				m_bvhNodeId = -1;
 		static i32		m_renderTypes;
@@ -1,4 +1,5 @@
 #include "lua_base.h"
+#include "lua_binder.h"
 #include "engine/core/log/Log.h"
 #include "engine/core/base/object.h"
 #include "engine/core/scene/node.h"
@@ -22,15 +23,26 @@ namespace Echo
 		Log::instance()->error(msg);
 	}
 
-	void lua_get_obj_name(Object* obj, char* buffer, int len)
+	Object* lua_get_obj(lua_State* state, int idx)
 	{
-        sprintf(buffer, "%d", obj->getId());
+		LUA_STACK_CHECK(state);
+
+		lua_getfield(state, idx, "this");
+		Object* obj = lua_isinteger(state, -1) ? Object::getById(ObjectHandle(lua_tointeger(state, -1))) : nullptr;
+		lua_pop(state, 1);
+
+		return obj;
 	}
 
-    void lua_register_object(Object* obj)
-    {
-        obj->registerToScript();
-    }
+	Node* lua_get_node(lua_State* state, int idx)
+	{
+		return ECHO_DOWN_CAST<Node*>(lua_get_obj(state, idx));
+	}
+
+	void lua_push_obj(lua_State* state, Object* obj)
+	{
+		LuaBinder::instance()->pushObject(state, obj);
+	}
 
 	int lua_get_upper_tables(lua_State* luaState, const String& objectName, String& currentLayerName)
 	{
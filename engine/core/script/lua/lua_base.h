@@ -50,8 +50,13 @@ namespace Echo
 	// log messages
 	void lua_binder_warning(const char* msg);
 	void lua_binder_error(const char* msg);
-	void lua_get_obj_name(Object* obj, char* buffer, int len);
-    void lua_register_object(Object* obj);
+
+	// object of the lua table at idx, its "this" field holds the object handle. nullptr once deleted
+	Object* lua_get_obj(lua_State* state, int idx);
+	Node* lua_get_node(lua_State* state, int idx);
+
+	// push the table of obj, nil for nullptr
+	void lua_push_obj(lua_State* state, Object* obj);
 
 	// lua stack to value
 	template<typename T> INLINE T lua_getvalue(lua_State* L, int index)			
@@ -216,24 +221,12 @@ namespace Echo
 
 	template<> INLINE Object* lua_getvalue<Object*>(lua_State* state, int idx)
 	{
-		LUA_STACK_CHECK(state);
-
-		lua_getfield(state, idx, "this");
-		Object* ptr = static_cast<Object*>(lua_touserdata(state, -1));
-		lua_pop(state, 1);
-
-		return ptr;
+		return lua_get_obj(state, idx);
 	}
 
 	template<> INLINE Node* lua_getvalue<Node*>(lua_State* state, int idx)
 	{
-		LUA_STACK_CHECK(state);
-
-		lua_getfield(state, idx, "this");
-		Node* nodeptr = static_cast<Node*>(lua_touserdata(state, -1));
-		lua_pop(state, 1);
-
-		return nodeptr;
+		return lua_get_node(state, idx);
 	}
 
 	// lua operate
@@ -386,21 +379,7 @@ namespace Echo
 
 	template<> INLINE void lua_pushvalue<Object*>(lua_State* state, Object* value) 
 	{
-		if (value)
-		{
-            lua_register_object(value);
-
-			char obj_name[128] = "_";
-			lua_get_obj_name(value, obj_name + 1, 127);
-
-			lua_getglobal(state, "objs");
-			lua_getfield(state, -1, obj_name);
-			lua_remove(state, -2);
-		}
-		else
-		{
-			lua_pushnil(state);
-		}
+		lua_push_obj(state, value);
 	}
 
 	template<> INLINE void lua_pushvalue<Node*>(lua_State* state, Node* value)
@@ -123,9 +123,7 @@ namespace Echo
 		// get object ptr
 		if (lua_istable(L, 1))
 		{
-			lua_getfield(L, 1, "this");
-			Object* objPtr = static_cast<Object*>(lua_touserdata(L, -1));
-			lua_pop(L, 1);
+			Object* objPtr = lua_get_obj(L, 1);
 
 			// get method ptr
 			ClassMethodBind* methodPtr = static_cast<ClassMethodBind*>(lua_touserdata(L, lua_upvalueindex(1)));
@@ -138,6 +136,33 @@ namespace Echo
 		return 0;
 	}
 
+	// objs.__index, binds objects on first access
+	static int objects_index_cb(lua_State* L)
+	{
+		const char* key = lua_type(L, 2) == LUA_TSTRING ? lua_tostring(L, 2) : nullptr;
+		if (key && key[0] == '_')
+		{
+			Object* obj = Object::getById(atoi(key + 1));
+			if (obj)
+			{
+				obj->registerToScript();
+
+				lua_pushvalue(L, 2);
+				lua_rawget(L, 1);
+				return 1;
+			}
+		}
+
+		lua_pushnil(L);
+		return 1;
+	}
+
+	// key of an object in the objs table
+	static void get_object_key(char* buffer, int len, i32 id)
+	{
+		snprintf(buffer, len, "_%d", id);
+	}
+
 	// instance
 	LuaBinder* LuaBinder::instance()
 	{
@@ -151,6 +176,16 @@ namespace Echo
 		m_luaState = luaL_newstate();
 		luaL_openlibs(m_luaState);
 
+		// objs table, kept in the registry so binding skips the global lookup
+		lua_newtable(m_luaState);
+		lua_newtable(m_luaState);
+		lua_pushcfunction(m_luaState, objects_index_cb);
+		lua_setfield(m_luaState, -2, "__index");
+		lua_setmetatable(m_luaState, -2);
+		lua_pushvalue(m_luaState, -1);
+		lua_setglobal(m_luaState, "objs");
+		m_objectsRef = luaL_ref(m_luaState, LUA_REGISTRYINDEX);
+
 		addLoader(luaLoaderEcho);
 		setSearchPath("Res://");
 	}
@@ -229,7 +264,7 @@ namespace Echo
 		return true;
 	}
 
-	bool LuaBinder::registerObject(const String& className, const String& objectName, void* obj)
+	bool LuaBinder::registerObject(const String& className, const String& objectName, Object* obj)
 	{
 		if ( !className.empty() && !objectName.empty() && obj)
 		{
@@ -242,8 +277,9 @@ namespace Echo
 			lua_newtable(m_luaState);
 			int objIdx = lua_gettop(m_luaState);
 
+			// the handle goes stale with the object, a pointer would dangle in scripts that keep the table
 			lua_pushstring(m_luaState, "this");
-			lua_pushlightuserdata(m_luaState, obj);
+			lua_pushinteger(m_luaState, obj->getId());
 			lua_settable(m_luaState, objIdx);
 
 			luaL_getmetatable(m_luaState, className.c_str());
@@ -263,6 +299,65 @@ namespace Echo
 		return true;
 	}
 
+	bool LuaBinder::bindObject(Object* obj)
+	{
+		if (m_objectsRef == LUA_NOREF || !obj)
+			return false;
+
+		LUA_STACK_CHECK(m_luaState);
+
+		char key[16];
+		get_object_key(key, sizeof(key), obj->getId());
+
+		lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, m_objectsRef);
+		lua_pushstring(m_luaState, key);
+
+		lua_createtable(m_luaState, 0, 1);
+		lua_pushinteger(m_luaState, obj->getId());
+		lua_setfield(m_luaState, -2, "this");
+		luaL_getmetatable(m_luaState, obj->getClassName().c_str());
+		lua_setmetatable(m_luaState, -2);
+
+		lua_rawset(m_luaState, -3);
+		lua_pop(m_luaState, 1);
+
+		return true;
+	}
+
+	void LuaBinder::unbindObject(i32 id)
+	{
+		if (m_objectsRef == LUA_NOREF)
+			return;
+
+		LUA_STACK_CHECK(m_luaState);
+
+		char key[16];
+		get_object_key(key, sizeof(key), id);
+
+		lua_rawgeti(m_luaState, LUA_REGISTRYINDEX, m_objectsRef);
+		lua_pushstring(m_luaState, key);
+		lua_pushnil(m_luaState);
+		lua_rawset(m_luaState, -3);
+		lua_pop(m_luaState, 1);
+	}
+
+	void LuaBinder::pushObject(lua_State* state, Object* obj)
+	{
+		if (m_objectsRef == LUA_NOREF || !obj)
+		{
+			lua_pushnil(state);
+			return;
+		}
+
+		char key[16];
+		get_object_key(key, sizeof(key), obj->getId());
+
+		// a missing entry goes through objs.__index and gets bound
+		lua_rawgeti(state, LUA_REGISTRYINDEX, m_objectsRef);
+		lua_getfield(state, -1, key);
+		lua_remove(state, -2);
+	}
+
 	// get class infos
 	void LuaBinder::getClassMethods(const String& className, StringArray& methods)
 	{
@@ -23,7 +23,15 @@ namespace Echo
 		// register
 		bool registerClass(const char* className, const char* parentClassName);
 		bool registerClassMethod(const String& className, const String& methodName, ClassMethodBind* method);
-		bool registerObject(const String& className, const String& objectName, void* obj);
+		bool registerObject(const String& className, const String& objectName, Object* obj);
+
+		// bind obj as objs._<id> through direct table operations, scripts reading an unbound
+		// objs._<id> bind it on first access
+		bool bindObject(Object* obj);
+		void unbindObject(i32 id);
+
+		// push the table of obj, binding it when needed
+		void pushObject(lua_State* state, Object* obj);
 
 		// get class infos
 		void getClassMethods(const String& className, StringArray& methods);
@@ -93,7 +101,8 @@ namespace Echo
 		LuaBinder() {}
 
 	private:
-		lua_State*		m_luaState;		// luaState
+		lua_State*		m_luaState = nullptr;		// luaState
+		int				m_objectsRef = LUA_NOREF;	// registry reference of the objs table
 	};
 
 	// call lua function with no parameter
@@ -0,0 +1,91 @@
+#include "ParallelWorkers.h"
+
+namespace Echo
+{
+    ParallelWorkers::ParallelWorkers()
+        : m_nextRange(0)
+        , m_pendingWorkers(0)
+        , m_quit(false)
+    {
+#ifndef ECHO_PLATFORM_HTML5
+        ui32 workerCount = std::min<ui32>(std::max<ui32>(std::thread::hardware_concurrency(), 1) - 1, 7);
+        for (ui32 i = 0; i < workerCount; i++)
+        {
+            Worker* worker = EchoNew(Worker);
+            worker->m_owner = this;
+            worker->m_thread.Start(&ParallelWorkers::workerThread, worker);
+            m_workers.emplace_back(worker);
+        }
+#endif
+    }
+
+    ParallelWorkers::~ParallelWorkers()
+    {
+        m_quit = true;
+        for (Worker* worker : m_workers)
+        {
+            worker->m_wakeEvent.SetEvent();
+            worker->m_thread.Join();
+        }
+
+        EchoSafeDeleteContainer(m_workers, Worker);
+    }
+
+    ParallelWorkers* ParallelWorkers::instance()
+    {
+        static ParallelWorkers* inst = EchoNew(ParallelWorkers);
+        return inst;
+    }
+
+    void ParallelWorkers::parallelFor(ui32 count, ui32 grain, const RangeFunc& func)
+    {
+        grain = std::max<ui32>(grain, 1);
+        if (m_workers.empty() || count <= grain)
+        {
+            if (count)
+                func(0, count);
+
+            return;
+        }
+
+        m_func = &func;
+        m_count = count;
+        m_grain = grain;
+        m_nextRange = 0;
+        m_pendingWorkers = ui32(m_workers.size());
+        for (Worker* worker : m_workers)
+            worker->m_wakeEvent.SetEvent();
+
+        runRanges();
+
+        // the last worker to leave signals exactly once per job
+        m_doneEvent.WaitEvent();
+        m_func = nullptr;
+    }
+
+    void ParallelWorkers::runRanges()
+    {
+        const ui32 rangeCount = (m_count + m_grain - 1) / m_grain;
+        for (ui32 range = m_nextRange++; range < rangeCount; range = m_nextRange++)
+        {
+            ui32 begin = range * m_grain;
+            (*m_func)(begin, std::min<ui32>(begin + m_grain, m_count));
+        }
+    }
+
+    void ParallelWorkers::workerThread(void* data)
+    {
+        Worker* worker = (Worker*)data;
+        ParallelWorkers* owner = worker->m_owner;
+        for (;;)
+        {
+            worker->m_wakeEvent.WaitEvent();
+            if (owner->m_quit)
+                break;
+
+            owner->runRanges();
+            if (--owner->m_pendingWorkers == 0)
+                owner->m_doneEvent.SetEvent();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include "engine/core/thread/Threading.h"
+#include "engine/core/memory/MemAllocDef.h"
+
+namespace Echo
+{
+    // small persistent worker set used to split frame work (particle systems, skeleton poses)
+    // across cores. the calling thread works on the job too and returns once every range is done.
+    // not reentrant, only the main thread starts jobs
+    class ParallelWorkers
+    {
+    public:
+        typedef std::function<void(ui32 begin, ui32 end)> RangeFunc;
+
+    public:
+        ~ParallelWorkers();
+
+        // instance
+        static ParallelWorkers* instance();
+
+        // worker count, not including the calling thread
+        ui32 getWorkerCount() const { return ui32(m_workers.size()); }
+
+        // run func over [0, count) in ranges of grain elements
+        void parallelFor(ui32 count, ui32 grain, const RangeFunc& func);
+
+    private:
+        ParallelWorkers();
+
+        // claim and run ranges until none are left
+        void runRanges();
+
+        // worker entry
+        static void workerThread(void* data);
+
+    private:
+        struct Worker
+        {
+            ParallelWorkers*    m_owner = nullptr;
+            Thread              m_thread;
+            ThreadEvent         m_wakeEvent;
+        };
+
+        vector<Worker*>::type   m_workers;
+        ThreadEvent             m_doneEvent;
+        const RangeFunc*        m_func = nullptr;
+        ui32                    m_count = 0;
+        ui32                    m_grain = 0;
+        std::atomic<ui32>       m_nextRange;
+        std::atomic<ui32>       m_pendingWorkers;
+        std::atomic<bool>       m_quit;
+    };
+}
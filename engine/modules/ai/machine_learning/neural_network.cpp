@@ -2,6 +2,8 @@
 #include "function/loss.h"
 #include "neural_network.h"
 #include "neural_layer.h"
+#include <algorithm>
+#include <cstring>
 
 
 namespace Echo
@@ -21,6 +23,7 @@ namespace Echo
 	void NeuralNetwork::bindMethods()
 	{
 		CLASS_BIND_METHOD(NeuralNetwork, train,			  DEF_METHOD("train"));
+		CLASS_BIND_METHOD(NeuralNetwork, trainBatch,	  DEF_METHOD("trainBatch"));
 		CLASS_BIND_METHOD(NeuralNetwork, computeOutput,   DEF_METHOD("computeOutput"));
 		CLASS_BIND_METHOD(NeuralNetwork, getLearningRate, DEF_METHOD("getLearningRate"));
 		CLASS_BIND_METHOD(NeuralNetwork, setLearningRate, DEF_METHOD("setLearningRate"));
@@ -35,11 +38,44 @@ namespace Echo
 		// build data structure or sync data
 		organzieStructureBaseOnNodeTree();
 
-		// compute output
-		computeOutput(inputVector);
+		if (m_isInit)
+		{
+			// compute output
+			forward(inputVector);
 
-		// learn
-		learn( expectedOutput);
+			// learn
+			learn(expectedOutput);
+		}
+	}
+
+	void NeuralNetwork::trainBatch(const Matrix& inputs, const Matrix& expectedOutputs, i32 batchSize)
+	{
+		organzieStructureBaseOnNodeTree();
+		if (!m_isInit || inputs.getHeight() != expectedOutputs.getHeight() || batchSize <= 0)
+		{
+			EchoLogError("NeuralNetwork train batch failed, sample number of inputs and expected outputs should be the same");
+			return;
+		}
+
+		i32 sampleNumber = inputs.getHeight();
+		for (i32 begin = 0; begin < sampleNumber; begin += batchSize)
+		{
+			i32 rows = std::min<i32>(batchSize, sampleNumber - begin);
+			if (rows == sampleNumber)
+			{
+				forward(inputs);
+				learn(expectedOutputs);
+			}
+			else
+			{
+				m_batchInput.resize(rows, inputs.getWidth());
+				m_batchExpected.resize(rows, expectedOutputs.getWidth());
+				std::memcpy(m_batchInput.data(), inputs[begin], sizeof(double) * rows * inputs.getWidth());
+				std::memcpy(m_batchExpected.data(), expectedOutputs[begin], sizeof(double) * rows * expectedOutputs.getWidth());
+				forward(m_batchInput);
+				learn(m_batchExpected);
+			}
+		}
 	}
 
 	i32 NeuralNetwork::getLayerNumber()
@@ -105,6 +141,9 @@ namespace Echo
 			if (layerNumber >= 3)
 			{
 				m_layerValues.resize(layerNumber);
+				m_preActivations.resize(layerNumber);
+				m_activationPrimes.resize(layerNumber);
+				m_deltas.resize(layerNumber - 1);
 				m_weights.resize(layerNumber - 1);
 				m_dJdWeights.resize(layerNumber - 1);
 				m_bias.resize(layerNumber - 1);
@@ -136,51 +175,70 @@ namespace Echo
 		// sync data to neuron
 	}
 
-	// compute output by layer
-	Matrix NeuralNetwork::computeLayerOutput(i32 layer, MatrixFunction fun)
-	{
-		return m_layerValues[layer].dot(m_weights[layer]).add(m_bias[layer]).applyFunction(fun);
-	}
-
-	// compute output
-	Matrix NeuralNetwork::computeOutput(const Matrix& inputVector)
+	// forward pass
+	void NeuralNetwork::forward(const Matrix& inputVector)
 	{
-		// set input layer value (row matrix)
+		// set input layer value (one sample per row)
 		m_layerValues[0] = inputVector;
 
 		i32 layerNumbr = (i32)m_layerValues.size() - 1;
 		for (i32 i = 0; i < layerNumbr; i++)
 		{
-			m_layerValues[i + 1] = computeLayerOutput( i, m_activationFunction);
+			Matrix::DotBiasActivate(m_layerValues[i + 1], &m_preActivations[i + 1], m_layerValues[i], m_weights[i], m_bias[i], m_activationFunction);
 		}
+	}
 
-		return m_layerValues[layerNumbr];
+	// compute output
+	Matrix NeuralNetwork::computeOutput(const Matrix& inputVector)
+	{
+		organzieStructureBaseOnNodeTree();
+		if (!m_isInit)
+			return Matrix();
+
+		forward(inputVector);
+		return m_layerValues.back();
 	}
 
 	// learn
 	void NeuralNetwork::learn(const Matrix& expectedOutput)
 	{
-		i32 layerNumber = getLayerNumber() - 1;
+		i32 layerNumber = (i32)m_weights.size();
+		double scale = 1.0 / std::max<i32>(expectedOutput.getHeight(), 1);
+
+		// derivative of activation function for every layer after the input one
+		for (i32 i = 1; i <= layerNumber; i++)
+		{
+			m_activationPrimes[i] = m_preActivations[i];
+			m_activationPrimes[i].applyFunctionInPlace(m_activationFunctionPrime);
+		}
 
 		// last hidden layer
 		i32 lastLayer = layerNumber - 1;
 		{
-			m_dJdBias[lastLayer] = (*m_lossFunctionPrime)(expectedOutput, m_layerValues[lastLayer+1]).multiply(computeLayerOutput( lastLayer, m_activationFunctionPrime));
-			m_dJdWeights[lastLayer] = m_layerValues[lastLayer].transpose().dot(m_dJdBias[lastLayer]);
+			m_deltas[lastLayer] = (*m_lossFunctionPrime)(expectedOutput, m_layerValues[lastLayer+1]);
+			m_deltas[lastLayer].multiplyInPlace(m_activationPrimes[lastLayer + 1]);
 		}
 
 		// recursive layer
 		for (i32 i = lastLayer-1; i >= 0; i--)
 		{
-			m_dJdBias[i] = m_dJdBias[i+1].dot(m_weights[i+1].transpose()).multiply(computeLayerOutput( i, m_activationFunctionPrime));
-			m_dJdWeights[i] = m_layerValues[i].transpose().dot(m_dJdBias[i]);
+			Matrix::Gemm(m_deltas[i], m_deltas[i + 1], false, m_weights[i + 1], true);
+			m_deltas[i].multiplyInPlace(m_activationPrimes[i + 1]);
+		}
+
+		// gradients averaged over the batch
+		for (i32 i = 0; i < layerNumber; i++)
+		{
+			Matrix::Gemm(m_dJdWeights[i], m_layerValues[i], true, m_deltas[i], false, scale);
+			Matrix::SumRows(m_dJdBias[i], m_deltas[i]);
+			m_dJdBias[i].multiplyInPlace(Real(scale));
 		}
 
 		// update params
 		for (i32 i = 0; i < layerNumber; i++)
 		{
-			m_weights[i] = m_weights[i].substract( m_dJdWeights[i].multiply(m_learningRate));
-			m_bias[i] = m_bias[i].substract(m_dJdBias[i].multiply(m_learningRate));
+			m_weights[i].addScaled(-m_learningRate, m_dJdWeights[i]);
+			m_bias[i].addScaled(-m_learningRate, m_dJdBias[i]);
 		}
 	}
 
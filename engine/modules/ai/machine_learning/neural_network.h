@@ -21,10 +21,13 @@ namespace Echo
 	public:
 		NeuralNetwork();
 
-		// train
+		// train, every row of input is one sample. gradients are averaged over all rows
 		void train(const Matrix& inputVector, const Matrix& expectedOutput);
 
-		// compute output
+		// one epoch over all rows, in mini batches of batchSize rows
+		void trainBatch(const Matrix& inputs, const Matrix& expectedOutputs, i32 batchSize);
+
+		// compute output, every row of input is one sample
 		Matrix computeOutput(const Matrix& inputVector);
 
 		// layer
@@ -58,12 +61,12 @@ namespace Echo
 		// organize by node tree structure
 		void organzieStructureBaseOnNodeTree();
 
+		// forward pass, fills layer values and pre activations
+		void forward(const Matrix& inputVector);
+
 		// learn
 		void learn(const Matrix& expectedOutput);
 
-		// compute output by layer
-		Matrix computeLayerOutput(i32 layer, MatrixFunction fun);
-
 	protected:
 		// update
 		virtual void update_self() override;
@@ -75,6 +78,11 @@ namespace Echo
 		LossFunction				m_lossFunctionPrime;
 		Real						m_learningRate;			// learning speed
 		vector<Matrix>::type		m_layerValues;
+		vector<Matrix>::type		m_preActivations;		// layer values before activation function
+		vector<Matrix>::type		m_activationPrimes;
+		vector<Matrix>::type		m_deltas;				// per sample partial derivative of loss function with respect to layer values
+		Matrix						m_batchInput;
+		Matrix						m_batchExpected;
 		vector<Matrix>::type		m_weights;
 		vector<Matrix>::type		m_dJdWeights;			// partial derivative of loss function with with respect to weights
 		vector<Matrix>::type		m_bias;
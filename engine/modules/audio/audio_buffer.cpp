@@ -0,0 +1,487 @@
+#include "audio_buffer.h"
+#define DR_MP3_IMPLEMENTATION
+#include "dr_libs/dr_mp3.h"
+#define DR_FLAC_IMPLEMENTATION
+#include "dr_libs/dr_flac.h"
+#define DR_WAV_IMPLEMENTATION
+#include "dr_libs/dr_wav.h"
+#include "engine/core/io/IO.h"
+#include "engine/core/util/Timer.h"
+#include "engine/core/log/Log.h"
+
+namespace Echo
+{
+	AudioDecoder::AudioDecoder()
+	{
+	}
+
+	AudioDecoder::~AudioDecoder()
+	{
+		close();
+	}
+
+	bool AudioDecoder::open(const void* data, size_t size)
+	{
+		close();
+
+		// flac and wav are recognized by their headers, anything else is tried as mp3
+		drflac* flac = drflac_open_memory(data, size);
+		if (flac)
+		{
+			m_type = Type::Flac;
+			m_handle = flac;
+			m_channels = flac->channels;
+			m_sampleRate = flac->sampleRate;
+			m_frameCount = flac->totalPCMFrameCount;
+		}
+		else
+		{
+			drwav* wav = EchoNew(drwav);
+			if (drwav_init_memory(wav, data, size))
+			{
+				m_type = Type::Wav;
+				m_handle = wav;
+				m_channels = wav->channels;
+				m_sampleRate = wav->sampleRate;
+				m_frameCount = wav->totalPCMFrameCount;
+			}
+			else
+			{
+				EchoSafeDelete(wav, drwav);
+
+				// mono output as before, the frame count needs a full scan so it stays unknown
+				drmp3* mp3 = EchoNew(drmp3);
+				drmp3_config config;
+				config.outputChannels = 1;
+				config.outputSampleRate = DR_MP3_DEFAULT_SAMPLE_RATE;
+				if (drmp3_init_memory(mp3, data, size, &config))
+				{
+					m_type = Type::Mp3;
+					m_handle = mp3;
+					m_channels = mp3->channels;
+					m_sampleRate = mp3->sampleRate;
+				}
+				else
+				{
+					EchoSafeDelete(mp3, drmp3);
+				}
+			}
+		}
+
+		// openal only takes mono and stereo
+		if (isOpen() && (m_channels < 1 || m_channels > 2))
+		{
+			EchoLogError("Audio decoder doesn't support [%d] channels", m_channels);
+			close();
+		}
+
+		return isOpen();
+	}
+
+	void AudioDecoder::close()
+	{
+		if (m_type == Type::Flac)
+		{
+			drflac_close((drflac*)m_handle);
+		}
+		else if (m_type == Type::Wav)
+		{
+			drwav* wav = (drwav*)m_handle;
+			drwav_uninit(wav);
+			EchoSafeDelete(wav, drwav);
+		}
+		else if (m_type == Type::Mp3)
+		{
+			drmp3* mp3 = (drmp3*)m_handle;
+			drmp3_uninit(mp3);
+			EchoSafeDelete(mp3, drmp3);
+		}
+
+		m_type = Type::None;
+		m_handle = nullptr;
+		m_channels = 0;
+		m_sampleRate = 0;
+		m_frameCount = 0;
+	}
+
+	ui32 AudioDecoder::read(i16* out, ui32 frames)
+	{
+		switch (m_type)
+		{
+		case Type::Flac: return ui32(drflac_read_pcm_frames_s16((drflac*)m_handle, frames, out));
+		case Type::Wav:	 return ui32(drwav_read_pcm_frames_s16((drwav*)m_handle, frames, out));
+		case Type::Mp3:
+		{
+			m_scratch.resize(frames * m_channels);
+			ui32 framesRead = ui32(drmp3_read_pcm_frames_f32((drmp3*)m_handle, frames, m_scratch.data()));
+			drwav_f32_to_s16(out, m_scratch.data(), framesRead * m_channels);
+			return framesRead;
+		}
+		default: return 0;
+		}
+	}
+
+	bool AudioDecoder::seek(ui64 frame)
+	{
+		switch (m_type)
+		{
+		case Type::Flac: return drflac_seek_to_pcm_frame((drflac*)m_handle, frame) ? true : false;
+		case Type::Wav:	 return drwav_seek_to_pcm_frame((drwav*)m_handle, frame) ? true : false;
+		case Type::Mp3:	 return drmp3_seek_to_pcm_frame((drmp3*)m_handle, frame) ? true : false;
+		default:		 return false;
+		}
+	}
+
+	AudioClip::AudioClip(const String& path)
+		: m_path(path)
+	{
+	}
+
+	AudioClip::~AudioClip()
+	{
+		if (m_buffer)
+			alDeleteBuffers(1, &m_buffer);
+	}
+
+	void AudioClip::load()
+	{
+		ulong beginTime = Time::instance()->getMilliseconds();
+
+		MemoryReader memReader(m_path);
+		AudioDecoder decoder;
+		if (memReader.getSize() && decoder.open(memReader.getData<const void*>(), memReader.getSize()))
+		{
+			// decode straight to 16 bit, no float copy of the whole clip
+			const ui32 step = 16384;
+			const ui32 channels = decoder.getChannels();
+			vector<i16>::type pcm;
+			pcm.reserve(size_t(decoder.getFrameCount() ? decoder.getFrameCount() : step) * channels);
+			for (;;)
+			{
+				size_t offset = pcm.size();
+				pcm.resize(offset + step * channels);
+				ui32 framesRead = decoder.read(pcm.data() + offset, step);
+				pcm.resize(offset + framesRead * channels);
+				if (framesRead < step)
+					break;
+			}
+
+			if (!pcm.empty())
+			{
+				m_channels = channels;
+				m_sampleRate = decoder.getSampleRate();
+				m_frameCount = pcm.size() / channels;
+				m_memorySize = pcm.size() * sizeof(i16);
+
+				alGenBuffers(1, &m_buffer);
+				alBufferData(m_buffer, decoder.getAlFormat(), pcm.data(), ALsizei(m_memorySize), ALsizei(m_sampleRate));
+			}
+		}
+
+		if (!isValid())
+			EchoLogError("Audio clip [%s] load failed", m_path.c_str());
+
+		m_loadTime = ui32(Time::instance()->getMilliseconds() - beginTime);
+	}
+
+	AudioStream::AudioStream(const String& path)
+		: m_path(path)
+		, m_quit(false)
+	{
+		ulong beginTime = Time::instance()->getMilliseconds();
+
+		m_file = EchoNew(MemoryReader(path));
+		if (m_file->getSize() && m_decoder.open(m_file->getData<const void*>(), m_file->getSize()))
+		{
+			// a quarter second per chunk
+			m_chunkFrames = std::max<ui32>(m_decoder.getSampleRate() / 4, 1024);
+			for (Chunk& chunk : m_chunks)
+				chunk.m_pcm.resize(m_chunkFrames * m_decoder.getChannels());
+
+			alGenBuffers(BufferCount, m_buffers);
+			for (ui32 i = 0; i < BufferCount; i++)
+				m_freeBuffers[i] = m_buffers[i];
+			m_freeBufferCount = BufferCount;
+
+			// html5 has no worker thread, requestDecode decodes on the main thread
+#ifndef ECHO_PLATFORM_HTML5
+			m_thread.Start(&AudioStream::decodeThread, this);
+#endif
+		}
+		else
+		{
+			EchoLogError("Audio stream [%s] open failed", path.c_str());
+		}
+
+		m_loadTime = ui32(Time::instance()->getMilliseconds() - beginTime);
+	}
+
+	AudioStream::~AudioStream()
+	{
+		if (isValid())
+		{
+#ifndef ECHO_PLATFORM_HTML5
+			m_quit = true;
+			m_decodeEvent.SetEvent();
+			m_thread.Join();
+#endif
+
+			alDeleteBuffers(BufferCount, m_buffers);
+		}
+
+		m_decoder.close();
+		EchoSafeDelete(m_file, MemoryReader);
+	}
+
+	size_t AudioStream::getMemorySize() const
+	{
+		size_t chunkBytes = m_chunkFrames * m_decoder.getChannels() * sizeof(i16);
+		return (m_file ? m_file->getSize() : 0) + chunkBytes * (ChunkCount + BufferCount);
+	}
+
+	void AudioStream::decodeThread(void* stream)
+	{
+		AudioStream* audioStream = (AudioStream*)stream;
+		for (;;)
+		{
+			audioStream->m_decodeEvent.WaitEvent();
+			if (audioStream->m_quit)
+				break;
+
+			audioStream->decodeChunks();
+		}
+	}
+
+	void AudioStream::requestDecode()
+	{
+#ifdef ECHO_PLATFORM_HTML5
+		// no worker thread, decode on the main thread
+		decodeChunks();
+#else
+		m_decodeEvent.SetEvent();
+#endif
+	}
+
+	void AudioStream::decodeChunks()
+	{
+		EE_LOCK_MUTEX(m_decodeMutex);
+
+		const ui32 channels = m_decoder.getChannels();
+		for (;;)
+		{
+			{
+				EE_LOCK_MUTEX(m_chunkMutex);
+				if (m_readyCount == ChunkCount || m_decodeEnd)
+					break;
+			}
+
+			// the slot at m_writeIdx is never touched by the reader until it's published
+			Chunk& chunk = m_chunks[m_writeIdx];
+			ui32 frames = 0;
+			bool isEnd = false;
+			bool isRewound = false;
+			while (frames < m_chunkFrames)
+			{
+				ui32 framesRead = m_decoder.read(chunk.m_pcm.data() + frames * channels, m_chunkFrames - frames);
+				if (framesRead)
+				{
+					frames += framesRead;
+					isRewound = false;
+				}
+				else if (m_isLoop && !isRewound && m_decoder.seek(0))
+				{
+					isRewound = true;
+				}
+				else
+				{
+					isEnd = true;
+					break;
+				}
+			}
+
+			EE_LOCK_MUTEX(m_chunkMutex);
+			if (frames)
+			{
+				chunk.m_frames = frames;
+				m_writeIdx = (m_writeIdx + 1) % ChunkCount;
+				m_readyCount++;
+			}
+
+			if (isEnd)
+				m_decodeEnd = true;
+		}
+	}
+
+	bool AudioStream::queueChunk(ALuint source, ALuint buffer)
+	{
+		Chunk* chunk = nullptr;
+		{
+			EE_LOCK_MUTEX(m_chunkMutex);
+			if (!m_readyCount)
+				return false;
+
+			chunk = &m_chunks[m_readIdx];
+		}
+
+		alBufferData(buffer, m_decoder.getAlFormat(), chunk->m_pcm.data(), ALsizei(chunk->m_frames * m_decoder.getChannels() * sizeof(i16)), ALsizei(m_decoder.getSampleRate()));
+		alSourceQueueBuffers(source, 1, &buffer);
+
+		EE_LOCK_MUTEX(m_chunkMutex);
+		m_readIdx = (m_readIdx + 1) % ChunkCount;
+		m_readyCount--;
+
+		return true;
+	}
+
+	void AudioStream::play(ALuint source)
+	{
+		if (!isValid())
+			return;
+
+		stop(source);
+
+		// rewind, waits for the worker to finish its current chunk
+		{
+			MutexLock decodeLock(m_decodeMutex);
+			m_decoder.seek(0);
+
+			MutexLock chunkLock(m_chunkMutex);
+			m_readIdx = 0;
+			m_writeIdx = 0;
+			m_readyCount = 0;
+			m_decodeEnd = false;
+		}
+
+		// prime the queue synchronously so playback starts this frame
+		decodeChunks();
+		while (m_freeBufferCount && queueChunk(source, m_freeBuffers[m_freeBufferCount - 1]))
+			m_freeBufferCount--;
+
+		alSourcei(source, AL_LOOPING, AL_FALSE);
+		alSourcePlay(source);
+		m_isPlaying = true;
+
+		requestDecode();
+	}
+
+	void AudioStream::stop(ALuint source)
+	{
+		if (!isValid())
+			return;
+
+		// detaching the buffer of a stopped source unqueues everything
+		alSourceStop(source);
+		alSourcei(source, AL_BUFFER, 0);
+
+		for (ui32 i = 0; i < BufferCount; i++)
+			m_freeBuffers[i] = m_buffers[i];
+		m_freeBufferCount = BufferCount;
+		m_isPlaying = false;
+	}
+
+	void AudioStream::update(ALuint source)
+	{
+		if (!m_isPlaying)
+			return;
+
+		ALint processed = 0;
+		alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+		for (; processed > 0; processed--)
+		{
+			ALuint buffer = 0;
+			alSourceUnqueueBuffers(source, 1, &buffer);
+			m_freeBuffers[m_freeBufferCount++] = buffer;
+		}
+
+		if (m_freeBufferCount)
+		{
+			while (m_freeBufferCount && queueChunk(source, m_freeBuffers[m_freeBufferCount - 1]))
+				m_freeBufferCount--;
+
+			requestDecode();
+		}
+
+		ALint state = AL_STOPPED;
+		alGetSourcei(source, AL_SOURCE_STATE, &state);
+		if (state == AL_STOPPED)
+		{
+			ALint queued = 0;
+			alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+			if (queued)
+			{
+				// the decoder fell behind and the source ran dry
+				alSourcePlay(source);
+			}
+			else
+			{
+				EE_LOCK_MUTEX(m_chunkMutex);
+				if (m_decodeEnd && !m_readyCount)
+					m_isPlaying = false;
+			}
+		}
+	}
+
+	AudioClipCache::~AudioClipCache()
+	{
+		for (auto& it : m_clips)
+			EchoSafeDelete(it.second, AudioClip);
+
+		m_clips.clear();
+	}
+
+	AudioClipCache* AudioClipCache::instance()
+	{
+		static AudioClipCache* inst = EchoNew(AudioClipCache);
+		return inst;
+	}
+
+	AudioClip* AudioClipCache::acquire(const String& path)
+	{
+		AudioClip* clip = nullptr;
+		auto it = m_clips.find(path);
+		if (it != m_clips.end())
+		{
+			clip = it->second;
+		}
+		else
+		{
+			clip = EchoNew(AudioClip(path));
+			clip->load();
+			m_clips[path] = clip;
+		}
+
+		clip->m_refCount++;
+		return clip;
+	}
+
+	void AudioClipCache::release(AudioClip* clip)
+	{
+		if (clip && --clip->m_refCount <= 0)
+		{
+			m_clips.erase(clip->getPath());
+			EchoSafeDelete(clip, AudioClip);
+		}
+	}
+
+	bool AudioClipCache::isStreamed(const String& path) const
+	{
+		size_t size = 0;
+		DataStream* stream = IO::instance()->open(path);
+		if (stream)
+		{
+			size = stream->size();
+			EchoSafeDelete(stream, DataStream);
+		}
+
+		return size > m_streamThreshold;
+	}
+
+	size_t AudioClipCache::getMemorySize() const
+	{
+		size_t size = 0;
+		for (auto& it : m_clips)
+			size += it.second->getMemorySize();
+
+		return size;
+	}
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include "engine/core/thread/Threading.h"
+#include "engine/core/io/MemoryReader.h"
+#include "audio_base.h"
+
+namespace Echo
+{
+	// mp3 | wav | flac decoder over an encoded block of memory, outputs 16 bit pcm
+	class AudioDecoder
+	{
+	public:
+		AudioDecoder();
+		~AudioDecoder();
+
+		// open, data must stay valid until close
+		bool open(const void* data, size_t size);
+		void close();
+		bool isOpen() const { return m_type != Type::None; }
+
+		// read interleaved frames, returns frames read
+		ui32 read(i16* out, ui32 frames);
+
+		// seek to pcm frame
+		bool seek(ui64 frame);
+
+		// format
+		ui32 getChannels() const { return m_channels; }
+		ui32 getSampleRate() const { return m_sampleRate; }
+		ui64 getFrameCount() const { return m_frameCount; } // 0 when unknown (mp3)
+		ALenum getAlFormat() const { return m_channels == 2 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16; }
+
+	private:
+		enum class Type
+		{
+			None,
+			Mp3,
+			Wav,
+			Flac,
+		}			m_type = Type::None;
+		void*		m_handle = nullptr;
+		ui32		m_channels = 0;
+		ui32		m_sampleRate = 0;
+		ui64		m_frameCount = 0;
+		vector<float>::type	m_scratch;
+	};
+
+	// fully decoded pcm in one openal buffer, shared by all players of the same resource
+	class AudioClip
+	{
+		friend class AudioClipCache;
+
+	public:
+		// openal buffer
+		ALuint getBuffer() const { return m_buffer; }
+		bool isValid() const { return m_frameCount > 0; }
+
+		// format
+		ui32 getChannels() const { return m_channels; }
+		ui32 getSampleRate() const { return m_sampleRate; }
+		ui64 getFrameCount() const { return m_frameCount; }
+		float getDuration() const { return m_sampleRate ? float(m_frameCount) / float(m_sampleRate) : 0.f; }
+
+		// stats, decoded bytes held by openal and milliseconds spent reading and decoding
+		const String& getPath() const { return m_path; }
+		size_t getMemorySize() const { return m_memorySize; }
+		ui32 getLoadTime() const { return m_loadTime; }
+		i32 getRefCount() const { return m_refCount; }
+
+	private:
+		AudioClip(const String& path);
+		~AudioClip();
+
+		// load
+		void load();
+
+	private:
+		String		m_path;
+		ALuint		m_buffer = 0;
+		ui32		m_channels = 0;
+		ui32		m_sampleRate = 0;
+		ui64		m_frameCount = 0;
+		size_t		m_memorySize = 0;
+		ui32		m_loadTime = 0;
+		i32			m_refCount = 0;
+	};
+
+	// decodes a long asset chunk by chunk on a worker thread, the main thread
+	// rotates a few openal buffers through alSourceQueueBuffers
+	class AudioStream
+	{
+	public:
+		AudioStream(const String& path);
+		~AudioStream();
+
+		// valid
+		bool isValid() const { return m_decoder.isOpen(); }
+
+		// loop
+		void setLoop(bool loop) { m_isLoop = loop; }
+
+		// play from the beginning on the source
+		void play(ALuint source);
+		void stop(ALuint source);
+
+		// refill processed buffers, main thread only
+		void update(ALuint source);
+
+		// stats, encoded bytes plus pcm chunks and milliseconds spent reading the file
+		const String& getPath() const { return m_path; }
+		size_t getMemorySize() const;
+		ui32 getLoadTime() const { return m_loadTime; }
+
+	private:
+		// decode until the pcm ring is full
+		void decodeChunks();
+
+		// worker
+		static void decodeThread(void* stream);
+
+		// wake worker
+		void requestDecode();
+
+		// upload next decoded chunk to buffer, false when nothing is ready
+		bool queueChunk(ALuint source, ALuint buffer);
+
+	private:
+		static const ui32 BufferCount = 4;
+		static const ui32 ChunkCount = 4;
+
+		struct Chunk
+		{
+			vector<i16>::type	m_pcm;
+			ui32				m_frames = 0;
+		};
+
+		String			m_path;
+		MemoryReader*	m_file = nullptr;
+		AudioDecoder	m_decoder;
+		ui32			m_chunkFrames = 0;
+		ui32			m_loadTime = 0;
+		bool			m_isLoop = false;
+		bool			m_isPlaying = false;
+		ALuint			m_buffers[BufferCount];
+		ALuint			m_freeBuffers[BufferCount];
+		ui32			m_freeBufferCount = 0;
+		Chunk			m_chunks[ChunkCount];
+		ui32			m_readIdx = 0;
+		ui32			m_writeIdx = 0;
+		ui32			m_readyCount = 0;
+		bool			m_decodeEnd = false;
+		std::atomic<bool>	m_quit;
+		Mutex			m_decodeMutex;
+		Mutex			m_chunkMutex;
+		ThreadEvent		m_decodeEvent;
+		Thread			m_thread;
+	};
+
+	// shared cache of decoded clips keyed by resource path
+	class AudioClipCache
+	{
+	public:
+		typedef map<String, AudioClip*>::type ClipMap;
+
+	public:
+		~AudioClipCache();
+
+		// instance
+		static AudioClipCache* instance();
+
+		// get or decode clip, every acquire needs a release
+		AudioClip* acquire(const String& path);
+		void release(AudioClip* clip);
+
+		// assets with more encoded bytes than the threshold are streamed instead of cached
+		bool isStreamed(const String& path) const;
+		size_t getStreamThreshold() const { return m_streamThreshold; }
+		void setStreamThreshold(size_t bytes) { m_streamThreshold = bytes; }
+
+		// stats
+		const ClipMap& getClips() const { return m_clips; }
+		size_t getMemorySize() const;
+
+	private:
+		AudioClipCache() {}
+
+	private:
+		ClipMap			m_clips;
+		size_t			m_streamThreshold = 1024 * 1024;
+	};
+}
@@ -2,6 +2,7 @@
 #include "audio_player.h"
 #include "audio_listener.h"
 #include "audio_device.h"
+#include "audio_buffer.h"
 #include "editor/audio_player_editor.h"
 #include "editor/audio_listener_editor.h"
 
@@ -16,6 +17,8 @@ namespace Echo
 
 	AudioModule::~AudioModule()
 	{
+		// clips own al buffers, free them while the context is alive
+		EchoSafeDeleteInstance(AudioClipCache);
 		EchoSafeDeleteInstance(AudioDevice);
 	}
 
@@ -1,18 +1,11 @@
 #include "audio_player.h"
-#define DR_MP3_IMPLEMENTATION
-#include "dr_libs/dr_mp3.h"
-#include "dr_libs/dr_flac.h"
-#define DR_WAV_IMPLEMENTATION
-#include "dr_libs/dr_wav.h"
 #include "engine/core/main/Engine.h"
-#include "engine/core/io/IO.h"
 
 namespace Echo
 {
 	AudioPlayer::AudioPlayer()
 	{
 		alGenSources(1, &m_source);
-		alGenBuffers(1, &m_buffer);
 	}
 
 	AudioPlayer::~AudioPlayer()
@@ -20,9 +13,9 @@ namespace Echo
         if(m_source!=-1)
         {
             stop();
+            unloadBuff();
             
             alDeleteSources(1, &m_source);
-            alDeleteBuffers(1, &m_buffer);
         }
 
 		EchoSafeDeleteContainer(m_oneShotPlayers, AudioPlayer);
@@ -41,6 +34,9 @@ namespace Echo
         CLASS_BIND_METHOD(AudioPlayer, setPlayOnAwake,      DEF_METHOD("setPlayOnAwake"));
         CLASS_BIND_METHOD(AudioPlayer, getAudio,	        DEF_METHOD("getAudio"));
         CLASS_BIND_METHOD(AudioPlayer, setAudio,	        DEF_METHOD("setAudio"));
+        CLASS_BIND_METHOD(AudioPlayer, isStreaming,         DEF_METHOD("isStreaming"));
+        CLASS_BIND_METHOD(AudioPlayer, getMemorySize,       DEF_METHOD("getMemorySize"));
+        CLASS_BIND_METHOD(AudioPlayer, getLoadTime,         DEF_METHOD("getLoadTime"));
 
 		CLASS_REGISTER_PROPERTY(AudioPlayer, "Is2D", Variant::Type::Bool, "is2d", "set2d");
         CLASS_REGISTER_PROPERTY(AudioPlayer, "Loop", Variant::Type::Bool, "isLoop", "setLoop");
@@ -67,7 +63,11 @@ namespace Echo
 	{
 		m_isLoop = loop;
 
-		alSourcei( m_source, AL_LOOPING, m_isLoop);
+		// streams loop by rewinding the decoder, the source itself never loops
+		if (m_stream)
+			m_stream->setLoop(m_isLoop);
+		else
+			alSourcei( m_source, AL_LOOPING, m_isLoop);
 	}
     
     void AudioPlayer::set2d(bool is2d)
@@ -109,6 +109,10 @@ namespace Echo
 		// update self position
 		updatePosition(position);
 
+		// keep stream buffers queued
+		if (m_stream)
+			m_stream->update(m_source);
+
 		// one shot players
 		if (!m_oneShotPlayers.empty())
 		{
@@ -140,11 +144,19 @@ namespace Echo
 
 	void AudioPlayer::play()
 	{    
-		//assign the buffer to this source
-		alSourcei(m_source, AL_BUFFER, m_buffer);
+		if (m_stream)
+		{
+			m_stream->play(m_source);
+		}
+		else if (m_clip)
+		{
+			//assign the shared buffer to this source
+			alSourcei(m_source, AL_BUFFER, m_clip->getBuffer());
+			alSourcei(m_source, AL_LOOPING, m_isLoop);
 
-        // play
-        alSourcePlay( m_source);
+			// play
+			alSourcePlay(m_source);
+		}
 	}
     
     void AudioPlayer::pause()
@@ -154,7 +166,10 @@ namespace Echo
     
     void AudioPlayer::stop()
     {
-        alSourceStop( m_source);
+		if (m_stream)
+			m_stream->stop(m_source);
+		else
+			alSourceStop( m_source);
     }
     
     void AudioPlayer::setAudio(const ResourcePath& res)
@@ -164,44 +179,61 @@ namespace Echo
 		{
 			loadBuff();
 		}
+		else
+		{
+			unloadBuff();
+		}
     }
     
     bool AudioPlayer::loadBuff()
     {
-		MemoryReader memReader(m_audioRes.getPath());
-		if (memReader.getSize())
+		unloadBuff();
+
+		const String& path = m_audioRes.getPath();
+		if (AudioClipCache::instance()->isStreamed(path))
 		{
-			drmp3 mp3;
-			drmp3_config config;
-			config.outputChannels = 1;
-			config.outputSampleRate = DR_MP3_DEFAULT_SAMPLE_RATE;
-			if (drmp3_init_memory(&mp3, memReader.getData<const void*>(), memReader.getSize(), &config))
-			{
-				drmp3_uint64 frameCount = drmp3_get_pcm_frame_count(&mp3);
+			m_stream = EchoNew(AudioStream(path));
+			m_stream->setLoop(m_isLoop);
+			alSourcei(m_source, AL_LOOPING, AL_FALSE);
+			return m_stream->isValid();
+		}
+		else
+		{
+			m_clip = AudioClipCache::instance()->acquire(path);
+			alSourcei(m_source, AL_LOOPING, m_isLoop);
+			return m_clip->isValid();
+		}
+    }
 
-				//drmp3_uint32 channels = mp3.channels;
-				float* audioBuffer = new float[frameCount];
-				i16* audioBuffer16 = new i16[frameCount];
-				drmp3_uint64 framesRead = drmp3_read_pcm_frames_f32(&mp3, frameCount, audioBuffer);
-				if (framesRead > 0)
-				{
-					ALenum  audioFormat = AL_FORMAT_MONO16;
-					ALint   audioBufferLen = static_cast<ALint>(framesRead * sizeof(i16));
-					ALint   audioFrequency = mp3.sampleRate;
+	void AudioPlayer::unloadBuff()
+	{
+		// the source must let go of the buffers before they can be released
+		alSourceStop(m_source);
+		alSourcei(m_source, AL_BUFFER, 0);
 
-					drwav_f32_to_s16(audioBuffer16, audioBuffer, framesRead);
-					alBufferData(m_buffer, audioFormat, audioBuffer16, audioBufferLen, audioFrequency);
-				}
+		EchoSafeDelete(m_stream, AudioStream);
+		if (m_clip)
+		{
+			AudioClipCache::instance()->release(m_clip);
+			m_clip = nullptr;
+		}
+	}
 
-				delete[] audioBuffer;
-				delete[] audioBuffer16;
+	i32 AudioPlayer::getMemorySize() const
+	{
+		if (m_stream)	return i32(m_stream->getMemorySize());
+		if (m_clip)		return i32(m_clip->getMemorySize());
 
-				return true;
-			}
-		}
-        
-        return false;
-    }
+		return 0;
+	}
+
+	i32 AudioPlayer::getLoadTime() const
+	{
+		if (m_stream)	return i32(m_stream->getLoadTime());
+		if (m_clip)		return i32(m_clip->getLoadTime());
+
+		return 0;
+	}
 
 	void AudioPlayer::playOneShot(const char* res, float volumeScale)
 	{
@@ -2,6 +2,7 @@
 
 #include "engine/core/scene/node.h"
 #include "audio_base.h"
+#include "audio_buffer.h"
 
 namespace Echo
 {
@@ -48,6 +49,11 @@ namespace Echo
         void setAudio(const ResourcePath& res);
         const ResourcePath& getAudio() const { return m_audioRes; }
 
+		// stats of the current audio, long assets are streamed instead of decoded at once
+		bool isStreaming() const { return m_stream ? true : false; }
+		i32 getMemorySize() const;
+		i32 getLoadTime() const;
+
 		// special operate
 		void playOneShot(const char* res, float volumeScale);
 
@@ -65,9 +71,13 @@ namespace Echo
         // load audio data from file
         bool loadBuff();
 
+		// release clip or stream
+		void unloadBuff();
+
 	private:
 		ALuint				m_source = -1;
-		ALuint				m_buffer;
+		AudioClip*			m_clip = nullptr;
+		AudioStream*		m_stream = nullptr;
 		float				m_pitch;
 		float				m_gain = 1.f;
 		bool				m_isLoop = false;
@@ -7,6 +7,9 @@ namespace Echo
 	Box2DBody::Box2DBody()
 		: m_type("Static", { "Static", "Kinematic", "Dynamic" })
 	{
+		// box2d reports contacts inside the world step, where bodies can't be changed
+		beginContact.setDispatchMode(Signal::DispatchMode::Deferred);
+		endContact.setDispatchMode(Signal::DispatchMode::Deferred);
 	}
 
 	Box2DBody::~Box2DBody()
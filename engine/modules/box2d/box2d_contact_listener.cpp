@@ -13,7 +13,9 @@ namespace Echo
 		Box2DBody* bodyA = (Box2DBody*)contact->GetFixtureA()->GetBody()->GetUserData();
         Box2DBody* bodyB = (Box2DBody*)contact->GetFixtureB()->GetBody()->GetUserData();
         
-        m_signals.emplace_back(bodyA->getId(), bodyB->getId(), true);
+        // contact signals are deferred, they run after the world step
+        bodyA->beginContact();
+        bodyB->beginContact();
     }
 
     void Box2DContactListener::EndContact(b2Contact* contact)
@@ -21,32 +23,7 @@ namespace Echo
 		Box2DBody* bodyA = (Box2DBody*)contact->GetFixtureA()->GetBody()->GetUserData();
         Box2DBody* bodyB = (Box2DBody*)contact->GetFixtureB()->GetBody()->GetUserData();
 
-        m_signals.emplace_back(bodyA->getId(), bodyB->getId(), false);
-    }
-
-    void Box2DContactListener::EmitSignals()
-    {
-        for(const SignalCache& signal : m_signals)
-        {
-            Box2DBody* bodyA = ECHO_DOWN_CAST<Box2DBody*>(Object::getById(signal.m_bodyAId));
-            if(bodyA)
-            {
-                if(signal.m_isBegin)
-                    bodyA->beginContact();
-                else
-                    bodyA->endContact();
-            }
-            
-            Box2DBody* bodyB = ECHO_DOWN_CAST<Box2DBody*>(Object::getById(signal.m_bodyBId));
-            if(bodyB)
-            {
-                if(signal.m_isBegin)
-                    bodyB->beginContact();
-                else
-                    bodyB->endContact();
-            }
-        }
-        
-        m_signals.clear();
+        bodyA->endContact();
+        bodyB->endContact();
     }
 }
@@ -43,7 +43,7 @@ namespace Echo
     {
         if(!m_bodyA.getPath().empty())
         {
-            Box2DBody* body = getNodeT<Box2DBody*>(m_bodyA.getPath().c_str());
+            Box2DBody* body = ECHO_DOWN_CAST<Box2DBody*>(m_bodyA.getNode(this));
             return body ? body->getb2Body() : nullptr;
         }
         
@@ -54,7 +54,7 @@ namespace Echo
     {
         if(!m_bodyB.getPath().empty())
         {
-            Box2DBody* body = getNodeT<Box2DBody*>(m_bodyB.getPath().c_str());
+            Box2DBody* body = ECHO_DOWN_CAST<Box2DBody*>(m_bodyB.getNode(this));
             return body ? body->getb2Body() : nullptr;
         }
         
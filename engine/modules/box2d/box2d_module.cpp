@@ -122,8 +122,5 @@ namespace Echo
             m_b2World->DrawDebugData();
             m_debugDraw->Update(elapsedTime);
         }
-        
-        // emit signals
-        m_contactListener->EmitSignals();
 	}
 }
@@ -0,0 +1,64 @@
+#include "emitter.h"
+
+namespace Echo
+{
+    ui32 ParticleEmitter::emit(ParticleStreams& streams, float elapsedTime)
+    {
+        m_accumulator += m_rate * elapsedTime;
+        ui32 count = ui32(m_accumulator);
+        m_accumulator -= float(count);
+
+        return burst(streams, count);
+    }
+
+    ui32 ParticleEmitter::burst(ParticleStreams& streams, ui32 count)
+    {
+        ui32 first = streams.spawn(count);
+        ui32 last = streams.getCount();
+
+        float* px = streams.get(ParticleStreams::PositionX);
+        float* py = streams.get(ParticleStreams::PositionY);
+        float* pz = streams.get(ParticleStreams::PositionZ);
+        float* vx = streams.get(ParticleStreams::VelocityX);
+        float* vy = streams.get(ParticleStreams::VelocityY);
+        float* vz = streams.get(ParticleStreams::VelocityZ);
+        float* cr = streams.get(ParticleStreams::ColorR);
+        float* cg = streams.get(ParticleStreams::ColorG);
+        float* cb = streams.get(ParticleStreams::ColorB);
+        float* ca = streams.get(ParticleStreams::ColorA);
+        float* size = streams.get(ParticleStreams::Size);
+        float* age = streams.get(ParticleStreams::Age);
+        float* invLifetime = streams.get(ParticleStreams::InvLifetime);
+        for (ui32 i = first; i < last; i++)
+        {
+            px[i] = m_position.x + (random() * 2.f - 1.f) * m_extent.x;
+            py[i] = m_position.y + (random() * 2.f - 1.f) * m_extent.y;
+            pz[i] = m_position.z + (random() * 2.f - 1.f) * m_extent.z;
+
+            float speed = m_speedMin + (m_speedMax - m_speedMin) * random();
+            vx[i] = (m_direction.x + (random() * 2.f - 1.f) * m_spread) * speed;
+            vy[i] = (m_direction.y + (random() * 2.f - 1.f) * m_spread) * speed;
+            vz[i] = (m_direction.z + (random() * 2.f - 1.f) * m_spread) * speed;
+
+            cr[i] = m_color.r;
+            cg[i] = m_color.g;
+            cb[i] = m_color.b;
+            ca[i] = m_color.a;
+            size[i] = m_size;
+            age[i] = 0.f;
+            invLifetime[i] = 1.f / std::max<float>(m_lifetimeMin + (m_lifetimeMax - m_lifetimeMin) * random(), 1e-3f);
+        }
+
+        return last - first;
+    }
+
+    float ParticleEmitter::random()
+    {
+        // xorshift32
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+
+        return float(m_seed >> 8) * (1.f / 16777216.f);
+    }
+}
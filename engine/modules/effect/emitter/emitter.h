@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../particle/particle.h"
+
+namespace Echo
+{
+    // spawns particles at a fixed rate inside a box, velocity is direction * speed
+    // plus a random offset scaled by spread
+    struct ParticleEmitter
+    {
+        float       m_rate = 20.f;                  // particles per second
+        Vector3     m_position = Vector3::ZERO;     // spawn box center
+        Vector3     m_extent = Vector3::ZERO;       // spawn box half size
+        Vector3     m_direction = Vector3::UNIT_Y;
+        float       m_speedMin = 50.f;
+        float       m_speedMax = 100.f;
+        float       m_spread = 0.3f;
+        float       m_lifetimeMin = 1.f;
+        float       m_lifetimeMax = 2.f;
+        float       m_size = 16.f;
+        Color       m_color = Color::WHITE;
+
+        // spawn the particles due in elapsedTime, returns spawned count
+        ui32 emit(ParticleStreams& streams, float elapsedTime);
+
+        // spawn count particles now
+        ui32 burst(ParticleStreams& streams, ui32 count);
+
+    private:
+        // random in [0, 1)
+        float random();
+
+    private:
+        float       m_accumulator = 0.f;
+        ui32        m_seed = 0x9e3779b9;
+    };
+}
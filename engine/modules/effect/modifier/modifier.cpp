@@ -0,0 +1,133 @@
+#include "modifier.h"
+#include "engine/core/math/Simd.h"
+
+namespace Echo
+{
+    namespace
+    {
+        // dst[i] += value
+        void addScalar(float* dst, ui32 begin, ui32 end, float value)
+        {
+#ifdef ECHO_SIMD
+            Simd::Float4 v = Simd::splat(value);
+            for (ui32 i = begin; i < end; i += 4)
+                Simd::store(dst + i, Simd::add(Simd::load(dst + i), v));
+#else
+            for (ui32 i = begin; i < end; i++)
+                dst[i] += value;
+#endif
+        }
+
+        // dst[i] = start + (end - start) * min(age * invLifetime, 1)
+        void lerpOverLife(float* dst, const float* age, const float* invLifetime, ui32 begin, ui32 end, float start, float finish)
+        {
+#ifdef ECHO_SIMD
+            Simd::Float4 one = Simd::splat(1.f);
+            Simd::Float4 s = Simd::splat(start);
+            Simd::Float4 d = Simd::splat(finish - start);
+            for (ui32 i = begin; i < end; i += 4)
+            {
+                Simd::Float4 t = Simd::min(Simd::mul(Simd::load(age + i), Simd::load(invLifetime + i)), one);
+                Simd::store(dst + i, Simd::madd(t, d, s));
+            }
+#else
+            for (ui32 i = begin; i < end; i++)
+                dst[i] = start + (finish - start) * std::min<float>(age[i] * invLifetime[i], 1.f);
+#endif
+        }
+
+#ifdef ECHO_SIMD
+        // smoothstepped triangle wave in [-1, 1] with period 1
+        Simd::Float4 wave(Simd::Float4 x)
+        {
+            Simd::Float4 one = Simd::splat(1.f);
+            Simd::Float4 two = Simd::splat(2.f);
+            Simd::Float4 tri = Simd::abs(Simd::sub(Simd::mul(Simd::sub(x, Simd::floor(x)), two), one));
+            Simd::Float4 s = Simd::mul(Simd::mul(tri, tri), Simd::sub(Simd::splat(3.f), Simd::mul(tri, two)));
+            return Simd::sub(Simd::mul(s, two), one);
+        }
+#else
+        float wave(float x)
+        {
+            float tri = std::abs((x - std::floor(x)) * 2.f - 1.f);
+            return tri * tri * (3.f - 2.f * tri) * 2.f - 1.f;
+        }
+#endif
+    }
+
+    void ParticleGravityModifier::apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime)
+    {
+        addScalar(streams.get(ParticleStreams::VelocityX), begin, end, m_acceleration.x * elapsedTime);
+        addScalar(streams.get(ParticleStreams::VelocityY), begin, end, m_acceleration.y * elapsedTime);
+        addScalar(streams.get(ParticleStreams::VelocityZ), begin, end, m_acceleration.z * elapsedTime);
+    }
+
+    void ParticleDragModifier::apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime)
+    {
+        float scale = std::max<float>(1.f - m_drag * elapsedTime, 0.f);
+        float* streamsToScale[] = { streams.get(ParticleStreams::VelocityX), streams.get(ParticleStreams::VelocityY), streams.get(ParticleStreams::VelocityZ) };
+        for (float* v : streamsToScale)
+        {
+#ifdef ECHO_SIMD
+            Simd::Float4 s = Simd::splat(scale);
+            for (ui32 i = begin; i < end; i += 4)
+                Simd::store(v + i, Simd::mul(Simd::load(v + i), s));
+#else
+            for (ui32 i = begin; i < end; i++)
+                v[i] *= scale;
+#endif
+        }
+    }
+
+    void ParticleColorOverLifeModifier::apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime)
+    {
+        const float* age = streams.get(ParticleStreams::Age);
+        const float* invLifetime = streams.get(ParticleStreams::InvLifetime);
+        lerpOverLife(streams.get(ParticleStreams::ColorR), age, invLifetime, begin, end, m_start.r, m_end.r);
+        lerpOverLife(streams.get(ParticleStreams::ColorG), age, invLifetime, begin, end, m_start.g, m_end.g);
+        lerpOverLife(streams.get(ParticleStreams::ColorB), age, invLifetime, begin, end, m_start.b, m_end.b);
+        lerpOverLife(streams.get(ParticleStreams::ColorA), age, invLifetime, begin, end, m_start.a, m_end.a);
+    }
+
+    void ParticleSizeOverLifeModifier::apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime)
+    {
+        lerpOverLife(streams.get(ParticleStreams::Size), streams.get(ParticleStreams::Age), streams.get(ParticleStreams::InvLifetime), begin, end, m_start, m_end);
+    }
+
+    void ParticleNoiseModifier::apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime)
+    {
+        const float* px = streams.get(ParticleStreams::PositionX);
+        const float* py = streams.get(ParticleStreams::PositionY);
+        const float* pz = streams.get(ParticleStreams::PositionZ);
+        float* vx = streams.get(ParticleStreams::VelocityX);
+        float* vy = streams.get(ParticleStreams::VelocityY);
+        float* vz = streams.get(ParticleStreams::VelocityZ);
+
+        // each axis is driven by another axis' position so the field swirls
+#ifdef ECHO_SIMD
+        Simd::Float4 frequency = Simd::splat(m_frequency);
+        Simd::Float4 time = Simd::splat(m_time);
+        Simd::Float4 timeY = Simd::splat(m_time + 0.31f);
+        Simd::Float4 timeZ = Simd::splat(m_time + 0.67f);
+        Simd::Float4 strength = Simd::splat(m_strength * elapsedTime);
+        for (ui32 i = begin; i < end; i += 4)
+        {
+            Simd::Float4 x = Simd::load(px + i);
+            Simd::Float4 y = Simd::load(py + i);
+            Simd::Float4 z = Simd::load(pz + i);
+            Simd::store(vx + i, Simd::madd(wave(Simd::madd(y, frequency, time)), strength, Simd::load(vx + i)));
+            Simd::store(vy + i, Simd::madd(wave(Simd::madd(z, frequency, timeY)), strength, Simd::load(vy + i)));
+            Simd::store(vz + i, Simd::madd(wave(Simd::madd(x, frequency, timeZ)), strength, Simd::load(vz + i)));
+        }
+#else
+        float strength = m_strength * elapsedTime;
+        for (ui32 i = begin; i < end; i++)
+        {
+            float x = px[i], y = py[i], z = pz[i];
+            vx[i] += wave(y * m_frequency + m_time) * strength;
+            vy[i] += wave(z * m_frequency + m_time + 0.31f) * strength;
+            vz[i] += wave(x * m_frequency + m_time + 0.67f) * strength;
+        }
+#endif
+    }
+}
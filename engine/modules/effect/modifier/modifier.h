@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../particle/particle.h"
+
+namespace Echo
+{
+    // modifiers run over [begin, end) of the particle streams, begin and end are
+    // multiples of 4. ranges of one tick may run on different threads at once
+    class ParticleModifier
+    {
+    public:
+        virtual ~ParticleModifier() {}
+
+        // called once per tick on the main thread before any range
+        virtual void prepare(float elapsedTime) {}
+
+        // apply to a range
+        virtual void apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime) = 0;
+    };
+
+    // constant acceleration
+    class ParticleGravityModifier : public ParticleModifier
+    {
+    public:
+        Vector3     m_acceleration = Vector3(0.f, -98.f, 0.f);
+
+        virtual void apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime) override;
+    };
+
+    // velocity *= 1 - drag * elapsedTime
+    class ParticleDragModifier : public ParticleModifier
+    {
+    public:
+        float       m_drag = 0.5f;
+
+        virtual void apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime) override;
+    };
+
+    // lerp color from start to end over the particle life
+    class ParticleColorOverLifeModifier : public ParticleModifier
+    {
+    public:
+        Color       m_start = Color::WHITE;
+        Color       m_end = Color(1.f, 1.f, 1.f, 0.f);
+
+        virtual void apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime) override;
+    };
+
+    // lerp size from start to end over the particle life
+    class ParticleSizeOverLifeModifier : public ParticleModifier
+    {
+    public:
+        float       m_start = 16.f;
+        float       m_end = 4.f;
+
+        virtual void apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime) override;
+    };
+
+    // smooth periodic turbulence sampled from the particle position
+    class ParticleNoiseModifier : public ParticleModifier
+    {
+    public:
+        float       m_strength = 50.f;
+        float       m_frequency = 0.02f;
+        float       m_speed = 0.5f;
+
+        virtual void prepare(float elapsedTime) override { m_time += elapsedTime * m_speed; }
+        virtual void apply(ParticleStreams& streams, ui32 begin, ui32 end, float elapsedTime) override;
+
+    private:
+        float       m_time = 0.f;
+    };
+}
@@ -2,11 +2,46 @@
 
 namespace Echo
 {
-    Particle::Particle()
+    ParticleStreams::ParticleStreams()
     {
     }
 
-    Particle::~Particle()
+    ParticleStreams::~ParticleStreams()
     {
     }
+
+    void ParticleStreams::setCapacity(ui32 capacity)
+    {
+        m_capacity = (capacity + 3) & ~3u;
+        m_count = std::min<ui32>(m_count, m_capacity);
+        for (vector<float>::type& stream : m_streams)
+            stream.resize(m_capacity, 0.f);
+    }
+
+    ui32 ParticleStreams::spawn(ui32 count)
+    {
+        ui32 first = m_count;
+        m_count += std::min<ui32>(count, getFreeCount());
+        return first;
+    }
+
+    void ParticleStreams::killExpired()
+    {
+        const float* age = get(Age);
+        const float* invLifetime = get(InvLifetime);
+        for (ui32 i = 0; i < m_count; )
+        {
+            if (age[i] * invLifetime[i] >= 1.f)
+            {
+                // move the last live particle into the hole
+                m_count--;
+                for (vector<float>::type& stream : m_streams)
+                    stream[i] = stream[m_count];
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
 }
@@ -4,17 +4,61 @@
 
 namespace Echo
 {
-    class Particle
+    // particle attributes stored as one contiguous float stream per component (SoA).
+    // live particles always occupy [0, count), dead ones are swapped with the last,
+    // so kernels run over dense arrays and emitters spawn into the free tail.
+    class ParticleStreams
     {
     public:
-        Particle();
-        ~Particle();
-        
+        enum Stream
+        {
+            PositionX = 0,
+            PositionY,
+            PositionZ,
+            VelocityX,
+            VelocityY,
+            VelocityZ,
+            ColorR,
+            ColorG,
+            ColorB,
+            ColorA,
+            Size,
+            Age,
+            InvLifetime,
+            StreamCount,
+        };
+
+    public:
+        ParticleStreams();
+        ~ParticleStreams();
+
+        // capacity, rounded up to a multiple of 4 so kernels never need a scalar tail
+        ui32 getCapacity() const { return m_capacity; }
+        void setCapacity(ui32 capacity);
+
+        // live particles
+        ui32 getCount() const { return m_count; }
+        ui32 getFreeCount() const { return m_capacity - m_count; }
+
+        // count rounded up to 4, the padding slots hold garbage but are safe to process
+        ui32 getPaddedCount() const { return (m_count + 3) & ~3u; }
+
+        // spawn count particles at the tail, returns index of the first one
+        ui32 spawn(ui32 count);
+
+        // kill particles whose age reached their lifetime
+        void killExpired();
+
+        // clear
+        void clear() { m_count = 0; }
+
+        // stream data
+        float* get(Stream stream) { return m_streams[stream].data(); }
+        const float* get(Stream stream) const { return m_streams[stream].data(); }
+
     private:
-        Vector3 m_position;
-        Vector3 m_velocity;
-        Color   m_color;
-        float   m_life;
+        ui32                    m_capacity = 0;
+        ui32                    m_count = 0;
+        vector<float>::type     m_streams[StreamCount];
     };
 }
-
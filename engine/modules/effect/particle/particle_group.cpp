@@ -1,4 +1,6 @@
 #include "particle_group.h"
+#include "engine/core/thread/pool/ParallelWorkers.h"
+#include "engine/core/math/Simd.h"
 
 namespace Echo
 {
@@ -8,10 +10,111 @@ namespace Echo
 
     ParticleGroup::~ParticleGroup()
     {
+        EchoSafeDeleteContainer(m_modifiers, ParticleModifier);
+    }
+
+    void ParticleGroup::addModifier(ParticleModifier* modifier)
+    {
+        m_modifiers.emplace_back(modifier);
     }
 
     void ParticleGroup::tick(float elapsedTime)
     {
-        
+        m_emitter.emit(m_streams, elapsedTime);
+
+        for (ParticleModifier* modifier : m_modifiers)
+            modifier->prepare(elapsedTime);
+
+        // every range runs the whole modifier chain so its streams stay in cache
+        ParallelWorkers::instance()->parallelFor(m_streams.getPaddedCount(), ParallelGrain, [&](ui32 begin, ui32 end)
+        {
+            for (ParticleModifier* modifier : m_modifiers)
+                modifier->apply(m_streams, begin, end, elapsedTime);
+
+            integrate(begin, end, elapsedTime);
+        });
+
+        m_streams.killExpired();
+    }
+
+    void ParticleGroup::integrate(ui32 begin, ui32 end, float elapsedTime)
+    {
+        float* age = m_streams.get(ParticleStreams::Age);
+        const ParticleStreams::Stream positions[] = { ParticleStreams::PositionX, ParticleStreams::PositionY, ParticleStreams::PositionZ };
+        const ParticleStreams::Stream velocities[] = { ParticleStreams::VelocityX, ParticleStreams::VelocityY, ParticleStreams::VelocityZ };
+
+#ifdef ECHO_SIMD
+        Simd::Float4 dt = Simd::splat(elapsedTime);
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float* p = m_streams.get(positions[axis]);
+            const float* v = m_streams.get(velocities[axis]);
+            for (ui32 i = begin; i < end; i += 4)
+                Simd::store(p + i, Simd::madd(Simd::load(v + i), dt, Simd::load(p + i)));
+        }
+
+        for (ui32 i = begin; i < end; i += 4)
+            Simd::store(age + i, Simd::add(Simd::load(age + i), dt));
+#else
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float* p = m_streams.get(positions[axis]);
+            const float* v = m_streams.get(velocities[axis]);
+            for (ui32 i = begin; i < end; i++)
+                p[i] += v[i] * elapsedTime;
+        }
+
+        for (ui32 i = begin; i < end; i++)
+            age[i] += elapsedTime;
+#endif
+    }
+
+    AABB ParticleGroup::buildVertices(Vertex* vertices)
+    {
+        const ui32 count = m_streams.getCount();
+        m_rangeBoxes.assign((count + ParallelGrain - 1) / ParallelGrain, AABB());
+
+        const float* px = m_streams.get(ParticleStreams::PositionX);
+        const float* py = m_streams.get(ParticleStreams::PositionY);
+        const float* pz = m_streams.get(ParticleStreams::PositionZ);
+        const float* cr = m_streams.get(ParticleStreams::ColorR);
+        const float* cg = m_streams.get(ParticleStreams::ColorG);
+        const float* cb = m_streams.get(ParticleStreams::ColorB);
+        const float* ca = m_streams.get(ParticleStreams::ColorA);
+        const float* size = m_streams.get(ParticleStreams::Size);
+        ParallelWorkers::instance()->parallelFor(count, ParallelGrain, [&](ui32 begin, ui32 end)
+        {
+            Vector3 boxMin(Math::MAX_REAL, Math::MAX_REAL, Math::MAX_REAL);
+            Vector3 boxMax(-Math::MAX_REAL, -Math::MAX_REAL, -Math::MAX_REAL);
+            for (ui32 i = begin; i < end; i++)
+            {
+                float h = size[i] * 0.5f;
+                Dword r = Dword(Math::Clamp(cr[i], 0.f, 1.f) * 255.f + 0.5f);
+                Dword g = Dword(Math::Clamp(cg[i], 0.f, 1.f) * 255.f + 0.5f);
+                Dword b = Dword(Math::Clamp(cb[i], 0.f, 1.f) * 255.f + 0.5f);
+                Dword a = Dword(Math::Clamp(ca[i], 0.f, 1.f) * 255.f + 0.5f);
+                Dword color = (a << 24) | (b << 16) | (g << 8) | r;
+
+                Vertex* quad = vertices + i * 4;
+                quad[0].m_position = Vector3(px[i] - h, py[i] - h, pz[i]); quad[0].m_uv = Vector2(0.f, 1.f);
+                quad[1].m_position = Vector3(px[i] - h, py[i] + h, pz[i]); quad[1].m_uv = Vector2(0.f, 0.f);
+                quad[2].m_position = Vector3(px[i] + h, py[i] + h, pz[i]); quad[2].m_uv = Vector2(1.f, 0.f);
+                quad[3].m_position = Vector3(px[i] + h, py[i] - h, pz[i]); quad[3].m_uv = Vector2(1.f, 1.f);
+                quad[0].m_color = quad[1].m_color = quad[2].m_color = quad[3].m_color = color;
+
+                boxMin.x = std::min<float>(boxMin.x, px[i] - h); boxMax.x = std::max<float>(boxMax.x, px[i] + h);
+                boxMin.y = std::min<float>(boxMin.y, py[i] - h); boxMax.y = std::max<float>(boxMax.y, py[i] + h);
+                boxMin.z = std::min<float>(boxMin.z, pz[i]);     boxMax.z = std::max<float>(boxMax.z, pz[i]);
+            }
+
+            if (begin < end)
+                m_rangeBoxes[begin / ParallelGrain] = AABB(boxMin, boxMax);
+        });
+
+        AABB box;
+        for (const AABB& rangeBox : m_rangeBoxes)
+            box.unionBox(rangeBox);
+
+        return box;
     }
 }
@@ -1,20 +1,59 @@
 #pragma once
 
+#include "engine/core/geom/AABB.h"
 #include "particle.h"
+#include "../emitter/emitter.h"
+#include "../modifier/modifier.h"
 
 namespace Echo
 {
+    // one simulated set of particles: an emitter, its modifiers and the SoA streams
     class ParticleGroup
     {
+    public:
+        // billboard vertex, matches MeshVertexFormat with vertex color and uv
+        struct Vertex
+        {
+            Vector3     m_position;
+            Dword       m_color;
+            Vector2     m_uv;
+        };
+        typedef vector<ParticleModifier*>::type ModifierArray;
+
+        // particles per worker range, systems smaller than this stay on the calling thread
+        static const ui32 ParallelGrain = 8192;
+
     public:
         ParticleGroup();
         ~ParticleGroup();
-        
-        // tick
+
+        // streams
+        ParticleStreams& getStreams() { return m_streams; }
+        const ParticleStreams& getStreams() const { return m_streams; }
+        ui32 getCount() const { return m_streams.getCount(); }
+
+        // emitter
+        ParticleEmitter& getEmitter() { return m_emitter; }
+        const ParticleEmitter& getEmitter() const { return m_emitter; }
+
+        // modifiers, the group owns them
+        void addModifier(ParticleModifier* modifier);
+        const ModifierArray& getModifiers() const { return m_modifiers; }
+
+        // tick, emit then run every modifier and integrate, then drop expired particles
         void tick(float elapsedTime);
-        
+
+        // write 4 vertices per live particle in the xy plane, returns the bounding box
+        AABB buildVertices(Vertex* vertices);
+
     private:
-        vector<Particle>::type  m_particles;
+        // position += velocity * elapsedTime, age += elapsedTime
+        void integrate(ui32 begin, ui32 end, float elapsedTime);
+
+    private:
+        ParticleStreams         m_streams;
+        ParticleEmitter         m_emitter;
+        ModifierArray           m_modifiers;
+        vector<AABB>::type      m_rangeBoxes;
     };
 }
-
@@ -10,6 +10,22 @@ namespace Echo
     ParticleSystem::ParticleSystem()
         : Render()
     {
+        m_gravity = EchoNew(ParticleGravityModifier);
+        m_drag = EchoNew(ParticleDragModifier);
+        m_noise = EchoNew(ParticleNoiseModifier);
+        m_colorOverLife = EchoNew(ParticleColorOverLifeModifier);
+        m_sizeOverLife = EchoNew(ParticleSizeOverLifeModifier);
+
+        // forces first, then the over life modifiers
+        m_group.addModifier(m_gravity);
+        m_group.addModifier(m_drag);
+        m_group.addModifier(m_noise);
+        m_group.addModifier(m_colorOverLife);
+        m_group.addModifier(m_sizeOverLife);
+
+        m_drag->m_drag = 0.f;
+        m_noise->m_strength = 0.f;
+        m_group.getStreams().setCapacity(1024);
     }
 
     ParticleSystem::~ParticleSystem()
@@ -22,9 +38,46 @@ namespace Echo
     {
         CLASS_BIND_METHOD(ParticleSystem, getMaterial,        DEF_METHOD("getMaterial"));
         CLASS_BIND_METHOD(ParticleSystem, setMaterial,        DEF_METHOD("setMaterial"));
+        CLASS_BIND_METHOD(ParticleSystem, getMaxParticles,    DEF_METHOD("getMaxParticles"));
+        CLASS_BIND_METHOD(ParticleSystem, setMaxParticles,    DEF_METHOD("setMaxParticles"));
+        CLASS_BIND_METHOD(ParticleSystem, getEmitRate,        DEF_METHOD("getEmitRate"));
+        CLASS_BIND_METHOD(ParticleSystem, setEmitRate,        DEF_METHOD("setEmitRate"));
+        CLASS_BIND_METHOD(ParticleSystem, getLifetime,        DEF_METHOD("getLifetime"));
+        CLASS_BIND_METHOD(ParticleSystem, setLifetime,        DEF_METHOD("setLifetime"));
+        CLASS_BIND_METHOD(ParticleSystem, getSpeed,           DEF_METHOD("getSpeed"));
+        CLASS_BIND_METHOD(ParticleSystem, setSpeed,           DEF_METHOD("setSpeed"));
+        CLASS_BIND_METHOD(ParticleSystem, getDirection,       DEF_METHOD("getDirection"));
+        CLASS_BIND_METHOD(ParticleSystem, setDirection,       DEF_METHOD("setDirection"));
+        CLASS_BIND_METHOD(ParticleSystem, getSpread,          DEF_METHOD("getSpread"));
+        CLASS_BIND_METHOD(ParticleSystem, setSpread,          DEF_METHOD("setSpread"));
+        CLASS_BIND_METHOD(ParticleSystem, getSize,            DEF_METHOD("getSize"));
+        CLASS_BIND_METHOD(ParticleSystem, setSize,            DEF_METHOD("setSize"));
+        CLASS_BIND_METHOD(ParticleSystem, getStartColor,      DEF_METHOD("getStartColor"));
+        CLASS_BIND_METHOD(ParticleSystem, setStartColor,      DEF_METHOD("setStartColor"));
+        CLASS_BIND_METHOD(ParticleSystem, getEndColor,        DEF_METHOD("getEndColor"));
+        CLASS_BIND_METHOD(ParticleSystem, setEndColor,        DEF_METHOD("setEndColor"));
+        CLASS_BIND_METHOD(ParticleSystem, getGravity,         DEF_METHOD("getGravity"));
+        CLASS_BIND_METHOD(ParticleSystem, setGravity,         DEF_METHOD("setGravity"));
+        CLASS_BIND_METHOD(ParticleSystem, getDrag,            DEF_METHOD("getDrag"));
+        CLASS_BIND_METHOD(ParticleSystem, setDrag,            DEF_METHOD("setDrag"));
+        CLASS_BIND_METHOD(ParticleSystem, getNoise,           DEF_METHOD("getNoise"));
+        CLASS_BIND_METHOD(ParticleSystem, setNoise,           DEF_METHOD("setNoise"));
+        CLASS_BIND_METHOD(ParticleSystem, getParticleCount,   DEF_METHOD("getParticleCount"));
 
         CLASS_REGISTER_PROPERTY(ParticleSystem, "Material", Variant::Type::Object, "getMaterial", "setMaterial");
         CLASS_REGISTER_PROPERTY_HINT(ParticleSystem, "Material", PropertyHintType::ResourceType, "Material");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "MaxParticles", Variant::Type::Int, "getMaxParticles", "setMaxParticles");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "EmitRate", Variant::Type::Real, "getEmitRate", "setEmitRate");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Lifetime", Variant::Type::Vector2, "getLifetime", "setLifetime");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Speed", Variant::Type::Vector2, "getSpeed", "setSpeed");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Direction", Variant::Type::Vector3, "getDirection", "setDirection");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Spread", Variant::Type::Real, "getSpread", "setSpread");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Size", Variant::Type::Vector2, "getSize", "setSize");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "StartColor", Variant::Type::Color, "getStartColor", "setStartColor");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "EndColor", Variant::Type::Color, "getEndColor", "setEndColor");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Gravity", Variant::Type::Vector3, "getGravity", "setGravity");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Drag", Variant::Type::Real, "getDrag", "setDrag");
+        CLASS_REGISTER_PROPERTY(ParticleSystem, "Noise", Variant::Type::Real, "getNoise", "setNoise");
     }
 
     void ParticleSystem::setMaterial(Object* material)
@@ -34,6 +87,50 @@ namespace Echo
         m_isRenderableDirty = true;
     }
 
+    void ParticleSystem::setMaxParticles(i32 maxParticles)
+    {
+        m_group.getStreams().setCapacity(ui32(std::max<i32>(maxParticles, 0)));
+    }
+
+    Vector2 ParticleSystem::getLifetime() const
+    {
+        const ParticleEmitter& emitter = m_group.getEmitter();
+        return Vector2(emitter.m_lifetimeMin, emitter.m_lifetimeMax);
+    }
+
+    void ParticleSystem::setLifetime(const Vector2& lifetime)
+    {
+        ParticleEmitter& emitter = m_group.getEmitter();
+        emitter.m_lifetimeMin = lifetime.x;
+        emitter.m_lifetimeMax = std::max<float>(lifetime.x, lifetime.y);
+    }
+
+    Vector2 ParticleSystem::getSpeed() const
+    {
+        const ParticleEmitter& emitter = m_group.getEmitter();
+        return Vector2(emitter.m_speedMin, emitter.m_speedMax);
+    }
+
+    void ParticleSystem::setSpeed(const Vector2& speed)
+    {
+        ParticleEmitter& emitter = m_group.getEmitter();
+        emitter.m_speedMin = speed.x;
+        emitter.m_speedMax = std::max<float>(speed.x, speed.y);
+    }
+
+    void ParticleSystem::setSize(const Vector2& size)
+    {
+        m_sizeOverLife->m_start = size.x;
+        m_sizeOverLife->m_end = size.y;
+        m_group.getEmitter().m_size = size.x;
+    }
+
+    void ParticleSystem::setStartColor(const Color& color)
+    {
+        m_colorOverLife->m_start = color;
+        m_group.getEmitter().m_color = color;
+    }
+
     void ParticleSystem::buildRenderable()
     {
         if (m_isRenderableDirty)
@@ -49,9 +146,6 @@ namespace Echo
                 m_material->setShaderPath(shader->getPath());
             }
 
-            // mesh
-            updateMeshBuffer();
-
             // create render able
             m_renderable = Renderable::create(m_mesh, m_material, this);
 
@@ -61,8 +155,11 @@ namespace Echo
 
     void ParticleSystem::update_self()
     {
-        if (isNeedRender())
+        m_group.tick(Engine::instance()->getFrameTime());
+
+        if (isNeedRender() && m_group.getCount())
         {
+            updateMeshBuffer();
             buildRenderable();
             if (m_renderable)
             {
@@ -77,30 +174,46 @@ namespace Echo
         {
             m_mesh = Mesh::create(true, true);
         }
-        
+
         if(m_mesh)
         {
-            // indices
-            IndiceArray indices = { 0, 1, 2, 0, 2, 3 };
-
-            float hw = 64 * 0.5f;
-            float hh = 64 * 0.5f;
+            // indices only change when the live count leaves [indexed / 2, indexed]
+            const ui32 count = m_group.getCount();
+            if (count > m_indexedParticles || count < m_indexedParticles / 2)
+            {
+                m_indexedParticles = std::min<ui32>(count + count / 4 + 16, m_group.getStreams().getCapacity());
+                m_indices.resize(m_indexedParticles * 6);
+                for (ui32 i = 0; i < m_indexedParticles; i++)
+                {
+                    ui32* quad = &m_indices[i * 6];
+                    quad[0] = i * 4;
+                    quad[1] = i * 4 + 1;
+                    quad[2] = i * 4 + 2;
+                    quad[3] = i * 4;
+                    quad[4] = i * 4 + 2;
+                    quad[5] = i * 4 + 3;
+                }
+
+                m_mesh->updateIndices(static_cast<ui32>(m_indices.size()), sizeof(ui32), m_indices.data());
+            }
 
-            // vertices
-            VertexArray vertices;
-            vertices.emplace_back(Vector3(-hw, -hh, 0.f), Vector2(0.f, 1.f));
-            vertices.emplace_back(Vector3(-hw,  hh, 0.f), Vector2(0.f, 0.f));
-            vertices.emplace_back(Vector3(hw,   hh, 0.f), Vector2(1.f, 0.f));
-            vertices.emplace_back(Vector3(hw,  -hh, 0.f), Vector2(1.f, 1.f));
+            // vertices, indexed slots past the live count collapse to degenerate quads
+            m_vertices.resize(m_indexedParticles * 4);
+            AABB box = m_group.buildVertices(m_vertices.data());
+            if (m_vertices.size() > count * 4)
+            {
+                const ParticleGroup::Vertex degenerate = { Vector3::ZERO, 0, Vector2::ZERO };
+                std::fill(m_vertices.begin() + count * 4, m_vertices.end(), degenerate);
+            }
 
             // format
             MeshVertexFormat define;
+            define.m_isUseVertexColor = true;
             define.m_isUseUV = true;
 
-            m_mesh->updateIndices(static_cast<ui32>(indices.size()), sizeof(Word), indices.data());
-            m_mesh->updateVertexs(define, static_cast<ui32>(vertices.size()), (const Byte*)vertices.data());
+            m_mesh->updateVertexs(define, static_cast<ui32>(m_vertices.size()), (const Byte*)m_vertices.data(), box);
 
-            m_localAABB = m_mesh->getLocalBox();
+            m_localAABB = box;
         }
     }
 }
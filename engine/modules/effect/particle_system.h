@@ -4,6 +4,7 @@
 #include "engine/core/render/base/mesh/mesh.h"
 #include "engine/core/render/base/material.h"
 #include "engine/core/render/base/renderable.h"
+#include "particle/particle_group.h"
 
 namespace Echo
 {
@@ -12,17 +13,8 @@ namespace Echo
         ECHO_CLASS(ParticleSystem, Render)
 
     public:
-        struct VertexFormat
-        {
-            Vector3        m_position;
-            Vector2        m_uv;
-
-            VertexFormat(const Vector3& pos, const Vector2& uv)
-                : m_position(pos), m_uv(uv)
-            {}
-        };
-        typedef vector<VertexFormat>::type    VertexArray;
-        typedef vector<Word>::type    IndiceArray;
+        typedef vector<ParticleGroup::Vertex>::type    VertexArray;
+        typedef vector<ui32>::type    IndiceArray;
 
     public:
         ParticleSystem();
@@ -32,6 +24,55 @@ namespace Echo
         Material* getMaterial() const { return m_material; }
         void setMaterial(Object* material);
 
+        // max live particles
+        i32 getMaxParticles() const { return i32(m_group.getStreams().getCapacity()); }
+        void setMaxParticles(i32 maxParticles);
+
+        // particles per second
+        float getEmitRate() const { return m_group.getEmitter().m_rate; }
+        void setEmitRate(float rate) { m_group.getEmitter().m_rate = rate; }
+
+        // lifetime range, x is min y is max
+        Vector2 getLifetime() const;
+        void setLifetime(const Vector2& lifetime);
+
+        // speed range, x is min y is max
+        Vector2 getSpeed() const;
+        void setSpeed(const Vector2& speed);
+
+        // emit direction
+        const Vector3& getDirection() const { return m_group.getEmitter().m_direction; }
+        void setDirection(const Vector3& direction) { m_group.getEmitter().m_direction = direction; }
+
+        // random velocity spread
+        float getSpread() const { return m_group.getEmitter().m_spread; }
+        void setSpread(float spread) { m_group.getEmitter().m_spread = spread; }
+
+        // size over life, x is start y is end
+        Vector2 getSize() const { return Vector2(m_sizeOverLife->m_start, m_sizeOverLife->m_end); }
+        void setSize(const Vector2& size);
+
+        // color over life
+        const Color& getStartColor() const { return m_colorOverLife->m_start; }
+        void setStartColor(const Color& color);
+        const Color& getEndColor() const { return m_colorOverLife->m_end; }
+        void setEndColor(const Color& color) { m_colorOverLife->m_end = color; }
+
+        // gravity
+        const Vector3& getGravity() const { return m_gravity->m_acceleration; }
+        void setGravity(const Vector3& gravity) { m_gravity->m_acceleration = gravity; }
+
+        // drag
+        float getDrag() const { return m_drag->m_drag; }
+        void setDrag(float drag) { m_drag->m_drag = drag; }
+
+        // noise strength
+        float getNoise() const { return m_noise->m_strength; }
+        void setNoise(float strength) { m_noise->m_strength = strength; }
+
+        // live particles
+        i32 getParticleCount() const { return i32(m_group.getCount()); }
+
     protected:
         // build drawable
         void buildRenderable();
@@ -44,6 +85,15 @@ namespace Echo
 
     private:
         bool                       m_isRenderableDirty = true;
+        ParticleGroup              m_group;
+        ParticleGravityModifier*   m_gravity = nullptr;
+        ParticleDragModifier*      m_drag = nullptr;
+        ParticleNoiseModifier*     m_noise = nullptr;
+        ParticleColorOverLifeModifier* m_colorOverLife = nullptr;
+        ParticleSizeOverLifeModifier*  m_sizeOverLife = nullptr;
+        ui32                       m_indexedParticles = 0;        // particles covered by the index buffer
+        VertexArray                m_vertices;
+        IndiceArray                m_indices;
         MeshPtr                    m_mesh;                        // Geometry Data for render
         MaterialPtr                m_material;                    // Material Instance
         Renderable*                m_renderable = nullptr;
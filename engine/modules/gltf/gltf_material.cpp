@@ -2,12 +2,21 @@
 
 static const char* pbrMetalicRoughnessVS = R"(
 attribute vec4 a_Position;
+#ifdef OCT_NORMALS
+#ifdef HAS_NORMALS
+attribute vec2 a_Normal;
+#endif
+#ifdef HAS_TANGENTS
+attribute vec2 a_Tangent;
+#endif
+#else
 #ifdef HAS_NORMALS
 attribute vec4 a_Normal;
 #endif
 #ifdef HAS_TANGENTS
 attribute vec4 a_Tangent;
 #endif
+#endif
 #ifdef HAS_UV
 attribute vec2 a_UV;
 #endif
@@ -21,11 +30,21 @@ uniform mat4 u_ViewProjMatrix;
 uniform mat4 u_WorldMatrix;
 uniform mat4 u_NormalMatrix;
 
+#ifdef INSTANCING
+attribute mat4 a_InstanceWorld;
+attribute mat4 a_InstanceNormal;
+attribute vec4 a_InstanceColor;
+varying   vec4 v_InstanceColor;
+#endif
+
 #ifdef HAS_SKIN
 attribute vec4	a_Weight;
 attribute vec4	a_Joint;
 
-uniform mat4	u_JointMatrixs[72];
+#ifndef JOINT_COUNT
+#define JOINT_COUNT 72
+#endif
+uniform mat4	u_JointMatrixs[JOINT_COUNT];
 #endif
 
 varying vec3 v_Position;
@@ -39,17 +58,38 @@ varying vec3 v_Normal;
 #endif
 #endif
 
+#ifdef OCT_NORMALS
+// octahedral 2x16 snorm to unit vector
+vec3 OctDecode(vec2 oct)
+{
+	vec3 dir = vec3(oct.xy, 1.0 - abs(oct.x) - abs(oct.y));
+	float t = max(-dir.z, 0.0);
+	dir.xy += vec2(dir.x >= 0.0 ? -t : t, dir.y >= 0.0 ? -t : t);
+	return normalize(dir);
+}
+#endif
+
 void main()
 {
+	// the world matrix of quantized positions dequantizes too, the normal matrix doesn't
+#ifdef INSTANCING
+	mat4 instanceWorld = a_InstanceWorld;
+	mat4 normalMatrix = a_InstanceNormal;
+	v_InstanceColor = a_InstanceColor;
+#else
+	mat4 instanceWorld = u_WorldMatrix;
+	mat4 normalMatrix = u_NormalMatrix;
+#endif
+
 #ifdef HAS_SKIN
 	mat4 skinMat = a_Weight.x * u_JointMatrixs[int(a_Joint.x)] +
 				   a_Weight.y * u_JointMatrixs[int(a_Joint.y)] +
 				   a_Weight.z * u_JointMatrixs[int(a_Joint.z)] +
 				   a_Weight.w * u_JointMatrixs[int(a_Joint.w)];
 
-	mat4 worldMatrix = u_WorldMatrix * skinMat;
+	mat4 worldMatrix = instanceWorld * skinMat;
 #else
-	mat4 worldMatrix = u_WorldMatrix;
+	mat4 worldMatrix = instanceWorld;
 #endif
 
 	gl_Position	= u_ViewProjMatrix * worldMatrix * a_Position; // needs w for proper perspective correction
@@ -58,13 +98,27 @@ void main()
 	v_Position = vec3(pos.xyz) / pos.w;
 
 #ifdef HAS_NORMALS
+	#ifdef OCT_NORMALS
+		vec4 normalL = vec4(OctDecode(a_Normal), 0.0);
+	#else
+		vec4 normalL = vec4(a_Normal.xyz, 0.0);
+	#endif
+	#ifdef HAS_SKIN
+		normalL = skinMat * normalL;
+	#endif
+		vec3 normalW = normalize(vec3(normalMatrix * normalL));
+
 	#ifdef HAS_TANGENTS
-		vec3 normalW = normalize(vec3(u_NormalMatrix * vec4(a_Normal.xyz, 0.0)));
-		vec3 tangentW = normalize(vec3(worldMatrix * vec4(a_Tangent.xyz, 0.0)));
-		vec3 bitangentW = cross(normalW, tangentW) * a_Tangent.w;
+		#ifdef OCT_NORMALS
+			vec4 tangentL = vec4(OctDecode(a_Tangent), 1.0);
+		#else
+			vec4 tangentL = a_Tangent;
+		#endif
+		vec3 tangentW = normalize(vec3(worldMatrix * vec4(tangentL.xyz, 0.0)));
+		vec3 bitangentW = cross(normalW, tangentW) * tangentL.w;
 		v_TBN = mat3(tangentW, bitangentW, normalW);
 	#else // HAS_TANGENTS != 1
-		v_Normal = normalize(vec3(worldMatrix * vec4(a_Normal.xyz, 0.0)));
+		v_Normal = normalW;
 	#endif
 #endif
 
@@ -106,6 +160,10 @@ uniform vec3 u_LightColor;
 varying	vec4 v_Color;
 #endif
 
+#ifdef INSTANCING
+varying	vec4 v_InstanceColor;
+#endif
+
 #ifdef USE_IBL
 uniform samplerCube u_DiffuseEnvSampler;
 uniform samplerCube u_SpecularEnvSampler;
@@ -328,6 +386,10 @@ void main()
 	baseColor *= v_Color;
 #endif
 
+#ifdef INSTANCING
+	baseColor *= v_InstanceColor;
+#endif
+
     vec3 f0 = vec3(0.04);
     vec3 diffuseColor = baseColor.rgb * (vec3(1.0) - f0);
     diffuseColor *= 1.0 - metallic;
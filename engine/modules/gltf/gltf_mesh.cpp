@@ -6,6 +6,7 @@
 #include "engine/core/main/Engine.h"
 #include "engine/core/gizmos/Gizmos.h"
 #include "engine/modules/light/light_module.h"
+#include "engine/core/render/base/mesh/mesh_skinning.h"
 
 namespace Echo
 {
@@ -14,7 +15,6 @@ namespace Echo
 		, m_skinIdx(-1)
 		, m_primitiveIdx(-1)
 		, m_material(nullptr)
-		, m_skeletonDirty(false)
 		, m_skeleton(nullptr)
 		, m_iblDiffuseSlot(-1)
 		, m_iblSpecularSlot(-1)
@@ -40,6 +40,8 @@ namespace Echo
 		CLASS_BIND_METHOD(GltfMesh, setMaterial, DEF_METHOD("setMaterial"));
 		CLASS_BIND_METHOD(GltfMesh, getSkeletonPath, DEF_METHOD("getSkeletonPath"));
 		CLASS_BIND_METHOD(GltfMesh, setSkeletonPath, DEF_METHOD("setSkeletonPath"));
+		CLASS_BIND_METHOD(GltfMesh, isCpuSkinning, DEF_METHOD("isCpuSkinning"));
+		CLASS_BIND_METHOD(GltfMesh, setCpuSkinning, DEF_METHOD("setCpuSkinning"));
 
 		CLASS_REGISTER_PROPERTY(GltfMesh, "Gltf", Variant::Type::ResourcePath, "getGltfRes", "setGltfRes");
 		CLASS_REGISTER_PROPERTY(GltfMesh, "Mesh", Variant::Type::Int, "getMeshIdx", "setMeshIdx");
@@ -47,6 +49,7 @@ namespace Echo
 		CLASS_REGISTER_PROPERTY(GltfMesh, "Material", Variant::Type::Object, "getMaterial", "setMaterial");
         CLASS_REGISTER_PROPERTY_HINT(GltfMesh, "Material", PropertyHintType::ResourceType, "Material");
         CLASS_REGISTER_PROPERTY(GltfMesh, "Skeleton", Variant::Type::NodePath, "getSkeletonPath", "setSkeletonPath");
+		CLASS_REGISTER_PROPERTY(GltfMesh, "CpuSkinning", Variant::Type::Bool, "isCpuSkinning", "setCpuSkinning");
 	}
 
 	// set gltf resource
@@ -61,10 +64,13 @@ namespace Echo
 
 	void GltfMesh::setSkeletonPath(const NodePath& skeletonPath)
 	{
-		if (m_skeletonPath.setPath(skeletonPath.getPath()))
-		{
-			m_skeletonDirty = true;
-		}
+		m_skeletonPath.setPath(skeletonPath.getPath());
+	}
+
+	void GltfMesh::setCpuSkinning(bool isCpuSkinning)
+	{
+		m_isCpuSkinning = isCpuSkinning;
+		m_renderableDirty = true;
 	}
 
 	// set mesh index
@@ -74,13 +80,13 @@ namespace Echo
 		m_nodeIdx = m_asset->getNodeIdxByMeshIdx(m_meshIdx);
 		m_skinIdx = m_asset->m_nodes[m_nodeIdx].m_skin;
 
-		// prepare joints matrix
+		// bind pose palette, used until a skeleton is bound
 		if (m_skinIdx != -1)
 		{
 			const GltfSkinInfo& skinInfo = m_asset->m_skins[m_skinIdx];
 			if (skinInfo.m_joints.size())
 			{
-				m_jointMatrixs.resize(/*skinInfo.m_joints.size()*/ 72);
+				m_jointMatrixs.assign(std::max<size_t>(skinInfo.m_joints.size(), GltfSkeleton::DefaultJointCount), Matrix4::IDENTITY);
 			}
 		}
 
@@ -105,12 +111,26 @@ namespace Echo
 	{
 		if ( m_renderableDirty && m_asset && m_meshIdx!=-1 && m_primitiveIdx!=-1)
 		{
+			MeshPtr mesh = m_asset->m_meshes[m_meshIdx].m_primitives[m_primitiveIdx].m_mesh;
+			bool isCpuSkinning = m_isCpuSkinning && mesh->isSkin();
+
 			Material* material = m_material ? m_material : m_asset->m_meshes[m_meshIdx].m_primitives[m_primitiveIdx].m_materialInst;
+			if (isCpuSkinning && !m_material)
+				material = m_asset->getCpuSkinningMaterial(m_meshIdx, m_primitiveIdx);
+
 			if (material)
 			{
 				clearRenderable();
 
-				MeshPtr mesh = m_asset->m_meshes[m_meshIdx].m_primitives[m_primitiveIdx].m_mesh;
+				// vertices are skinned into a copy every frame, indices are shared
+				if (isCpuSkinning)
+				{
+					m_skinnedMesh = Mesh::create(true, false);
+					m_skinnedMesh->copyIndices(*mesh);
+					MeshSkinning::prepare(mesh->getVertexData(), m_skinnedVertices);
+					mesh = m_skinnedMesh;
+				}
+
 				m_renderable = Renderable::create(mesh, material, this);
 
 				m_localAABB = mesh->getLocalBox();
@@ -132,17 +152,14 @@ namespace Echo
 	{
 		if (isNeedRender())
 		{
-			// update animation
-			if (m_skeletonDirty)
-			{
-				m_skeleton = ECHO_DOWN_CAST<GltfSkeleton*>(getNode(m_skeletonPath.getPath().c_str()));
-				m_skeletonDirty = false;
-			}
+			// update animation, the path caches its target while the tree is unchanged
+			m_skeleton = ECHO_DOWN_CAST<GltfSkeleton*>(m_skeletonPath.getNode(this));
 
 			if (m_skeleton)
 			{
+				// the pose is evaluated once per skeleton and frame, every mesh bound to it shares the palette
+				m_skeleton->evaluate();
 				syncGltfNodeAnim();
-				syncGltfSkinAnim();
 			}
 
 			if(/*m_isUseLight*/ true)
@@ -151,6 +168,7 @@ namespace Echo
 			}
 
 			buildRenderable();
+			syncCpuSkinning();
 			if (m_renderable)
 				m_renderable->submitToRenderQueue();
 		}
@@ -165,29 +183,33 @@ namespace Echo
 		}
 	}
 
-	void GltfMesh::syncGltfSkinAnim()
+	void GltfMesh::syncCpuSkinning()
 	{
-		if (m_skeleton && m_skinIdx!=-1)
+		if (m_skinnedMesh)
 		{
-			Transform tranform;
+			const vector<Matrix4>::type& jointMatrixs = getJointMatrixs();
+			MeshPtr mesh = m_asset->m_meshes[m_meshIdx].m_primitives[m_primitiveIdx].m_mesh;
+			AABB box = MeshSkinning::skin(mesh->getVertexData(), jointMatrixs.data(), ui32(jointMatrixs.size()), m_skinnedVertices);
+			m_skinnedMesh->updateVertexs(m_skinnedVertices.getFormat(), m_skinnedVertices.getVertexCount(), m_skinnedVertices.getVertices(), box);
 
-			const GltfSkinInfo& skinInfo = m_asset->m_skins[m_skinIdx];
-			for (size_t i = 0; i < skinInfo.m_joints.size(); i++)
-			{
-				if (m_skeleton->getGltfNodeTransform(tranform, skinInfo.m_joints[i]))
-				{
-					tranform.buildMatrix(m_jointMatrixs[i]);
-
-					// inverse matrix
-					m_jointMatrixs[i] = skinInfo.m_inverseMatrixs[i] * m_jointMatrixs[i];
-				}
-			}
+			m_localAABB = box;
 		}
 	}
 
+	const vector<Matrix4>::type& GltfMesh::getJointMatrixs()
+	{
+		// a skeleton of another asset may have a smaller palette than the shader reads
+		const vector<Matrix4>::type* jointMatrixs = m_skeleton ? m_skeleton->getJointMatrixs(m_skinIdx) : nullptr;
+		return jointMatrixs && jointMatrixs->size() >= m_jointMatrixs.size() ? *jointMatrixs : m_jointMatrixs;
+	}
+
 	// light data
 	void GltfMesh::syncLightData()
 	{
+		AABB worldBox;
+		buildWorldAABB(worldBox);
+		m_lightCount = i32(LightModule::instance()->gatherDrawLights(worldBox, m_lights));
+
 		if (m_renderable)
 		{
 			Material* material = m_material ? m_material : m_asset->m_meshes[m_meshIdx].m_primitives[m_primitiveIdx].m_materialInst;
@@ -219,7 +241,7 @@ namespace Echo
 		}
 		else if (name == "u_JointMatrixs")
 		{
-			return m_jointMatrixs.data();
+			return (void*)getJointMatrixs().data();
 		}
 		else if (name == "u_DiffuseEnvSampler")
 		{
@@ -236,6 +258,15 @@ namespace Echo
 			static i32 idx = 0;// i32(GltfImageBasedLight::TextureIndex::BrdfLUT);
 			return &idx;
 		}
+		else if (name == "u_Lights")
+		{
+			// fixed size, slots past u_LightCount are stale
+			return m_lights;
+		}
+		else if (name == "u_LightCount")
+		{
+			return &m_lightCount;
+		}
 
 		return nullptr;
 	}
@@ -248,5 +279,6 @@ namespace Echo
 	void GltfMesh::clearRenderable()
 	{
 		EchoSafeRelease(m_renderable);
+		m_skinnedMesh = nullptr;
 	}
 }
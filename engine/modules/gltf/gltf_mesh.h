@@ -5,6 +5,7 @@
 #include "engine/core/render/base/mesh/mesh.h"
 #include "engine/core/render/base/material.h"
 #include "engine/core/render/base/renderable.h"
+#include "engine/modules/light/light_module.h"
 #include "gltf_res.h"
 #include "gltf_skeleton.h"
 
@@ -38,6 +39,10 @@ namespace Echo
 		const NodePath& getSkeletonPath() { return m_skeletonPath; }
 		void setSkeletonPath(const NodePath& skeletonPath);
 
+		// skin vertices on the cpu instead of the vertex shader, custom materials have to be skin free
+		bool isCpuSkinning() const { return m_isCpuSkinning; }
+		void setCpuSkinning(bool isCpuSkinning);
+
 	protected:
 		// build drawable
 		void buildRenderable();
@@ -48,13 +53,19 @@ namespace Echo
 		// get global uniforms
 		virtual void* getGlobalUniformValue(const String& name) override;
 
+		// the lights touching the mesh are per node
+		virtual bool hasPerDrawUniforms() override { return m_lightCount > 0; }
+
 		// clear
 		void clear();
 		void clearRenderable();
 
 		// gltf anim
 		void syncGltfNodeAnim();
-		void syncGltfSkinAnim();
+		void syncCpuSkinning();
+
+		// palette of the bound skeleton, bind pose without one
+		const vector<Matrix4>::type& getJointMatrixs();
 
 		// light data
 		void syncLightData();
@@ -63,7 +74,7 @@ namespace Echo
 		bool					m_renderableDirty = true;
 		Renderable*				m_renderable = nullptr;
 		Matrix4					m_matWVP;
-		ResourcePath			m_assetPath = ResourcePath("", ".gltf");
+		ResourcePath			m_assetPath = ResourcePath("", ".gltf|.glb");
 		GltfResPtr				m_asset;			                        // gltf asset ptr
 		i32						m_nodeIdx = -1;			                       // node index in the asset, used by skeleton
 		i32						m_meshIdx;			                        // mesh index in the asset
@@ -71,11 +82,15 @@ namespace Echo
 		int						m_primitiveIdx;		                        // sub mesh index
 		MaterialPtr				m_material;			                        // custom material
 		NodePath				m_skeletonPath;
-		bool					m_skeletonDirty;	                        // dirty flag
 		GltfSkeleton*			m_skeleton;
-		vector<Matrix4>::type	m_jointMatrixs;
+		vector<Matrix4>::type	m_jointMatrixs;								// bind pose palette
+		bool					m_isCpuSkinning = false;
+		MeshPtr					m_skinnedMesh;								// cpu skinned copy of the primitive
+		MeshVertexData			m_skinnedVertices;
 		i32						m_iblDiffuseSlot;
 		i32						m_iblSpecularSlot;
 		i32						m_iblBrdfSlot;
+		LightCluster::PackedLight m_lights[LightModule::MaxDrawLights];	// point and spot lights touching the mesh
+		i32						m_lightCount = 0;
 	};
 }
@@ -1,6 +1,7 @@
 #include "gltf_module.h"
 #include "gltf_mesh.h"
 #include "gltf_skeleton.h"
+#include "engine/core/thread/pool/ParallelWorkers.h"
 
 namespace Echo
 {
@@ -18,7 +19,10 @@ namespace Echo
 
 	void GltfModule::bindMethods()
 	{
+		CLASS_BIND_METHOD(GltfModule, isCompactEncoding, DEF_METHOD("isCompactEncoding"));
+		CLASS_BIND_METHOD(GltfModule, setCompactEncoding, DEF_METHOD("setCompactEncoding"));
 
+		CLASS_REGISTER_PROPERTY(GltfModule, "CompactEncoding", Variant::Type::Bool, "isCompactEncoding", "setCompactEncoding");
 	}
 
 	void GltfModule::registerTypes()
@@ -27,4 +31,52 @@ namespace Echo
 		Class::registerType<GltfMesh>();
 		Class::registerType<GltfSkeleton>();
 	}
+
+	void GltfModule::update(float elapsedTime)
+	{
+		m_frame++;
+
+		// skeletons updated last frame are likely updated again, evaluate them ahead of the node tree.
+		// a skeleton shares its anim clips with the asset, so skeletons of one clip go to one worker
+		m_pendingSkeletons.clear();
+		for (GltfSkeleton* skeleton : m_skeletons)
+		{
+			if (skeleton->getEvaluatedFrame() + 1 == m_frame)
+				m_pendingSkeletons.emplace_back(skeleton);
+		}
+
+		std::sort(m_pendingSkeletons.begin(), m_pendingSkeletons.end(), [](GltfSkeleton* a, GltfSkeleton* b)
+		{
+			return a->getAnimClip() < b->getAnimClip();
+		});
+
+		vector<ui32>::type groups;
+		for (ui32 i = 0; i < m_pendingSkeletons.size(); i++)
+		{
+			if (!i || m_pendingSkeletons[i]->getAnimClip() != m_pendingSkeletons[i - 1]->getAnimClip())
+				groups.emplace_back(i);
+		}
+		groups.emplace_back(ui32(m_pendingSkeletons.size()));
+
+		ParallelWorkers::instance()->parallelFor(ui32(groups.size() - 1), 1, [&](ui32 begin, ui32 end)
+		{
+			for (ui32 i = groups[begin]; i < groups[end]; i++)
+				m_pendingSkeletons[i]->evaluate();
+		});
+	}
+
+	void GltfModule::addSkeleton(GltfSkeleton* skeleton)
+	{
+		m_skeletons.emplace_back(skeleton);
+	}
+
+	void GltfModule::removeSkeleton(GltfSkeleton* skeleton)
+	{
+		auto it = std::find(m_skeletons.begin(), m_skeletons.end(), skeleton);
+		if (it != m_skeletons.end())
+		{
+			*it = m_skeletons.back();
+			m_skeletons.pop_back();
+		}
+	}
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 namespace Echo
 {
+	class GltfSkeleton;
 	class GltfModule : public Module
 	{
 		ECHO_SINGLETON_CLASS(GltfModule, Module)
@@ -16,5 +17,26 @@ namespace Echo
 
 		// register all types of the module
 		virtual void registerTypes() override;
+
+		// update, evaluates the poses of the skeletons in use across the worker threads
+		virtual void update(float elapsedTime) override;
+
+	public:
+		// skeletons register themselves
+		void addSkeleton(GltfSkeleton* skeleton);
+		void removeSkeleton(GltfSkeleton* skeleton);
+
+		// frame number, poses are evaluated once per frame
+		ui32 getFrame() const { return m_frame; }
+
+		// encode loaded gltf vertices with the compact MeshVertexFormat encodings, off by default
+		bool isCompactEncoding() const { return m_isCompactEncoding; }
+		void setCompactEncoding(bool isCompactEncoding) { m_isCompactEncoding = isCompactEncoding; }
+
+	protected:
+		bool							m_isCompactEncoding = false;
+		ui32							m_frame = 0;
+		vector<GltfSkeleton*>::type		m_skeletons;
+		vector<GltfSkeleton*>::type		m_pendingSkeletons;		// evaluated ahead this frame
 	};
 }
@@ -2,12 +2,18 @@
 #include "gltf_mesh.h"
 #include "gltf_material.h"
 #include "gltf_skeleton.h"
+#include "gltf_module.h"
 #include "engine/core/io/stream/DataStream.h"
 #include "engine/core/log/Log.h"
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/util/base64.h"
 #include "engine/core/util/magic_enum.hpp"
+#include "engine/core/math/Simd.h"
+#include "engine/core/render/base/renderer.h"
+#include "engine/core/render/base/image/image.h"
+#include "engine/core/render/base/image/pixel_format.h"
 #include "engine/modules/light/light_module.h"
+#include <limits>
 
 namespace Echo
 {
@@ -100,6 +106,72 @@ namespace Echo
 		return isMustExist ? false : true;
 	}
 
+	// glb container, a json chunk followed by an optional binary chunk
+	static const ui32 GlbMagic = 0x46546C67;			// "glTF"
+	static const ui32 GlbChunkJson = 0x4E4F534A;		// "JSON"
+	static const ui32 GlbChunkBin = 0x004E4942;			// "BIN"
+
+	// bytes of one accessor component
+	static ui32 GetComponentSize(GltfAccessorInfo::ComponentType type)
+	{
+		switch (type)
+		{
+		case GltfAccessorInfo::Byte:
+		case GltfAccessorInfo::UnsignedByte:	return 1;
+		case GltfAccessorInfo::Short:
+		case GltfAccessorInfo::UnsignedShort:	return 2;
+		default:								return 4;
+		}
+	}
+
+	// components of one accessor element
+	static ui32 GetComponentCount(GltfAccessorInfo::Type type)
+	{
+		switch (type)
+		{
+		case GltfAccessorInfo::Scalar:	return 1;
+		case GltfAccessorInfo::Vec2:	return 2;
+		case GltfAccessorInfo::Vec3:	return 3;
+		case GltfAccessorInfo::Vec4:	return 4;
+		case GltfAccessorInfo::Mat2:	return 4;
+		case GltfAccessorInfo::Mat3:	return 9;
+		case GltfAccessorInfo::Mat4:	return 16;
+		default:						return 0;
+		}
+	}
+
+	// integer components to floats. normalized ones map to [0, 1] or [-1, 1] the way KHR_mesh_quantization defines
+	template<typename T>
+	static void DecodeComponents(const Byte* src, ui32 srcStride, ui32 count, ui32 components, bool normalized, Byte* dst, ui32 dstStride)
+	{
+		const float scale = normalized ? 1.f / float(std::numeric_limits<T>::max()) : 1.f;
+		const float minValue = normalized && std::numeric_limits<T>::is_signed ? -1.f : -std::numeric_limits<float>::max();
+
+#ifdef ECHO_SIMD
+		Simd::Float4 simdScale = Simd::splat(scale);
+		Simd::Float4 simdMin = Simd::splat(minValue);
+		i32 lanes[4] = { 0, 0, 0, 0 };
+		float result[4];
+		for (ui32 i = 0; i < count; i++, src += srcStride, dst += dstStride)
+		{
+			const T* element = (const T*)src;
+			for (ui32 c = 0; c < components; c++)
+				lanes[c] = i32(element[c]);
+
+			Simd::store(result, Simd::max(Simd::mul(Simd::loadInt(lanes), simdScale), simdMin));
+			std::memcpy(dst, result, components * sizeof(float));
+		}
+#else
+		for (ui32 i = 0; i < count; i++, src += srcStride, dst += dstStride)
+		{
+			const T* element = (const T*)src;
+			float* result = (float*)dst;
+			for (ui32 c = 0; c < components; c++)
+				result[c] = std::max<float>(float(element[c]) * scale, minValue);
+		}
+#endif
+	}
+
 	// contructor
 	GltfRes::GltfRes(const ResourcePath& path)
 		: Res(path)
@@ -109,7 +181,7 @@ namespace Echo
 
 	GltfRes::~GltfRes()
 	{
-
+		EchoSafeDelete(m_file, MemoryReader);
 	}
 
 	void GltfRes::bindMethods()
@@ -125,11 +197,19 @@ namespace Echo
 	// load
 	bool GltfRes::load()
 	{
-		MemoryReader memReader(m_path.getPath());
-		if (memReader.getSize())
+		m_file = EchoNew(MemoryReader(m_path.getPath()));
+		if (m_file->getSize())
 		{
+			const char* jsonBegin = m_file->getData<const char*>();
+			const char* jsonEnd = jsonBegin + m_file->getSize();
+			if (!loadGlb(jsonBegin, jsonEnd))
+			{
+				EchoLogError("gltf parse glb container failed when load resource [%s].", m_path.getPath().c_str());
+				return false;
+			}
+
 			using namespace nlohmann;
-			json j =  json::parse(memReader.getData<char*>());
+			json j =  json::parse(jsonBegin, jsonEnd);
 
 			// load asset
 			if (!loadAsset(j))
@@ -192,15 +272,16 @@ namespace Echo
 				return false;
 			}
 
-			if (!loadMeshes(j))
+			// skins first, materials size the joint palette by them
+			if (!loadSkins(j))
 			{
-				EchoLogError("gltf parse meshes failed when load resource [%s].", m_path.getPath().c_str());
+				EchoLogError("gltf parse skins failed when load resource [%s]", m_path.getPath().c_str());
 				return false;
 			}
 
-			if (!loadSkins(j))
+			if (!loadMeshes(j))
 			{
-				EchoLogError("gltf parse skins failed when load resource [%s]", m_path.getPath().c_str());
+				EchoLogError("gltf parse meshes failed when load resource [%s].", m_path.getPath().c_str());
 				return false;
 			}
 
@@ -218,6 +299,50 @@ namespace Echo
 		return false;
 	}
 
+	bool GltfRes::loadGlb(const char*& jsonBegin, const char*& jsonEnd)
+	{
+		const char* data = m_file->getData<const char*>();
+		ui32 size = m_file->getSize();
+		auto readUI32 = [data](ui32 offset) { ui32 value; std::memcpy(&value, data + offset, sizeof(value)); return value; };
+
+		// plain json
+		if (size < 12 || readUI32(0) != GlbMagic)
+			return true;
+
+		// header
+		ui32 version = readUI32(4);
+		ui32 length = readUI32(8);
+		if (version != 2 || length > size)
+			return false;
+
+		// chunks, the binary one stays in place and buffers point into it
+		bool isHaveJson = false;
+		for (ui32 offset = 12; offset + 8 <= length;)
+		{
+			ui32 chunkLength = readUI32(offset);
+			ui32 chunkType = readUI32(offset + 4);
+			const char* chunkData = data + offset + 8;
+			if (chunkLength > length - offset - 8)
+				return false;
+
+			if (chunkType == GlbChunkJson && !isHaveJson)
+			{
+				jsonBegin = chunkData;
+				jsonEnd = chunkData + chunkLength;
+				isHaveJson = true;
+			}
+			else if (chunkType == GlbChunkBin && !m_glbBinary)
+			{
+				m_glbBinary = chunkData;
+				m_glbBinarySize = chunkLength;
+			}
+
+			offset += 8 + chunkLength;
+		}
+
+		return isHaveJson;
+	}
+
 	bool GltfRes::loadAsset(nlohmann::json& json)
 	{
 		if (json.find("asset") != json.end())
@@ -442,6 +567,16 @@ namespace Echo
 					m_buffers[i].m_uri = PathUtil::GetFileDirPath(m_path.getPath()) + bufferUri;
 				}
 			}
+			else if (i == 0 && m_glbBinary)
+			{
+				// the first buffer of a glb is its binary chunk, which may carry up to 3 bytes of padding
+				if (ui32(m_buffers[i].m_byteLength) > m_glbBinarySize)
+					return false;
+
+				m_buffers[i].m_binary = m_glbBinary;
+				m_buffers[i].m_binarySize = m_glbBinarySize;
+				continue;
+			}
 
 			if (!loadBufferData(m_buffers[i]))
 				return false;
@@ -812,6 +947,61 @@ namespace Echo
 		return true;
 	}
 
+	const Byte* GltfRes::getAccessElements(GltfAccessorInfo& access, ui32& stride)
+	{
+		if (access.m_bufferView < 0 || access.m_bufferView >= i32(m_bufferViews.size()))
+			return nullptr;
+
+		GltfBufferViewInfo& bufferView = m_bufferViews[access.m_bufferView];
+		if (bufferView.m_bufferIdx >= m_buffers.size())
+			return nullptr;
+
+		ui32 elementSize = GetComponentSize(access.m_componentType) * GetComponentCount(access.m_type);
+		stride = bufferView.m_byteStride ? bufferView.m_byteStride : elementSize;
+
+		// the last element has to end inside the view and the buffer
+		GltfBufferInfo& buffer = m_buffers[bufferView.m_bufferIdx];
+		ui64 end = access.m_count ? ui64(access.m_byteOffset) + ui64(access.m_count - 1) * stride + elementSize : 0;
+		if (end > bufferView.m_byteLength || ui64(bufferView.m_byteOffset) + bufferView.m_byteLength > buffer.getSize())
+			return nullptr;
+
+		return (const Byte*)buffer.getData(bufferView.m_byteOffset + access.m_byteOffset);
+	}
+
+	bool GltfRes::readAccessor(GltfAccessorInfo& access, float* dst, ui32 dstStride)
+	{
+		ui32 srcStride = 0;
+		const Byte* src = getAccessElements(access, srcStride);
+		ui32 components = GetComponentCount(access.m_type);
+		if (!src || components > 4)
+			return false;
+
+		Byte* dstBytes = (Byte*)dst;
+		switch (access.m_componentType)
+		{
+		case GltfAccessorInfo::Float:
+			{
+				// one copy when both sides are packed, otherwise one per element
+				ui32 elementSize = components * sizeof(float);
+				if (srcStride == elementSize && dstStride == elementSize)
+				{
+					std::memcpy(dstBytes, src, access.m_count * elementSize);
+				}
+				else
+				{
+					for (ui32 i = 0; i < access.m_count; i++)
+						std::memcpy(dstBytes + i * dstStride, src + i * srcStride, elementSize);
+				}
+			}
+			return true;
+		case GltfAccessorInfo::Byte:			DecodeComponents<i8>(src, srcStride, access.m_count, components, access.m_normalized, dstBytes, dstStride);	return true;
+		case GltfAccessorInfo::UnsignedByte:	DecodeComponents<ui8>(src, srcStride, access.m_count, components, access.m_normalized, dstBytes, dstStride);	return true;
+		case GltfAccessorInfo::Short:			DecodeComponents<i16>(src, srcStride, access.m_count, components, access.m_normalized, dstBytes, dstStride);	return true;
+		case GltfAccessorInfo::UnsignedShort:	DecodeComponents<ui16>(src, srcStride, access.m_count, components, access.m_normalized, dstBytes, dstStride);	return true;
+		default:								return false;
+		}
+	}
+
 	bool GltfRes::buildPrimitiveData(int meshIdx, int primitiveIdx)
 	{
 		GltfPrimitive& primitive = m_meshes[meshIdx].m_primitives[primitiveIdx];
@@ -863,97 +1053,63 @@ namespace Echo
 		MeshVertexData vertexData;
 		vertexData.set(vertFormat, vertCount);
 
-		// vertices data
+		// vertices data, decoded straight into the interleaved vertex buffer
+		const MeshVertexFormat& format = vertexData.getFormat();
+		Byte* vertices = vertexData.getVertices();
+		ui32 vertexStride = vertexData.getVertexStride();
 		for (auto& it : primitive.m_attributes)
 		{
-			int attributeIdx = it.second;
-			GltfAccessorInfo&   access = m_accessors[attributeIdx];
-			vertexData.set(vertFormat, access.m_count);
+			GltfAccessorInfo& access = m_accessors[it.second];
 			if (it.first == "POSITION")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec3 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector3* positions = getAccessData<Vector3*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setPosition(i, positions[i]);
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec3 || !readAccessor(access, (float*)(vertices + format.m_posOffset), vertexStride))
 					return false;
-				}
 			}
 			else if (it.first == "NORMAL")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec3 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector3* normals = getAccessData<Vector3*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setNormal(i, normals[i]);
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec3 || !readAccessor(access, (float*)(vertices + format.m_normalOffset), vertexStride))
 					return false;
-				}
 			}
 			else if (it.first == "TEXCOORD_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec2 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector2* uv0s = getAccessData<Vector2*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setUV0(i, uv0s[i]);
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec2 || !readAccessor(access, (float*)(vertices + format.m_uv0Offset), vertexStride))
 					return false;
-				}
 			}
 			else if (it.first == "COLOR_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec4 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Color* color0s = getAccessData<Color*>(access);
-					for (int i = 0; i < vertCount; i++)
-						vertexData.setColor(i, color0s[i]);
-				}
-				else
-				{
+				vector<Vector4>::type colors(vertCount, Vector4(1.f, 1.f, 1.f, 1.f));
+				if ((access.m_type != GltfAccessorInfo::Vec3 && access.m_type != GltfAccessorInfo::Vec4) || !readAccessor(access, &colors[0].x, sizeof(Vector4)))
 					return false;
-				}
+
+				for (int i = 0; i < vertCount; i++)
+					vertexData.setColor(i, Color(colors[i].x, colors[i].y, colors[i].z, colors[i].w));
 			}
 			else if (it.first == "WEIGHTS_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec4 && access.m_componentType == GltfAccessorInfo::ComponentType::Float)
-				{
-					Vector4* weights = getAccessData<Vector4*>(access);
-					for (int i = 0; i < vertCount; i++)
-					{
-						vertexData.setWeight(i, weights[i]);
-					}
-				}
-				else
-				{
+				if (access.m_type != GltfAccessorInfo::Vec4 || !readAccessor(access, (float*)(vertices + format.m_boneWeightsOffset), vertexStride))
 					return false;
-				}
 			}
 			else if (it.first == "JOINTS_0")
 			{
-				if (access.m_type == GltfAccessorInfo::Vec4 && access.m_componentType==GltfAccessorInfo::ComponentType::UnsignedShort)
+				ui32 jointStride = 0;
+				const Byte* joints = getAccessElements(access, jointStride);
+				if (access.m_type != GltfAccessorInfo::Vec4 || !joints)
+					return false;
+
+				for (int i = 0; i < vertCount; i++, joints += jointStride)
 				{
 					ui8 joint[4];
-					ui16* joints = getAccessData<ui16*>(access);
-					for (int i = 0; i < vertCount; i++)
+					for (int j = 0; j < 4; j++)
 					{
-						joint[0] = (ui8)joints[i * 4 + 0];
-						joint[1] = (ui8)joints[i * 4 + 1];
-						joint[2] = (ui8)joints[i * 4 + 2];
-						joint[3] = (ui8)joints[i * 4 + 3];
-						vertexData.setJoint(i, *(const Dword*)joint);		
+						if (access.m_componentType == GltfAccessorInfo::ComponentType::UnsignedByte)
+							joint[j] = joints[j];
+						else if (access.m_componentType == GltfAccessorInfo::ComponentType::UnsignedShort)
+							joint[j] = (ui8)((const ui16*)joints)[j];
+						else
+							return false;
 					}
-				}
-				else
-				{
-					return false;
+
+					vertexData.setJoint(i, *(const Dword*)joint);
 				}
 			}
 		}
@@ -963,10 +1119,17 @@ namespace Echo
 		{
 			primitive.m_mesh = Mesh::create(true, true);
 
-			// update indices
-			if(indicesDataVoid)
+			// vertex cache order and lods are baked by the importers, runtime loads keep the source order
+			if (indicesDataVoid)
 				primitive.m_mesh->updateIndices(indicesCount, indicesStride, indicesDataVoid);
 
+			// compact vertex encodings
+			if (GltfModule::instance()->isCompactEncoding())
+			{
+				vertFormat.useCompactEncodings();
+				vertexData.convert(vertFormat);
+			}
+
 			// update vertices
 			primitive.m_mesh->updateVertexs(vertexData);
 		}
@@ -1041,7 +1204,7 @@ namespace Echo
 		return true;
 	}
 
-	bool GltfRes::buildMaterial(int meshIdx, int primitiveIdx)
+	bool GltfRes::buildMaterial(int meshIdx, int primitiveIdx, bool isCpuSkinning)
 	{
 		GltfPrimitive& primitive = m_meshes[meshIdx].m_primitives[primitiveIdx];
         GltfMaterialInfo& matInfo = primitive.m_material!=-1 ?  m_materials[primitive.m_material] : GltfMaterialInfo::DEFAULT;
@@ -1054,73 +1217,143 @@ namespace Echo
         primitive.m_shader = GltfMaterial::getPbrMetalicRoughnessContent();
 		primitive.m_shader->setBlendMode("Opaque");
 
-		primitive.m_materialInst = ECHO_CREATE_RES(Material);
-		primitive.m_materialInst->setShaderPath(primitive.m_shader->getPath());
+		Material* material = ECHO_CREATE_RES(Material);
+		if (isCpuSkinning)
+			primitive.m_cpuSkinningMaterialInst = material;
+		else
+			primitive.m_materialInst = material;
+
+		material->setShaderPath(primitive.m_shader->getPath());
+
+		// joint palette of the skin the mesh is bound to
+		i32 nodeIdx = getNodeIdxByMeshIdx(meshIdx);
+		i32 skinIdx = nodeIdx != -1 ? m_nodes[nodeIdx].m_skin : -1;
+		ui32 jointCount = skinIdx != -1 ? ui32(m_skins[skinIdx].m_joints.size()) : 0;
 
 		// macros
 		const MeshVertexFormat& vertexFormat = primitive.m_mesh->getVertexData().getFormat();
-		primitive.m_materialInst->setMacro("MANUAL_SRGB", true);
-		primitive.m_materialInst->setMacro("SRGB_FAST_APPROXIMATION", true);
-		primitive.m_materialInst->setMacro("HAS_NORMALS", vertexFormat.m_isUseNormal);
-		primitive.m_materialInst->setMacro("HAS_VERTEX_COLOR", vertexFormat.m_isUseVertexColor);
-		primitive.m_materialInst->setMacro("HAS_UV", vertexFormat.m_isUseUV);
-		primitive.m_materialInst->setMacro("HAS_SKIN", vertexFormat.m_isUseBlendingData);
-		primitive.m_materialInst->setMacro("HAS_BASECOLORMAP", baseColorTextureIdx != -1);
-		primitive.m_materialInst->setMacro("HAS_METALROUGHNESSMAP", metalicRoughnessIdx != -1);
-		primitive.m_materialInst->setMacro("HAS_NORMALMAP", normalTextureIdx != -1);
-		primitive.m_materialInst->setMacro("HAS_EMISSIVEMAP", emissiveTextureIdx != -1);
-		primitive.m_materialInst->setMacro("HAS_OCCLUSIONMAP", occusionTextureIdx != -1);
-		primitive.m_materialInst->setMacro("USE_IBL", LightModule::instance()->isIBLEnable());
-		//primitive.m_materialInst->setMacro("USE_TEX_LOD", true);
+		bool isGpuSkinning = vertexFormat.m_isUseBlendingData && !isCpuSkinning;
+		material->setMacro("MANUAL_SRGB", true);
+		material->setMacro("SRGB_FAST_APPROXIMATION", true);
+		material->setMacro("HAS_NORMALS", vertexFormat.m_isUseNormal);
+		material->setMacro("OCT_NORMALS", vertexFormat.m_normalEncoding == VE_OCT16 && !isCpuSkinning);
+		material->setMacro("HAS_VERTEX_COLOR", vertexFormat.m_isUseVertexColor);
+		material->setMacro("HAS_UV", vertexFormat.m_isUseUV);
+		material->setMacro("HAS_SKIN", isGpuSkinning);
+		material->setMacro("JOINT_COUNT " + StringUtil::ToString(jointCount), isGpuSkinning && jointCount);
+		material->setMacro("HAS_BASECOLORMAP", baseColorTextureIdx != -1);
+		material->setMacro("HAS_METALROUGHNESSMAP", metalicRoughnessIdx != -1);
+		material->setMacro("HAS_NORMALMAP", normalTextureIdx != -1);
+		material->setMacro("HAS_EMISSIVEMAP", emissiveTextureIdx != -1);
+		material->setMacro("HAS_OCCLUSIONMAP", occusionTextureIdx != -1);
+		material->setMacro("USE_IBL", LightModule::instance()->isIBLEnable());
+		//material->setMacro("USE_TEX_LOD", true);
 
         // temp variables
         Vector2 metalicRoughnessFactor(matInfo.m_pbr.m_metallicFactor, matInfo.m_pbr.m_roughnessFactor);
         
 		// params
-		primitive.m_materialInst->getUniform("u_MetallicRoughnessValues")->setValue(&metalicRoughnessFactor);
-		primitive.m_materialInst->getUniform("u_BaseColorFactor")->setValue(matInfo.m_pbr.m_baseColorFactor);
+		material->getUniform("u_MetallicRoughnessValues")->setValue(&metalicRoughnessFactor);
+		material->getUniform("u_BaseColorFactor")->setValue(matInfo.m_pbr.m_baseColorFactor);
 		
 		// base color texture
 		if (baseColorTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[baseColorTextureIdx].m_source;
-			primitive.m_materialInst->getUniform("BaseColor")->setTexture(m_images[imageIdx].m_uri);
+			setImageTexture(material->getUniform("BaseColor"), imageIdx);
 		}
 
 		// normal map
 		if (normalTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[normalTextureIdx].m_source;
-			primitive.m_materialInst->getUniform("u_NormalSampler")->setTexture(m_images[imageIdx].m_uri);
-			primitive.m_materialInst->getUniform("u_NormalScale")->setValue(&matInfo.m_normalTexture.m_scale);
+			setImageTexture(material->getUniform("u_NormalSampler"), imageIdx);
+			material->getUniform("u_NormalScale")->setValue(&matInfo.m_normalTexture.m_scale);
 		}
 
 		// emissive map
 		if (emissiveTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[emissiveTextureIdx].m_source;
-			primitive.m_materialInst->getUniform("u_EmissiveSampler")->setTexture(m_images[imageIdx].m_uri);
-			primitive.m_materialInst->getUniform("u_EmissiveFactor")->setValue(&matInfo.m_emissiveTexture.m_factor);
+			setImageTexture(material->getUniform("u_EmissiveSampler"), imageIdx);
+			material->getUniform("u_EmissiveFactor")->setValue(&matInfo.m_emissiveTexture.m_factor);
 		}
 
 		// metallic roughness texture
 		if (metalicRoughnessIdx != -1)
 		{
 			i32 imageIdx = m_textures[metalicRoughnessIdx].m_source;
-			primitive.m_materialInst->getUniform("u_MetallicRoughnessSampler")->setTexture(m_images[imageIdx].m_uri);
+			setImageTexture(material->getUniform("u_MetallicRoughnessSampler"), imageIdx);
 		}
 
 		// occlusion map
 		if (occusionTextureIdx != -1)
 		{
 			i32 imageIdx = m_textures[occusionTextureIdx].m_source;
-			primitive.m_materialInst->getUniform("u_OcclusionSampler")->setTexture(m_images[imageIdx].m_uri);
-			primitive.m_materialInst->getUniform("u_OcclusionStrength")->setValue(&matInfo.m_occlusionTexture.m_strength);
+			setImageTexture(material->getUniform("u_OcclusionSampler"), imageIdx);
+			material->getUniform("u_OcclusionStrength")->setValue(&matInfo.m_occlusionTexture.m_strength);
 		}
 
 		return true;
 	}
 
+	void GltfRes::setImageTexture(Material::UniformValue* uniform, i32 imageIdx)
+	{
+		if (imageIdx < 0 || imageIdx >= i32(m_images.size()))
+		{
+			EchoLogError("gltf texture references missing image [%d] in resource [%s].", imageIdx, m_path.getPath().c_str());
+			return;
+		}
+
+		GltfImageInfo& image = m_images[imageIdx];
+		if (!image.m_uri.empty())
+		{
+			uniform->setTexture(image.m_uri);
+		}
+		else
+		{
+			if (!image.m_texture)
+				image.m_texture = loadImageFromBufferView(imageIdx);
+
+			if (image.m_texture)
+				uniform->setTexture(TexturePtr(image.m_texture.ptr()));
+		}
+	}
+
+	TextureRender* GltfRes::loadImageFromBufferView(i32 imageIdx)
+	{
+		GltfImageInfo& image = m_images[imageIdx];
+		if (image.m_bufferView < 0 || image.m_bufferView >= i32(m_bufferViews.size()))
+		{
+			EchoLogError("gltf image [%d] references missing bufferView [%d] in resource [%s].", imageIdx, image.m_bufferView, m_path.getPath().c_str());
+			return nullptr;
+		}
+
+		GltfBufferViewInfo& bufferView = m_bufferViews[image.m_bufferView];
+		if (bufferView.m_bufferIdx >= m_buffers.size() || ui64(bufferView.m_byteOffset) + bufferView.m_byteLength > m_buffers[bufferView.m_bufferIdx].getSize())
+		{
+			EchoLogError("gltf image [%d] bufferView is out of its buffer in resource [%s].", imageIdx, m_path.getPath().c_str());
+			return nullptr;
+		}
+
+		// the spec only allows png and jpeg here
+		ImageFormat format = image.m_mimeType == "image/png" ? IF_PNG : (image.m_mimeType == "image/jpeg" ? IF_JPG : IF_UNKNOWN);
+		Byte* encoded = (Byte*)m_buffers[bufferView.m_bufferIdx].getData(bufferView.m_byteOffset);
+		Image* decoded = Image::createFromMemory(Buffer(bufferView.m_byteLength, encoded, false), format);
+		if (!decoded)
+		{
+			EchoLogError("gltf image [%d] of type [%s] can't be decoded in resource [%s].", imageIdx, image.m_mimeType.c_str(), m_path.getPath().c_str());
+			return nullptr;
+		}
+
+		TextureRender* texture = Renderer::instance()->createTextureRender(StringUtil::Format("%s#image%d", m_path.getPath().c_str(), imageIdx));
+		ui32 pixelsSize = PixelUtil::CalcSurfaceSize(decoded->getWidth(), decoded->getHeight(), 1, 1, decoded->getPixelFormat());
+		texture->updateTexture2D(decoded->getPixelFormat(), Texture::TU_GPU_READ, decoded->getWidth(), decoded->getHeight(), decoded->getData(), pixelsSize);
+		EchoSafeDelete(decoded, Image);
+
+		return texture;
+	}
+
 	bool GltfRes::loadMaterials(nlohmann::json& json)
 	{
 		if (json.find("materials") == json.end())
@@ -1309,11 +1542,9 @@ namespace Echo
 			if (!parseJsonValueString(m_images[i].m_name, image, "name", false))
 				return false;
 
-			// uri
-			if (parseJsonValueString(m_images[i].m_uri, image, "uri", false))
+			// uri, images embedded in a glb have a bufferView instead
+			if (parseJsonValueString(m_images[i].m_uri, image, "uri", false) && !m_images[i].m_uri.empty())
 				m_images[i].m_uri = PathUtil::GetFileDirPath(m_path.getPath()) + m_images[i].m_uri;
-			else
-				return false;
 
 			// mimeType
 			if (!parseJsonValueString(m_images[i].m_mimeType, image, "mimeType", false))
@@ -1322,10 +1553,14 @@ namespace Echo
 			// bufferView
 			if (!parseJsonValueI32(m_images[i].m_bufferView, image, "bufferView", false))
 				return false;
+
+			if (m_images[i].m_uri.empty() && m_images[i].m_bufferView == -1)
+			{
+				EchoLogError("gltf image [%d] has neither uri nor bufferView in resource [%s].", i, m_path.getPath().c_str());
+				return false;
+			}
 		}
 
-		// TODO: Handle dependencies between mimeType and bufferView
-		// TODO: Handle the fact that we want an uri OR a bufferView
 		// TODO: images[i]["extensions"]
 		// TODO: images[i]["extras"]
 
@@ -1416,6 +1651,15 @@ namespace Echo
 		return true;
 	}
 
+	Material* GltfRes::getCpuSkinningMaterial(int meshIdx, int primitiveIdx)
+	{
+		GltfPrimitive& primitive = m_meshes[meshIdx].m_primitives[primitiveIdx];
+		if (!primitive.m_cpuSkinningMaterialInst)
+			buildMaterial(meshIdx, primitiveIdx, true);
+
+		return primitive.m_cpuSkinningMaterialInst;
+	}
+
 	i32  GltfRes::getNodeIdxByMeshIdx(i32 meshIdx)
 	{
 		for (size_t i=0; i<m_nodes.size(); i++)
@@ -7,6 +7,7 @@
 #include "engine/core/render/base/mesh/mesh.h"
 #include "engine/core/resource/Res.h"
 #include "engine/core/render/base/material.h"
+#include "engine/core/render/base/texture_render.h"
 #include "engine/modules/anim/anim_property.h"
 #include <nlohmann/json.hpp>
 
@@ -46,6 +47,7 @@ namespace Echo
 		MeshPtr			m_mesh;				// geometry Data for render
         ShaderProgramPtr    m_shader;
 		MaterialPtr			m_materialInst;
+		MaterialPtr			m_cpuSkinningMaterialInst;	// skin free variant, built on first use
 	};
 
 	struct GltfMeshInfo
@@ -88,6 +90,8 @@ namespace Echo
 		}					m_uriType = UriType::Uri;
 		i32					m_byteLength;
 		MemoryReader*		m_data = nullptr;
+		const char*			m_binary = nullptr;		// glb binary chunk, owned by GltfRes
+		ui32				m_binarySize = 0;
 
 		// destructor
 		~GltfBufferInfo()
@@ -98,17 +102,26 @@ namespace Echo
 		// get data
 		void* getData(ui32 offset)
 		{
-			return m_data ? m_data->getData<char*>() + offset : nullptr;
+			if (m_data)
+				return m_data->getData<char*>() + offset;
+
+			return m_binary ? (void*)(m_binary + offset) : nullptr;
+		}
+
+		// get size
+		ui32 getSize()
+		{
+			return m_data ? m_data->getSize() : m_binarySize;
 		}
 	};
 
 	struct GltfBufferViewInfo
 	{
 		String		m_name;
-		ui32		m_bufferIdx;
-		ui32		m_byteOffset;
-		ui32		m_byteLength;
-		ui32		m_byteStride;
+		ui32		m_bufferIdx = 0;
+		ui32		m_byteOffset = 0;
+		ui32		m_byteLength = 0;
+		ui32		m_byteStride = 0;		// 0 when elements are tightly packed
 		enum class TargetType : ui16
 		{
 			None = 0,
@@ -203,8 +216,9 @@ namespace Echo
 	{
 		String	m_name;
 		String	m_uri;
-		String	m_mimeType;
-		i32		m_bufferView = -1;
+		String				m_mimeType;
+		i32					m_bufferView = -1;
+		TextureRenderPtr	m_texture;		// decoded from the bufferView, glb images have no uri
 	};
 
 	struct GltfSamplerInfo
@@ -282,7 +296,7 @@ namespace Echo
 
 	class GltfRes : public Res
 	{
-		ECHO_RES(GltfRes, Res, ".gltf", nullptr, GltfRes::load);
+		ECHO_RES(GltfRes, Res, ".gltf|.glb", nullptr, GltfRes::load);
 
 	public:
 		GltfMetaInfo						m_metaInfo;
@@ -298,6 +312,9 @@ namespace Echo
 		vector<GltfSamplerInfo>::type		m_samplers;
 		vector<GltfTextureInfo>::type		m_textures;
 		vector<GltfAnimInfo>::type			m_animations;
+		MemoryReader*						m_file = nullptr;
+		const char*							m_glbBinary = nullptr;	// binary chunk inside m_file
+		ui32								m_glbBinarySize = 0;
 
 		GltfRes() {}
 
@@ -307,6 +324,9 @@ namespace Echo
 		// get node index of mesh
 		i32 getNodeIdxByMeshIdx(i32 meshIdx);
 
+		// material of a primitive whose vertices are skinned on the cpu
+		Material* getCpuSkinningMaterial(int meshIdx, int primitiveIdx);
+
 	protected:
 		// create
 		static Res* load(const ResourcePath& path);
@@ -315,6 +335,7 @@ namespace Echo
 		GltfRes(const ResourcePath& path);
 		~GltfRes();
 		bool load();
+		bool loadGlb(const char*& jsonBegin, const char*& jsonEnd);
 		bool loadAsset(nlohmann::json& json);
 		bool loadScenes(nlohmann::json& json);
 		bool loadNodes(nlohmann::json& json);
@@ -332,12 +353,20 @@ namespace Echo
 		bool loadAnimations(nlohmann::json& json);
 		bool buildAnimationData();
 		bool buildPrimitiveData(int meshIdx, int primitiveIdx);
-		bool buildMaterial(int meshIdx, int primitiveIdx);
+		bool buildMaterial(int meshIdx, int primitiveIdx, bool isCpuSkinning = false);
+		void setImageTexture(Material::UniformValue* uniform, i32 imageIdx);
+		TextureRender* loadImageFromBufferView(i32 imageIdx);
 		void createNode(vector<Node*>::type& nodes, int idx);
 		Node*createSkeleton();
 		void bindSkeleton(Node* parent);
 		
 	private:
+		// first element of an accessor and the bytes between elements, nullptr when out of range
+		const Byte* getAccessElements(GltfAccessorInfo& access, ui32& stride);
+
+		// decode every element of a vertex attribute accessor to floats, dst elements are dstStride bytes apart
+		bool readAccessor(GltfAccessorInfo& access, float* dst, ui32 dstStride);
+
 		// help function for get access data
 		template<typename T> T getAccessData(GltfAccessorInfo& access)
 		{
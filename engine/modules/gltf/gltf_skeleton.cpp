@@ -1,4 +1,5 @@
 #include "gltf_skeleton.h"
+#include "gltf_module.h"
 #include "engine/core/log/Log.h"
 #include "engine/core/main/Engine.h"
 #include "engine/core/util/magic_enum.hpp"
@@ -8,10 +9,12 @@ namespace Echo
 	GltfSkeleton::GltfSkeleton()
 		: m_animations("")
 	{
+		GltfModule::instance()->addSkeleton(this);
 	}
 
 	GltfSkeleton::~GltfSkeleton()
 	{
+		GltfModule::instance()->removeSkeleton(this);
 	}
 
 	void GltfSkeleton::bindMethods()
@@ -50,7 +53,14 @@ namespace Echo
 				{
 					if (m_nodeTransforms.empty())
 						m_nodeTransforms.resize(m_asset->m_nodes.size());
+
+					buildNodeOrder();
 				}
+
+				// palettes start out in the bind pose
+				m_jointMatrixs.resize(m_asset->m_skins.size());
+				for (size_t i = 0; i < m_asset->m_skins.size(); i++)
+					m_jointMatrixs[i].assign(std::max<size_t>(m_asset->m_skins[i].m_joints.size(), DefaultJointCount), Matrix4::IDENTITY);
 			}
 		}
 	}
@@ -69,15 +79,26 @@ namespace Echo
 
 	void GltfSkeleton::update_self()
 	{
-		if (m_animations.isValid())
+		// usually done already by the module
+		evaluate();
+	}
+
+	void GltfSkeleton::evaluate()
+	{
+		ui32 frame = GltfModule::instance()->getFrame();
+		if (m_evaluatedFrame != frame)
 		{
-			ui32 deltaTime = Engine::instance()->getFrameTimeMS();
-			AnimClip* clip = m_clips[m_animations.getIdx()];
-			if (clip)
+			m_evaluatedFrame = frame;
+			if (m_animations.isValid())
 			{
-				clip->update(deltaTime);
+				ui32 deltaTime = Engine::instance()->getFrameTimeMS();
+				AnimClip* clip = m_clips[m_animations.getIdx()];
+				if (clip)
+				{
+					clip->update(deltaTime);
 
-				extractClipData(clip);
+					extractClipData(clip);
+				}
 			}
 		}
 	}
@@ -135,27 +156,65 @@ namespace Echo
 				}
 			}
 
-			for (GltfSceneInfo& scene : m_asset->m_scenes)
+			buildNodeTransforms();
+			buildJointMatrixs();
+		}
+	}
+
+	void GltfSkeleton::buildNodeOrder()
+	{
+		// breadth first from the scene roots, each node is visited once
+		m_nodeOrder.clear();
+		vector<Byte>::type visited(m_asset->m_nodes.size(), 0);
+		for (GltfSceneInfo& scene : m_asset->m_scenes)
+		{
+			for (ui32 rootNodeIdx : scene.m_nodes)
 			{
-				for (ui32 rootNodeIdx : scene.m_nodes)
+				if (rootNodeIdx < visited.size() && !visited[rootNodeIdx])
 				{
-					jointInhertParentTransform(rootNodeIdx);
+					visited[rootNodeIdx] = 1;
+					m_nodeOrder.emplace_back(i32(rootNodeIdx));
+				}
+			}
+		}
+
+		for (size_t i = 0; i < m_nodeOrder.size(); i++)
+		{
+			for (i32 child : m_asset->m_nodes[m_nodeOrder[i]].m_children)
+			{
+				if (!visited[child])
+				{
+					visited[child] = 1;
+					m_nodeOrder.emplace_back(child);
 				}
 			}
 		}
 	}
 
-	void GltfSkeleton::jointInhertParentTransform(i32 nodeIdx)
+	void GltfSkeleton::buildNodeTransforms()
 	{
-		const GltfNodeInfo& nodeInfo = m_asset->m_nodes[nodeIdx];
-		if (nodeInfo.m_parent != -1)
+		// parents come first, so they are already in world space
+		for (i32 nodeIdx : m_nodeOrder)
 		{
-			m_nodeTransforms[nodeIdx] = m_nodeTransforms[nodeInfo.m_parent] * m_nodeTransforms[nodeIdx];
+			i32 parent = m_asset->m_nodes[nodeIdx].m_parent;
+			if (parent != -1)
+				m_nodeTransforms[nodeIdx] = m_nodeTransforms[parent] * m_nodeTransforms[nodeIdx];
 		}
+	}
 
-		for (ui32 child : nodeInfo.m_children)
+	void GltfSkeleton::buildJointMatrixs()
+	{
+		m_nodeMatrixs.resize(m_nodeTransforms.size());
+		Transform::BuildMatrixBatch(m_nodeMatrixs.data(), m_nodeTransforms.data(), ui32(m_nodeTransforms.size()));
+
+		for (size_t skinIdx = 0; skinIdx < m_jointMatrixs.size(); skinIdx++)
 		{
-			jointInhertParentTransform(child);
+			const GltfSkinInfo& skin = m_asset->m_skins[skinIdx];
+			vector<Matrix4>::type& palette = m_jointMatrixs[skinIdx];
+			for (size_t i = 0; i < skin.m_joints.size() && i < skin.m_inverseMatrixs.size(); i++)
+			{
+				Matrix4::Multiply(palette[i], skin.m_inverseMatrixs[i], m_nodeMatrixs[skin.m_joints[i]]);
+			}
 		}
 	}
 
@@ -169,4 +228,9 @@ namespace Echo
 
 		return false;
 	}
+
+	const vector<Matrix4>::type* GltfSkeleton::getJointMatrixs(i32 skinIdx)
+	{
+		return skinIdx >= 0 && skinIdx < i32(m_jointMatrixs.size()) ? &m_jointMatrixs[skinIdx] : nullptr;
+	}
 }
@@ -11,6 +11,10 @@ namespace Echo
 	{
 		ECHO_CLASS(GltfSkeleton, Node)
 
+	public:
+		// palette size of shaders that don't define JOINT_COUNT
+		static const ui32 DefaultJointCount = 72;
+
 	public:
 		GltfSkeleton();
 		virtual ~GltfSkeleton();
@@ -34,6 +38,14 @@ namespace Echo
 		// get node transform
 		bool getGltfNodeTransform(Transform& transform, size_t nodeIdx);
 
+		// joint matrices of a skin of the asset, shared by every mesh bound to it
+		const vector<Matrix4>::type* getJointMatrixs(i32 skinIdx);
+
+		// sample the clip and rebuild node transforms and joint palettes, once per frame.
+		// touches the playing clip, which other skeletons of the asset share
+		void evaluate();
+		ui32 getEvaluatedFrame() const { return m_evaluatedFrame; }
+
 	protected:
 		// update self
 		virtual void update_self() override;
@@ -45,8 +57,12 @@ namespace Echo
 		//  query clip data
 		void extractClipData(AnimClip* clip);
 
-		// joint transform
-		void jointInhertParentTransform(i32 parent);
+		// nodes of the scenes ordered parents first
+		void buildNodeOrder();
+
+		// world transforms of nodes, then the palettes of every skin
+		void buildNodeTransforms();
+		void buildJointMatrixs();
 
 	private:
 		ResourcePath					m_assetPath;
@@ -54,5 +70,9 @@ namespace Echo
 		StringOption					m_animations;
 		vector<AnimClip*>::type			m_clips;
 		vector<Transform>::type			m_nodeTransforms;
+		vector<Matrix4>::type			m_nodeMatrixs;
+		vector<i32>::type				m_nodeOrder;
+		vector<vector<Matrix4>::type>::type	m_jointMatrixs;		// palette per skin
+		ui32							m_evaluatedFrame = 0;
 	};
 }
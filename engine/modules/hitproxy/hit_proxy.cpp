@@ -1,4 +1,5 @@
 #include "hit_proxy.h"
+#include "hit_proxy_module.h"
 
 namespace Echo
 {
@@ -9,14 +10,56 @@ namespace Echo
 
 	HitProxy::~HitProxy()
 	{
-
+		releaseShape();
 	}
 
 	void HitProxy::bindMethods()
 	{
 		CLASS_BIND_METHOD(HitProxy, is2d, DEF_METHOD("is2d"));
 		CLASS_BIND_METHOD(HitProxy, set2d, DEF_METHOD("set2d"));
+		CLASS_BIND_METHOD(HitProxy, getLayers, DEF_METHOD("getLayers"));
+		CLASS_BIND_METHOD(HitProxy, setLayers, DEF_METHOD("setLayers"));
 
 		CLASS_REGISTER_PROPERTY(HitProxy, "Is2D", Variant::Type::Bool, "is2d", "set2d");
+		CLASS_REGISTER_PROPERTY(HitProxy, "Layers", Variant::Type::Int, "getLayers", "setLayers");
+	}
+
+	void HitProxy::setLayers(i32 layers)
+	{
+		m_layers = ui32(layers);
+		if (m_handle != -1)
+			HitProxyModule::instance()->getScene().setLayers(m_handle, m_layers);
+	}
+
+	void HitProxy::update_self()
+	{
+		if (m_isShapeDirty)
+		{
+			releaseShape();
+			m_isShapeDirty = false;
+
+			m_shape = createShape();
+			if (m_shape)
+			{
+				m_shapeWorld = getWorldMatrix();
+				m_handle = HitProxyModule::instance()->getScene().add(m_shape, m_shapeWorld, m_layers, getId());
+			}
+		}
+		else if (m_handle != -1 && !(getWorldMatrix() == m_shapeWorld))
+		{
+			m_shapeWorld = getWorldMatrix();
+			HitProxyModule::instance()->getScene().move(m_handle, m_shapeWorld);
+		}
+	}
+
+	void HitProxy::releaseShape()
+	{
+		if (m_handle != -1)
+		{
+			HitProxyModule::instance()->getScene().remove(m_handle);
+			m_handle = -1;
+		}
+
+		EchoSafeDelete(m_shape, HitShape);
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <engine/core/scene/node.h>
+#include "hit_shape.h"
 
 namespace Echo
 {
@@ -16,7 +17,29 @@ namespace Echo
 		bool is2d() const { return m_2d; }
 		void set2d(bool is2d) { m_2d = is2d; }
 
+		// layer bits, queries only see proxies sharing a bit with their mask
+		i32 getLayers() const { return i32(m_layers); }
+		void setLayers(i32 layers);
+
+	protected:
+		// shape from the current properties, nullptr while there is nothing to hit
+		virtual HitShape* createShape() { return nullptr; }
+
+		// rebuild the shape on the next update
+		void markShapeDirty() { m_isShapeDirty = true; }
+
+		// keep the shape in the hit scene
+		virtual void update_self() override;
+
+		// leave the hit scene
+		void releaseShape();
+
 	protected:
-		bool	m_2d = false;
+		bool		m_2d = false;
+		ui32		m_layers = 1;
+		HitShape*	m_shape = nullptr;
+		i32			m_handle = -1;
+		bool		m_isShapeDirty = true;
+		Matrix4		m_shapeWorld;
 	};
 }
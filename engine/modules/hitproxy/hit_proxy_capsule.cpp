@@ -0,0 +1,42 @@
+#include "hit_proxy_capsule.h"
+
+namespace Echo
+{
+	HitProxyCapsule::HitProxyCapsule()
+	{
+
+	}
+
+	HitProxyCapsule::~HitProxyCapsule()
+	{
+
+	}
+
+	void HitProxyCapsule::bindMethods()
+	{
+		CLASS_BIND_METHOD(HitProxyCapsule, getRadius, DEF_METHOD("getRadius"));
+		CLASS_BIND_METHOD(HitProxyCapsule, setRadius, DEF_METHOD("setRadius"));
+		CLASS_BIND_METHOD(HitProxyCapsule, getHeight, DEF_METHOD("getHeight"));
+		CLASS_BIND_METHOD(HitProxyCapsule, setHeight, DEF_METHOD("setHeight"));
+
+		CLASS_REGISTER_PROPERTY(HitProxyCapsule, "Radius", Variant::Type::Real, "getRadius", "setRadius");
+		CLASS_REGISTER_PROPERTY(HitProxyCapsule, "Height", Variant::Type::Real, "getHeight", "setHeight");
+	}
+
+	void HitProxyCapsule::setRadius(float radius)
+	{
+		m_radius = std::max<float>(radius, 0.f);
+		markShapeDirty();
+	}
+
+	void HitProxyCapsule::setHeight(float height)
+	{
+		m_height = std::max<float>(height, 0.f);
+		markShapeDirty();
+	}
+
+	HitShape* HitProxyCapsule::createShape()
+	{
+		return EchoNew(HitShapeCapsule(m_radius, m_height * 0.5f));
+	}
+}
@@ -0,0 +1,42 @@
+#include "hit_proxy_cyliner.h"
+
+namespace Echo
+{
+	HitProxyCylinder::HitProxyCylinder()
+	{
+
+	}
+
+	HitProxyCylinder::~HitProxyCylinder()
+	{
+
+	}
+
+	void HitProxyCylinder::bindMethods()
+	{
+		CLASS_BIND_METHOD(HitProxyCylinder, getRadius, DEF_METHOD("getRadius"));
+		CLASS_BIND_METHOD(HitProxyCylinder, setRadius, DEF_METHOD("setRadius"));
+		CLASS_BIND_METHOD(HitProxyCylinder, getHeight, DEF_METHOD("getHeight"));
+		CLASS_BIND_METHOD(HitProxyCylinder, setHeight, DEF_METHOD("setHeight"));
+
+		CLASS_REGISTER_PROPERTY(HitProxyCylinder, "Radius", Variant::Type::Real, "getRadius", "setRadius");
+		CLASS_REGISTER_PROPERTY(HitProxyCylinder, "Height", Variant::Type::Real, "getHeight", "setHeight");
+	}
+
+	void HitProxyCylinder::setRadius(float radius)
+	{
+		m_radius = std::max<float>(radius, 0.f);
+		markShapeDirty();
+	}
+
+	void HitProxyCylinder::setHeight(float height)
+	{
+		m_height = std::max<float>(height, 0.f);
+		markShapeDirty();
+	}
+
+	HitShape* HitProxyCylinder::createShape()
+	{
+		return EchoNew(HitShapeCylinder(m_radius, m_height * 0.5f));
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "hit_proxy.h"
+
+namespace Echo
+{
+	// along local y
+	class HitProxyCylinder : public HitProxy
+	{
+		ECHO_CLASS(HitProxyCylinder, HitProxy);
+
+	public:
+		HitProxyCylinder();
+		virtual ~HitProxyCylinder();
+
+		// radius
+		float getRadius() const { return m_radius; }
+		void setRadius(float radius);
+
+		// height, the total height
+		float getHeight() const { return m_height; }
+		void setHeight(float height);
+
+	protected:
+		// shape
+		virtual HitShape* createShape() override;
+
+	protected:
+		float	m_radius = 0.5f;
+		float	m_height = 1.f;
+	};
+}
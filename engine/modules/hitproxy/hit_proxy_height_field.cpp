@@ -0,0 +1,30 @@
+#include "hit_proxy_height_field.h"
+
+namespace Echo
+{
+	HitProxyHeightField::HitProxyHeightField()
+	{
+
+	}
+
+	HitProxyHeightField::~HitProxyHeightField()
+	{
+
+	}
+
+	void HitProxyHeightField::bindMethods()
+	{
+
+	}
+
+	void HitProxyHeightField::setHeightField(TerrainHeightFieldPtr heightField)
+	{
+		m_heightField = heightField;
+		markShapeDirty();
+	}
+
+	HitShape* HitProxyHeightField::createShape()
+	{
+		return m_heightField ? EchoNew(HitShapeHeightField(m_heightField)) : nullptr;
+	}
+}
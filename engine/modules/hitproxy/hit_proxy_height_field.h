@@ -0,0 +1,27 @@
+#pragma once
+
+#include "hit_proxy.h"
+
+namespace Echo
+{
+	// terrain surface, shares the immutable height field the terrain publishes
+	class HitProxyHeightField : public HitProxy
+	{
+		ECHO_CLASS(HitProxyHeightField, HitProxy);
+
+	public:
+		HitProxyHeightField();
+		virtual ~HitProxyHeightField();
+
+		// height field in local space
+		TerrainHeightFieldPtr getHeightField() const { return m_heightField; }
+		void setHeightField(TerrainHeightFieldPtr heightField);
+
+	protected:
+		// shape
+		virtual HitShape* createShape() override;
+
+	protected:
+		TerrainHeightFieldPtr	m_heightField;
+	};
+}
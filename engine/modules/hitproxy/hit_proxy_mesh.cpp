@@ -0,0 +1,54 @@
+#include "hit_proxy_mesh.h"
+
+namespace Echo
+{
+	HitProxyMesh::HitProxyMesh()
+	{
+
+	}
+
+	HitProxyMesh::~HitProxyMesh()
+	{
+
+	}
+
+	void HitProxyMesh::bindMethods()
+	{
+
+	}
+
+	void HitProxyMesh::setTriangles(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount)
+	{
+		m_positions.assign(positions, positions + vertexCount);
+		m_indices.assign(indices, indices + indexCount);
+		markShapeDirty();
+	}
+
+	void HitProxyMesh::setMesh(MeshPtr mesh)
+	{
+		m_positions.clear();
+		m_indices.clear();
+		if (mesh && mesh->getTopologyType() == Mesh::TT_TRIANGLELIST)
+		{
+			MeshVertexData& vertices = mesh->getVertexData();
+			m_positions.resize(mesh->getVertexCount());
+			for (ui32 i = 0; i < m_positions.size(); i++)
+				m_positions[i] = vertices.getPosition(Word(i));
+
+			const Byte* indices = (const Byte*)mesh->getIndices();
+			m_indices.resize(mesh->getIndexCount());
+			for (ui32 i = 0; i < m_indices.size(); i++)
+				m_indices[i] = mesh->getIndexStride() == sizeof(ui32) ? ((const ui32*)indices)[i] : ((const Word*)indices)[i];
+		}
+
+		markShapeDirty();
+	}
+
+	HitShape* HitProxyMesh::createShape()
+	{
+		if (m_indices.size() < 3)
+			return nullptr;
+
+		return EchoNew(HitShapeMesh(m_positions.data(), ui32(m_positions.size()), m_indices.data(), ui32(m_indices.size())));
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "hit_proxy.h"
+#include "engine/core/render/base/mesh/mesh.h"
+
+namespace Echo
+{
+	// exact hits against triangles, the triangle bvh is built when the geometry is set
+	class HitProxyMesh : public HitProxy
+	{
+		ECHO_CLASS(HitProxyMesh, HitProxy);
+
+	public:
+		HitProxyMesh();
+		virtual ~HitProxyMesh();
+
+		// triangle list geometry, copied
+		void setTriangles(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount);
+
+		// copy the triangles of a cpu side triangle list mesh
+		void setMesh(MeshPtr mesh);
+
+	protected:
+		// shape
+		virtual HitShape* createShape() override;
+
+	protected:
+		vector<Vector3>::type	m_positions;
+		vector<ui32>::type		m_indices;
+	};
+}
@@ -1,6 +1,11 @@
 #include "hit_proxy_module.h"
 #include "hit_proxy.h"
 #include "hit_proxy_obb.h"
+#include "hit_proxy_sphere.h"
+#include "hit_proxy_capsule.h"
+#include "hit_proxy_cyliner.h"
+#include "hit_proxy_mesh.h"
+#include "hit_proxy_height_field.h"
 
 namespace Echo
 {
@@ -29,5 +34,10 @@ namespace Echo
 	{
 		Class::registerType<HitProxy>();
 		Class::registerType<HitProxyOBB>();
+		Class::registerType<HitProxySphere>();
+		Class::registerType<HitProxyCapsule>();
+		Class::registerType<HitProxyCylinder>();
+		Class::registerType<HitProxyMesh>();
+		Class::registerType<HitProxyHeightField>();
 	}
 }
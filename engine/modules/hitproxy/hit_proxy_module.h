@@ -2,6 +2,7 @@
 
 #include "engine/core/main/module.h"
 #include "engine/core/render/base/texture.h"
+#include "hit_scene.h"
 
 namespace Echo
 {
@@ -18,7 +19,11 @@ namespace Echo
 
 		// register all types of the module
 		virtual void registerTypes() override;  
+
+		// queries over every hit proxy
+		HitScene& getScene() { return m_scene; }
         
     protected:
+		HitScene	m_scene;
 	};
 }
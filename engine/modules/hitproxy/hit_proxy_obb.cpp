@@ -14,6 +14,20 @@ namespace Echo
 
 	void HitProxyOBB::bindMethods()
 	{
+		CLASS_BIND_METHOD(HitProxyOBB, getHalfExtent, DEF_METHOD("getHalfExtent"));
+		CLASS_BIND_METHOD(HitProxyOBB, setHalfExtent, DEF_METHOD("setHalfExtent"));
 
+		CLASS_REGISTER_PROPERTY(HitProxyOBB, "HalfExtent", Variant::Type::Vector3, "getHalfExtent", "setHalfExtent");
+	}
+
+	void HitProxyOBB::setHalfExtent(const Vector3& halfExtent)
+	{
+		m_halfExtent = halfExtent;
+		markShapeDirty();
+	}
+
+	HitShape* HitProxyOBB::createShape()
+	{
+		return EchoNew(HitShapeBox(m_halfExtent));
 	}
 }
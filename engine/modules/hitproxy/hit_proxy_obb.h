@@ -12,7 +12,15 @@ namespace Echo
 		HitProxyOBB();
 		virtual ~HitProxyOBB();
 
+		// half size along the local axes
+		const Vector3& getHalfExtent() const { return m_halfExtent; }
+		void setHalfExtent(const Vector3& halfExtent);
+
 	protected:
+		// shape
+		virtual HitShape* createShape() override;
 
+	protected:
+		Vector3		m_halfExtent = Vector3(0.5f, 0.5f, 0.5f);
 	};
 }
@@ -0,0 +1,33 @@
+#include "hit_proxy_sphere.h"
+
+namespace Echo
+{
+	HitProxySphere::HitProxySphere()
+	{
+
+	}
+
+	HitProxySphere::~HitProxySphere()
+	{
+
+	}
+
+	void HitProxySphere::bindMethods()
+	{
+		CLASS_BIND_METHOD(HitProxySphere, getRadius, DEF_METHOD("getRadius"));
+		CLASS_BIND_METHOD(HitProxySphere, setRadius, DEF_METHOD("setRadius"));
+
+		CLASS_REGISTER_PROPERTY(HitProxySphere, "Radius", Variant::Type::Real, "getRadius", "setRadius");
+	}
+
+	void HitProxySphere::setRadius(float radius)
+	{
+		m_radius = std::max<float>(radius, 0.f);
+		markShapeDirty();
+	}
+
+	HitShape* HitProxySphere::createShape()
+	{
+		return EchoNew(HitShapeSphere(m_radius));
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "hit_proxy.h"
+
+namespace Echo
+{
+	class HitProxySphere : public HitProxy
+	{
+		ECHO_CLASS(HitProxySphere, HitProxy);
+
+	public:
+		HitProxySphere();
+		virtual ~HitProxySphere();
+
+		// radius
+		float getRadius() const { return m_radius; }
+		void setRadius(float radius);
+
+	protected:
+		// shape
+		virtual HitShape* createShape() override;
+
+	protected:
+		float	m_radius = 0.5f;
+	};
+}
@@ -0,0 +1,283 @@
+#include "hit_scene.h"
+#include <algorithm>
+
+namespace Echo
+{
+	// bvh callbacks around a lambda
+	template<typename T>
+	class HitQueryCb : public BvhCb
+	{
+	public:
+		HitQueryCb(const T& fn) : m_fn(fn) {}
+
+		virtual bool queryCallback(i32 nodeId) override { m_fn(nodeId); return true; }
+		virtual float rayCastCallback(i32 nodeId) override { return -1.f; }
+
+	private:
+		const T&	m_fn;
+	};
+
+	// the lambda returns the new max fraction of the segment, or -1 to leave it
+	template<typename T>
+	class HitRayCastCb : public BvhCb
+	{
+	public:
+		HitRayCastCb(const T& fn) : m_fn(fn) {}
+
+		virtual bool queryCallback(i32 nodeId) override { return true; }
+		virtual float rayCastCallback(i32 nodeId) override { return m_fn(nodeId); }
+
+	private:
+		const T&	m_fn;
+	};
+
+	template<typename T>
+	static void QueryBox(const Bvh& bvh, const AABB& box, const T& fn)
+	{
+		HitQueryCb<T> callback(fn);
+		bvh.query(&callback, box);
+	}
+
+	template<typename T>
+	static void QueryRay(const Bvh& bvh, const Vector3& start, const Vector3& end, const T& fn)
+	{
+		HitRayCastCb<T> callback(fn);
+		bvh.rayCast(&callback, start, end);
+	}
+
+	// rotation and scale only
+	static Vector3 TransformDirection(const Vector3& dir, const Matrix4& mat)
+	{
+		return Vector3(
+			dir.x * mat.m00 + dir.y * mat.m10 + dir.z * mat.m20,
+			dir.x * mat.m01 + dir.y * mat.m11 + dir.z * mat.m21,
+			dir.x * mat.m02 + dir.y * mat.m12 + dir.z * mat.m22);
+	}
+
+	// normals go through the inverse transpose
+	static Vector3 TransformNormal(const Vector3& normal, const Matrix4& invMat)
+	{
+		Vector3 result(
+			normal.x * invMat.m00 + normal.y * invMat.m01 + normal.z * invMat.m02,
+			normal.x * invMat.m10 + normal.y * invMat.m11 + normal.z * invMat.m12,
+			normal.x * invMat.m20 + normal.y * invMat.m21 + normal.z * invMat.m22);
+		result.normalize();
+
+		return result;
+	}
+
+	HitScene::HitScene()
+	{
+	}
+
+	HitScene::~HitScene()
+	{
+	}
+
+	i32 HitScene::add(const HitShape* shape, const Matrix4& world, ui32 layers, i32 userData)
+	{
+		i32 handle = m_bvh.createProxy(shape->getLocalBox().transform(world), userData);
+		if (handle >= i32(m_entries.size()))
+			m_entries.resize(handle + 1);
+
+		Entry& entry = m_entries[handle];
+		entry.m_shape = shape;
+		entry.m_layers = layers;
+		entry.m_userData = userData;
+		entry.m_world = world;
+		entry.m_invWorld = world;
+		entry.m_invWorld.detInverse();
+
+		return handle;
+	}
+
+	void HitScene::move(i32 handle, const Matrix4& world)
+	{
+		Entry& entry = m_entries[handle];
+		entry.m_world = world;
+		entry.m_invWorld = world;
+		entry.m_invWorld.detInverse();
+
+		m_bvh.moveProxy(handle, entry.m_shape->getLocalBox().transform(world), Vector3::ZERO);
+	}
+
+	void HitScene::remove(i32 handle)
+	{
+		m_bvh.destroyProxy(handle);
+		m_entries[handle] = Entry();
+	}
+
+	void HitScene::setLayers(i32 handle, ui32 layers)
+	{
+		m_entries[handle].m_layers = layers;
+	}
+
+	bool HitScene::raycastEntry(const Entry& entry, const Vector3& origin, const Vector3& dir, float maxDistance, Hit& hit) const
+	{
+		// the local dir keeps the scale, so distances stay in world units
+		Vector3 localOrigin = origin * entry.m_invWorld;
+		Vector3 localDir = TransformDirection(dir, entry.m_invWorld);
+		float distance = 0.f;
+		Vector3 normal;
+		if (!entry.m_shape->raycast(localOrigin, localDir, maxDistance, distance, normal))
+			return false;
+
+		hit.m_userData = entry.m_userData;
+		hit.m_distance = distance;
+		hit.m_position = origin + dir * distance;
+		hit.m_normal = TransformNormal(normal, entry.m_invWorld);
+		return true;
+	}
+
+	Vector3 HitScene::closestPoint(const Entry& entry, const Vector3& point) const
+	{
+		return entry.m_shape->closestPoint(point * entry.m_invWorld) * entry.m_world;
+	}
+
+	bool HitScene::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, ui32 layerMask, Hit& hit) const
+	{
+		hit = Hit();
+		float len = dir.len();
+		if (len <= 0.f || maxDistance <= 0.f)
+			return false;
+
+		Vector3 unitDir = dir / len;
+		bool isHit = false;
+		float nearest = maxDistance;
+		QueryRay(m_bvh, origin, origin + unitDir * maxDistance, [&](i32 handle)
+		{
+			const Entry& entry = m_entries[handle];
+			if (!(entry.m_layers & layerMask) || !raycastEntry(entry, origin, unitDir, nearest, hit))
+				return -1.f;
+
+			// shorten the segment, a hit at distance 0 ends the walk
+			isHit = true;
+			nearest = hit.m_distance;
+			return nearest / maxDistance;
+		});
+
+		return isHit;
+	}
+
+	ui32 HitScene::raycastAll(const Vector3& origin, const Vector3& dir, float maxDistance, ui32 layerMask, vector<Hit>::type& hits) const
+	{
+		float len = dir.len();
+		if (len <= 0.f || maxDistance <= 0.f)
+			return 0;
+
+		Vector3 unitDir = dir / len;
+		size_t first = hits.size();
+		QueryRay(m_bvh, origin, origin + unitDir * maxDistance, [&](i32 handle)
+		{
+			Hit hit;
+			const Entry& entry = m_entries[handle];
+			if ((entry.m_layers & layerMask) && raycastEntry(entry, origin, unitDir, maxDistance, hit))
+				hits.emplace_back(hit);
+
+			return -1.f;
+		});
+
+		std::sort(hits.begin() + first, hits.end(), [](const Hit& a, const Hit& b) { return a.m_distance < b.m_distance; });
+		return ui32(hits.size() - first);
+	}
+
+	void HitScene::raycastBatch(const RayQuery* queries, Hit* hits, ui32 count) const
+	{
+		for (ui32 i = 0; i < count; i++)
+			raycast(queries[i].m_origin, queries[i].m_dir, queries[i].m_maxDistance, queries[i].m_layerMask, hits[i]);
+	}
+
+	ui32 HitScene::overlapSphere(const Vector3& center, float radius, ui32 layerMask, vector<i32>::type& results) const
+	{
+		size_t first = results.size();
+		Vector3 extent(radius, radius, radius);
+		QueryBox(m_bvh, AABB(center - extent, center + extent), [&](i32 handle)
+		{
+			const Entry& entry = m_entries[handle];
+			if ((entry.m_layers & layerMask) && (closestPoint(entry, center) - center).lenSqr() <= radius * radius)
+				results.emplace_back(entry.m_userData);
+		});
+
+		return ui32(results.size() - first);
+	}
+
+	ui32 HitScene::overlapBox(const AABB& box, ui32 layerMask, vector<i32>::type& results) const
+	{
+		size_t first = results.size();
+		QueryBox(m_bvh, box, [&](i32 handle)
+		{
+			const Entry& entry = m_entries[handle];
+			if (!(entry.m_layers & layerMask))
+				return;
+
+			// alternate projections between the box and the shape, they meet when the two
+			// convex sets touch and settle on the closest pair otherwise
+			Vector3 boxPoint = box.getCenter();
+			for (i32 i = 0; i < 16; i++)
+			{
+				Vector3 shapePoint = closestPoint(entry, boxPoint);
+				Vector3 clamped(Math::Clamp(shapePoint.x, box.vMin.x, box.vMax.x), Math::Clamp(shapePoint.y, box.vMin.y, box.vMax.y), Math::Clamp(shapePoint.z, box.vMin.z, box.vMax.z));
+				float distanceSqr = (clamped - shapePoint).lenSqr();
+				if (distanceSqr <= 1e-8f)
+				{
+					results.emplace_back(entry.m_userData);
+					break;
+				}
+
+				if ((clamped - boxPoint).lenSqr() <= 1e-10f)
+					break;
+
+				boxPoint = clamped;
+			}
+		});
+
+		return ui32(results.size() - first);
+	}
+
+	bool HitScene::sweepSphere(const Vector3& center, float radius, const Vector3& dir, float maxDistance, ui32 layerMask, Hit& hit) const
+	{
+		hit = Hit();
+		float len = dir.len();
+		if (len <= 0.f || maxDistance < 0.f)
+			return false;
+
+		Vector3 unitDir = dir / len;
+		Vector3 extent(radius, radius, radius);
+		AABB sweptBox(center - extent, center + extent);
+		sweptBox.addPoint(center + unitDir * maxDistance - extent);
+		sweptBox.addPoint(center + unitDir * maxDistance + extent);
+
+		bool isHit = false;
+		float nearest = maxDistance;
+		QueryBox(m_bvh, sweptBox, [&](i32 handle)
+		{
+			const Entry& entry = m_entries[handle];
+			if (!(entry.m_layers & layerMask))
+				return;
+
+			// conservative advancement, the sphere may always move by its gap to the shape
+			float t = 0.f;
+			for (i32 i = 0; i < 64 && t <= nearest; i++)
+			{
+				Vector3 position = center + unitDir * t;
+				Vector3 contact = closestPoint(entry, position);
+				Vector3 offset = position - contact;
+				float gap = offset.len() - radius;
+				if (gap <= 1e-4f)
+				{
+					isHit = true;
+					nearest = t;
+					hit.m_userData = entry.m_userData;
+					hit.m_distance = t;
+					hit.m_position = contact;
+					hit.m_normal = offset.lenSqr() > 1e-12f ? offset / offset.len() : -unitDir;
+					break;
+				}
+
+				t += gap;
+			}
+		});
+
+		return isHit;
+	}
+}
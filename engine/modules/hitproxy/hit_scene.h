@@ -0,0 +1,77 @@
+#pragma once
+
+#include "engine/core/scene/bvh.h"
+#include "hit_shape.h"
+
+namespace Echo
+{
+	// scene queries over hit shapes kept in a bvh. adding, moving and removing happen on the
+	// main thread, queries are const and may run on any number of workers in between
+	class HitScene
+	{
+	public:
+		static const ui32 AllLayers = 0xffffffff;
+
+		struct Hit
+		{
+			i32			m_userData = -1;		// -1 when nothing was hit
+			float		m_distance = 0.f;
+			Vector3		m_position;
+			Vector3		m_normal;
+		};
+
+		struct RayQuery
+		{
+			Vector3		m_origin;
+			Vector3		m_dir;
+			float		m_maxDistance = 1000.f;
+			ui32		m_layerMask = AllLayers;
+		};
+
+	public:
+		HitScene();
+		~HitScene();
+
+		// shapes are not owned, they must outlive their registration. returns a handle
+		i32 add(const HitShape* shape, const Matrix4& world, ui32 layers, i32 userData);
+		void move(i32 handle, const Matrix4& world);
+		void remove(i32 handle);
+		void setLayers(i32 handle, ui32 layers);
+
+		// closest hit, distance is in world units along the normalized dir
+		bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, ui32 layerMask, Hit& hit) const;
+
+		// every shape along the ray, sorted near to far. returns the number appended
+		ui32 raycastAll(const Vector3& origin, const Vector3& dir, float maxDistance, ui32 layerMask, vector<Hit>::type& hits) const;
+
+		// closest hit of each query, split the batch across workers for large counts
+		void raycastBatch(const RayQuery* queries, Hit* hits, ui32 count) const;
+
+		// user data of the shapes touching a sphere or world box. returns the number appended
+		ui32 overlapSphere(const Vector3& center, float radius, ui32 layerMask, vector<i32>::type& results) const;
+		ui32 overlapBox(const AABB& box, ui32 layerMask, vector<i32>::type& results) const;
+
+		// first contact of a sphere moving along dir, position is the contact on the shape
+		bool sweepSphere(const Vector3& center, float radius, const Vector3& dir, float maxDistance, ui32 layerMask, Hit& hit) const;
+
+	private:
+		struct Entry
+		{
+			const HitShape*		m_shape = nullptr;
+			Matrix4				m_world;
+			Matrix4				m_invWorld;
+			ui32				m_layers = 0;
+			i32					m_userData = -1;
+		};
+
+		// shape hit in world space
+		bool raycastEntry(const Entry& entry, const Vector3& origin, const Vector3& dir, float maxDistance, Hit& hit) const;
+
+		// closest point in world space. under non uniform scale it is the local closest point
+		Vector3 closestPoint(const Entry& entry, const Vector3& point) const;
+
+	private:
+		Bvh						m_bvh;
+		vector<Entry>::type		m_entries;		// indexed by bvh proxy id
+	};
+}
@@ -0,0 +1,349 @@
+#include "hit_shape.h"
+#include "engine/core/geom/Ray.h"
+
+namespace Echo
+{
+	// first entry of a ray into a sphere, false when it starts inside or misses
+	static bool IntersectSphere(const Vector3& origin, const Vector3& dir, const Vector3& center, float radius, float maxDistance, float& distance)
+	{
+		Vector3 offset = origin - center;
+		float a = dir.dot(dir);
+		float b = offset.dot(dir);
+		float c = offset.dot(offset) - radius * radius;
+		float disc = b * b - a * c;
+		if (a <= 0.f || c <= 0.f || disc < 0.f)
+			return false;
+
+		float t = (-b - std::sqrt(disc)) / a;
+		if (t < 0.f || t > maxDistance)
+			return false;
+
+		distance = t;
+		return true;
+	}
+
+	// first entry through the side of an infinite y axis cylinder within |y| <= halfHeight
+	static bool IntersectTube(const Vector3& origin, const Vector3& dir, float radius, float halfHeight, float maxDistance, float& distance)
+	{
+		float a = dir.x * dir.x + dir.z * dir.z;
+		float b = origin.x * dir.x + origin.z * dir.z;
+		float c = origin.x * origin.x + origin.z * origin.z - radius * radius;
+		float disc = b * b - a * c;
+		if (a <= 1e-12f || c <= 0.f || disc < 0.f)
+			return false;
+
+		float t = (-b - std::sqrt(disc)) / a;
+		if (t < 0.f || t > maxDistance || std::abs(origin.y + dir.y * t) > halfHeight)
+			return false;
+
+		distance = t;
+		return true;
+	}
+
+	// a query starting inside a shape hits it at once, facing back along the ray
+	static bool HitInside(const Vector3& dir, float& distance, Vector3& normal)
+	{
+		distance = 0.f;
+		normal = -dir;
+		normal.normalize();
+		return true;
+	}
+
+	bool HitShape::IntersectBox(const Vector3& origin, const Vector3& dir, const Vector3& boxMin, const Vector3& boxMax, float& tMin, float& tMax)
+	{
+		for (i32 axis = 0; axis < 3; axis++)
+		{
+			if (std::abs(dir[axis]) < 1e-12f)
+			{
+				if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+					return false;
+			}
+			else
+			{
+				float invDir = 1.f / dir[axis];
+				float t0 = (boxMin[axis] - origin[axis]) * invDir;
+				float t1 = (boxMax[axis] - origin[axis]) * invDir;
+				if (t0 > t1)
+					std::swap(t0, t1);
+
+				tMin = std::max<float>(tMin, t0);
+				tMax = std::min<float>(tMax, t1);
+				if (tMin > tMax)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool HitShape::IntersectTriangle(const Vector3& origin, const Vector3& dir, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& t)
+	{
+		Vector3 edge1 = v1 - v0;
+		Vector3 edge2 = v2 - v0;
+		Vector3 p = dir.cross(edge2);
+		float det = edge1.dot(p);
+		if (std::abs(det) < 1e-12f)
+			return false;
+
+		float invDet = 1.f / det;
+		Vector3 s = origin - v0;
+		float u = s.dot(p) * invDet;
+		if (u < 0.f || u > 1.f)
+			return false;
+
+		Vector3 q = s.cross(edge1);
+		float v = dir.dot(q) * invDet;
+		if (v < 0.f || u + v > 1.f)
+			return false;
+
+		t = edge2.dot(q) * invDet;
+		return t >= 0.f;
+	}
+
+	Vector3 HitShape::ClosestPointOnTriangle(const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c)
+	{
+		// voronoi regions of the vertices, edges and face
+		Vector3 ab = b - a;
+		Vector3 ac = c - a;
+		Vector3 ap = point - a;
+		float d1 = ab.dot(ap);
+		float d2 = ac.dot(ap);
+		if (d1 <= 0.f && d2 <= 0.f)
+			return a;
+
+		Vector3 bp = point - b;
+		float d3 = ab.dot(bp);
+		float d4 = ac.dot(bp);
+		if (d3 >= 0.f && d4 <= d3)
+			return b;
+
+		float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+			return a + ab * (d1 / (d1 - d3));
+
+		Vector3 cp = point - c;
+		float d5 = ab.dot(cp);
+		float d6 = ac.dot(cp);
+		if (d6 >= 0.f && d5 <= d6)
+			return c;
+
+		float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+			return a + ac * (d2 / (d2 - d6));
+
+		float va = d3 * d6 - d5 * d4;
+		if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		float denom = 1.f / (va + vb + vc);
+		return a + ab * (vb * denom) + ac * (vc * denom);
+	}
+
+	AABB HitShapeSphere::getLocalBox() const
+	{
+		return AABB(Vector3(-m_radius, -m_radius, -m_radius), Vector3(m_radius, m_radius, m_radius));
+	}
+
+	bool HitShapeSphere::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const
+	{
+		if (origin.lenSqr() <= m_radius * m_radius)
+			return HitInside(dir, distance, normal);
+
+		if (!IntersectSphere(origin, dir, Vector3::ZERO, m_radius, maxDistance, distance))
+			return false;
+
+		normal = (origin + dir * distance) / m_radius;
+		return true;
+	}
+
+	Vector3 HitShapeSphere::closestPoint(const Vector3& point) const
+	{
+		float len = point.len();
+		return len <= m_radius ? point : point * (m_radius / len);
+	}
+
+	AABB HitShapeBox::getLocalBox() const
+	{
+		return AABB(-m_halfExtent, m_halfExtent);
+	}
+
+	bool HitShapeBox::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const
+	{
+		if (closestPoint(origin) == origin)
+			return HitInside(dir, distance, normal);
+
+		float tMin = 0.f;
+		float tMax = maxDistance;
+		if (!IntersectBox(origin, dir, -m_halfExtent, m_halfExtent, tMin, tMax))
+			return false;
+
+		// the entry face is the one the hit point lies furthest out on
+		Vector3 position = origin + dir * tMin;
+		i32 axis = 0;
+		float maxRatio = -1.f;
+		for (i32 i = 0; i < 3; i++)
+		{
+			float ratio = m_halfExtent[i] > 0.f ? std::abs(position[i]) / m_halfExtent[i] : Math::MAX_REAL;
+			if (ratio > maxRatio)
+			{
+				maxRatio = ratio;
+				axis = i;
+			}
+		}
+
+		distance = tMin;
+		normal = Vector3::ZERO;
+		normal[axis] = position[axis] < 0.f ? -1.f : 1.f;
+		return true;
+	}
+
+	Vector3 HitShapeBox::closestPoint(const Vector3& point) const
+	{
+		return Vector3(Math::Clamp(point.x, -m_halfExtent.x, m_halfExtent.x), Math::Clamp(point.y, -m_halfExtent.y, m_halfExtent.y), Math::Clamp(point.z, -m_halfExtent.z, m_halfExtent.z));
+	}
+
+	AABB HitShapeCapsule::getLocalBox() const
+	{
+		return AABB(Vector3(-m_radius, -m_halfHeight - m_radius, -m_radius), Vector3(m_radius, m_halfHeight + m_radius, m_radius));
+	}
+
+	bool HitShapeCapsule::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const
+	{
+		if (closestPoint(origin) == origin)
+			return HitInside(dir, distance, normal);
+
+		bool isHit = false;
+		float t = 0.f;
+		if (IntersectTube(origin, dir, m_radius, m_halfHeight, maxDistance, t))
+		{
+			Vector3 position = origin + dir * t;
+			distance = maxDistance = t;
+			normal = Vector3(position.x, 0.f, position.z) / m_radius;
+			isHit = true;
+		}
+
+		for (float capY : { -m_halfHeight, m_halfHeight })
+		{
+			Vector3 center(0.f, capY, 0.f);
+			if (IntersectSphere(origin, dir, center, m_radius, maxDistance, t))
+			{
+				distance = maxDistance = t;
+				normal = (origin + dir * t - center) / m_radius;
+				isHit = true;
+			}
+		}
+
+		return isHit;
+	}
+
+	Vector3 HitShapeCapsule::closestPoint(const Vector3& point) const
+	{
+		Vector3 axisPoint(0.f, Math::Clamp(point.y, -m_halfHeight, m_halfHeight), 0.f);
+		Vector3 offset = point - axisPoint;
+		float len = offset.len();
+
+		return len <= m_radius ? point : axisPoint + offset * (m_radius / len);
+	}
+
+	AABB HitShapeCylinder::getLocalBox() const
+	{
+		return AABB(Vector3(-m_radius, -m_halfHeight, -m_radius), Vector3(m_radius, m_halfHeight, m_radius));
+	}
+
+	bool HitShapeCylinder::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const
+	{
+		if (closestPoint(origin) == origin)
+			return HitInside(dir, distance, normal);
+
+		bool isHit = false;
+		float t = 0.f;
+		if (IntersectTube(origin, dir, m_radius, m_halfHeight, maxDistance, t))
+		{
+			Vector3 position = origin + dir * t;
+			distance = maxDistance = t;
+			normal = Vector3(position.x, 0.f, position.z) / m_radius;
+			isHit = true;
+		}
+
+		// caps, only the one facing the ray can be entered
+		if (std::abs(dir.y) > 1e-12f)
+		{
+			float capY = dir.y < 0.f ? m_halfHeight : -m_halfHeight;
+			t = (capY - origin.y) / dir.y;
+			Vector3 position = origin + dir * t;
+			if (t >= 0.f && t <= maxDistance && position.x * position.x + position.z * position.z <= m_radius * m_radius)
+			{
+				distance = t;
+				normal = capY > 0.f ? Vector3::UNIT_Y : Vector3::NEG_UNIT_Y;
+				isHit = true;
+			}
+		}
+
+		return isHit;
+	}
+
+	Vector3 HitShapeCylinder::closestPoint(const Vector3& point) const
+	{
+		Vector3 result = point;
+		float radialSqr = point.x * point.x + point.z * point.z;
+		if (radialSqr > m_radius * m_radius)
+		{
+			float scale = m_radius / std::sqrt(radialSqr);
+			result.x *= scale;
+			result.z *= scale;
+		}
+		result.y = Math::Clamp(point.y, -m_halfHeight, m_halfHeight);
+
+		return result;
+	}
+
+	HitShapeMesh::HitShapeMesh(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount)
+	{
+		m_triangles.build(positions, vertexCount, indices, indexCount);
+	}
+
+	bool HitShapeMesh::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const
+	{
+		i32 triangle = m_triangles.raycast(origin, dir, maxDistance, distance);
+		if (triangle == -1)
+			return false;
+
+		// two sided, face the ray
+		normal = m_triangles.getNormal(triangle);
+		if (normal.dot(dir) > 0.f)
+			normal = -normal;
+
+		return true;
+	}
+
+	AABB HitShapeHeightField::getLocalBox() const
+	{
+		TerrainHeightField::Bounds bounds = m_heightField->getBounds(31, 0, 0);
+		float spacing = m_heightField->getGridSpacing();
+		return AABB(Vector3(0.f, bounds.m_min, 0.f), Vector3((m_heightField->getColumns() - 1) * spacing, bounds.m_max, (m_heightField->getRows() - 1) * spacing));
+	}
+
+	bool HitShapeHeightField::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const
+	{
+		if (!m_heightField->raycast(Ray(origin, dir), maxDistance, distance))
+			return false;
+
+		Vector3 position = origin + dir * distance;
+		normal = m_heightField->getNormalAt(position.x, position.z);
+		return true;
+	}
+
+	Vector3 HitShapeHeightField::closestPoint(const Vector3& point) const
+	{
+		float spacing = m_heightField->getGridSpacing();
+		float x = Math::Clamp(point.x, 0.f, (m_heightField->getColumns() - 1) * spacing);
+		float z = Math::Clamp(point.z, 0.f, (m_heightField->getRows() - 1) * spacing);
+		float height = m_heightField->getHeightAt(x, z);
+
+		// below the surface counts as inside
+		if (x == point.x && z == point.z && point.y <= height)
+			return point;
+
+		return Vector3(x, height, z);
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "engine/core/geom/AABB.h"
+#include "engine/modules/scene/terrain/terrain_height_field.h"
+#include "hit_triangle_bvh.h"
+
+namespace Echo
+{
+	// collision geometry in local space. shapes are immutable while registered in a HitScene,
+	// so queries may run on any thread
+	class HitShape
+	{
+	public:
+		virtual ~HitShape() {}
+
+		// local bounds
+		virtual AABB getLocalBox() const = 0;
+
+		// nearest hit within maxDistance, dir needn't be normalized and distance is in units of it
+		virtual bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const = 0;
+
+		// closest point of the shape, the point itself when it is inside
+		virtual Vector3 closestPoint(const Vector3& point) const = 0;
+
+	public:
+		// ray box slab test, the interval is clipped to [tMin, tMax]
+		static bool IntersectBox(const Vector3& origin, const Vector3& dir, const Vector3& boxMin, const Vector3& boxMax, float& tMin, float& tMax);
+
+		// two sided moller trumbore
+		static bool IntersectTriangle(const Vector3& origin, const Vector3& dir, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& t);
+
+		// closest point of a triangle
+		static Vector3 ClosestPointOnTriangle(const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c);
+	};
+
+	class HitShapeSphere : public HitShape
+	{
+	public:
+		HitShapeSphere(float radius) : m_radius(radius) {}
+
+		virtual AABB getLocalBox() const override;
+		virtual bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const override;
+		virtual Vector3 closestPoint(const Vector3& point) const override;
+
+	private:
+		float	m_radius;
+	};
+
+	class HitShapeBox : public HitShape
+	{
+	public:
+		HitShapeBox(const Vector3& halfExtent) : m_halfExtent(halfExtent) {}
+
+		virtual AABB getLocalBox() const override;
+		virtual bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const override;
+		virtual Vector3 closestPoint(const Vector3& point) const override;
+
+	private:
+		Vector3	m_halfExtent;
+	};
+
+	// along local y, halfHeight is the half length of the inner segment
+	class HitShapeCapsule : public HitShape
+	{
+	public:
+		HitShapeCapsule(float radius, float halfHeight) : m_radius(radius), m_halfHeight(halfHeight) {}
+
+		virtual AABB getLocalBox() const override;
+		virtual bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const override;
+		virtual Vector3 closestPoint(const Vector3& point) const override;
+
+	private:
+		float	m_radius;
+		float	m_halfHeight;
+	};
+
+	// along local y
+	class HitShapeCylinder : public HitShape
+	{
+	public:
+		HitShapeCylinder(float radius, float halfHeight) : m_radius(radius), m_halfHeight(halfHeight) {}
+
+		virtual AABB getLocalBox() const override;
+		virtual bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const override;
+		virtual Vector3 closestPoint(const Vector3& point) const override;
+
+	private:
+		float	m_radius;
+		float	m_halfHeight;
+	};
+
+	// exact triangle hits through a per mesh bvh
+	class HitShapeMesh : public HitShape
+	{
+	public:
+		HitShapeMesh(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount);
+
+		virtual AABB getLocalBox() const override { return m_triangles.getBox(); }
+		virtual bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const override;
+		virtual Vector3 closestPoint(const Vector3& point) const override { return m_triangles.closestPoint(point); }
+
+	private:
+		HitTriangleBvh	m_triangles;
+	};
+
+	// terrain surface, the closest point is the one straight above or below
+	class HitShapeHeightField : public HitShape
+	{
+	public:
+		HitShapeHeightField(TerrainHeightFieldPtr heightField) : m_heightField(heightField) {}
+
+		virtual AABB getLocalBox() const override;
+		virtual bool raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance, Vector3& normal) const override;
+		virtual Vector3 closestPoint(const Vector3& point) const override;
+
+	private:
+		TerrainHeightFieldPtr	m_heightField;
+	};
+}
@@ -0,0 +1,210 @@
+#include "hit_triangle_bvh.h"
+#include "hit_shape.h"
+#include <algorithm>
+
+namespace Echo
+{
+	static const ui32 MaxLeafTriangles = 4;
+
+	// squared distance from a point to a box, 0 inside
+	static float DistanceSqr(const AABB& box, const Vector3& point)
+	{
+		float dx = std::max<float>(std::max<float>(box.vMin.x - point.x, point.x - box.vMax.x), 0.f);
+		float dy = std::max<float>(std::max<float>(box.vMin.y - point.y, point.y - box.vMax.y), 0.f);
+		float dz = std::max<float>(std::max<float>(box.vMin.z - point.z, point.z - box.vMax.z), 0.f);
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	void HitTriangleBvh::build(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount)
+	{
+		m_nodes.clear();
+		m_vertices.clear();
+
+		vector<Vector3>::type vertices;
+		vector<Vector3>::type centroids;
+		vertices.reserve(indexCount);
+		centroids.reserve(indexCount / 3);
+		for (ui32 i = 0; i + 2 < indexCount; i += 3)
+		{
+			if (indices[i] < vertexCount && indices[i + 1] < vertexCount && indices[i + 2] < vertexCount)
+			{
+				const Vector3& a = positions[indices[i]];
+				const Vector3& b = positions[indices[i + 1]];
+				const Vector3& c = positions[indices[i + 2]];
+				vertices.emplace_back(a);
+				vertices.emplace_back(b);
+				vertices.emplace_back(c);
+				centroids.emplace_back((a + b + c) / 3.f);
+			}
+		}
+
+		if (centroids.empty())
+			return;
+
+		vector<ui32>::type order(centroids.size());
+		for (ui32 i = 0; i < order.size(); i++)
+			order[i] = i;
+
+		m_nodes.reserve(centroids.size() * 2 / MaxLeafTriangles + 1);
+		m_vertices.reserve(vertices.size());
+		buildNode(order, centroids, vertices, 0, ui32(order.size()));
+	}
+
+	ui32 HitTriangleBvh::buildNode(vector<ui32>::type& order, const vector<Vector3>::type& centroids, const vector<Vector3>::type& vertices, ui32 begin, ui32 end)
+	{
+		ui32 nodeIdx = ui32(m_nodes.size());
+		m_nodes.emplace_back();
+
+		AABB box;
+		AABB centroidBox;
+		for (ui32 i = begin; i < end; i++)
+		{
+			box.addPoint(vertices[order[i] * 3]);
+			box.addPoint(vertices[order[i] * 3 + 1]);
+			box.addPoint(vertices[order[i] * 3 + 2]);
+			centroidBox.addPoint(centroids[order[i]]);
+		}
+		m_nodes[nodeIdx].m_box = box;
+
+		Vector3 size = centroidBox.vMax - centroidBox.vMin;
+		if (end - begin <= MaxLeafTriangles || size.x + size.y + size.z <= 0.f)
+		{
+			m_nodes[nodeIdx].m_first = ui32(m_vertices.size() / 3);
+			m_nodes[nodeIdx].m_count = end - begin;
+			for (ui32 i = begin; i < end; i++)
+			{
+				m_vertices.emplace_back(vertices[order[i] * 3]);
+				m_vertices.emplace_back(vertices[order[i] * 3 + 1]);
+				m_vertices.emplace_back(vertices[order[i] * 3 + 2]);
+			}
+
+			return nodeIdx;
+		}
+
+		i32 axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+		ui32 middle = (begin + end) / 2;
+		std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&centroids, axis](ui32 a, ui32 b)
+		{
+			return centroids[a][axis] < centroids[b][axis];
+		});
+
+		buildNode(order, centroids, vertices, begin, middle);
+		ui32 right = buildNode(order, centroids, vertices, middle, end);
+		m_nodes[nodeIdx].m_first = right;
+
+		return nodeIdx;
+	}
+
+	i32 HitTriangleBvh::raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance) const
+	{
+		if (m_nodes.empty())
+			return -1;
+
+		i32 hitTriangle = -1;
+		float nearest = maxDistance;
+
+		ui32 stack[64];
+		ui32 stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+			float t0 = 0.f;
+			float t1 = nearest;
+			if (!HitShape::IntersectBox(origin, dir, node.m_box.vMin, node.m_box.vMax, t0, t1))
+				continue;
+
+			if (node.m_count)
+			{
+				for (ui32 i = node.m_first; i < node.m_first + node.m_count; i++)
+				{
+					float t = 0.f;
+					if (HitShape::IntersectTriangle(origin, dir, m_vertices[i * 3], m_vertices[i * 3 + 1], m_vertices[i * 3 + 2], t) && t <= nearest)
+					{
+						nearest = t;
+						hitTriangle = i32(i);
+					}
+				}
+			}
+			else
+			{
+				// push the farther child first so the nearer one shrinks the interval sooner
+				ui32 left = ui32(&node - m_nodes.data()) + 1;
+				ui32 right = node.m_first;
+				float leftEnter = 0.f, leftExit = nearest;
+				float rightEnter = 0.f, rightExit = nearest;
+				bool isLeftHit = HitShape::IntersectBox(origin, dir, m_nodes[left].m_box.vMin, m_nodes[left].m_box.vMax, leftEnter, leftExit);
+				bool isRightHit = HitShape::IntersectBox(origin, dir, m_nodes[right].m_box.vMin, m_nodes[right].m_box.vMax, rightEnter, rightExit);
+				if (isLeftHit && isRightHit)
+				{
+					stack[stackSize++] = leftEnter < rightEnter ? right : left;
+					stack[stackSize++] = leftEnter < rightEnter ? left : right;
+				}
+				else if (isLeftHit)
+				{
+					stack[stackSize++] = left;
+				}
+				else if (isRightHit)
+				{
+					stack[stackSize++] = right;
+				}
+			}
+		}
+
+		if (hitTriangle != -1)
+			distance = nearest;
+
+		return hitTriangle;
+	}
+
+	Vector3 HitTriangleBvh::closestPoint(const Vector3& point) const
+	{
+		if (m_nodes.empty())
+			return point;
+
+		Vector3 closest = point;
+		float nearestSqr = Math::MAX_REAL;
+
+		ui32 stack[64];
+		ui32 stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize)
+		{
+			const Node& node = m_nodes[stack[--stackSize]];
+			if (DistanceSqr(node.m_box, point) >= nearestSqr)
+				continue;
+
+			if (node.m_count)
+			{
+				for (ui32 i = node.m_first; i < node.m_first + node.m_count; i++)
+				{
+					Vector3 candidate = HitShape::ClosestPointOnTriangle(point, m_vertices[i * 3], m_vertices[i * 3 + 1], m_vertices[i * 3 + 2]);
+					float distanceSqr = (candidate - point).lenSqr();
+					if (distanceSqr < nearestSqr)
+					{
+						nearestSqr = distanceSqr;
+						closest = candidate;
+					}
+				}
+			}
+			else
+			{
+				ui32 left = ui32(&node - m_nodes.data()) + 1;
+				ui32 right = node.m_first;
+				bool isLeftNearer = DistanceSqr(m_nodes[left].m_box, point) < DistanceSqr(m_nodes[right].m_box, point);
+				stack[stackSize++] = isLeftNearer ? right : left;
+				stack[stackSize++] = isLeftNearer ? left : right;
+			}
+		}
+
+		return closest;
+	}
+
+	Vector3 HitTriangleBvh::getNormal(i32 triangle) const
+	{
+		Vector3 normal = (m_vertices[triangle * 3 + 1] - m_vertices[triangle * 3]).cross(m_vertices[triangle * 3 + 2] - m_vertices[triangle * 3]);
+		normal.normalize();
+
+		return normal;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "engine/core/geom/AABB.h"
+
+namespace Echo
+{
+	// static bounding volume hierarchy over the triangles of one mesh, built once at load.
+	// nodes are stored depth first so the left child always follows its parent
+	class HitTriangleBvh
+	{
+	public:
+		HitTriangleBvh() {}
+
+		// triangle list, positions are copied
+		void build(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount);
+
+		// info
+		ui32 getTriangleCount() const { return ui32(m_vertices.size() / 3); }
+		const AABB& getBox() const { return m_nodes.empty() ? AABB::ZERO : m_nodes[0].m_box; }
+
+		// nearest hit, dir needn't be normalized. returns the triangle index or -1
+		i32 raycast(const Vector3& origin, const Vector3& dir, float maxDistance, float& distance) const;
+
+		// closest point on the surface
+		Vector3 closestPoint(const Vector3& point) const;
+
+		// triangle normal
+		Vector3 getNormal(i32 triangle) const;
+
+	private:
+		struct Node
+		{
+			AABB	m_box;
+			ui32	m_first = 0;		// first triangle of a leaf, right child of an inner node
+			ui32	m_count = 0;		// triangles in a leaf, 0 for inner nodes
+		};
+
+		// split on the longest centroid axis at the median
+		ui32 buildNode(vector<ui32>::type& order, const vector<Vector3>::type& centroids, const vector<Vector3>::type& vertices, ui32 begin, ui32 end);
+
+	private:
+		vector<Node>::type		m_nodes;
+		vector<Vector3>::type	m_vertices;		// three per triangle, in leaf order
+	};
+}
@@ -1,22 +1,29 @@
 #include "light.h"
+#include "light_module.h"
 
 namespace Echo
 {
 	Light::Light()
 	{
-
+		LightModule::instance()->addLight(this);
 	}
 
 	Light::~Light()
 	{
-
+		LightModule::instance()->removeLight(this);
 	}
 
 	void Light::bindMethods()
 	{
 		CLASS_BIND_METHOD(Light, is2d, DEF_METHOD("is2d"));
 		CLASS_BIND_METHOD(Light, set2d, DEF_METHOD("set2d"));
+		CLASS_BIND_METHOD(Light, getColor, DEF_METHOD("getColor"));
+		CLASS_BIND_METHOD(Light, setColor, DEF_METHOD("setColor"));
+		CLASS_BIND_METHOD(Light, getIntensity, DEF_METHOD("getIntensity"));
+		CLASS_BIND_METHOD(Light, setIntensity, DEF_METHOD("setIntensity"));
 
 		CLASS_REGISTER_PROPERTY(Light, "Is2D", Variant::Type::Bool, "is2d", "set2d");
+		CLASS_REGISTER_PROPERTY(Light, "Color", Variant::Type::Color, "getColor", "setColor");
+		CLASS_REGISTER_PROPERTY(Light, "Intensity", Variant::Type::Real, "getIntensity", "setIntensity");
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <engine/core/scene/node.h>
+#include "light_cluster.h"
 
 namespace Echo
 {
@@ -16,7 +17,20 @@ namespace Echo
 		bool is2d() const { return m_2d; }
 		void set2d(bool is2d) { m_2d = is2d; }
 
+		// color
+		const Color& getColor() const { return m_color; }
+		void setColor(const Color& color) { m_color = color; }
+
+		// intensity
+		float getIntensity() const { return m_intensity; }
+		void setIntensity(float intensity) { m_intensity = std::max<float>(intensity, 0.f); }
+
+		// fill the cluster description, false for lights the cluster doesn't handle
+		virtual bool getClusterInfo(LightCluster::LightInfo& info) { return false; }
+
 	protected:
 		bool	m_2d = false;
+		Color	m_color = Color::WHITE;
+		float	m_intensity = 1.f;
 	};
 }
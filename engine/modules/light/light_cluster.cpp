@@ -0,0 +1,267 @@
+#include "light_cluster.h"
+#include "engine/core/math/Simd.h"
+
+namespace Echo
+{
+	LightCluster::LightCluster()
+	{
+		setGridSize(16, 8, 24);
+	}
+
+	LightCluster::~LightCluster()
+	{
+	}
+
+	void LightCluster::setGridSize(ui32 x, ui32 y, ui32 z)
+	{
+		m_gridX = std::max<ui32>(x, 1);
+		m_gridY = std::max<ui32>(y, 1);
+		m_gridZ = std::max<ui32>(z, 1);
+		m_rowStride = (m_gridX + 3) & ~3u;
+		m_isBoxesDirty = true;
+	}
+
+	void LightCluster::buildClusterBoxes()
+	{
+		const ui32 rows = m_gridY * m_gridZ;
+		for (i32 axis = 0; axis < 3; axis++)
+		{
+			m_boxMin[axis].assign(rows * m_rowStride, Math::MAX_REAL);
+			m_boxMax[axis].assign(rows * m_rowStride, -Math::MAX_REAL);
+		}
+
+		for (ui32 k = 0; k < m_gridZ; k++)
+		{
+			float d0 = m_near * std::pow(m_far / m_near, float(k) / m_gridZ);
+			float d1 = m_near * std::pow(m_far / m_near, float(k + 1) / m_gridZ);
+			for (ui32 j = 0; j < m_gridY; j++)
+			{
+				float y0 = (2.f * j / m_gridY - 1.f) * m_tanHalfFovY;
+				float y1 = (2.f * (j + 1) / m_gridY - 1.f) * m_tanHalfFovY;
+				for (ui32 i = 0; i < m_gridX; i++)
+				{
+					float x0 = (2.f * i / m_gridX - 1.f) * m_tanHalfFovX;
+					float x1 = (2.f * (i + 1) / m_gridX - 1.f) * m_tanHalfFovX;
+
+					// tile edges are lines through the eye, so the extremes sit on the slice planes
+					ui32 idx = (k * m_gridY + j) * m_rowStride + i;
+					m_boxMin[0][idx] = std::min<float>(x0 * d0, x0 * d1);
+					m_boxMax[0][idx] = std::max<float>(x1 * d0, x1 * d1);
+					m_boxMin[1][idx] = std::min<float>(y0 * d0, y0 * d1);
+					m_boxMax[1][idx] = std::max<float>(y1 * d0, y1 * d1);
+					m_boxMin[2][idx] = -d1;
+					m_boxMax[2][idx] = -d0;
+				}
+			}
+		}
+
+		float sliceScale = float(m_gridZ) / std::log(m_far / m_near);
+		m_clusterParams = Vector4(float(m_gridX), float(m_gridY), sliceScale, -std::log(m_near) * sliceScale);
+		m_isBoxesDirty = false;
+	}
+
+	i32 LightCluster::getSlice(float depth) const
+	{
+		i32 slice = i32(std::floor(std::log(depth) * m_clusterParams.z + m_clusterParams.w));
+		return Math::Clamp(slice, 0, i32(m_gridZ) - 1);
+	}
+
+	bool LightCluster::getClusterRange(const Vector3& boxMin, const Vector3& boxMax, i32* begin, i32* end) const
+	{
+		float dNear = std::max<float>(-boxMax.z, m_near);
+		float dFar = std::min<float>(-boxMin.z, m_far);
+		if (dNear > dFar)
+			return false;
+
+		// x / depth is smallest at the near depth for negative x and at the far depth otherwise
+		float tanHalfFov[2] = { m_tanHalfFovX, m_tanHalfFovY };
+		ui32 grid[2] = { m_gridX, m_gridY };
+		for (i32 axis = 0; axis < 2; axis++)
+		{
+			float ndcMin = boxMin[axis] / (tanHalfFov[axis] * (boxMin[axis] < 0.f ? dNear : dFar));
+			float ndcMax = boxMax[axis] / (tanHalfFov[axis] * (boxMax[axis] > 0.f ? dNear : dFar));
+			if (ndcMax < -1.f || ndcMin > 1.f)
+				return false;
+
+			begin[axis] = Math::Clamp(i32(std::floor((ndcMin + 1.f) * 0.5f * grid[axis])), 0, i32(grid[axis]) - 1);
+			end[axis] = Math::Clamp(i32(std::floor((ndcMax + 1.f) * 0.5f * grid[axis])), 0, i32(grid[axis]) - 1) + 1;
+		}
+
+		begin[2] = getSlice(dNear);
+		end[2] = getSlice(dFar) + 1;
+		return true;
+	}
+
+	void LightCluster::binSphere(const Vector3& center, float radius, const i32* begin, const i32* end, ui32 lightIdx)
+	{
+		const float radiusSqr = radius * radius;
+		for (i32 k = begin[2]; k < end[2]; k++)
+		{
+			for (i32 j = begin[1]; j < end[1]; j++)
+			{
+				const ui32 row = (k * m_gridY + j) * m_rowStride;
+#ifdef ECHO_SIMD
+				// four froxels per step, squared distance from the sphere center to each box
+				Simd::Float4 cx = Simd::splat(center.x);
+				Simd::Float4 cy = Simd::splat(center.y);
+				Simd::Float4 cz = Simd::splat(center.z);
+				Simd::Float4 zero = Simd::splat(0.f);
+				Simd::Float4 r2 = Simd::splat(radiusSqr);
+				for (i32 i = begin[0] & ~3; i < end[0]; i += 4)
+				{
+					const ui32 idx = row + i;
+					Simd::Float4 dx = Simd::max(Simd::max(Simd::sub(Simd::load(&m_boxMin[0][idx]), cx), Simd::sub(cx, Simd::load(&m_boxMax[0][idx]))), zero);
+					Simd::Float4 dy = Simd::max(Simd::max(Simd::sub(Simd::load(&m_boxMin[1][idx]), cy), Simd::sub(cy, Simd::load(&m_boxMax[1][idx]))), zero);
+					Simd::Float4 dz = Simd::max(Simd::max(Simd::sub(Simd::load(&m_boxMin[2][idx]), cz), Simd::sub(cz, Simd::load(&m_boxMax[2][idx]))), zero);
+					Simd::Float4 distSqr = Simd::madd(dx, dx, Simd::madd(dy, dy, Simd::mul(dz, dz)));
+
+					i32 mask = Simd::lessEqualMask(distSqr, r2);
+					for (i32 lane = 0; mask; lane++, mask >>= 1)
+					{
+						if ((mask & 1) && i + lane >= begin[0] && i + lane < end[0])
+						{
+							m_pairClusters.emplace_back((k * m_gridY + j) * m_gridX + i + lane);
+							m_pairLights.emplace_back(lightIdx);
+						}
+					}
+				}
+#else
+				for (i32 i = begin[0]; i < end[0]; i++)
+				{
+					const ui32 idx = row + i;
+					float dx = std::max<float>(std::max<float>(m_boxMin[0][idx] - center.x, center.x - m_boxMax[0][idx]), 0.f);
+					float dy = std::max<float>(std::max<float>(m_boxMin[1][idx] - center.y, center.y - m_boxMax[1][idx]), 0.f);
+					float dz = std::max<float>(std::max<float>(m_boxMin[2][idx] - center.z, center.z - m_boxMax[2][idx]), 0.f);
+					if (dx * dx + dy * dy + dz * dz <= radiusSqr)
+					{
+						m_pairClusters.emplace_back((k * m_gridY + j) * m_gridX + i);
+						m_pairLights.emplace_back(lightIdx);
+					}
+				}
+#endif
+			}
+		}
+	}
+
+	void LightCluster::update(const Matrix4& view, float fovy, float aspect, float nearClip, float farClip, const LightInfo* lights, ui32 count)
+	{
+		float tanHalfFovY = std::tan(fovy * 0.5f);
+		float tanHalfFovX = tanHalfFovY * aspect;
+		nearClip = std::max<float>(nearClip, 1e-3f);
+		farClip = std::max<float>(farClip, nearClip * 1.001f);
+		if (m_isBoxesDirty || tanHalfFovX != m_tanHalfFovX || tanHalfFovY != m_tanHalfFovY || nearClip != m_near || farClip != m_far)
+		{
+			m_tanHalfFovX = tanHalfFovX;
+			m_tanHalfFovY = tanHalfFovY;
+			m_near = nearClip;
+			m_far = farClip;
+			buildClusterBoxes();
+		}
+
+		m_view = view;
+		m_packedLights.clear();
+		m_pairClusters.clear();
+		m_pairLights.clear();
+
+		for (ui32 i = 0; i < count; i++)
+		{
+			const LightInfo& light = lights[i];
+
+			// a cone narrower than 45 degrees fits a smaller sphere than its range
+			Vector3 center = light.m_position;
+			float radius = light.m_range;
+			if (light.m_cosOuter > 0.7071f)
+			{
+				radius = light.m_range / (2.f * light.m_cosOuter);
+				center = light.m_position + light.m_direction * radius;
+			}
+
+			Vector3 viewCenter = center * view;
+			i32 begin[3];
+			i32 end[3];
+			if (!getClusterRange(viewCenter - Vector3(radius, radius, radius), viewCenter + Vector3(radius, radius, radius), begin, end))
+				continue;
+
+			size_t pairCount = m_pairLights.size();
+			binSphere(viewCenter, radius, begin, end, ui32(m_packedLights.size()));
+			if (m_pairLights.size() != pairCount)
+			{
+				PackedLight packed;
+				packed.m_positionRange = Vector4(light.m_position, light.m_range);
+				packed.m_colorCosInner = Vector4(light.m_color, light.m_cosInner);
+				packed.m_directionCosOuter = Vector4(light.m_direction, light.m_cosOuter);
+				m_packedLights.emplace_back(packed);
+			}
+		}
+
+		// counting sort of the hits by froxel
+		const ui32 clusterCount = getClusterCount();
+		m_clusterRanges.assign(clusterCount * 2, 0);
+		for (ui32 cluster : m_pairClusters)
+			m_clusterRanges[cluster * 2 + 1]++;
+
+		ui32 offset = 0;
+		for (ui32 cluster = 0; cluster < clusterCount; cluster++)
+		{
+			m_clusterRanges[cluster * 2] = offset;
+			offset += m_clusterRanges[cluster * 2 + 1];
+			m_clusterRanges[cluster * 2 + 1] = 0;
+		}
+
+		m_lightIndices.resize(m_pairLights.size());
+		for (size_t i = 0; i < m_pairLights.size(); i++)
+		{
+			ui32* range = &m_clusterRanges[m_pairClusters[i] * 2];
+			m_lightIndices[range[0] + range[1]++] = m_pairLights[i];
+		}
+
+		m_lightStamps.assign(m_packedLights.size(), 0);
+		m_stamp = 0;
+	}
+
+	ui32 LightCluster::gatherLights(const AABB& worldBox, ui32* indices, ui32 maxCount)
+	{
+		if (m_packedLights.empty() || !worldBox.isValid())
+			return 0;
+
+		AABB viewBox = worldBox.transform(m_view);
+		i32 begin[3];
+		i32 end[3];
+		if (!getClusterRange(viewBox.vMin, viewBox.vMax, begin, end))
+			return 0;
+
+		m_stamp++;
+		ui32 count = 0;
+		for (i32 k = begin[2]; k < end[2]; k++)
+		{
+			for (i32 j = begin[1]; j < end[1]; j++)
+			{
+				for (i32 i = begin[0]; i < end[0]; i++)
+				{
+					const ui32* range = &m_clusterRanges[((k * m_gridY + j) * m_gridX + i) * 2];
+					for (ui32 n = 0; n < range[1]; n++)
+					{
+						ui32 lightIdx = m_lightIndices[range[0] + n];
+						if (m_lightStamps[lightIdx] == m_stamp)
+							continue;
+
+						// froxels are coarse, test the light against the box itself
+						m_lightStamps[lightIdx] = m_stamp;
+						const Vector4& positionRange = m_packedLights[lightIdx].m_positionRange;
+						float dx = std::max<float>(std::max<float>(worldBox.vMin.x - positionRange.x, positionRange.x - worldBox.vMax.x), 0.f);
+						float dy = std::max<float>(std::max<float>(worldBox.vMin.y - positionRange.y, positionRange.y - worldBox.vMax.y), 0.f);
+						float dz = std::max<float>(std::max<float>(worldBox.vMin.z - positionRange.z, positionRange.z - worldBox.vMax.z), 0.f);
+						if (dx * dx + dy * dy + dz * dz <= positionRange.w * positionRange.w)
+						{
+							indices[count++] = lightIdx;
+							if (count == maxCount)
+								return count;
+						}
+					}
+				}
+			}
+		}
+
+		return count;
+	}
+}
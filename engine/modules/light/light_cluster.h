@@ -0,0 +1,96 @@
+#pragma once
+
+#include "engine/core/math/Math.h"
+#include "engine/core/math/Vector4.h"
+#include "engine/core/math/Matrix4.h"
+#include "engine/core/geom/AABB.h"
+
+namespace Echo
+{
+	// clustered forward light culling. the view frustum is cut into a froxel grid, screen tiles
+	// in x y and exponential depth slices in z, and every point or spot light is binned into
+	// the froxels its bounding sphere touches
+	class LightCluster
+	{
+	public:
+		// world space light
+		struct LightInfo
+		{
+			Vector3		m_position;
+			float		m_range = 1.f;
+			Vector3		m_direction = Vector3::NEG_UNIT_Z;
+			float		m_cosInner = -1.f;
+			float		m_cosOuter = -1.f;			// -1 for point lights
+			Vector3		m_color = Vector3::ONE;		// premultiplied by intensity
+		};
+
+		// shader layout, three vec4 per light
+		struct PackedLight
+		{
+			Vector4		m_positionRange;			// world position, range
+			Vector4		m_colorCosInner;			// color, cos of the spot inner angle
+			Vector4		m_directionCosOuter;		// spot direction, cos of the outer angle, -1 for point lights
+		};
+
+	public:
+		LightCluster();
+		~LightCluster();
+
+		// froxel grid, x y are screen tiles and z depth slices
+		void setGridSize(ui32 x, ui32 y, ui32 z);
+		ui32 getClusterCount() const { return m_gridX * m_gridY * m_gridZ; }
+
+		// bin lights for a right handed view looking down -z
+		void update(const Matrix4& view, float fovy, float aspect, float nearClip, float farClip, const LightInfo* lights, ui32 count);
+
+		// lights that touch at least one froxel
+		const vector<PackedLight>::type& getPackedLights() const { return m_packedLights; }
+
+		// offset and count into getLightIndices for every froxel, x runs fastest then y then z
+		const vector<ui32>::type& getClusterRanges() const { return m_clusterRanges; }
+
+		// indices into getPackedLights
+		const vector<ui32>::type& getLightIndices() const { return m_lightIndices; }
+
+		// grid x, grid y, slice scale, slice bias. slice = floor(log(viewDepth) * scale + bias)
+		const Vector4& getClusterParams() const { return m_clusterParams; }
+
+		// lights touching a world box, for per draw light lists. returns the number written
+		ui32 gatherLights(const AABB& worldBox, ui32* indices, ui32 maxCount);
+
+	private:
+		// view space froxel boxes, rebuilt when the projection changes
+		void buildClusterBoxes();
+
+		// depth slice of a view depth
+		i32 getSlice(float depth) const;
+
+		// froxel range touched by a view space box, false if outside the frustum
+		bool getClusterRange(const Vector3& boxMin, const Vector3& boxMax, i32* begin, i32* end) const;
+
+		// sphere against one row of froxel boxes, appends the hits
+		void binSphere(const Vector3& center, float radius, const i32* begin, const i32* end, ui32 lightIdx);
+
+	private:
+		ui32						m_gridX = 16;
+		ui32						m_gridY = 8;
+		ui32						m_gridZ = 24;
+		ui32						m_rowStride = 16;		// grid x padded to 4
+		float						m_tanHalfFovX = 0.f;
+		float						m_tanHalfFovY = 0.f;
+		float						m_near = 0.f;
+		float						m_far = 0.f;
+		bool						m_isBoxesDirty = true;
+		vector<float>::type			m_boxMin[3];			// soa froxel boxes, padded lanes never hit
+		vector<float>::type			m_boxMax[3];
+		Matrix4						m_view;
+		Vector4						m_clusterParams;
+		vector<PackedLight>::type	m_packedLights;
+		vector<ui32>::type			m_clusterRanges;
+		vector<ui32>::type			m_lightIndices;
+		vector<ui32>::type			m_pairClusters;			// (froxel, light) hits before sorting by froxel
+		vector<ui32>::type			m_pairLights;
+		vector<ui32>::type			m_lightStamps;			// dedup for gatherLights
+		ui32						m_stamp = 0;
+	};
+}
@@ -10,6 +10,7 @@
 #include "editor/direction_light_editor.h"
 #include "editor/cube_light_capture_editor.h"
 #include "editor/cube_light_custom_editor.h"
+#include "engine/core/scene/node_tree.h"
 
 namespace Echo
 {
@@ -57,6 +58,48 @@ namespace Echo
         CLASS_REGISTER_EDITOR(CubeLightCapture, CubeLightCaptureEditor)
 	}
 
+    void LightModule::update(float elapsedTime)
+    {
+        Camera* camera = NodeTree::instance()->get3dCamera();
+        if (camera && camera->getProjectionMode() == Camera::ProjMode::PM_PERSPECTIVE && camera->getHeight() > 0)
+        {
+            m_lightInfos.clear();
+            LightCluster::LightInfo info;
+            for (Light* light : m_lights)
+            {
+                if (light->getClusterInfo(info))
+                    m_lightInfos.emplace_back(info);
+            }
+
+            float aspect = float(camera->getWidth()) / float(camera->getHeight());
+            m_lightCluster.update(camera->getViewMatrix(), camera->getFov(), aspect, camera->getNear(), camera->getFar(), m_lightInfos.data(), ui32(m_lightInfos.size()));
+        }
+    }
+
+    void LightModule::addLight(Light* light)
+    {
+        m_lights.emplace_back(light);
+    }
+
+    void LightModule::removeLight(Light* light)
+    {
+        auto it = std::find(m_lights.begin(), m_lights.end(), light);
+        if (it != m_lights.end())
+        {
+            *it = m_lights.back();
+            m_lights.pop_back();
+        }
+    }
+
+    ui32 LightModule::gatherDrawLights(const AABB& worldBox, LightCluster::PackedLight* lights)
+    {
+        ui32 count = m_lightCluster.gatherLights(worldBox, m_drawLightIndices, MaxDrawLights);
+        for (ui32 i = 0; i < count; i++)
+            lights[i] = m_lightCluster.getPackedLights()[m_drawLightIndices[i]];
+
+        return count;
+    }
+
     void LightModule::setIBLBrdfPath(const ResourcePath& brdf)
     {
         if (m_iblBrdfPath.setPath(brdf.getPath()))
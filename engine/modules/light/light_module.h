@@ -2,9 +2,11 @@
 
 #include "engine/core/main/module.h"
 #include "engine/core/render/base/texture.h"
+#include "light_cluster.h"
 
 namespace Echo
 {
+	class Light;
 	class LightModule : public Module
 	{
 		ECHO_SINGLETON_CLASS(LightModule, Module)
@@ -21,6 +23,9 @@ namespace Echo
 
 		// register all types of the module
 		virtual void registerTypes() override;
+
+		// update
+		virtual void update(float elapsedTime) override;
         
     public:
         // image based lighting
@@ -35,6 +40,19 @@ namespace Echo
         Texture* getIBLDiffuseTexture();
         Texture* getIBLSpecularTexture();
         Texture* getIBLBrdfTexture();
+
+    public:
+        // lights register themselves
+        void addLight(Light* light);
+        void removeLight(Light* light);
+
+        // point and spot lights binned for the 3d camera, rebuilt every update
+        LightCluster& getLightCluster() { return m_lightCluster; }
+
+        // per draw light list for u_Lights[MaxDrawLights * 3] and u_LightCount. the froxel ranges and
+        // index list are too large for uniform arrays on gles and metal, so draws get the lights touching them
+        static const ui32 MaxDrawLights = 8;
+        ui32 gatherDrawLights(const AABB& worldBox, LightCluster::PackedLight* lights);
         
     protected:
         bool            m_isIBLEnable = true;
@@ -42,5 +60,9 @@ namespace Echo
         Texture*        m_iblDiffuseTexture = nullptr;
         Texture*        m_iblSpecularTexture = nullptr;
         Texture*        m_iblBrdfTexture = nullptr;
+        vector<Light*>::type    m_lights;
+        vector<LightCluster::LightInfo>::type m_lightInfos;
+        LightCluster    m_lightCluster;
+        ui32            m_drawLightIndices[MaxDrawLights];
 	};
 }
@@ -14,6 +14,20 @@ namespace Echo
 
 	void PointLight::bindMethods()
 	{
+		CLASS_BIND_METHOD(PointLight, getRange, DEF_METHOD("getRange"));
+		CLASS_BIND_METHOD(PointLight, setRange, DEF_METHOD("setRange"));
 
+		CLASS_REGISTER_PROPERTY(PointLight, "Range", Variant::Type::Real, "getRange", "setRange");
+	}
+
+	bool PointLight::getClusterInfo(LightCluster::LightInfo& info)
+	{
+		info.m_position = getWorldPosition();
+		info.m_range = m_range;
+		info.m_cosInner = -1.f;
+		info.m_cosOuter = -1.f;
+		info.m_color = Vector3(m_color.r, m_color.g, m_color.b) * m_intensity;
+
+		return !m_2d && m_range > 0.f && m_intensity > 0.f;
 	}
 }
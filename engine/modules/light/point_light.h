@@ -12,7 +12,14 @@ namespace Echo
 		PointLight();
         virtual ~PointLight();
 
-	protected:
+		// range
+		float getRange() const { return m_range; }
+		void setRange(float range) { m_range = std::max<float>(range, 0.f); }
+
+		// cluster
+		virtual bool getClusterInfo(LightCluster::LightInfo& info) override;
 
+	protected:
+		float	m_range = 10.f;
 	};
 }
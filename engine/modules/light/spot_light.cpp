@@ -14,6 +14,33 @@ namespace Echo
 
 	void SpotLight::bindMethods()
 	{
+		CLASS_BIND_METHOD(SpotLight, getRange, DEF_METHOD("getRange"));
+		CLASS_BIND_METHOD(SpotLight, setRange, DEF_METHOD("setRange"));
+		CLASS_BIND_METHOD(SpotLight, getInnerAngle, DEF_METHOD("getInnerAngle"));
+		CLASS_BIND_METHOD(SpotLight, setInnerAngle, DEF_METHOD("setInnerAngle"));
+		CLASS_BIND_METHOD(SpotLight, getOuterAngle, DEF_METHOD("getOuterAngle"));
+		CLASS_BIND_METHOD(SpotLight, setOuterAngle, DEF_METHOD("setOuterAngle"));
 
+		CLASS_REGISTER_PROPERTY(SpotLight, "Range", Variant::Type::Real, "getRange", "setRange");
+		CLASS_REGISTER_PROPERTY(SpotLight, "InnerAngle", Variant::Type::Real, "getInnerAngle", "setInnerAngle");
+		CLASS_REGISTER_PROPERTY(SpotLight, "OuterAngle", Variant::Type::Real, "getOuterAngle", "setOuterAngle");
+	}
+
+	void SpotLight::setOuterAngle(float angle)
+	{
+		m_outerAngle = Math::Clamp(angle, 0.f, 89.f);
+		m_innerAngle = std::min<float>(m_innerAngle, m_outerAngle);
+	}
+
+	bool SpotLight::getClusterInfo(LightCluster::LightInfo& info)
+	{
+		info.m_position = getWorldPosition();
+		info.m_range = m_range;
+		info.m_direction = getWorldOrientation().rotateVec3(Vector3::NEG_UNIT_Z);
+		info.m_cosInner = std::cos(m_innerAngle * Math::DEG2RAD);
+		info.m_cosOuter = std::cos(m_outerAngle * Math::DEG2RAD);
+		info.m_color = Vector3(m_color.r, m_color.g, m_color.b) * m_intensity;
+
+		return !m_2d && m_range > 0.f && m_intensity > 0.f;
 	}
 }
@@ -4,6 +4,7 @@
 
 namespace Echo
 {
+	// shines down its local -z axis
 	class SpotLight : public Light
 	{
 		ECHO_CLASS(SpotLight, Light);
@@ -12,7 +13,22 @@ namespace Echo
 		SpotLight();
 		virtual ~SpotLight();
 
-	protected:
+		// range
+		float getRange() const { return m_range; }
+		void setRange(float range) { m_range = std::max<float>(range, 0.f); }
+
+		// half angles of the cone in degrees, full intensity inside the inner angle
+		float getInnerAngle() const { return m_innerAngle; }
+		void setInnerAngle(float angle) { m_innerAngle = Math::Clamp(angle, 0.f, m_outerAngle); }
+		float getOuterAngle() const { return m_outerAngle; }
+		void setOuterAngle(float angle);
 
+		// cluster
+		virtual bool getClusterInfo(LightCluster::LightInfo& info) override;
+
+	protected:
+		float	m_range = 10.f;
+		float	m_innerAngle = 30.f;
+		float	m_outerAngle = 40.f;
 	};
 }
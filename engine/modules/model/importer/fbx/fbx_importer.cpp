@@ -2,7 +2,7 @@
 #include "engine/core/editor/editor.h"
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/io/IO.h"
-#include "engine/core/render/base/mesh/mesh.h"
+#include "engine/core/render/base/mesh/mesh_optimizer.h"
 
 #ifdef ECHO_EDITOR_MODE
 
@@ -19,7 +19,10 @@ namespace Echo
 
 	void FbxImporter::bindMethods()
 	{
+		CLASS_BIND_METHOD(FbxImporter, isCompactEncoding, DEF_METHOD("isCompactEncoding"));
+		CLASS_BIND_METHOD(FbxImporter, setCompactEncoding, DEF_METHOD("setCompactEncoding"));
 
+		CLASS_REGISTER_PROPERTY(FbxImporter, "CompactEncoding", Variant::Type::Bool, "isCompactEncoding", "setCompactEncoding");
 	}
 
 	void FbxImporter::run(const char* targetFolder)
@@ -97,35 +100,26 @@ namespace Echo
 						}
 					}
 
-					// update vertices data
-					MeshPtr mesh = Mesh::create(true, true);
-					mesh->updateVertexs(vertexData);
-
 					// indices
 					const i32* fbxFaceIndices = geometry->getFaceIndices();
-					if (geometry->getVertexCount() < 65535)
-					{
-						vector<i16>::type shortIndices;
-						for (int j = 0; j < geometry->getIndexCount(); ++j)
-						{
-							int idx = (fbxFaceIndices[j] < 0) ? (-fbxFaceIndices[j] - 1)  : (fbxFaceIndices[j]);
-							shortIndices.push_back(idx);
-						}
+					vector<ui32>::type indices(geometry->getIndexCount());
+					for (int j = 0; j < geometry->getIndexCount(); ++j)
+						indices[j] = (fbxFaceIndices[j] < 0) ? (-fbxFaceIndices[j] - 1) : (fbxFaceIndices[j]);
 
-						mesh->updateIndices(static_cast<ui32>(geometry->getIndexCount()), sizeof(i16), shortIndices.data());
-					}
-					else
-					{
-						vector<i32>::type intIndices;
-						for (int j = 0; j < geometry->getIndexCount(); ++j)
-						{
-							int idx = (fbxFaceIndices[j] < 0) ? (-fbxFaceIndices[j] - 1) : (fbxFaceIndices[j]);
-							intIndices.push_back(idx);
-						}
+					// cache friendly order and lods, vertices are reordered so they are uploaded afterwards
+					MeshPtr mesh = Mesh::create(true, true);
+					MeshOptimizer::optimize(mesh, vertexData, indices.data(), ui32(indices.size()), sizeof(ui32));
 
-						mesh->updateIndices(static_cast<ui32>(geometry->getIndexCount()), sizeof(i32), intIndices.data());
+					// compact vertex encodings
+					if (m_isCompactEncoding)
+					{
+						vertFormat.useCompactEncodings();
+						vertexData.convert(vertFormat);
 					}
 
+					// update vertices data
+					mesh->updateVertexs(vertexData);
+
 					if (mesh)
 					{
 						String meshName = PathUtil::GetPureFilename(fbxFile, false);
@@ -21,11 +21,16 @@ namespace Echo
 		// import
 		virtual void run(const char* targetFolder) override;
 
+		// save meshes with the compact MeshVertexFormat encodings, off by default
+		bool isCompactEncoding() const { return m_isCompactEncoding; }
+		void setCompactEncoding(bool isCompactEncoding) { m_isCompactEncoding = isCompactEncoding; }
+
 		// save
 		void saveMeshs(ofbx::IScene* fbxScene, const String& fbxFile);
 
 	private:
 		String		m_targetFoler;
+		bool		m_isCompactEncoding = false;
 	};
 }
 #endif
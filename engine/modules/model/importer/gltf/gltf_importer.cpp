@@ -17,7 +17,10 @@ namespace Echo
 
 	void GltfImporter::bindMethods()
 	{
+		CLASS_BIND_METHOD(GltfImporter, isCompactEncoding, DEF_METHOD("isCompactEncoding"));
+		CLASS_BIND_METHOD(GltfImporter, setCompactEncoding, DEF_METHOD("setCompactEncoding"));
 
+		CLASS_REGISTER_PROPERTY(GltfImporter, "CompactEncoding", Variant::Type::Bool, "isCompactEncoding", "setCompactEncoding");
 	}
 
 	void GltfImporter::run(const char* targetFolder)
@@ -30,6 +33,7 @@ namespace Echo
 				if (!m_gltfFile.empty())
 				{
 					Gltf::Loader loader;
+					loader.m_isCompactEncoding = m_isCompactEncoding;
 					if (loader.load(m_gltfFile))
 					{
 						// save meshes
@@ -20,12 +20,17 @@ namespace Echo
 		// import
 		virtual void run(const char* targetFolder) override;
 
+		// save meshes with the compact MeshVertexFormat encodings, off by default
+		bool isCompactEncoding() const { return m_isCompactEncoding; }
+		void setCompactEncoding(bool isCompactEncoding) { m_isCompactEncoding = isCompactEncoding; }
+
 		// save
 		void saveMeshs(Gltf::Loader& loader);
 
 	private:
 		String		m_gltfFile;
 		String		m_targetFoler;
+		bool		m_isCompactEncoding = false;
 	};
 }
 #endif
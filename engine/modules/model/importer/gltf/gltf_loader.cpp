@@ -4,6 +4,7 @@
 #include "engine/core/util/PathUtil.h"
 #include "engine/core/util/base64.h"
 #include "engine/core/util/magic_enum.hpp"
+#include "engine/core/render/base/mesh/mesh_optimizer.h"
 #include "engine/modules/light/light_module.h"
 
 #ifdef ECHO_EDITOR_MODE
@@ -947,10 +948,19 @@ namespace Gltf
 		{
 			primitive.m_mesh = Mesh::create(true, true);
 
-			// update indices
-			if (indicesDataVoid)
+			// cache friendly order and lods for triangle lists, before the vertices get encoded
+			if (indicesDataVoid && primitive.m_mode == Primitive::Triangles)
+				MeshOptimizer::optimize(primitive.m_mesh, vertexData, indicesDataVoid, indicesCount, indicesStride);
+			else if (indicesDataVoid)
 				primitive.m_mesh->updateIndices(indicesCount, indicesStride, indicesDataVoid);
 
+			// compact vertex encodings
+			if (m_isCompactEncoding)
+			{
+				vertFormat.useCompactEncodings();
+				vertexData.convert(vertFormat);
+			}
+
 			// update vertices
 			primitive.m_mesh->updateVertexs(vertexData);
 		}
@@ -1048,6 +1058,7 @@ namespace Gltf
 		primitive.m_materialInst->setMacro("MANUAL_SRGB", true);
 		primitive.m_materialInst->setMacro("SRGB_FAST_APPROXIMATION", true);
 		primitive.m_materialInst->setMacro("HAS_NORMALS", vertexFormat.m_isUseNormal);
+		primitive.m_materialInst->setMacro("OCT_NORMALS", vertexFormat.m_normalEncoding == VE_OCT16);
 		primitive.m_materialInst->setMacro("HAS_VERTEX_COLOR", vertexFormat.m_isUseVertexColor);
 		primitive.m_materialInst->setMacro("HAS_UV", vertexFormat.m_isUseUV);
 		primitive.m_materialInst->setMacro("HAS_SKIN", vertexFormat.m_isUseBlendingData);
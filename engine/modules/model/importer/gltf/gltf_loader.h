@@ -299,6 +299,7 @@ namespace Gltf
 		vector<SamplerInfo>::type		m_samplers;
 		vector<TextureInfo>::type		m_textures;
 		vector<AnimInfo>::type			m_animations;
+		bool							m_isCompactEncoding = false;	// compact vertex encodings for the meshes
 
 		// get node index of mesh
 		i32 getNodeIdxByMeshIdx(i32 meshIdx);
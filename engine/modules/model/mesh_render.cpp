@@ -46,7 +46,10 @@ namespace Echo
 		{
 			buildRenderable();
 			if (m_renderable)
+			{
+				m_renderable->setLod(m_renderable->getMesh()->selectLod(getScreenRadius()));
 				m_renderable->submitToRenderQueue();
+			}
 		}
 	}
 
@@ -60,9 +63,13 @@ namespace Echo
 			if (!m_material && m_mesh)
 			{
 				StringArray macros;
-				if(m_mesh->getVertexData().getFormat().m_isUseNormal)
+				const MeshVertexFormat& format = m_mesh->getVertexData().getFormat();
+				if(format.m_isUseNormal)
 					macros.emplace_back("HAS_NORMALS");
 
+				if(format.m_isUseNormal && format.m_normalEncoding == VE_OCT16)
+					macros.emplace_back("OCT_NORMALS");
+
 				ShaderProgramPtr shader = ShaderProgram::getDefault3D(macros);
 
 				// material
@@ -1,9 +1,50 @@
 #include "recast_crowd_agent.h"
+#include "recast_module.h"
 
 namespace Echo
 {
+	RecastCrowdAgent::RecastCrowdAgent()
+	{
+		RecastModule::instance()->addAgent(this);
+	}
+
+	RecastCrowdAgent::~RecastCrowdAgent()
+	{
+		RecastModule::instance()->removeAgent(this);
+	}
+
 	void RecastCrowdAgent::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastCrowdAgent, getRadius, DEF_METHOD("getRadius"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, setRadius, DEF_METHOD("setRadius"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, getHeight, DEF_METHOD("getHeight"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, setHeight, DEF_METHOD("setHeight"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, getMaxSpeed, DEF_METHOD("getMaxSpeed"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, setMaxSpeed, DEF_METHOD("setMaxSpeed"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, getMaxAcceleration, DEF_METHOD("getMaxAcceleration"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, setMaxAcceleration, DEF_METHOD("setMaxAcceleration"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, setTarget, DEF_METHOD("setTarget"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, resetTarget, DEF_METHOD("resetTarget"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, hasTarget, DEF_METHOD("hasTarget"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, getTarget, DEF_METHOD("getTarget"));
+		CLASS_BIND_METHOD(RecastCrowdAgent, getVelocity, DEF_METHOD("getVelocity"));
 
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "Radius", Variant::Type::Real, "getRadius", "setRadius");
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "Height", Variant::Type::Real, "getHeight", "setHeight");
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "MaxSpeed", Variant::Type::Real, "getMaxSpeed", "setMaxSpeed");
+		CLASS_REGISTER_PROPERTY(RecastCrowdAgent, "MaxAcceleration", Variant::Type::Real, "getMaxAcceleration", "setMaxAcceleration");
+	}
+
+	void RecastCrowdAgent::setTarget(const Vector3& target)
+	{
+		m_target = target;
+		m_hasTarget = true;
+		m_isTargetDirty = true;
+	}
+
+	void RecastCrowdAgent::resetTarget()
+	{
+		m_hasTarget = false;
+		m_isTargetDirty = true;
 	}
-}
\ No newline at end of file
+}
@@ -4,10 +4,54 @@
 
 namespace Echo
 {
+	// agent steered by the crowd of the navmesh, the crowd owns its world position
 	class RecastCrowdAgent : public Node
 	{
 		ECHO_CLASS(RecastCrowdAgent, Node)
 
 	public:
+		RecastCrowdAgent();
+		virtual ~RecastCrowdAgent();
+
+		// radius
+		float getRadius() const { return m_radius; }
+		void setRadius(float radius) { m_radius = radius; m_isParamsDirty = true; }
+
+		// height
+		float getHeight() const { return m_height; }
+		void setHeight(float height) { m_height = height; m_isParamsDirty = true; }
+
+		// max speed
+		float getMaxSpeed() const { return m_maxSpeed; }
+		void setMaxSpeed(float maxSpeed) { m_maxSpeed = maxSpeed; m_isParamsDirty = true; }
+
+		// max acceleration
+		float getMaxAcceleration() const { return m_maxAcceleration; }
+		void setMaxAcceleration(float maxAcceleration) { m_maxAcceleration = maxAcceleration; m_isParamsDirty = true; }
+
+		// walk to a world position, the path request is queued in the crowd
+		void setTarget(const Vector3& target);
+		void resetTarget();
+		bool hasTarget() const { return m_hasTarget; }
+		const Vector3& getTarget() const { return m_target; }
+
+		// velocity of the last crowd update
+		const Vector3& getVelocity() const { return m_velocity; }
+
+	protected:
+		float		m_radius = 0.6f;
+		float		m_height = 2.f;
+		float		m_maxSpeed = 3.5f;
+		float		m_maxAcceleration = 8.f;
+		bool		m_hasTarget = false;
+		Vector3		m_target;
+		Vector3		m_velocity;
+
+		// crowd state, kept by the navmesh
+		friend class RecastNavMesh;
+		i32			m_crowdIndex = -1;
+		bool		m_isTargetDirty = false;
+		bool		m_isParamsDirty = false;
+		Vector3		m_crowdPosition;
 	};
-}
\ No newline at end of file
+}
@@ -1,4 +1,5 @@
 #include "recast_module.h"
+#include <algorithm>
 #include "recast_crowd_agent.h"
 #include "recast_nav_convex_volume.h"
 #include "recast_nav_input_geom.h"
@@ -10,6 +11,18 @@ namespace Echo
 {
 	DECLARE_MODULE(RecastModule)
 
+	// unordered erase
+	template<typename T>
+	static void RemoveFrom(typename vector<T*>::type& items, T* item)
+	{
+		auto it = std::find(items.begin(), items.end(), item);
+		if (it != items.end())
+		{
+			*it = items.back();
+			items.pop_back();
+		}
+	}
+
 	RecastModule::RecastModule()
 	{
 	}
@@ -34,4 +47,70 @@ namespace Echo
 		Class::registerType<RecastNavTempObstacle>();
 		Class::registerType<RecastOffMeshLink>();
 	}
-}
\ No newline at end of file
+
+	void RecastModule::update(float elapsedTime)
+	{
+		if (m_navMesh)
+			m_navMesh->update(elapsedTime);
+	}
+
+	void RecastModule::removeNavMesh(RecastNavMesh* navMesh)
+	{
+		if (m_navMesh == navMesh)
+			m_navMesh = nullptr;
+	}
+
+	void RecastModule::addInputGeom(RecastNavInputGeom* geom)
+	{
+		m_inputGeoms.emplace_back(geom);
+		markInputGeomDirty();
+	}
+
+	void RecastModule::removeInputGeom(RecastNavInputGeom* geom)
+	{
+		RemoveFrom(m_inputGeoms, geom);
+		markInputGeomDirty();
+	}
+
+	void RecastModule::markInputGeomDirty()
+	{
+		if (m_navMesh)
+			m_navMesh->markBuildDirty();
+	}
+
+	void RecastModule::addObstacle(RecastNavTempObstacle* obstacle)
+	{
+		m_obstacles.emplace_back(obstacle);
+	}
+
+	void RecastModule::removeObstacle(RecastNavTempObstacle* obstacle)
+	{
+		RemoveFrom(m_obstacles, obstacle);
+		if (m_navMesh && obstacle->isApplied())
+			m_navMesh->markTilesDirty(obstacle->getAppliedBox());
+	}
+
+	void RecastModule::addVolume(RecastNavConvexVolume* volume)
+	{
+		m_volumes.emplace_back(volume);
+	}
+
+	void RecastModule::removeVolume(RecastNavConvexVolume* volume)
+	{
+		RemoveFrom(m_volumes, volume);
+		if (m_navMesh && volume->isApplied())
+			m_navMesh->markTilesDirty(volume->getAppliedBox());
+	}
+
+	void RecastModule::addAgent(RecastCrowdAgent* agent)
+	{
+		m_agents.emplace_back(agent);
+	}
+
+	void RecastModule::removeAgent(RecastCrowdAgent* agent)
+	{
+		RemoveFrom(m_agents, agent);
+		if (m_navMesh)
+			m_navMesh->removeAgent(agent);
+	}
+}
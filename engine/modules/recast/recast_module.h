@@ -4,6 +4,11 @@
 
 namespace Echo
 {
+	class RecastNavMesh;
+	class RecastNavInputGeom;
+	class RecastNavTempObstacle;
+	class RecastNavConvexVolume;
+	class RecastCrowdAgent;
 	class RecastModule : public Module
 	{
 		ECHO_SINGLETON_CLASS(RecastModule, Module)
@@ -16,5 +21,40 @@ namespace Echo
 
 		// register all types of the module
 		virtual void registerTypes() override;
+
+		// update
+		virtual void update(float elapsedTime) override;
+
+	public:
+		// the navmesh agents walk on, the last one created
+		RecastNavMesh* getNavMesh() { return m_navMesh; }
+		void setNavMesh(RecastNavMesh* navMesh) { m_navMesh = navMesh; }
+		void removeNavMesh(RecastNavMesh* navMesh);
+
+		// geometry the navmesh is built from, changes rebuild the whole navmesh
+		void addInputGeom(RecastNavInputGeom* geom);
+		void removeInputGeom(RecastNavInputGeom* geom);
+		void markInputGeomDirty();
+		const vector<RecastNavInputGeom*>::type& getInputGeoms() const { return m_inputGeoms; }
+
+		// obstacles and volumes, changes rebuild the tiles under them
+		void addObstacle(RecastNavTempObstacle* obstacle);
+		void removeObstacle(RecastNavTempObstacle* obstacle);
+		const vector<RecastNavTempObstacle*>::type& getObstacles() const { return m_obstacles; }
+		void addVolume(RecastNavConvexVolume* volume);
+		void removeVolume(RecastNavConvexVolume* volume);
+		const vector<RecastNavConvexVolume*>::type& getVolumes() const { return m_volumes; }
+
+		// crowd agents
+		void addAgent(RecastCrowdAgent* agent);
+		void removeAgent(RecastCrowdAgent* agent);
+		const vector<RecastCrowdAgent*>::type& getAgents() const { return m_agents; }
+
+	private:
+		RecastNavMesh*						m_navMesh = nullptr;
+		vector<RecastNavInputGeom*>::type		m_inputGeoms;
+		vector<RecastNavTempObstacle*>::type	m_obstacles;
+		vector<RecastNavConvexVolume*>::type	m_volumes;
+		vector<RecastCrowdAgent*>::type		m_agents;
 	};
 }
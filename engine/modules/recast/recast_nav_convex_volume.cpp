@@ -1,9 +1,53 @@
 #include "recast_nav_convex_volume.h"
+#include "recast_module.h"
 
 namespace Echo
 {
+	RecastNavConvexVolume::RecastNavConvexVolume()
+	{
+		RecastModule::instance()->addVolume(this);
+	}
+
+	RecastNavConvexVolume::~RecastNavConvexVolume()
+	{
+		RecastModule::instance()->removeVolume(this);
+	}
+
 	void RecastNavConvexVolume::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastNavConvexVolume, getHalfExtent, DEF_METHOD("getHalfExtent"));
+		CLASS_BIND_METHOD(RecastNavConvexVolume, setHalfExtent, DEF_METHOD("setHalfExtent"));
+		CLASS_BIND_METHOD(RecastNavConvexVolume, getArea, DEF_METHOD("getArea"));
+		CLASS_BIND_METHOD(RecastNavConvexVolume, setArea, DEF_METHOD("setArea"));
+
+		CLASS_REGISTER_PROPERTY(RecastNavConvexVolume, "HalfExtent", Variant::Type::Vector3, "getHalfExtent", "setHalfExtent");
+		CLASS_REGISTER_PROPERTY(RecastNavConvexVolume, "Area", Variant::Type::Int, "getArea", "setArea");
+	}
+
+	RecastNavVolume RecastNavConvexVolume::getVolume()
+	{
+		const Matrix4& world = getWorldMatrix();
+		const Vector3 corners[4] =
+		{
+			Vector3(-m_halfExtent.x, 0.f, -m_halfExtent.z),
+			Vector3( m_halfExtent.x, 0.f, -m_halfExtent.z),
+			Vector3( m_halfExtent.x, 0.f,  m_halfExtent.z),
+			Vector3(-m_halfExtent.x, 0.f,  m_halfExtent.z),
+		};
+
+		RecastNavVolume volume;
+		for (const Vector3& corner : corners)
+			volume.m_points.emplace_back(corner * world);
 
+		AABB bounds = getBounds();
+		volume.m_minY = bounds.vMin.y;
+		volume.m_maxY = bounds.vMax.y;
+		volume.m_area = ui8(m_area);
+		return volume;
+	}
+
+	AABB RecastNavConvexVolume::getBounds()
+	{
+		return AABB(-m_halfExtent, m_halfExtent).transform(getWorldMatrix());
 	}
-}
\ No newline at end of file
+}
@@ -1,13 +1,41 @@
 #pragma once
 
 #include "engine/core/scene/node.h"
+#include "recast_tile_builder.h"
 
 namespace Echo
 {
+	// box shaped volume marking an area id on the navmesh, area 0 blocks it. the footprint
+	// follows the node yaw, moving it rebuilds only the tiles it covers
 	class RecastNavConvexVolume : public Node
 	{
 		ECHO_CLASS(RecastNavConvexVolume, Node)
 
 	public:
+		RecastNavConvexVolume();
+		virtual ~RecastNavConvexVolume();
+
+		// half extent
+		const Vector3& getHalfExtent() const { return m_halfExtent; }
+		void setHalfExtent(const Vector3& halfExtent) { m_halfExtent = halfExtent; }
+
+		// area id, 0 to 63
+		i32 getArea() const { return m_area; }
+		void setArea(i32 area) { m_area = Math::Clamp(area, 0, 63); }
+
+		// world volume and its bounds
+		RecastNavVolume getVolume();
+		AABB getBounds();
+
+		// bounds the navmesh was last built with
+		bool isApplied() const { return m_isApplied; }
+		const AABB& getAppliedBox() const { return m_appliedBox; }
+		void setAppliedBox(const AABB& box) { m_appliedBox = box; m_isApplied = true; }
+
+	protected:
+		Vector3		m_halfExtent = Vector3(1.f, 1.f, 1.f);
+		i32			m_area = 0;
+		bool		m_isApplied = false;
+		AABB		m_appliedBox;
 	};
-}
\ No newline at end of file
+}
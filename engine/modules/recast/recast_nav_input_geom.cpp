@@ -1,9 +1,72 @@
 #include "recast_nav_input_geom.h"
+#include "recast_module.h"
 
 namespace Echo
 {
+	RecastNavInputGeom::RecastNavInputGeom()
+	{
+		m_builtWorld = Matrix4::IDENTITY;
+		RecastModule::instance()->addInputGeom(this);
+	}
+
+	RecastNavInputGeom::~RecastNavInputGeom()
+	{
+		RecastModule::instance()->removeInputGeom(this);
+	}
+
 	void RecastNavInputGeom::bindMethods()
 	{
 
 	}
-}
\ No newline at end of file
+
+	void RecastNavInputGeom::setTriangles(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount)
+	{
+		m_positions.assign(positions, positions + vertexCount);
+		m_indices.assign(indices, indices + indexCount);
+		RecastModule::instance()->markInputGeomDirty();
+	}
+
+	void RecastNavInputGeom::setMesh(MeshPtr mesh)
+	{
+		m_positions.clear();
+		m_indices.clear();
+		if (mesh && mesh->getTopologyType() == Mesh::TT_TRIANGLELIST)
+		{
+			MeshVertexData& vertices = mesh->getVertexData();
+			m_positions.resize(mesh->getVertexCount());
+			for (ui32 i = 0; i < m_positions.size(); i++)
+				m_positions[i] = vertices.getPosition(Word(i));
+
+			const Byte* indices = (const Byte*)mesh->getIndices();
+			m_indices.resize(mesh->getIndexCount());
+			for (ui32 i = 0; i < m_indices.size(); i++)
+				m_indices[i] = mesh->getIndexStride() == sizeof(ui32) ? ((const ui32*)indices)[i] : ((const Word*)indices)[i];
+		}
+
+		RecastModule::instance()->markInputGeomDirty();
+	}
+
+	void RecastNavInputGeom::getWorldTriangles(vector<float>::type& vertices, vector<i32>::type& triangles)
+	{
+		m_builtWorld = getWorldMatrix();
+
+		i32 base = i32(vertices.size() / 3);
+		for (const Vector3& position : m_positions)
+		{
+			Vector3 world = position * m_builtWorld;
+			vertices.insert(vertices.end(), { world.x, world.y, world.z });
+		}
+
+		for (size_t i = 0; i + 2 < m_indices.size(); i += 3)
+			triangles.insert(triangles.end(), { base + i32(m_indices[i]), base + i32(m_indices[i + 1]), base + i32(m_indices[i + 2]) });
+	}
+
+	void RecastNavInputGeom::update_self()
+	{
+		if (!m_positions.empty() && !(getWorldMatrix() == m_builtWorld))
+		{
+			m_builtWorld = getWorldMatrix();
+			RecastModule::instance()->markInputGeomDirty();
+		}
+	}
+}
@@ -1,13 +1,35 @@
 #pragma once
 
 #include "engine/core/scene/node.h"
+#include "engine/core/render/base/mesh/mesh.h"
 
 namespace Echo
 {
+	// static triangles the navmesh is built from, any change rebuilds the whole navmesh
 	class RecastNavInputGeom : public Node
 	{
 		ECHO_CLASS(RecastNavInputGeom, Node)
 
 	public:
+		RecastNavInputGeom();
+		virtual ~RecastNavInputGeom();
+
+		// triangle list geometry in local space, copied
+		void setTriangles(const Vector3* positions, ui32 vertexCount, const ui32* indices, ui32 indexCount);
+
+		// copy the triangles of a cpu side triangle list mesh
+		void setMesh(MeshPtr mesh);
+
+		// append the world space triangles
+		void getWorldTriangles(vector<float>::type& vertices, vector<i32>::type& triangles);
+
+	protected:
+		// rebuild when moved
+		virtual void update_self() override;
+
+	protected:
+		vector<Vector3>::type	m_positions;
+		vector<ui32>::type		m_indices;
+		Matrix4					m_builtWorld;
 	};
-}
\ No newline at end of file
+}
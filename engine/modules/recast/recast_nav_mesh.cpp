@@ -1,9 +1,422 @@
 #include "recast_nav_mesh.h"
+#include "recast_module.h"
+#include "recast_crowd_agent.h"
+#include "recast_nav_temp_obstacle.h"
+#include "recast_nav_convex_volume.h"
+#include "recast_nav_input_geom.h"
+#include "engine/core/log/Log.h"
+#include "DetourAlloc.h"
+#include "DetourCommon.h"
+#include "DetourNavMesh.h"
+#include "DetourNavMeshQuery.h"
+#include "DetourCrowd.h"
 
 namespace Echo
 {
+	RecastNavMesh::RecastNavMesh()
+	{
+		RecastModule::instance()->setNavMesh(this);
+	}
+
+	RecastNavMesh::~RecastNavMesh()
+	{
+		RecastModule::instance()->removeNavMesh(this);
+		clear();
+		EchoSafeDelete(m_builder, RecastTileBuilder);
+	}
+
 	void RecastNavMesh::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastNavMesh, getCellSize, DEF_METHOD("getCellSize"));
+		CLASS_BIND_METHOD(RecastNavMesh, setCellSize, DEF_METHOD("setCellSize"));
+		CLASS_BIND_METHOD(RecastNavMesh, getCellHeight, DEF_METHOD("getCellHeight"));
+		CLASS_BIND_METHOD(RecastNavMesh, setCellHeight, DEF_METHOD("setCellHeight"));
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentRadius, DEF_METHOD("getAgentRadius"));
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentRadius, DEF_METHOD("setAgentRadius"));
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentHeight, DEF_METHOD("getAgentHeight"));
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentHeight, DEF_METHOD("setAgentHeight"));
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentMaxClimb, DEF_METHOD("getAgentMaxClimb"));
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentMaxClimb, DEF_METHOD("setAgentMaxClimb"));
+		CLASS_BIND_METHOD(RecastNavMesh, getAgentMaxSlope, DEF_METHOD("getAgentMaxSlope"));
+		CLASS_BIND_METHOD(RecastNavMesh, setAgentMaxSlope, DEF_METHOD("setAgentMaxSlope"));
+		CLASS_BIND_METHOD(RecastNavMesh, getTileSize, DEF_METHOD("getTileSize"));
+		CLASS_BIND_METHOD(RecastNavMesh, setTileSize, DEF_METHOD("setTileSize"));
+		CLASS_BIND_METHOD(RecastNavMesh, getMaxAgents, DEF_METHOD("getMaxAgents"));
+		CLASS_BIND_METHOD(RecastNavMesh, setMaxAgents, DEF_METHOD("setMaxAgents"));
+		CLASS_BIND_METHOD(RecastNavMesh, markBuildDirty, DEF_METHOD("markBuildDirty"));
+		CLASS_BIND_METHOD(RecastNavMesh, getPendingTileCount, DEF_METHOD("getPendingTileCount"));
+
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "CellSize", Variant::Type::Real, "getCellSize", "setCellSize");
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "CellHeight", Variant::Type::Real, "getCellHeight", "setCellHeight");
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentRadius", Variant::Type::Real, "getAgentRadius", "setAgentRadius");
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentHeight", Variant::Type::Real, "getAgentHeight", "setAgentHeight");
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentMaxClimb", Variant::Type::Real, "getAgentMaxClimb", "setAgentMaxClimb");
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "AgentMaxSlope", Variant::Type::Real, "getAgentMaxSlope", "setAgentMaxSlope");
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "TileSize", Variant::Type::Int, "getTileSize", "setTileSize");
+		CLASS_REGISTER_PROPERTY(RecastNavMesh, "MaxAgents", Variant::Type::Int, "getMaxAgents", "setMaxAgents");
+	}
+
+	void RecastNavMesh::update(float elapsedTime)
+	{
+		if (m_isBuildDirty)
+			build();
+
+		if (m_navMesh)
+		{
+			updateModifiers();
+			requestDirtyTiles();
+			addFinishedTiles();
+			updateCrowd(elapsedTime);
+		}
+	}
+
+	void RecastNavMesh::build()
+	{
+		clear();
+		m_isBuildDirty = false;
+
+		vector<float>::type vertices;
+		vector<i32>::type triangles;
+		for (RecastNavInputGeom* geom : RecastModule::instance()->getInputGeoms())
+			geom->getWorldTriangles(vertices, triangles);
+
+		if (triangles.empty())
+			return;
+
+		m_geometry = std::make_shared<RecastNavGeometry>(vertices, triangles, m_settings);
+
+		// 32 bit poly refs keep 10 salt bits, whatever the tiles leave goes to polys. below
+		// 256 polys per tile a tile can't hold its mesh, so the tile count is capped
+		const i32 maxTileBits = 14;
+		i32 tileCount = m_geometry->getTilesX() * m_geometry->getTilesZ();
+		i32 tileBits = i32(dtIlog2(dtNextPow2(ui32(tileCount))));
+		if (tileBits > maxTileBits)
+		{
+			EchoLogError("RecastNavMesh: %d tiles exceed the %d tile limit of 32 bit poly refs, raise TileSize", tileCount, 1 << maxTileBits);
+			clear();
+			return;
+		}
+
+		i32 polyBits = 22 - tileBits;
+
+		dtNavMeshParams params;
+		memset(&params, 0, sizeof(params));
+		dtVcopy(params.orig, &m_geometry->getMin().x);
+		params.tileWidth = m_geometry->getTileWidth();
+		params.tileHeight = m_geometry->getTileWidth();
+		params.maxTiles = 1 << tileBits;
+		params.maxPolys = 1 << polyBits;
+
+		m_navMesh = dtAllocNavMesh();
+		if (!m_navMesh || dtStatusFailed(m_navMesh->init(&params)))
+		{
+			EchoLogError("RecastNavMesh: init navmesh failed");
+			clear();
+			return;
+		}
+
+		m_query = dtAllocNavMeshQuery();
+		m_crowd = dtAllocCrowd();
+		if (!m_query || !m_crowd || dtStatusFailed(m_query->init(m_navMesh, 2048)) || !m_crowd->init(m_maxAgents, m_settings.m_agentRadius, m_navMesh))
+		{
+			EchoLogError("RecastNavMesh: init crowd failed");
+			clear();
+			return;
+		}
+
+		if (!m_builder)
+			m_builder = EchoNew(RecastTileBuilder);
+
+		m_tileGenerations.assign(tileCount, 0);
+		m_builtGenerations.assign(tileCount, 0);
+		m_dirtyTiles.assign(tileCount, true);
+		m_hasDirtyTiles = true;
+	}
+
+	void RecastNavMesh::clear()
+	{
+		if (m_builder)
+			m_builder->cancel();
+
+		// agents enter the next crowd again
+		for (RecastCrowdAgent* agent : RecastModule::instance()->getAgents())
+		{
+			agent->m_crowdIndex = -1;
+			agent->m_isTargetDirty = agent->m_hasTarget;
+		}
+
+		dtFreeCrowd(m_crowd);
+		dtFreeNavMeshQuery(m_query);
+		dtFreeNavMesh(m_navMesh);
+		m_crowd = nullptr;
+		m_query = nullptr;
+		m_navMesh = nullptr;
+
+		m_geometry.reset();
+		m_tileGenerations.clear();
+		m_builtGenerations.clear();
+		m_dirtyTiles.clear();
+		m_hasDirtyTiles = false;
+		m_pendingTiles = 0;
+	}
+
+	void RecastNavMesh::markTilesDirty(const AABB& box)
+	{
+		if (!m_geometry)
+			return;
+
+		// obstacles grow by the agent radius and tiles read geometry from their border
+		float margin = m_settings.m_agentRadius + m_settings.getBorderSize() * m_settings.m_cellSize;
+		AABB grown(box.vMin - Vector3(margin, 0.f, margin), box.vMax + Vector3(margin, 0.f, margin));
+
+		i32 minX, minZ, maxX, maxZ;
+		if (m_geometry->getTileRange(grown, minX, minZ, maxX, maxZ))
+		{
+			for (i32 z = minZ; z <= maxZ; z++)
+				for (i32 x = minX; x <= maxX; x++)
+					m_dirtyTiles[z * m_geometry->getTilesX() + x] = true;
+
+			m_hasDirtyTiles = true;
+		}
+	}
+
+	void RecastNavMesh::updateModifiers()
+	{
+		for (RecastNavTempObstacle* obstacle : RecastModule::instance()->getObstacles())
+		{
+			AABB box = obstacle->getBounds();
+			if (!obstacle->isApplied() || box != obstacle->getAppliedBox())
+			{
+				if (obstacle->isApplied())
+					markTilesDirty(obstacle->getAppliedBox());
+
+				markTilesDirty(box);
+				obstacle->setAppliedBox(box);
+			}
+		}
+
+		for (RecastNavConvexVolume* volume : RecastModule::instance()->getVolumes())
+		{
+			AABB box = volume->getBounds();
+			if (!volume->isApplied() || box != volume->getAppliedBox())
+			{
+				if (volume->isApplied())
+					markTilesDirty(volume->getAppliedBox());
+
+				markTilesDirty(box);
+				volume->setAppliedBox(box);
+			}
+		}
+	}
+
+	void RecastNavMesh::requestDirtyTiles()
+	{
+		if (!m_hasDirtyTiles)
+			return;
+
+		// one snapshot for every tile of this request
+		std::shared_ptr<RecastNavModifiers> modifiers = std::make_shared<RecastNavModifiers>();
+		for (RecastNavTempObstacle* obstacle : RecastModule::instance()->getObstacles())
+			modifiers->m_obstacles.emplace_back(obstacle->getObstacle());
+
+		for (RecastNavConvexVolume* volume : RecastModule::instance()->getVolumes())
+			modifiers->m_volumes.emplace_back(volume->getVolume());
+
+		RecastTileBuilder::Job job;
+		job.m_generation = ++m_generation;
+		job.m_settings = m_settings;
+		job.m_geometry = m_geometry;
+		job.m_modifiers = modifiers;
+		for (i32 z = 0; z < m_geometry->getTilesZ(); z++)
+		{
+			for (i32 x = 0; x < m_geometry->getTilesX(); x++)
+			{
+				i32 index = z * m_geometry->getTilesX() + x;
+				if (m_dirtyTiles[index])
+				{
+					if (m_tileGenerations[index] == m_builtGenerations[index])
+						m_pendingTiles++;
+
+					m_dirtyTiles[index] = false;
+					m_tileGenerations[index] = job.m_generation;
+					job.m_x = x;
+					job.m_z = z;
+					m_builder->request(job);
+				}
+			}
+		}
+
+		m_hasDirtyTiles = false;
+	}
+
+	void RecastNavMesh::addFinishedTiles()
+	{
+		m_finishedTiles.clear();
+		m_builder->collect(m_finishedTiles);
+
+		bool isChanged = false;
+		for (RecastTileBuilder::Tile& tile : m_finishedTiles)
+		{
+			// results that were requested again since are dropped
+			i32 index = tile.m_z * m_geometry->getTilesX() + tile.m_x;
+			if (tile.m_x >= m_geometry->getTilesX() || tile.m_z >= m_geometry->getTilesZ() || tile.m_generation != m_tileGenerations[index])
+			{
+				dtFree(tile.m_data);
+				continue;
+			}
+
+			m_builtGenerations[index] = tile.m_generation;
+			m_pendingTiles--;
+
+			dtTileRef ref = m_navMesh->getTileRefAt(tile.m_x, tile.m_z, 0);
+			if (ref)
+				m_navMesh->removeTile(ref, nullptr, nullptr);
+
+			if (tile.m_data && dtStatusFailed(m_navMesh->addTile(tile.m_data, tile.m_dataSize, DT_TILE_FREE_DATA, 0, nullptr)))
+				dtFree(tile.m_data);
+
+			isChanged = true;
+		}
+		m_finishedTiles.clear();
+
+		// agents that were placed off the mesh try again on the new tiles
+		if (isChanged)
+		{
+			for (RecastCrowdAgent* agent : RecastModule::instance()->getAgents())
+			{
+				if (agent->m_crowdIndex != -1 && m_crowd->getAgent(agent->m_crowdIndex)->state == DT_CROWDAGENT_STATE_INVALID)
+				{
+					m_crowd->removeAgent(agent->m_crowdIndex);
+					agent->m_crowdIndex = -1;
+					agent->m_isTargetDirty = agent->m_hasTarget;
+				}
+			}
+		}
+	}
+
+	void RecastNavMesh::removeAgent(RecastCrowdAgent* agent)
+	{
+		if (m_crowd && agent->m_crowdIndex != -1)
+			m_crowd->removeAgent(agent->m_crowdIndex);
+
+		agent->m_crowdIndex = -1;
+	}
+
+	static void GetAgentParams(const RecastCrowdAgent* agent, dtCrowdAgentParams& params)
+	{
+		memset(&params, 0, sizeof(params));
+		params.radius = agent->getRadius();
+		params.height = agent->getHeight();
+		params.maxAcceleration = agent->getMaxAcceleration();
+		params.maxSpeed = agent->getMaxSpeed();
+		params.collisionQueryRange = params.radius * 12.f;
+		params.pathOptimizationRange = params.radius * 30.f;
+		params.separationWeight = 2.f;
+		params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION;
+		params.obstacleAvoidanceType = 3;
+	}
+
+	void RecastNavMesh::updateCrowd(float elapsedTime)
+	{
+		dtCrowdAgentParams params;
+		for (RecastCrowdAgent* agent : RecastModule::instance()->getAgents())
+		{
+			// moved by hand, place it again
+			if (agent->m_crowdIndex != -1 && agent->getWorldPosition() != agent->m_crowdPosition)
+			{
+				m_crowd->removeAgent(agent->m_crowdIndex);
+				agent->m_crowdIndex = -1;
+				agent->m_isTargetDirty = agent->m_hasTarget;
+			}
+
+			if (agent->m_crowdIndex == -1)
+			{
+				GetAgentParams(agent, params);
+				agent->m_crowdPosition = agent->getWorldPosition();
+				agent->m_crowdIndex = m_crowd->addAgent(&agent->m_crowdPosition.x, &params);
+				agent->m_isParamsDirty = false;
+				if (agent->m_crowdIndex == -1)
+					continue;
+			}
+
+			if (agent->m_isParamsDirty)
+			{
+				GetAgentParams(agent, params);
+				m_crowd->updateAgentParameters(agent->m_crowdIndex, &params);
+				agent->m_isParamsDirty = false;
+			}
+
+			// targets go through the path queue of the crowd, a few paths per update
+			if (agent->m_isTargetDirty)
+			{
+				if (agent->m_hasTarget)
+				{
+					dtPolyRef ref = 0;
+					float nearest[3];
+					m_query->findNearestPoly(&agent->m_target.x, m_crowd->getQueryHalfExtents(), m_crowd->getFilter(0), &ref, nearest);
+					if (ref && m_crowd->requestMoveTarget(agent->m_crowdIndex, ref, nearest))
+						agent->m_isTargetDirty = false;
+				}
+				else
+				{
+					m_crowd->resetMoveTarget(agent->m_crowdIndex);
+					agent->m_isTargetDirty = false;
+				}
+			}
+		}
+
+		m_crowd->update(elapsedTime, nullptr);
+
+		for (RecastCrowdAgent* agent : RecastModule::instance()->getAgents())
+		{
+			if (agent->m_crowdIndex != -1)
+			{
+				const dtCrowdAgent* crowdAgent = m_crowd->getAgent(agent->m_crowdIndex);
+				if (crowdAgent->state == DT_CROWDAGENT_STATE_WALKING)
+				{
+					agent->setWorldPosition(Vector3(crowdAgent->npos[0], crowdAgent->npos[1], crowdAgent->npos[2]));
+					agent->m_velocity = Vector3(crowdAgent->vel[0], crowdAgent->vel[1], crowdAgent->vel[2]);
+				}
+
+				agent->m_crowdPosition = agent->getWorldPosition();
+			}
+		}
+	}
+
+	bool RecastNavMesh::findPath(const Vector3& start, const Vector3& end, vector<Vector3>::type& path) const
+	{
+		path.clear();
+		if (!m_query)
+			return false;
+
+		dtQueryFilter filter;
+		const float halfExtents[3] = { m_settings.m_agentRadius * 2.f, m_settings.m_agentHeight, m_settings.m_agentRadius * 2.f };
+		dtPolyRef startRef = 0;
+		dtPolyRef endRef = 0;
+		float startPos[3];
+		float endPos[3];
+		m_query->findNearestPoly(&start.x, halfExtents, &filter, &startRef, startPos);
+		m_query->findNearestPoly(&end.x, halfExtents, &filter, &endRef, endPos);
+		if (!startRef || !endRef)
+			return false;
+
+		const i32 maxPolys = 256;
+		dtPolyRef polys[maxPolys];
+		i32 polyCount = 0;
+		m_query->findPath(startRef, endRef, startPos, endPos, &filter, polys, &polyCount, maxPolys);
+		if (!polyCount)
+			return false;
+
+		// a partial path ends on the closest poly reached
+		if (polys[polyCount - 1] != endRef)
+			m_query->closestPointOnPoly(polys[polyCount - 1], endPos, endPos, nullptr);
+
+		float straight[maxPolys * 3];
+		i32 straightCount = 0;
+		m_query->findStraightPath(startPos, endPos, polys, polyCount, straight, nullptr, nullptr, &straightCount, maxPolys);
+		for (i32 i = 0; i < straightCount; i++)
+			path.emplace_back(straight[i * 3 + 0], straight[i * 3 + 1], straight[i * 3 + 2]);
 
+		return polys[polyCount - 1] == endRef;
 	}
-}
\ No newline at end of file
+}
@@ -1,13 +1,114 @@
 #pragma once
 
 #include "engine/core/scene/node.h"
+#include "recast_tile_builder.h"
+
+class dtNavMesh;
+class dtNavMeshQuery;
+class dtCrowd;
 
 namespace Echo
 {
+	class RecastCrowdAgent;
+
+	// tiled navmesh built from every RecastNavInputGeom on worker threads. obstacles and
+	// volumes rebuild only the tiles they cover, agents are driven by a detour crowd
 	class RecastNavMesh : public Node
 	{
 		ECHO_CLASS(RecastNavMesh, Node)
 
 	public:
+		RecastNavMesh();
+		virtual ~RecastNavMesh();
+
+		// cell size
+		float getCellSize() const { return m_settings.m_cellSize; }
+		void setCellSize(float cellSize) { m_settings.m_cellSize = cellSize; markBuildDirty(); }
+
+		// cell height
+		float getCellHeight() const { return m_settings.m_cellHeight; }
+		void setCellHeight(float cellHeight) { m_settings.m_cellHeight = cellHeight; markBuildDirty(); }
+
+		// agent radius
+		float getAgentRadius() const { return m_settings.m_agentRadius; }
+		void setAgentRadius(float radius) { m_settings.m_agentRadius = radius; markBuildDirty(); }
+
+		// agent height
+		float getAgentHeight() const { return m_settings.m_agentHeight; }
+		void setAgentHeight(float height) { m_settings.m_agentHeight = height; markBuildDirty(); }
+
+		// agent max climb
+		float getAgentMaxClimb() const { return m_settings.m_agentMaxClimb; }
+		void setAgentMaxClimb(float maxClimb) { m_settings.m_agentMaxClimb = maxClimb; markBuildDirty(); }
+
+		// agent max slope in degrees
+		float getAgentMaxSlope() const { return m_settings.m_agentMaxSlope; }
+		void setAgentMaxSlope(float maxSlope) { m_settings.m_agentMaxSlope = maxSlope; markBuildDirty(); }
+
+		// tile size in cells
+		i32 getTileSize() const { return m_settings.m_tileSize; }
+		void setTileSize(i32 tileSize) { m_settings.m_tileSize = std::max<i32>(tileSize, 8); markBuildDirty(); }
+
+		// crowd capacity
+		i32 getMaxAgents() const { return m_maxAgents; }
+		void setMaxAgents(i32 maxAgents) { m_maxAgents = std::max<i32>(maxAgents, 1); markBuildDirty(); }
+
+		// rebuild everything on the next update
+		void markBuildDirty() { m_isBuildDirty = true; }
+
+		// rebuild the tiles overlapping a world box
+		void markTilesDirty(const AABB& box);
+
+		// tiles queued or being built
+		i32 getPendingTileCount() const { return m_pendingTiles; }
+
+		// drive tiles and crowd, called by the module every frame
+		void update(float elapsedTime);
+
+		// leave the crowd
+		void removeAgent(RecastCrowdAgent* agent);
+
+		// straight path between two world positions, false when either end is off the mesh
+		bool findPath(const Vector3& start, const Vector3& end, vector<Vector3>::type& path) const;
+
+		// detour objects, nullptr before the first build
+		dtNavMesh* getDetourNavMesh() { return m_navMesh; }
+		dtCrowd* getCrowd() { return m_crowd; }
+
+	protected:
+		// gather the input geometry and queue every tile
+		void build();
+
+		// free detour objects and cancel pending tiles
+		void clear();
+
+		// dirty the tiles under obstacles and volumes that moved
+		void updateModifiers();
+
+		// queue the dirty tiles with the current obstacles and volumes
+		void requestDirtyTiles();
+
+		// move finished tiles into the navmesh
+		void addFinishedTiles();
+
+		// push agent changes, step the crowd and write positions back
+		void updateCrowd(float elapsedTime);
+
+	protected:
+		RecastBuildSettings		m_settings;
+		i32						m_maxAgents = 1024;
+		bool					m_isBuildDirty = true;
+		RecastTileBuilder*		m_builder = nullptr;
+		RecastNavGeometryPtr	m_geometry;
+		dtNavMesh*				m_navMesh = nullptr;
+		dtNavMeshQuery*			m_query = nullptr;
+		dtCrowd*				m_crowd = nullptr;
+		ui32					m_generation = 0;
+		vector<ui32>::type		m_tileGenerations;		// wanted build of each tile
+		vector<ui32>::type		m_builtGenerations;
+		vector<bool>::type		m_dirtyTiles;
+		bool					m_hasDirtyTiles = false;
+		i32						m_pendingTiles = 0;
+		vector<RecastTileBuilder::Tile>::type	m_finishedTiles;
 	};
-}
\ No newline at end of file
+}
@@ -1,9 +1,41 @@
 #include "recast_nav_temp_obstacle.h"
+#include "recast_module.h"
 
 namespace Echo
 {
+	RecastNavTempObstacle::RecastNavTempObstacle()
+	{
+		RecastModule::instance()->addObstacle(this);
+	}
+
+	RecastNavTempObstacle::~RecastNavTempObstacle()
+	{
+		RecastModule::instance()->removeObstacle(this);
+	}
+
 	void RecastNavTempObstacle::bindMethods()
 	{
+		CLASS_BIND_METHOD(RecastNavTempObstacle, getRadius, DEF_METHOD("getRadius"));
+		CLASS_BIND_METHOD(RecastNavTempObstacle, setRadius, DEF_METHOD("setRadius"));
+		CLASS_BIND_METHOD(RecastNavTempObstacle, getHeight, DEF_METHOD("getHeight"));
+		CLASS_BIND_METHOD(RecastNavTempObstacle, setHeight, DEF_METHOD("setHeight"));
 
+		CLASS_REGISTER_PROPERTY(RecastNavTempObstacle, "Radius", Variant::Type::Real, "getRadius", "setRadius");
+		CLASS_REGISTER_PROPERTY(RecastNavTempObstacle, "Height", Variant::Type::Real, "getHeight", "setHeight");
+	}
+
+	RecastNavObstacle RecastNavTempObstacle::getObstacle()
+	{
+		RecastNavObstacle obstacle;
+		obstacle.m_position = getWorldPosition();
+		obstacle.m_radius = m_radius;
+		obstacle.m_height = m_height;
+		return obstacle;
+	}
+
+	AABB RecastNavTempObstacle::getBounds()
+	{
+		const Vector3& position = getWorldPosition();
+		return AABB(position - Vector3(m_radius, 0.f, m_radius), position + Vector3(m_radius, m_height, m_radius));
 	}
-}
\ No newline at end of file
+}
@@ -1,13 +1,40 @@
 #pragma once
 
 #include "engine/core/scene/node.h"
+#include "recast_tile_builder.h"
 
 namespace Echo
 {
+	// upright cylinder cut out of the navmesh, moving it rebuilds only the tiles it covers
 	class RecastNavTempObstacle : public Node
 	{
 		ECHO_CLASS(RecastNavTempObstacle, Node)
 
 	public:
+		RecastNavTempObstacle();
+		virtual ~RecastNavTempObstacle();
+
+		// radius
+		float getRadius() const { return m_radius; }
+		void setRadius(float radius) { m_radius = radius; }
+
+		// height above the node position
+		float getHeight() const { return m_height; }
+		void setHeight(float height) { m_height = height; }
+
+		// world cylinder and its bounds
+		RecastNavObstacle getObstacle();
+		AABB getBounds();
+
+		// bounds the navmesh was last built with
+		bool isApplied() const { return m_isApplied; }
+		const AABB& getAppliedBox() const { return m_appliedBox; }
+		void setAppliedBox(const AABB& box) { m_appliedBox = box; m_isApplied = true; }
+
+	protected:
+		float	m_radius = 0.5f;
+		float	m_height = 2.f;
+		bool	m_isApplied = false;
+		AABB	m_appliedBox;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,295 @@
+#include "recast_tile_builder.h"
+#include <cstring>
+#include <algorithm>
+#include "Recast.h"
+#include "DetourAlloc.h"
+#include "DetourNavMesh.h"
+#include "DetourNavMeshBuilder.h"
+#include "engine/core/thread/pool/ParallelWorkers.h"
+
+namespace Echo
+{
+	RecastNavGeometry::RecastNavGeometry(const vector<float>::type& vertices, const vector<i32>::type& triangles, const RecastBuildSettings& settings)
+		: m_vertices(vertices)
+		, m_triangles(triangles)
+	{
+		m_min = Vector3::ZERO;
+		m_max = Vector3::ZERO;
+		if (m_vertices.size() < 3 || m_triangles.size() < 3)
+			return;
+
+		rcCalcBounds(m_vertices.data(), i32(m_vertices.size() / 3), &m_min.x, &m_max.x);
+
+		m_tileWidth = settings.getTileWidth();
+		m_tilesX = std::max<i32>(i32(std::ceil((m_max.x - m_min.x) / m_tileWidth)), 1);
+		m_tilesZ = std::max<i32>(i32(std::ceil((m_max.z - m_min.z) / m_tileWidth)), 1);
+		m_tileTriangles.resize(m_tilesX * m_tilesZ);
+
+		// a triangle goes to every tile whose border it reaches
+		float border = settings.getBorderSize() * settings.m_cellSize;
+		for (size_t i = 0; i + 2 < m_triangles.size(); i += 3)
+		{
+			AABB box;
+			box.reset();
+			for (size_t j = 0; j < 3; j++)
+			{
+				const float* v = &m_vertices[m_triangles[i + j] * 3];
+				box.addPoint(Vector3(v[0], v[1], v[2]));
+			}
+
+			box.vMin -= Vector3(border, 0.f, border);
+			box.vMax += Vector3(border, 0.f, border);
+
+			i32 minX, minZ, maxX, maxZ;
+			if (getTileRange(box, minX, minZ, maxX, maxZ))
+			{
+				for (i32 z = minZ; z <= maxZ; z++)
+					for (i32 x = minX; x <= maxX; x++)
+						m_tileTriangles[z * m_tilesX + x].emplace_back(i32(i / 3));
+			}
+		}
+	}
+
+	bool RecastNavGeometry::getTileRange(const AABB& box, i32& minX, i32& minZ, i32& maxX, i32& maxZ) const
+	{
+		if (!m_tilesX || !m_tilesZ)
+			return false;
+
+		minX = i32(std::floor((box.vMin.x - m_min.x) / m_tileWidth));
+		minZ = i32(std::floor((box.vMin.z - m_min.z) / m_tileWidth));
+		maxX = i32(std::floor((box.vMax.x - m_min.x) / m_tileWidth));
+		maxZ = i32(std::floor((box.vMax.z - m_min.z) / m_tileWidth));
+		if (maxX < 0 || maxZ < 0 || minX >= m_tilesX || minZ >= m_tilesZ)
+			return false;
+
+		minX = std::max<i32>(minX, 0);
+		minZ = std::max<i32>(minZ, 0);
+		maxX = std::min<i32>(maxX, m_tilesX - 1);
+		maxZ = std::min<i32>(maxZ, m_tilesZ - 1);
+		return true;
+	}
+
+	void RecastTileBuilder::request(const Job& job)
+	{
+		m_queue.emplace_back(job);
+	}
+
+	void RecastTileBuilder::collect(vector<Tile>::type& tiles)
+	{
+		// a tile takes milliseconds, so a frame builds no more than the cores can run at once
+		ui32 count = std::min<ui32>(ui32(m_queue.size()), ParallelWorkers::instance()->getWorkerCount() + 1);
+		if (count)
+		{
+			size_t first = tiles.size();
+			tiles.resize(first + count);
+
+			const Job* jobs = m_queue.data() + m_queue.size() - count;
+			Tile* built = tiles.data() + first;
+			ParallelWorkers::instance()->parallelFor(count, 1, [jobs, built](ui32 begin, ui32 end)
+			{
+				for (ui32 i = begin; i < end; i++)
+				{
+					built[i].m_x = jobs[i].m_x;
+					built[i].m_z = jobs[i].m_z;
+					built[i].m_generation = jobs[i].m_generation;
+					built[i].m_data = BuildTile(jobs[i], built[i].m_dataSize);
+				}
+			});
+
+			m_queue.resize(m_queue.size() - count);
+		}
+	}
+
+	void RecastTileBuilder::cancel()
+	{
+		m_queue.clear();
+	}
+
+	// intermediate recast data of one tile
+	struct RecastTileScratch
+	{
+		rcHeightfield*			m_solid = nullptr;
+		rcCompactHeightfield*	m_chf = nullptr;
+		rcContourSet*			m_cset = nullptr;
+		rcPolyMesh*				m_pmesh = nullptr;
+		rcPolyMeshDetail*		m_dmesh = nullptr;
+
+		~RecastTileScratch()
+		{
+			rcFreeHeightField(m_solid);
+			rcFreeCompactHeightfield(m_chf);
+			rcFreeContourSet(m_cset);
+			rcFreePolyMesh(m_pmesh);
+			rcFreePolyMeshDetail(m_dmesh);
+		}
+	};
+
+	unsigned char* RecastTileBuilder::BuildTile(const Job& job, i32& dataSize)
+	{
+		dataSize = 0;
+		if (!job.m_geometry)
+			return nullptr;
+
+		const RecastNavGeometry& geometry = *job.m_geometry;
+		const RecastBuildSettings& settings = job.m_settings;
+		const vector<i32>::type& tileTriangles = geometry.getTileTriangles(job.m_x, job.m_z);
+		if (tileTriangles.empty())
+			return nullptr;
+
+		rcConfig cfg;
+		memset(&cfg, 0, sizeof(cfg));
+		cfg.cs = settings.m_cellSize;
+		cfg.ch = settings.m_cellHeight;
+		cfg.walkableSlopeAngle = settings.m_agentMaxSlope;
+		cfg.walkableHeight = i32(std::ceil(settings.m_agentHeight / cfg.ch));
+		cfg.walkableClimb = i32(std::floor(settings.m_agentMaxClimb / cfg.ch));
+		cfg.walkableRadius = i32(std::ceil(settings.m_agentRadius / cfg.cs));
+		cfg.maxEdgeLen = i32(settings.m_edgeMaxLen / cfg.cs);
+		cfg.maxSimplificationError = settings.m_edgeMaxError;
+		cfg.minRegionArea = settings.m_regionMinSize * settings.m_regionMinSize;
+		cfg.mergeRegionArea = settings.m_regionMergeSize * settings.m_regionMergeSize;
+		cfg.maxVertsPerPoly = std::min<i32>(settings.m_vertsPerPoly, DT_VERTS_PER_POLYGON);
+		cfg.tileSize = settings.m_tileSize;
+		cfg.borderSize = settings.getBorderSize();
+		cfg.width = cfg.tileSize + cfg.borderSize * 2;
+		cfg.height = cfg.tileSize + cfg.borderSize * 2;
+		cfg.detailSampleDist = settings.m_detailSampleDist < 0.9f ? 0.f : cfg.cs * settings.m_detailSampleDist;
+		cfg.detailSampleMaxError = cfg.ch * settings.m_detailSampleMaxError;
+
+		// tile bounds grown by the border, so neighbours agree on their shared edges
+		float tileWidth = geometry.getTileWidth();
+		float border = cfg.borderSize * cfg.cs;
+		cfg.bmin[0] = geometry.getMin().x + job.m_x * tileWidth - border;
+		cfg.bmin[1] = geometry.getMin().y;
+		cfg.bmin[2] = geometry.getMin().z + job.m_z * tileWidth - border;
+		cfg.bmax[0] = geometry.getMin().x + (job.m_x + 1) * tileWidth + border;
+		cfg.bmax[1] = geometry.getMax().y;
+		cfg.bmax[2] = geometry.getMin().z + (job.m_z + 1) * tileWidth + border;
+
+		rcContext ctx(false);
+		RecastTileScratch scratch;
+
+		// rasterize the triangles of this tile
+		scratch.m_solid = rcAllocHeightfield();
+		if (!scratch.m_solid || !rcCreateHeightfield(&ctx, *scratch.m_solid, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
+			return nullptr;
+
+		const vector<float>::type& vertices = geometry.getVertices();
+		const vector<i32>::type& triangles = geometry.getTriangles();
+		vector<i32>::type tris(tileTriangles.size() * 3);
+		for (size_t i = 0; i < tileTriangles.size(); i++)
+		{
+			tris[i * 3 + 0] = triangles[tileTriangles[i] * 3 + 0];
+			tris[i * 3 + 1] = triangles[tileTriangles[i] * 3 + 1];
+			tris[i * 3 + 2] = triangles[tileTriangles[i] * 3 + 2];
+		}
+
+		i32 vertexCount = i32(vertices.size() / 3);
+		i32 triangleCount = i32(tileTriangles.size());
+		vector<unsigned char>::type areas(triangleCount, 0);
+		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, vertices.data(), vertexCount, tris.data(), triangleCount, areas.data());
+		if (!rcRasterizeTriangles(&ctx, vertices.data(), vertexCount, tris.data(), areas.data(), triangleCount, *scratch.m_solid, cfg.walkableClimb))
+			return nullptr;
+
+		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *scratch.m_solid);
+		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *scratch.m_solid);
+		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *scratch.m_solid);
+
+		scratch.m_chf = rcAllocCompactHeightfield();
+		if (!scratch.m_chf || !rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *scratch.m_solid, *scratch.m_chf))
+			return nullptr;
+
+		rcFreeHeightField(scratch.m_solid);
+		scratch.m_solid = nullptr;
+
+		if (!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *scratch.m_chf))
+			return nullptr;
+
+		// obstacles and volumes, after erosion so obstacles grow by the agent radius themselves
+		if (job.m_modifiers)
+		{
+			for (const RecastNavObstacle& obstacle : job.m_modifiers->m_obstacles)
+			{
+				float position[3] = { obstacle.m_position.x, obstacle.m_position.y, obstacle.m_position.z };
+				rcMarkCylinderArea(&ctx, position, obstacle.m_radius + settings.m_agentRadius, obstacle.m_height, RC_NULL_AREA, *scratch.m_chf);
+			}
+
+			for (const RecastNavVolume& volume : job.m_modifiers->m_volumes)
+			{
+				if (volume.m_points.size() < 3)
+					continue;
+
+				vector<float>::type points;
+				for (const Vector3& point : volume.m_points)
+					points.insert(points.end(), { point.x, volume.m_minY, point.z });
+
+				rcMarkConvexPolyArea(&ctx, points.data(), i32(volume.m_points.size()), volume.m_minY, volume.m_maxY, volume.m_area, *scratch.m_chf);
+			}
+		}
+
+		if (!rcBuildDistanceField(&ctx, *scratch.m_chf))
+			return nullptr;
+
+		if (!rcBuildRegions(&ctx, *scratch.m_chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
+			return nullptr;
+
+		scratch.m_cset = rcAllocContourSet();
+		if (!scratch.m_cset || !rcBuildContours(&ctx, *scratch.m_chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *scratch.m_cset))
+			return nullptr;
+
+		if (!scratch.m_cset->nconts)
+			return nullptr;
+
+		scratch.m_pmesh = rcAllocPolyMesh();
+		if (!scratch.m_pmesh || !rcBuildPolyMesh(&ctx, *scratch.m_cset, cfg.maxVertsPerPoly, *scratch.m_pmesh))
+			return nullptr;
+
+		scratch.m_dmesh = rcAllocPolyMeshDetail();
+		if (!scratch.m_dmesh || !rcBuildPolyMeshDetail(&ctx, *scratch.m_pmesh, *scratch.m_chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *scratch.m_dmesh))
+			return nullptr;
+
+		// detour indexes vertices with 16 bits
+		rcPolyMesh& pmesh = *scratch.m_pmesh;
+		if (!pmesh.npolys || pmesh.nverts >= 0xffff)
+			return nullptr;
+
+		// every poly left is walkable, area ids stay for the query filters
+		for (i32 i = 0; i < pmesh.npolys; i++)
+			pmesh.flags[i] = 1;
+
+		dtNavMeshCreateParams params;
+		memset(&params, 0, sizeof(params));
+		params.verts = pmesh.verts;
+		params.vertCount = pmesh.nverts;
+		params.polys = pmesh.polys;
+		params.polyAreas = pmesh.areas;
+		params.polyFlags = pmesh.flags;
+		params.polyCount = pmesh.npolys;
+		params.nvp = pmesh.nvp;
+		params.detailMeshes = scratch.m_dmesh->meshes;
+		params.detailVerts = scratch.m_dmesh->verts;
+		params.detailVertsCount = scratch.m_dmesh->nverts;
+		params.detailTris = scratch.m_dmesh->tris;
+		params.detailTriCount = scratch.m_dmesh->ntris;
+		params.walkableHeight = settings.m_agentHeight;
+		params.walkableRadius = settings.m_agentRadius;
+		params.walkableClimb = settings.m_agentMaxClimb;
+		params.tileX = job.m_x;
+		params.tileY = job.m_z;
+		params.tileLayer = 0;
+		rcVcopy(params.bmin, pmesh.bmin);
+		rcVcopy(params.bmax, pmesh.bmax);
+		params.cs = cfg.cs;
+		params.ch = cfg.ch;
+		params.buildBvTree = true;
+
+		unsigned char* data = nullptr;
+		if (!dtCreateNavMeshData(&params, &data, &dataSize))
+		{
+			dataSize = 0;
+			return nullptr;
+		}
+
+		return data;
+	}
+}
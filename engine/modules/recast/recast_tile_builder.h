@@ -0,0 +1,135 @@
+#pragma once
+
+#include <memory>
+#include "engine/core/geom/AABB.h"
+#include "engine/core/memory/MemAllocDef.h"
+
+namespace Echo
+{
+	// recast parameters, world units unless noted
+	struct RecastBuildSettings
+	{
+		float	m_cellSize = 0.3f;
+		float	m_cellHeight = 0.2f;
+		float	m_agentHeight = 2.f;
+		float	m_agentRadius = 0.6f;
+		float	m_agentMaxClimb = 0.9f;
+		float	m_agentMaxSlope = 45.f;			// degrees
+		i32		m_tileSize = 48;				// cells
+		i32		m_regionMinSize = 8;			// cells
+		i32		m_regionMergeSize = 20;			// cells
+		float	m_edgeMaxLen = 12.f;
+		float	m_edgeMaxError = 1.3f;			// cells
+		i32		m_vertsPerPoly = 6;
+		float	m_detailSampleDist = 6.f;		// cells
+		float	m_detailSampleMaxError = 1.f;	// cells
+
+		// cells of geometry around a tile that still affect it
+		i32 getBorderSize() const { return i32(std::ceil(m_agentRadius / m_cellSize)) + 3; }
+		float getTileWidth() const { return m_tileSize * m_cellSize; }
+	};
+
+	// world space input triangles bucketed by tile. immutable once built, so every tile job of
+	// a build generation shares one copy
+	class RecastNavGeometry
+	{
+	public:
+		RecastNavGeometry(const vector<float>::type& vertices, const vector<i32>::type& triangles, const RecastBuildSettings& settings);
+
+		// vertices and triangle indices
+		const vector<float>::type& getVertices() const { return m_vertices; }
+		const vector<i32>::type& getTriangles() const { return m_triangles; }
+
+		// tile grid
+		const Vector3& getMin() const { return m_min; }
+		const Vector3& getMax() const { return m_max; }
+		i32 getTilesX() const { return m_tilesX; }
+		i32 getTilesZ() const { return m_tilesZ; }
+		float getTileWidth() const { return m_tileWidth; }
+
+		// tile range overlapping a world box, false when outside the grid
+		bool getTileRange(const AABB& box, i32& minX, i32& minZ, i32& maxX, i32& maxZ) const;
+
+		// triangles touching a tile and its border
+		const vector<i32>::type& getTileTriangles(i32 x, i32 z) const { return m_tileTriangles[z * m_tilesX + x]; }
+
+	private:
+		vector<float>::type					m_vertices;
+		vector<i32>::type					m_triangles;
+		Vector3								m_min;
+		Vector3								m_max;
+		i32									m_tilesX = 0;
+		i32									m_tilesZ = 0;
+		float								m_tileWidth = 0.f;
+		vector<vector<i32>::type>::type		m_tileTriangles;
+	};
+	typedef std::shared_ptr<const RecastNavGeometry> RecastNavGeometryPtr;
+
+	// cylinder carved out of the navmesh
+	struct RecastNavObstacle
+	{
+		Vector3		m_position;		// bottom center
+		float		m_radius = 0.5f;
+		float		m_height = 2.f;
+	};
+
+	// convex prism marking its area id on the navmesh, area 0 is not walkable
+	struct RecastNavVolume
+	{
+		vector<Vector3>::type	m_points;		// xz outline, y is ignored
+		float					m_minY = 0.f;
+		float					m_maxY = 0.f;
+		ui8						m_area = 0;
+	};
+
+	// obstacles and volumes of one rebuild, shared by its tile jobs
+	struct RecastNavModifiers
+	{
+		vector<RecastNavObstacle>::type		m_obstacles;
+		vector<RecastNavVolume>::type		m_volumes;
+	};
+	typedef std::shared_ptr<const RecastNavModifiers> RecastNavModifiersPtr;
+
+	// queues navmesh tiles and builds a few per frame across the parallel workers, tiles are independent
+	class RecastTileBuilder
+	{
+	public:
+		struct Job
+		{
+			i32						m_x = 0;
+			i32						m_z = 0;
+			ui32					m_generation = 0;	// lets the owner drop results that were requested again
+			RecastBuildSettings		m_settings;
+			RecastNavGeometryPtr	m_geometry;
+			RecastNavModifiersPtr	m_modifiers;
+		};
+
+		struct Tile
+		{
+			i32				m_x = 0;
+			i32				m_z = 0;
+			ui32			m_generation = 0;
+			unsigned char*	m_data = nullptr;		// detour tile data, dtAlloc'ed, nullptr for an empty tile
+			i32				m_dataSize = 0;
+		};
+
+	public:
+		RecastTileBuilder() {}
+		~RecastTileBuilder() {}
+
+		// queue a tile
+		void request(const Job& job);
+
+		// build the newest jobs, one per core, and take their tiles. tile data belongs to the caller
+		void collect(vector<Tile>::type& tiles);
+
+		// drop queued jobs
+		void cancel();
+
+		// build one tile, thread safe
+		static unsigned char* BuildTile(const Job& job, i32& dataSize);
+
+	private:
+		vector<Job>::type		m_queue;
+	};
+}
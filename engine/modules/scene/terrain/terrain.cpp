@@ -8,6 +8,44 @@
 
 namespace Echo
 {
+	// frames a tile may stay unselected before its mesh is released
+	static const ui32 TileIdleFrames = 600;
+
+	// world space frustum planes of a row vector view projection matrix, inside is dot(plane, p) >= 0
+	static void ExtractFrustumPlanes(Vector4* planes, const Matrix4& viewProj)
+	{
+		const Real* m = viewProj.m;
+		for (i32 i = 0; i < 3; i++)
+		{
+			Vector4 column(m[i], m[4 + i], m[8 + i], m[12 + i]);
+			Vector4 w(m[3], m[7], m[11], m[15]);
+			planes[i * 2 + 0] = w + column;
+			planes[i * 2 + 1] = w - column;
+		}
+	}
+
+	// false when the box is completely outside one of the planes
+	static bool IsBoxInFrustum(const AABB& box, const Vector4* planes)
+	{
+		for (i32 i = 0; i < 6; i++)
+		{
+			const Vector4& plane = planes[i];
+			Vector3 farthest(plane.x >= 0.f ? box.vMax.x : box.vMin.x, plane.y >= 0.f ? box.vMax.y : box.vMin.y, plane.z >= 0.f ? box.vMax.z : box.vMin.z);
+			if (plane.x * farthest.x + plane.y * farthest.y + plane.z * farthest.z + plane.w < 0.f)
+				return false;
+		}
+
+		return true;
+	}
+
+	static float DistanceToBox(const Vector3& point, const AABB& box)
+	{
+		float dx = std::max<float>(std::max<float>(box.vMin.x - point.x, point.x - box.vMax.x), 0.f);
+		float dy = std::max<float>(std::max<float>(box.vMin.y - point.y, point.y - box.vMax.y), 0.f);
+		float dz = std::max<float>(std::max<float>(box.vMin.z - point.z, point.z - box.vMax.z), 0.f);
+		return std::sqrt(dx * dx + dy * dy + dz * dz);
+	}
+
     Terrain::Terrain()
     {
         setRenderType("3d");
@@ -28,18 +66,26 @@ namespace Echo
 		CLASS_BIND_METHOD(Terrain, setHeightRange,   DEF_METHOD("setHeightRange"));
 		CLASS_BIND_METHOD(Terrain, getGridSpacing,   DEF_METHOD("getGridSpacing"));
 		CLASS_BIND_METHOD(Terrain, setGridSpacing,   DEF_METHOD("setGridSpacing"));
+		CLASS_BIND_METHOD(Terrain, getLodDistance,   DEF_METHOD("getLodDistance"));
+		CLASS_BIND_METHOD(Terrain, setLodDistance,   DEF_METHOD("setLodDistance"));
+		CLASS_BIND_METHOD(Terrain, getHeightAt,      DEF_METHOD("getHeightAt"));
+		CLASS_BIND_METHOD(Terrain, getNormalAt,      DEF_METHOD("getNormalAt"));
+		CLASS_BIND_METHOD(Terrain, getRayHit,        DEF_METHOD("getRayHit"));
         CLASS_BIND_METHOD(Terrain, getMaterial,      DEF_METHOD("getMaterial"));
         CLASS_BIND_METHOD(Terrain, setMaterial,      DEF_METHOD("setMaterial"));
         
         CLASS_REGISTER_PROPERTY(Terrain, "Data", Variant::Type::ResourcePath, "getDataPath", "setDataPath");
 		CLASS_REGISTER_PROPERTY(Terrain, "HeightRange", Variant::Type::Real, "getHeightRange", "setHeightRange");
 		CLASS_REGISTER_PROPERTY(Terrain, "GridSpacing", Variant::Type::Int, "getGridSpacing", "setGridSpacing");
+		CLASS_REGISTER_PROPERTY(Terrain, "LodDistance", Variant::Type::Real, "getLodDistance", "setLodDistance");
         CLASS_REGISTER_PROPERTY(Terrain, "Material", Variant::Type::Object, "getMaterial", "setMaterial");
         CLASS_REGISTER_PROPERTY_HINT(Terrain, "Material", PropertyHintType::ResourceType, "Material");
     }
     
     void Terrain::setDataPath(const ResourcePath& path)
     {
+        // tiles may still be reading the images
+        clearRenderable();
         EchoSafeDelete(m_heightmapImage, Image);
         EchoSafeDeleteContainer(m_layerImages, Image);
 
@@ -88,6 +134,12 @@ namespace Echo
         m_isRenderableDirty = true;
 	}
 
+	void Terrain::setLodDistance(float distance)
+	{
+		// 0 would never split a tile, keep at least one tile width
+		m_lodDistance = std::max<float>(distance, 1.f);
+	}
+
     void Terrain::setMaterial( Object* material)
     {
         m_material = (Material*)material;
@@ -97,7 +149,7 @@ namespace Echo
     
     void Terrain::buildRenderable()
     {
-        if (m_isRenderableDirty && m_heightmapImage && m_columns > 0 && m_rows > 0)
+        if (m_isRenderableDirty && m_heightmapImage && m_columns > 1 && m_rows > 1)
         {
             clearRenderable();
             
@@ -110,12 +162,28 @@ namespace Echo
                 m_material = ECHO_CREATE_RES(Material);
                 m_material->setShaderPath(shader->getPath());
             }
-            
-            // mesh
-			updateMeshBuffer();
-            
-			// create renderable
-            m_renderable = Renderable::create(m_mesh, m_material, this);
+
+            buildHeights();
+
+            // smallest root that covers every cell
+            i32 rootLevel = 0;
+            while ((TerrainTile::GridQuads << rootLevel) < std::max<i32>(m_columns, m_rows) - 1)
+                rootLevel++;
+
+            m_rootTile = EchoNew(TerrainTile(this, rootLevel, 0, 0));
+            m_rootTile->computeBounds(*m_heightField);
+            m_localAABB = m_rootTile->getLocalBox();
+
+            m_leafColumns = (m_columns - 2) / TerrainTile::GridQuads + 1;
+            m_leafRows = (m_rows - 2) / TerrainTile::GridQuads + 1;
+            m_leafLevels.assign(m_leafColumns * m_leafRows, -1);
+
+            // the root is always drawable, finer tiles stream in over the next frames
+            m_rootTile->buildVertices();
+            m_rootTile->upload(m_material, this);
+
+            if (!m_tileBuilder)
+                m_tileBuilder = EchoNew(TerrainTileBuilder);
             
             m_isRenderableDirty = false;
         }
@@ -126,124 +194,317 @@ namespace Echo
         if (isNeedRender())
         {
             buildRenderable();
-            if (m_renderable)
-                m_renderable->submitToRenderQueue();
+            if (m_rootTile)
+            {
+                m_frame++;
+                uploadTiles();
+
+                // eye in terrain local space for lod, frustum planes in world space for culling
+                Vector3 eye = Vector3::ZERO;
+                Vector4 frustumPlanes[6];
+                Camera* camera = NodeTree::instance()->get3dCamera();
+                if (camera)
+                {
+                    Matrix4 invWorldMatrix;
+                    Matrix4::Inverse(invWorldMatrix, getWorldMatrix());
+                    eye = camera->getPosition() * invWorldMatrix;
+                    ExtractFrustumPlanes(frustumPlanes, camera->getViewProjMatrix());
+                }
+
+                m_selectedTiles.clear();
+                selectTiles(m_rootTile, eye, camera ? frustumPlanes : nullptr);
+                stitchTiles();
+
+                for (TerrainTile* tile : m_selectedTiles)
+                    tile->submit();
+
+                // release tiles the camera moved away from
+                if (m_frame % 64 == 0)
+                {
+                    m_rootTile->setLastUsedFrame(m_frame);
+                    m_rootTile->unloadUnused(m_frame, TileIdleFrames);
+                }
+            }
         }
     }
-    
-    void Terrain::buildMeshData(VertexArray& oVertices, IndiceArray& oIndices)
+
+    void Terrain::buildHeights()
+    {
+        TerrainHeightFieldPtr heightField = std::make_shared<TerrainHeightField>(m_columns, m_rows, float(m_gridSpacing));
+        float* heights = heightField->getHeights();
+
+        // common heightmap formats read the red channel directly
+        const Byte* data = m_heightmapImage->getData();
+        const i32 count = m_columns * m_rows;
+        switch (m_heightmapImage->getPixelFormat())
+        {
+        case PF_R8_UNORM:
+        case PF_RGB8_UNORM:
+        case PF_RGBA8_UNORM:
+        {
+            const i32 pixelSize = PixelUtil::GetPixelSize(m_heightmapImage->getPixelFormat());
+            for (i32 i = 0; i < count; i++)
+                heights[i] = (data[i * pixelSize] / 255.f * 2.f - 1.f) * m_heightRange;
+        }
+        break;
+        case PF_R16_UNORM:
+        {
+            const ui16* values = (const ui16*)data;
+            for (i32 i = 0; i < count; i++)
+                heights[i] = (values[i] / 65535.f * 2.f - 1.f) * m_heightRange;
+        }
+        break;
+        default:
+        {
+            for (i32 row = 0; row < m_rows; row++)
+            {
+                for (i32 column = 0; column < m_columns; column++)
+                    heights[row * m_columns + column] = (m_heightmapImage->getColor(column, row, 0).r * 2.f - 1.f) * m_heightRange;
+            }
+        }
+        break;
+        }
+
+        heightField->buildMips();
+
+        EE_LOCK_MUTEX(m_heightFieldMutex);
+        m_heightField = heightField;
+    }
+
+    void Terrain::selectTiles(TerrainTile* tile, const Vector3& eye, const Vector4* frustumPlanes)
     {
-        if(m_columns>0 && m_rows>0)
+        if (frustumPlanes && !IsBoxInFrustum(tile->getLocalBox().transform(getWorldMatrix()), frustumPlanes))
+            return;
+
+        tile->setLastUsedFrame(m_frame);
+        if (tile->getState() != TerrainTile::State::Ready)
         {
-            // vertex buffer
-			for (i32 row = 0; row < m_rows; row++)
+            if (tile->getState() == TerrainTile::State::Empty)
+                m_tileBuilder->request(tile);
+
+            return;
+        }
+
+        // split only when every child can be drawn, otherwise keep the parent until they are built
+        bool isSplit = false;
+        if (!tile->isLeaf() && DistanceToBox(eye, tile->getLocalBox()) < tile->getSize() * m_gridSpacing * m_lodDistance)
+        {
+            isSplit = true;
+            for (i32 i = 0; i < 4; i++)
             {
-				for (i32 column = 0; column < m_columns; column++)
+                TerrainTile* child = tile->getChild(i);
+                if (child)
                 {
-                    VertexFormat vert;
-                    vert.m_position = Vector3(row * m_gridSpacing, getHeight(row, column), column * m_gridSpacing);
-                    vert.m_uv = Vector2(row, column);
-                    vert.m_normal = getNormal(row, column);
-                    vert.m_layerIndices = Color(0, 1, 2, 3).getABGR();
-
-                    float weight = Math::IntervalRandom(0.f, 1.f);
-                    vert.m_layerWeights = Vector4(getWeight(row, column, 0), getWeight(row, column, 1), getWeight(row, column, 2), getWeight(row, column, 3));
-                    oVertices.emplace_back(vert);
+                    child->setLastUsedFrame(m_frame);
+                    if (child->getState() != TerrainTile::State::Ready)
+                    {
+                        if (child->getState() == TerrainTile::State::Empty)
+                            m_tileBuilder->request(child);
+
+                        isSplit = false;
+                    }
                 }
             }
-            
-            // index buffer
-			i32 rowLength = m_rows - 1;
-			i32 columnLength = m_columns - 1;
-			for (i32 row = 0; row < rowLength; row++)
-			{
-				for (i32 column = 0; column < columnLength; column++)
-                {
-                    i32 indexLeftTop = row * m_columns + column;
-                    i32 indexRightTop = indexLeftTop + 1;
-                    i32 indexLeftBottom = indexLeftTop + m_columns;
-                    i32 indexRightBottom = indexRightTop + m_columns;
-                    
-                    oIndices.emplace_back(indexLeftTop);
-                    oIndices.emplace_back(indexRightBottom);
-                    oIndices.emplace_back(indexRightTop);
-                    oIndices.emplace_back(indexLeftTop);
-                    oIndices.emplace_back(indexLeftBottom);
-                    oIndices.emplace_back(indexRightBottom);
-                }
+        }
+
+        if (isSplit)
+        {
+            for (i32 i = 0; i < 4; i++)
+            {
+                if (tile->getChild(i))
+                    selectTiles(tile->getChild(i), eye, frustumPlanes);
             }
         }
+        else
+        {
+            m_selectedTiles.emplace_back(tile);
+        }
     }
-    
-    void Terrain::updateMeshBuffer()
+
+    void Terrain::stitchTiles()
     {
-		// create mesh
-		if (!m_mesh) m_mesh = Mesh::create(true, true);
+        // rasterize selected levels into the leaf grid
+        std::fill(m_leafLevels.begin(), m_leafLevels.end(), -1);
+        for (TerrainTile* tile : m_selectedTiles)
+        {
+            i32 leafX = tile->getX() / TerrainTile::GridQuads;
+            i32 leafZ = tile->getZ() / TerrainTile::GridQuads;
+            i32 leafCount = 1 << tile->getLevel();
+            i32 endX = std::min<i32>(leafX + leafCount, m_leafColumns);
+            i32 endZ = std::min<i32>(leafZ + leafCount, m_leafRows);
+            for (i32 z = leafZ; z < endZ; z++)
+            {
+                for (i32 x = leafX; x < endX; x++)
+                    m_leafLevels[z * m_leafColumns + x] = i8(tile->getLevel());
+            }
+        }
 
-		// update data
-        VertexArray    vertices;
-        IndiceArray    indices;
-        buildMeshData(vertices, indices);
-        
-        MeshVertexFormat define;
-        define.m_isUseNormal = true;
-        define.m_isUseUV = true;
-        define.m_isUseBlendingData = true;
-        
-        m_mesh->updateIndices(static_cast<ui32>(indices.size()), sizeof(ui32), indices.data());
-        m_mesh->updateVertexs(define, static_cast<ui32>(vertices.size()), (const Byte*)vertices.data());
+        // an edge is stitched when the cells across it are drawn coarser. a coarser tile is aligned
+        // to its size, so it covers the whole edge and one level difference holds for every cell
+        for (TerrainTile* tile : m_selectedTiles)
+        {
+            i32 level = tile->getLevel();
+            i32 leafX = tile->getX() / TerrainTile::GridQuads;
+            i32 leafZ = tile->getZ() / TerrainTile::GridQuads;
+            i32 endX = std::min<i32>(leafX + (1 << level), m_leafColumns);
+            i32 endZ = std::min<i32>(leafZ + (1 << level), m_leafRows);
+
+            auto levelDiff = [&](i32 x, i32 z)
+            {
+                bool isInside = x >= 0 && z >= 0 && x < m_leafColumns && z < m_leafRows;
+                return isInside ? std::max<i32>(m_leafLevels[z * m_leafColumns + x] - level, 0) : 0;
+            };
+
+            i32 diffs[4] = { 0, 0, 0, 0 };
+            for (i32 x = leafX; x < endX; x++)
+            {
+                diffs[TerrainTile::EdgeNegZ] = std::max<i32>(diffs[TerrainTile::EdgeNegZ], levelDiff(x, leafZ - 1));
+                diffs[TerrainTile::EdgePosZ] = std::max<i32>(diffs[TerrainTile::EdgePosZ], levelDiff(x, endZ));
+            }
+
+            for (i32 z = leafZ; z < endZ; z++)
+            {
+                diffs[TerrainTile::EdgeNegX] = std::max<i32>(diffs[TerrainTile::EdgeNegX], levelDiff(leafX - 1, z));
+                diffs[TerrainTile::EdgePosX] = std::max<i32>(diffs[TerrainTile::EdgePosX], levelDiff(endX, z));
+            }
+
+            ui32 stitchKey = 0;
+            for (i32 edge = TerrainTile::EdgeNegZ; edge <= TerrainTile::EdgeNegX; edge++)
+                stitchKey |= TerrainTile::MakeStitch(TerrainTile::Edge(edge), diffs[edge]);
+
+            tile->setStitch(stitchKey);
+        }
+    }
 
-        m_localAABB = m_mesh->getLocalBox();
+    void Terrain::uploadTiles()
+    {
+        m_finishedTiles.clear();
+        m_tileBuilder->collect(m_finishedTiles);
+        for (TerrainTile* tile : m_finishedTiles)
+            tile->upload(m_material, this);
     }
     
     void Terrain::clear()
     {
         clearRenderable();
+        EchoSafeDelete(m_tileBuilder, TerrainTileBuilder);
     }
     
     void Terrain::clearRenderable()
     {
-        EchoSafeRelease(m_renderable);
-        m_mesh.reset();
+        // the builder must not hold on to tiles of the old tree
+        if (m_tileBuilder)
+            m_tileBuilder->cancel();
+
+        EchoSafeDelete(m_rootTile, TerrainTile);
+        m_selectedTiles.clear();
+        m_finishedTiles.clear();
+        m_leafLevels.clear();
     }
     
-    float Terrain::getHeight(i32 x, i32 z)
+    float Terrain::getHeight(i32 x, i32 z) const
     {
-        if(m_heightmapImage)
-        {
-            i32 column = Math::Clamp(x, 0, m_columns-1);
-            i32 row = Math::Clamp(z, 0, m_rows-1);
-            Color color = m_heightmapImage->getColor(column, row, 0);
-            float height = (color.r * 2.f - 1.f) * m_heightRange;
-            
-            return height;
-        }
-        
-        return 0.f;
+        // tiles read the field without the lock, they are only built inside update
+        return m_heightField ? m_heightField->getHeight(x, z) : 0.f;
     }
     
-    Vector3 Terrain::getNormal( i32 x, i32 z)
+    Vector3 Terrain::getNormal( i32 x, i32 z) const
+    {
+        return m_heightField ? m_heightField->getNormal(x, z) : Vector3::UNIT_Y;
+    }
+
+    float Terrain::getHeightAt(float x, float z)
+    {
+        Vector3 position(x, 0.f, z);
+        float height = 0.f;
+        getHeightsAt(&position, &height, 1);
+
+        return height;
+    }
+
+    Vector3 Terrain::getNormalAt(float x, float z)
     {
-        if(m_heightmapImage)
+        // readers on other threads hold their own reference while the field is replaced
+        TerrainHeightFieldPtr heightField = getHeightField();
+        if (heightField)
         {
-            float h0 = getHeight(   x,   z);
-            float h1 = getHeight( x+1,   z) - h0;
-            float h2 = getHeight(   x, z-1) - h0;
-            float h3 = getHeight( x-1,   z) - h0;
-            float h4 = getHeight(   x, z+1) - h0;
-            
-            Vector3 normal( h3 - h1, 2, h2 - h4);
+            Matrix4 invWorldMatrix;
+            Matrix4::Inverse(invWorldMatrix, getWorldMatrix());
+
+            Vector3 local = Vector3(x, 0.f, z) * invWorldMatrix;
+            Vector3 normal = getWorldMatrix().transformNormal(heightField->getNormalAt(local.x, local.z));
             normal.normalize();
-            
+
             return normal;
         }
 
         return Vector3::UNIT_Y;
     }
 
-    float Terrain::getWeight(i32 x, i32 z, i32 index)
+    void Terrain::getHeightsAt(const Vector3* positions, float* heights, ui32 count)
+    {
+        TerrainHeightFieldPtr heightField = getHeightField();
+        if (heightField)
+        {
+            const Matrix4& worldMatrix = getWorldMatrix();
+            Matrix4 invWorldMatrix;
+            Matrix4::Inverse(invWorldMatrix, worldMatrix);
+            for (ui32 i = 0; i < count; i++)
+            {
+                Vector3 local = Vector3(positions[i].x, 0.f, positions[i].z) * invWorldMatrix;
+                local.y = heightField->getHeightAt(local.x, local.z);
+                heights[i] = (local * worldMatrix).y;
+            }
+        }
+        else
+        {
+            for (ui32 i = 0; i < count; i++)
+                heights[i] = 0.f;
+        }
+    }
+
+    bool Terrain::raycast(const Ray& ray, float maxDistance, Ray::HitInfo& hitInfo)
+    {
+        TerrainHeightFieldPtr heightField = getHeightField();
+        if (heightField)
+        {
+            // an affine transform keeps the ray parameter
+            Matrix4 invWorldMatrix;
+            Matrix4::Inverse(invWorldMatrix, getWorldMatrix());
+            Ray localRay(ray.m_origin * invWorldMatrix, invWorldMatrix.transformNormal(ray.m_dir));
+
+            float distance = 0.f;
+            if (heightField->raycast(localRay, maxDistance, distance))
+            {
+                Vector3 local = localRay.getPoint(distance);
+                hitInfo.bHit = true;
+                hitInfo.hitPos = ray.getPoint(distance);
+                hitInfo.normal = getWorldMatrix().transformNormal(heightField->getNormalAt(local.x, local.z));
+                hitInfo.normal.normalize();
+
+                return true;
+            }
+        }
+
+        hitInfo.bHit = false;
+        return false;
+    }
+
+    Vector3 Terrain::getRayHit(const Vector3& origin, const Vector3& dir, float maxDistance)
+    {
+        Ray::HitInfo hitInfo;
+        return raycast(Ray(origin, dir), maxDistance, hitInfo) ? hitInfo.hitPos : Vector3::INVALID;
+    }
+
+    TerrainHeightFieldPtr Terrain::getHeightField()
+    {
+        EE_LOCK_MUTEX(m_heightFieldMutex);
+        return m_heightField;
+    }
+
+    float Terrain::getWeight(i32 x, i32 z, i32 index) const
     {
-        if (m_layerImages[index])
+        if (index < i32(m_layerImages.size()) && m_layerImages[index])
         {
 			i32 column = Math::Clamp(x, 0, m_columns - 1);
 			i32 row = Math::Clamp(z, 0, m_rows - 1);
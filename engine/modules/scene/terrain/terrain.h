@@ -5,7 +5,9 @@
 #include "engine/core/render/base/material.h"
 #include "engine/core/render/base/renderable.h"
 #include "engine/core/render/base/image/image.h"
+#include "engine/core/thread/Threading.h"
 #include "terrain_tile.h"
+#include "terrain_height_field.h"
 
 namespace Echo
 {
@@ -25,6 +27,7 @@ namespace Echo
         };
         typedef vector<VertexFormat>::type  VertexArray;
         typedef vector<ui32>::type          IndiceArray;
+        typedef vector<TerrainTile*>::type  TileArray;
         
     public:
         Terrain();
@@ -45,33 +48,58 @@ namespace Echo
 		// grid spacing
 		i32 getGridSpacing() const { return m_gridSpacing; }
 		void setGridSpacing(i32 gridSpacing);
+
+		// a tile splits into its children when the camera is closer than LodDistance tile widths
+		float getLodDistance() const { return m_lodDistance; }
+		void setLodDistance(float distance);
         
         // material
         Material* getMaterial() const { return m_material; }
         void setMaterial( Object* material);
         
-        // get height
-        float getHeight(i32 x, i32 z);
+        // get height of a grid sample
+        float getHeight(i32 x, i32 z) const;
         
-        // get normal
-        Vector3 getNormal(i32 x, i32 z);
+        // get normal of a grid sample
+        Vector3 getNormal(i32 x, i32 z) const;
+
+        // bilinear height and normal below a world position
+        float getHeightAt(float x, float z);
+        Vector3 getNormalAt(float x, float z);
+
+        // batched getHeightAt, only x and z of the positions are used
+        void getHeightsAt(const Vector3* positions, float* heights, ui32 count);
+
+        // nearest hit of a world space ray
+        bool raycast(const Ray& ray, float maxDistance, Ray::HitInfo& hitInfo);
+        Vector3 getRayHit(const Vector3& origin, const Vector3& dir, float maxDistance);
+
+        // current height field. world space queries above are for the main thread,
+        // worker threads keep this pointer and query in terrain local space
+        TerrainHeightFieldPtr getHeightField();
 
         // get weight
-        float getWeight(i32 x, i32 z, i32 index);
+        float getWeight(i32 x, i32 z, i32 index) const;
         
     protected:
-        // build drawable
+        // build drawable, rebuilds the tile quadtree
         void buildRenderable();
         void clearRenderable();
         
         // update
         virtual void update_self() override;
         
-        // update vertex buffer
-        void updateMeshBuffer();
-        
-        // build mesh data by drawables data
-        void buildMeshData(VertexArray& oVertices, IndiceArray& oIndices);
+        // decode heightmap into a new height field
+        void buildHeights();
+
+        // lod selection, tiles to draw end up in m_selectedTiles
+        void selectTiles(TerrainTile* tile, const Vector3& eye, const Vector4* frustumPlanes);
+
+        // match edges of selected tiles against coarser neighbors
+        void stitchTiles();
+
+        // upload tiles finished by the builder
+        void uploadTiles();
         
         // clear
         void clear();
@@ -83,11 +111,19 @@ namespace Echo
         vector<Image*>::type    m_layerImages;
 		float					m_heightRange = 256.f;
 		i32						m_gridSpacing = 1;
-        MeshPtr              m_mesh;
+		float					m_lodDistance = 2.f;
         MaterialPtr             m_material;
-        Renderable*             m_renderable = nullptr;
         i32                     m_columns = 0;
         i32                     m_rows = 0;
-		//TerrainTiles			m_tiles;
+		TerrainHeightFieldPtr	m_heightField;
+		Mutex					m_heightFieldMutex;
+		TerrainTile*			m_rootTile = nullptr;
+		TerrainTileBuilder*		m_tileBuilder = nullptr;
+		TileArray				m_selectedTiles;
+		TileArray				m_finishedTiles;
+		vector<i8>::type		m_leafLevels;			// selected level per leaf sized cell, -1 if nothing drawn there
+		i32						m_leafColumns = 0;
+		i32						m_leafRows = 0;
+		ui32					m_frame = 0;
     };
 }
@@ -0,0 +1,270 @@
+#include "terrain_height_field.h"
+
+namespace Echo
+{
+	// ray box slab test, the interval is clipped to [tMin, tMax]
+	static bool IntersectSlabs(const Vector3& origin, const Vector3& dir, const Vector3& boxMin, const Vector3& boxMax, float& tMin, float& tMax)
+	{
+		for (i32 axis = 0; axis < 3; axis++)
+		{
+			if (std::abs(dir[axis]) < 1e-12f)
+			{
+				if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis])
+					return false;
+			}
+			else
+			{
+				float invDir = 1.f / dir[axis];
+				float t0 = (boxMin[axis] - origin[axis]) * invDir;
+				float t1 = (boxMax[axis] - origin[axis]) * invDir;
+				if (t0 > t1)
+					std::swap(t0, t1);
+
+				tMin = std::max<float>(tMin, t0);
+				tMax = std::min<float>(tMax, t1);
+				if (tMin > tMax)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	// two sided moller trumbore
+	static bool IntersectTriangle(const Vector3& origin, const Vector3& dir, const Vector3& v0, const Vector3& v1, const Vector3& v2, float& t)
+	{
+		Vector3 edge1 = v1 - v0;
+		Vector3 edge2 = v2 - v0;
+		Vector3 p = dir.cross(edge2);
+		float det = edge1.dot(p);
+		if (std::abs(det) < 1e-12f)
+			return false;
+
+		float invDet = 1.f / det;
+		Vector3 s = origin - v0;
+		float u = s.dot(p) * invDet;
+		if (u < 0.f || u > 1.f)
+			return false;
+
+		Vector3 q = s.cross(edge1);
+		float v = dir.dot(q) * invDet;
+		if (v < 0.f || u + v > 1.f)
+			return false;
+
+		t = edge2.dot(q) * invDet;
+		return t >= 0.f;
+	}
+
+	TerrainHeightField::TerrainHeightField(i32 columns, i32 rows, float gridSpacing)
+		: m_columns(std::max<i32>(columns, 1))
+		, m_rows(std::max<i32>(rows, 1))
+		, m_gridSpacing(std::max<float>(gridSpacing, 1e-3f))
+	{
+		m_heights.resize(m_columns * m_rows, 0.f);
+	}
+
+	TerrainHeightField::~TerrainHeightField()
+	{
+	}
+
+	void TerrainHeightField::buildMips()
+	{
+		m_mips.clear();
+		m_mipColumns.clear();
+
+		// level 0, the four corners of every cell
+		i32 mipColumns = std::max<i32>(m_columns - 1, 1);
+		i32 mipRows = std::max<i32>(m_rows - 1, 1);
+		m_mips.emplace_back(vector<Bounds>::type(mipColumns * mipRows));
+		m_mipColumns.emplace_back(mipColumns);
+		for (i32 z = 0; z < mipRows; z++)
+		{
+			for (i32 x = 0; x < mipColumns; x++)
+			{
+				float h0 = getHeight(x, z);
+				float h1 = getHeight(x + 1, z);
+				float h2 = getHeight(x, z + 1);
+				float h3 = getHeight(x + 1, z + 1);
+
+				Bounds& bounds = m_mips[0][z * mipColumns + x];
+				bounds.m_min = std::min<float>(std::min<float>(h0, h1), std::min<float>(h2, h3));
+				bounds.m_max = std::max<float>(std::max<float>(h0, h1), std::max<float>(h2, h3));
+			}
+		}
+
+		// halve until one block covers everything
+		while (mipColumns > 1 || mipRows > 1)
+		{
+			i32 parentColumns = (mipColumns + 1) / 2;
+			i32 parentRows = (mipRows + 1) / 2;
+			vector<Bounds>::type parent(parentColumns * parentRows);
+			const vector<Bounds>::type& child = m_mips.back();
+			for (i32 z = 0; z < parentRows; z++)
+			{
+				for (i32 x = 0; x < parentColumns; x++)
+				{
+					Bounds bounds = { Math::MAX_REAL, -Math::MAX_REAL };
+					for (i32 i = 0; i < 4; i++)
+					{
+						i32 childX = x * 2 + (i & 1);
+						i32 childZ = z * 2 + (i >> 1);
+						if (childX < mipColumns && childZ < mipRows)
+						{
+							const Bounds& childBounds = child[childZ * mipColumns + childX];
+							bounds.m_min = std::min<float>(bounds.m_min, childBounds.m_min);
+							bounds.m_max = std::max<float>(bounds.m_max, childBounds.m_max);
+						}
+					}
+
+					parent[z * parentColumns + x] = bounds;
+				}
+			}
+
+			m_mips.emplace_back(std::move(parent));
+			m_mipColumns.emplace_back(parentColumns);
+			mipColumns = parentColumns;
+			mipRows = parentRows;
+		}
+	}
+
+	float TerrainHeightField::getHeight(i32 x, i32 z) const
+	{
+		i32 column = Math::Clamp(x, 0, m_columns - 1);
+		i32 row = Math::Clamp(z, 0, m_rows - 1);
+
+		return m_heights[row * m_columns + column];
+	}
+
+	Vector3 TerrainHeightField::getNormal(i32 x, i32 z) const
+	{
+		Vector3 normal(getHeight(x - 1, z) - getHeight(x + 1, z), 2.f * m_gridSpacing, getHeight(x, z - 1) - getHeight(x, z + 1));
+		normal.normalize();
+
+		return normal;
+	}
+
+	float TerrainHeightField::getHeightAt(float x, float z) const
+	{
+		float fx = Math::Clamp(x / m_gridSpacing, 0.f, float(m_columns - 1));
+		float fz = Math::Clamp(z / m_gridSpacing, 0.f, float(m_rows - 1));
+		i32 ix = std::max<i32>(std::min<i32>(i32(fx), m_columns - 2), 0);
+		i32 iz = std::max<i32>(std::min<i32>(i32(fz), m_rows - 2), 0);
+		float tx = fx - ix;
+		float tz = fz - iz;
+
+		float h00 = getHeight(ix, iz);
+		float h10 = getHeight(ix + 1, iz);
+		float h01 = getHeight(ix, iz + 1);
+		float h11 = getHeight(ix + 1, iz + 1);
+		float h0 = h00 + (h10 - h00) * tx;
+		float h1 = h01 + (h11 - h01) * tx;
+
+		return h0 + (h1 - h0) * tz;
+	}
+
+	Vector3 TerrainHeightField::getNormalAt(float x, float z) const
+	{
+		float s = m_gridSpacing;
+		Vector3 normal(getHeightAt(x - s, z) - getHeightAt(x + s, z), 2.f * s, getHeightAt(x, z - s) - getHeightAt(x, z + s));
+		normal.normalize();
+
+		return normal;
+	}
+
+	void TerrainHeightField::getHeightsAt(const Vector2* positions, float* heights, ui32 count) const
+	{
+		for (ui32 i = 0; i < count; i++)
+			heights[i] = getHeightAt(positions[i].x, positions[i].y);
+	}
+
+	void TerrainHeightField::getNormalsAt(const Vector2* positions, Vector3* normals, ui32 count) const
+	{
+		for (ui32 i = 0; i < count; i++)
+			normals[i] = getNormalAt(positions[i].x, positions[i].y);
+	}
+
+	TerrainHeightField::Bounds TerrainHeightField::getBounds(i32 level, i32 x, i32 z) const
+	{
+		if (m_mips.empty())
+			return Bounds{ 0.f, 0.f };
+
+		i32 mipLevel = Math::Clamp(level, 0, i32(m_mips.size()) - 1);
+		i32 mipColumns = m_mipColumns[mipLevel];
+		i32 mipRows = i32(m_mips[mipLevel].size()) / mipColumns;
+		i32 mipX = Math::Clamp(x >> mipLevel, 0, mipColumns - 1);
+		i32 mipZ = Math::Clamp(z >> mipLevel, 0, mipRows - 1);
+
+		return m_mips[mipLevel][mipZ * mipColumns + mipX];
+	}
+
+	bool TerrainHeightField::raycast(const Ray& ray, float maxDistance, float& distance) const
+	{
+		if (m_mips.empty())
+			return false;
+
+		// grid space, one unit per cell. t is unchanged by the scale
+		Vector3 origin(ray.m_origin.x / m_gridSpacing, ray.m_origin.y, ray.m_origin.z / m_gridSpacing);
+		Vector3 dir(ray.m_dir.x / m_gridSpacing, ray.m_dir.y, ray.m_dir.z / m_gridSpacing);
+
+		return raycastBlock(origin, dir, i32(m_mips.size()) - 1, 0, 0, 0.f, maxDistance, distance);
+	}
+
+	bool TerrainHeightField::raycastBlock(const Vector3& origin, const Vector3& dir, i32 level, i32 x, i32 z, float tMin, float tMax, float& distance) const
+	{
+		i32 mipColumns = m_mipColumns[level];
+		if (x >= mipColumns || z * mipColumns >= i32(m_mips[level].size()))
+			return false;
+
+		const Bounds& bounds = m_mips[level][z * mipColumns + x];
+		Vector3 boxMin(float(x << level), bounds.m_min, float(z << level));
+		Vector3 boxMax(float(std::min<i32>((x + 1) << level, m_columns - 1)), bounds.m_max, float(std::min<i32>((z + 1) << level, m_rows - 1)));
+		float t0 = tMin;
+		float t1 = tMax;
+		if (!IntersectSlabs(origin, dir, boxMin, boxMax, t0, t1))
+			return false;
+
+		if (level == 0)
+			return raycastCell(origin, dir, x, z, tMax, distance);
+
+		// the quadrant the ray starts in comes first and the opposite one last. a line can't
+		// cross both of the remaining two, so their order doesn't matter
+		i32 nearest = (dir.x < 0.f ? 1 : 0) | (dir.z < 0.f ? 2 : 0);
+		for (i32 i = 0; i < 4; i++)
+		{
+			i32 child = i ^ nearest;
+			if (raycastBlock(origin, dir, level - 1, x * 2 + (child & 1), z * 2 + (child >> 1), t0, t1, distance))
+				return true;
+		}
+
+		return false;
+	}
+
+	bool TerrainHeightField::raycastCell(const Vector3& origin, const Vector3& dir, i32 x, i32 z, float tMax, float& distance) const
+	{
+		// same diagonal as the rendered tiles
+		Vector3 leftTop(float(x), getHeight(x, z), float(z));
+		Vector3 leftBottom(float(x + 1), getHeight(x + 1, z), float(z));
+		Vector3 rightTop(float(x), getHeight(x, z + 1), float(z + 1));
+		Vector3 rightBottom(float(x + 1), getHeight(x + 1, z + 1), float(z + 1));
+
+		float t = 0.f;
+		float nearest = tMax;
+		bool isHit = false;
+		if (IntersectTriangle(origin, dir, leftTop, rightBottom, rightTop, t) && t <= nearest)
+		{
+			nearest = t;
+			isHit = true;
+		}
+
+		if (IntersectTriangle(origin, dir, leftTop, leftBottom, rightBottom, t) && t <= nearest)
+		{
+			nearest = t;
+			isHit = true;
+		}
+
+		if (isHit)
+			distance = nearest;
+
+		return isHit;
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include "engine/core/geom/Ray.h"
+
+namespace Echo
+{
+	// decoded heightmap in terrain local space. it is immutable once built, so any thread
+	// holding a TerrainHeightFieldPtr can query it while the terrain rebuilds a new one
+	class TerrainHeightField
+	{
+	public:
+		// height range of a block of cells
+		struct Bounds
+		{
+			float	m_min;
+			float	m_max;
+		};
+
+	public:
+		TerrainHeightField(i32 columns, i32 rows, float gridSpacing);
+		~TerrainHeightField();
+
+		// size
+		i32 getColumns() const { return m_columns; }
+		i32 getRows() const { return m_rows; }
+		float getGridSpacing() const { return m_gridSpacing; }
+
+		// row major samples, fill them then call buildMips
+		float* getHeights() { return m_heights.data(); }
+		void buildMips();
+
+		// grid sample, clamped to the border
+		float getHeight(i32 x, i32 z) const;
+		Vector3 getNormal(i32 x, i32 z) const;
+
+		// bilinear sample at local position
+		float getHeightAt(float x, float z) const;
+		Vector3 getNormalAt(float x, float z) const;
+
+		// batched samples, positions are local xz
+		void getHeightsAt(const Vector2* positions, float* heights, ui32 count) const;
+		void getNormalsAt(const Vector2* positions, Vector3* normals, ui32 count) const;
+
+		// height range of the 2^level cell block holding cell (x, z)
+		Bounds getBounds(i32 level, i32 x, i32 z) const;
+
+		// nearest hit against the rendered triangles, ray in local space
+		bool raycast(const Ray& ray, float maxDistance, float& distance) const;
+
+	private:
+		// walk the mips front to back
+		bool raycastBlock(const Vector3& origin, const Vector3& dir, i32 level, i32 x, i32 z, float tMin, float tMax, float& distance) const;
+
+		// the two triangles of cell (x, z)
+		bool raycastCell(const Vector3& origin, const Vector3& dir, i32 x, i32 z, float tMax, float& distance) const;
+
+	private:
+		i32									m_columns;
+		i32									m_rows;
+		float								m_gridSpacing;
+		vector<float>::type					m_heights;
+		vector<vector<Bounds>::type>::type	m_mips;			// level 0 is per cell
+		vector<i32>::type					m_mipColumns;
+	};
+	typedef std::shared_ptr<TerrainHeightField> TerrainHeightFieldPtr;
+}
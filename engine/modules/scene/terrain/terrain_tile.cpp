@@ -1,15 +1,228 @@
 #include "terrain.h"
 #include "terrain_tile.h"
+#include "engine/core/thread/pool/ParallelWorkers.h"
 
 namespace Echo
 {
-	TerrainTile::TerrainTile()
+	TerrainTile::TerrainTile(Terrain* terrain, i32 level, i32 x, i32 z)
+		: m_terrain(terrain)
+		, m_level(level)
+		, m_x(x)
+		, m_z(z)
 	{
-
+		if (level > 0)
+		{
+			i32 half = getSize() / 2;
+			for (i32 i = 0; i < 4; i++)
+			{
+				i32 childX = x + (i & 1) * half;
+				i32 childZ = z + (i >> 1) * half;
+				if (childX < terrain->getColumns() - 1 && childZ < terrain->getRows() - 1)
+					m_children[i] = EchoNew(TerrainTile(terrain, level - 1, childX, childZ));
+			}
+		}
 	}
 
 	TerrainTile::~TerrainTile()
 	{
+		unload();
+
+		for (TerrainTile*& child : m_children)
+			EchoSafeDelete(child, TerrainTile);
+	}
+
+	void TerrainTile::computeBounds(const TerrainHeightField& heightField)
+	{
+		// a tile covers exactly one block of the mip at its level
+		TerrainHeightField::Bounds bounds = heightField.getBounds(m_level + GridQuadsShift, m_x, m_z);
+		float spacing = heightField.getGridSpacing();
+		i32 endX = std::min<i32>(m_x + getSize(), heightField.getColumns() - 1);
+		i32 endZ = std::min<i32>(m_z + getSize(), heightField.getRows() - 1);
+		m_localBox = AABB(Vector3(m_x * spacing, bounds.m_min, m_z * spacing), Vector3(endX * spacing, bounds.m_max, endZ * spacing));
+
+		for (TerrainTile* child : m_children)
+		{
+			if (child)
+				child->computeBounds(heightField);
+		}
+	}
+
+	void TerrainTile::buildVertices()
+	{
+		const i32 step = 1 << m_level;
+		const i32 lastColumn = m_terrain->getColumns() - 1;
+		const i32 lastRow = m_terrain->getRows() - 1;
+		const float spacing = float(m_terrain->getGridSpacing());
+
+		m_vertices.resize(GridVertices * GridVertices * sizeof(Terrain::VertexFormat));
+		m_vertexBox.reset();
+
+		Terrain::VertexFormat* vertices = (Terrain::VertexFormat*)m_vertices.data();
+		for (i32 j = 0; j < GridVertices; j++)
+		{
+			// samples past the heightmap border clamp onto it and collapse into degenerate quads
+			i32 z = std::min<i32>(m_z + j * step, lastRow);
+			for (i32 i = 0; i < GridVertices; i++)
+			{
+				i32 x = std::min<i32>(m_x + i * step, lastColumn);
+
+				Terrain::VertexFormat& vert = vertices[j * GridVertices + i];
+				vert.m_position = Vector3(x * spacing, m_terrain->getHeight(x, z), z * spacing);
+				vert.m_uv = Vector2(float(x), float(z));
+				vert.m_normal = m_terrain->getNormal(x, z);
+				vert.m_layerIndices = Color(0, 1, 2, 3).getABGR();
+				vert.m_layerWeights = Vector4(m_terrain->getWeight(x, z, 0), m_terrain->getWeight(x, z, 1), m_terrain->getWeight(x, z, 2), m_terrain->getWeight(x, z, 3));
+
+				m_vertexBox.addPoint(vert.m_position);
+			}
+		}
+	}
+
+	void TerrainTile::upload(Material* material, Render* node)
+	{
+		if (!m_mesh)
+			m_mesh = Mesh::create(false, true);
+
+		MeshVertexFormat define;
+		define.m_isUseNormal = true;
+		define.m_isUseUV = true;
+		define.m_isUseBlendingData = true;
+		m_mesh->updateVertexs(define, GridVertices * GridVertices, m_vertices.data(), m_vertexBox);
+
+		// the mesh keeps its own copy
+		vector<Byte>::type().swap(m_vertices);
+
+		m_stitchKey = ~0u;
+		setStitch(0);
+
+		EchoSafeRelease(m_renderable);
+		m_renderable = Renderable::create(m_mesh, material, node);
+		m_state = State::Ready;
+	}
+
+	void TerrainTile::setStitch(ui32 stitchKey)
+	{
+		if (m_mesh && m_stitchKey != stitchKey)
+		{
+			const vector<ui32>::type& indices = GetIndices(stitchKey);
+			m_mesh->updateIndices(static_cast<ui32>(indices.size()), sizeof(ui32), indices.data());
+			m_stitchKey = stitchKey;
+		}
+	}
+
+	void TerrainTile::unload()
+	{
+		EchoSafeRelease(m_renderable);
+		m_mesh.reset();
+		vector<Byte>::type().swap(m_vertices);
+		m_stitchKey = ~0u;
+		m_state = State::Empty;
+	}
+
+	void TerrainTile::unloadUnused(ui32 frame, ui32 maxIdleFrames)
+	{
+		// tiles still waiting on the builder are owned by it until collected
+		if (m_state == State::Ready && frame - m_lastUsedFrame > maxIdleFrames)
+			unload();
+
+		for (TerrainTile* child : m_children)
+		{
+			if (child)
+				child->unloadUnused(frame, maxIdleFrames);
+		}
+	}
+
+	void TerrainTile::submit()
+	{
+		if (m_renderable)
+			m_renderable->submitToRenderQueue();
+	}
+
+	const vector<ui32>::type& TerrainTile::GetIndices(ui32 stitchKey)
+	{
+		// built on first use, only the level differences the camera produces get a table
+		static map<ui32, vector<ui32>::type>::type tables;
+
+		vector<ui32>::type& indices = tables[stitchKey];
+		if (indices.empty())
+		{
+			i32 collapseMasks[4];
+			for (i32 edge = EdgeNegZ; edge <= EdgeNegX; edge++)
+				collapseMasks[edge] = (1 << GetStitch(stitchKey, Edge(edge))) - 1;
+
+			auto vertexIndex = [&collapseMasks](i32 i, i32 j)
+			{
+				if (j == 0)				i &= ~collapseMasks[EdgeNegZ];
+				if (j == GridQuads)		i &= ~collapseMasks[EdgePosZ];
+				if (i == 0)				j &= ~collapseMasks[EdgeNegX];
+				if (i == GridQuads)		j &= ~collapseMasks[EdgePosX];
+
+				return ui32(j * GridVertices + i);
+			};
+
+			auto addTriangle = [&indices](ui32 a, ui32 b, ui32 c)
+			{
+				if (a != b && b != c && a != c)
+				{
+					indices.emplace_back(a);
+					indices.emplace_back(b);
+					indices.emplace_back(c);
+				}
+			};
+
+			indices.reserve(GridQuads * GridQuads * 6);
+			for (i32 j = 0; j < GridQuads; j++)
+			{
+				for (i32 i = 0; i < GridQuads; i++)
+				{
+					ui32 leftTop = vertexIndex(i, j);
+					ui32 rightTop = vertexIndex(i, j + 1);
+					ui32 leftBottom = vertexIndex(i + 1, j);
+					ui32 rightBottom = vertexIndex(i + 1, j + 1);
+
+					addTriangle(leftTop, rightBottom, rightTop);
+					addTriangle(leftTop, leftBottom, rightBottom);
+				}
+			}
+		}
+
+		return indices;
+	}
+
+	TerrainTileBuilder::~TerrainTileBuilder()
+	{
+		cancel();
+	}
+
+	void TerrainTileBuilder::request(TerrainTile* tile)
+	{
+		tile->setState(TerrainTile::State::Queued);
+		m_queue.emplace_back(tile);
+	}
+
+	void TerrainTileBuilder::collect(vector<TerrainTile*>::type& tiles)
+	{
+		// newest requests first, they are closest to what the camera sees now
+		ui32 count = std::min<ui32>(ui32(m_queue.size()), MaxBuildsPerFrame);
+		if (count)
+		{
+			TerrainTile** builds = m_queue.data() + m_queue.size() - count;
+			ParallelWorkers::instance()->parallelFor(count, 1, [builds](ui32 begin, ui32 end)
+			{
+				for (ui32 i = begin; i < end; i++)
+					builds[i]->buildVertices();
+			});
+
+			tiles.insert(tiles.end(), m_queue.rbegin(), m_queue.rbegin() + count);
+			m_queue.resize(m_queue.size() - count);
+		}
+	}
+
+	void TerrainTileBuilder::cancel()
+	{
+		for (TerrainTile* tile : m_queue)
+			tile->setState(TerrainTile::State::Empty);
 
+		m_queue.clear();
 	}
 }
@@ -1,16 +1,132 @@
 #pragma once
 
+#include "engine/core/geom/AABB.h"
+#include "engine/core/render/base/mesh/mesh.h"
+#include "engine/core/render/base/material.h"
+#include "engine/core/render/base/renderable.h"
+#include "terrain_height_field.h"
+
 namespace Echo
 {
 	class Terrain;
-    class TerrainTile
-    {
-    public:
-		TerrainTile();
+
+	// quadtree node of the terrain. every node draws the same grid resolution,
+	// deeper nodes cover less ground so they sample the heightmap more densely
+	class TerrainTile
+	{
+	public:
+		// quads per tile side
+		static const i32 GridQuadsShift = 5;
+		static const i32 GridQuads = 1 << GridQuadsShift;
+		static const i32 GridVertices = GridQuads + 1;
+
+		// tile edges. a stitch key holds StitchBits per edge with the level difference
+		// to the coarser neighbor across that edge, 0 when the neighbor isn't coarser
+		enum Edge
+		{
+			EdgeNegZ = 0,
+			EdgePosX,
+			EdgePosZ,
+			EdgeNegX,
+		};
+		static const ui32 StitchBits = 4;
+
+		// stitch key with the level difference across edge
+		static ui32 MakeStitch(Edge edge, i32 levelDiff) { return ui32(std::min<i32>(levelDiff, GridQuadsShift)) << (edge * StitchBits); }
+		static i32 GetStitch(ui32 stitchKey, Edge edge) { return i32((stitchKey >> (edge * StitchBits)) & ((1 << StitchBits) - 1)); }
+
+		// build state, only changed on the main thread
+		enum class State
+		{
+			Empty,
+			Queued,
+			Ready,
+		};
+
+	public:
+		TerrainTile(Terrain* terrain, i32 level, i32 x, i32 z);
 		~TerrainTile();
 
+		// coverage in heightmap cells, level 0 tiles are the finest
+		i32 getLevel() const { return m_level; }
+		i32 getX() const { return m_x; }
+		i32 getZ() const { return m_z; }
+		i32 getSize() const { return GridQuads << m_level; }
+
+		// children, null where the tile would be outside the heightmap
+		bool isLeaf() const { return m_level == 0; }
+		TerrainTile* getChild(i32 idx) const { return m_children[idx]; }
+
+		// bounds in terrain local space, read from the height field mips for the whole subtree
+		const AABB& getLocalBox() const { return m_localBox; }
+		void computeBounds(const TerrainHeightField& heightField);
+
+		// state
+		State getState() const { return m_state; }
+		void setState(State state) { m_state = state; }
+
+		// build vertex data, safe on worker threads
+		void buildVertices();
+
+		// upload vertex data and create the renderable, main thread
+		void upload(Material* material, Render* node);
+
+		// pick the shared index set for the neighbor lods
+		void setStitch(ui32 stitchKey);
+
+		// release mesh and renderable of this tile and its subtree
+		void unload();
+		void unloadUnused(ui32 frame, ui32 maxIdleFrames);
+
+		// submit to render queue
+		void submit();
+
+		// last frame the lod selection visited this tile
+		ui32 getLastUsedFrame() const { return m_lastUsedFrame; }
+		void setLastUsedFrame(ui32 frame) { m_lastUsedFrame = frame; }
+
+	public:
+		// indices for a GridVertices x GridVertices grid. vertices on a stitched edge are collapsed
+		// onto every (1 << levelDiff)th vertex so the edge matches a neighbor that many times coarser
+		static const vector<ui32>::type& GetIndices(ui32 stitchKey);
+
+	private:
+		Terrain*						m_terrain;
+		i32								m_level;
+		i32								m_x;
+		i32								m_z;
+		TerrainTile*					m_children[4] = { nullptr, nullptr, nullptr, nullptr };
+		AABB							m_localBox;
+		State							m_state = State::Empty;
+		ui32							m_stitchKey = ~0u;
+		ui32							m_lastUsedFrame = 0;
+		vector<Byte>::type				m_vertices;
+		AABB							m_vertexBox;
+		MeshPtr							m_mesh;
+		Renderable*						m_renderable = nullptr;
+	};
+
+	// queues tiles and builds a few of them per frame across the parallel workers
+	class TerrainTileBuilder
+	{
+	public:
+		// tiles built by one collect, the rest wait for later frames
+		static const ui32 MaxBuildsPerFrame = 16;
+
+	public:
+		TerrainTileBuilder() {}
+		~TerrainTileBuilder();
+
+		// queue tile, it must stay alive until collected or cancelled
+		void request(TerrainTile* tile);
+
+		// build the newest requests and move them into tiles, main thread
+		void collect(vector<TerrainTile*>::type& tiles);
+
+		// drop queued tiles
+		void cancel();
+
 	private:
-		//Terrain*	m_terrain;
-    };
-	typedef map<String, TerrainTile*> TerrainTiles;
+		vector<TerrainTile*>::type		m_queue;
+	};
 }
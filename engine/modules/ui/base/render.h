@@ -24,6 +24,9 @@ namespace Echo
 		// get global uniforms
 		virtual void* getGlobalUniformValue(const String& name) override;
 
+		// u_Alpha is per node
+		virtual bool hasPerDrawUniforms() override { return true; }
+
 	protected:
 		float					m_alpha = 1.f;
 	};
@@ -0,0 +1,69 @@
+#include <thread>
+#include <unordered_set>
+#include <gtest/gtest.h>
+#include <engine/core/base/object_registry.h>
+
+using namespace Echo;
+
+TEST(ObjectRegistry, staleHandles)
+{
+	ObjectRegistry* registry = ObjectRegistry::instance();
+	ui32 count = registry->getCount();
+
+	// the registry never dereferences objects, any address will do
+	Object* obj = (Object*)registry;
+	ObjectHandle handle = registry->add(obj);
+	EXPECT_GT(handle, 0);
+	EXPECT_EQ(registry->get(handle), obj);
+	EXPECT_EQ(registry->getCount(), count + 1);
+
+	registry->remove(handle);
+	EXPECT_EQ(registry->get(handle), nullptr);
+	EXPECT_EQ(registry->getCount(), count);
+	EXPECT_EQ(registry->get(0), nullptr);
+	EXPECT_EQ(registry->get(-1), nullptr);
+
+	// churn until slots get reused, old handles stay stale
+	std::unordered_set<ObjectHandle> handles = { handle };
+	for (ui32 i = 0; i < ObjectRegistry::MinFreeSlots * 3; i++)
+	{
+		ObjectHandle newHandle = registry->add(obj);
+		EXPECT_TRUE(handles.insert(newHandle).second);
+		registry->remove(newHandle);
+	}
+
+	for (ObjectHandle oldHandle : handles)
+		EXPECT_EQ(registry->get(oldHandle), nullptr);
+}
+
+TEST(ObjectRegistry, threadedAdd)
+{
+	ObjectRegistry* registry = ObjectRegistry::instance();
+	const ui32 threadCount = 4;
+	const ui32 perThread = 2000;
+
+	vector<ObjectHandle>::type handles[threadCount];
+	vector<std::thread>::type threads;
+	for (ui32 t = 0; t < threadCount; t++)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for (ui32 i = 0; i < perThread; i++)
+				handles[t].push_back(registry->add((Object*)&handles[t]));
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	std::unordered_set<ObjectHandle> unique;
+	for (ui32 t = 0; t < threadCount; t++)
+	{
+		for (ObjectHandle handle : handles[t])
+		{
+			EXPECT_TRUE(unique.insert(handle).second);
+			EXPECT_EQ(registry->get(handle), (Object*)&handles[t]);
+			registry->remove(handle);
+		}
+	}
+}
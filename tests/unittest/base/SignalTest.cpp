@@ -0,0 +1,137 @@
+#include <thread>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <engine/core/base/signal.h>
+
+using namespace Echo;
+
+// counts how often it runs
+struct CountConnect : public Connect
+{
+	std::atomic<int>& m_count;
+
+	CountConnect(std::atomic<int>& count) : m_count(count) {}
+
+	virtual void emitSignal(const Variant** args, int argCount) override { m_count++; }
+};
+
+class TestSignal : public Signal
+{
+public:
+	TestSignal(DispatchMode mode) : Signal(nullptr) { setDispatchMode(mode); }
+
+	// the signal owns the connect
+	Connect* connectCount(std::atomic<int>& count)
+	{
+		if (!m_connects)
+			m_connects = new vector<Connect*>::type;
+
+		m_connects->push_back(EchoNew(CountConnect(count)));
+		return m_connects->back();
+	}
+};
+
+TEST(Signal, deferredDispatch)
+{
+	std::atomic<int> count(0);
+	TestSignal signal(Signal::DispatchMode::Deferred);
+	signal.connectCount(count);
+
+	// every emit runs at the flush, none inside emit
+	signal.emit();
+	signal.emit();
+	signal.emit();
+	EXPECT_EQ(0, count);
+
+	Signal::flushDeferred();
+	EXPECT_EQ(3, count);
+
+	Signal::flushDeferred();
+	EXPECT_EQ(3, count);
+
+	// immediate signals don't wait
+	signal.setDispatchMode(Signal::DispatchMode::Immediate);
+	signal.emit();
+	EXPECT_EQ(4, count);
+}
+
+TEST(Signal, coalescedPerTarget)
+{
+	std::atomic<int> countA(0);
+	std::atomic<int> countB(0);
+	std::atomic<int> countC(0);
+	TestSignal signal(Signal::DispatchMode::DeferredCoalesced);
+	signal.connectCount(countA);
+	signal.connectCount(countB);
+
+	// each target runs once per flush
+	signal.emit();
+	signal.emit();
+	Signal::flushDeferred();
+	EXPECT_EQ(1, countA);
+	EXPECT_EQ(1, countB);
+
+	// an emit reaches the targets connected when it was raised, a disconnected one isn't run
+	signal.emit();
+	signal.connectCount(countC);
+	signal.emit();
+	signal.disconnect((*signal.getConnects())[0]);
+	Signal::flushDeferred();
+	EXPECT_EQ(1, countA);
+	EXPECT_EQ(2, countB);
+	EXPECT_EQ(1, countC);
+
+	// the next frame coalesces again
+	signal.emit();
+	Signal::flushDeferred();
+	EXPECT_EQ(3, countB);
+	EXPECT_EQ(2, countC);
+}
+
+TEST(Signal, deletedBeforeFlush)
+{
+	std::atomic<int> count(0);
+	TestSignal* signal = new TestSignal(Signal::DispatchMode::Deferred);
+	signal->connectCount(count);
+	signal->emit();
+	delete signal;
+
+	Signal::flushDeferred();
+	EXPECT_EQ(0, count);
+}
+
+TEST(Signal, workerThreadEmit)
+{
+	std::atomic<int> deferredCount(0);
+	std::atomic<int> coalescedCount(0);
+	TestSignal deferred(Signal::DispatchMode::Deferred);
+	TestSignal coalesced(Signal::DispatchMode::DeferredCoalesced);
+	deferred.connectCount(deferredCount);
+	coalesced.connectCount(coalescedCount);
+
+	// connects only run on the flushing thread
+	const int threadCount = 4;
+	const int emits = 1000;
+	std::vector<std::thread> workers;
+	for (int i = 0; i < threadCount; i++)
+	{
+		workers.emplace_back([&]()
+		{
+			for (int j = 0; j < emits; j++)
+			{
+				deferred.emit();
+				coalesced.emit();
+			}
+		});
+	}
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	EXPECT_EQ(0, deferredCount);
+	EXPECT_EQ(0, coalescedCount);
+
+	Signal::flushDeferred();
+	EXPECT_EQ(threadCount * emits, deferredCount);
+	EXPECT_EQ(1, coalescedCount);
+}
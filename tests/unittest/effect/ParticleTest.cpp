@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <engine/modules/effect/particle/particle_group.h>
+
+using namespace Echo;
+
+TEST(Particle, spawn_and_kill)
+{
+	ParticleStreams streams;
+	streams.setCapacity(10);
+	EXPECT_EQ(streams.getCapacity(), 12u);
+
+	// spawning never goes past capacity
+	EXPECT_EQ(streams.spawn(8), 0u);
+	EXPECT_EQ(streams.spawn(8), 8u);
+	EXPECT_EQ(streams.getCount(), 12u);
+
+	float* age = streams.get(ParticleStreams::Age);
+	float* invLifetime = streams.get(ParticleStreams::InvLifetime);
+	float* size = streams.get(ParticleStreams::Size);
+	for (ui32 i = 0; i < streams.getCount(); i++)
+	{
+		age[i] = (i % 3 == 0) ? 2.f : 0.5f;
+		invLifetime[i] = 1.f;
+		size[i] = float(i);
+	}
+
+	// expired particles are replaced by the last live ones, the rest stay dense
+	streams.killExpired();
+	EXPECT_EQ(streams.getCount(), 8u);
+	for (ui32 i = 0; i < streams.getCount(); i++)
+	{
+		EXPECT_NE(int(size[i]) % 3, 0);
+		EXPECT_LT(age[i], 1.f);
+	}
+}
+
+TEST(Particle, simulate)
+{
+	ParticleGroup group;
+	group.getStreams().setCapacity(1000);
+	group.getEmitter().m_rate = 0.f;
+	group.getEmitter().m_speedMin = group.getEmitter().m_speedMax = 10.f;
+	group.getEmitter().m_spread = 0.f;
+	group.getEmitter().m_lifetimeMin = group.getEmitter().m_lifetimeMax = 1.f;
+
+	ParticleGravityModifier* gravity = EchoNew(ParticleGravityModifier);
+	gravity->m_acceleration = Vector3(0.f, -10.f, 0.f);
+	group.addModifier(gravity);
+
+	ParticleSizeOverLifeModifier* size = EchoNew(ParticleSizeOverLifeModifier);
+	size->m_start = 10.f;
+	size->m_end = 0.f;
+	group.addModifier(size);
+
+	EXPECT_EQ(group.getEmitter().burst(group.getStreams(), 5), 5u);
+
+	// velocity is updated before position
+	group.tick(0.25f);
+	const ParticleStreams& streams = group.getStreams();
+	for (ui32 i = 0; i < 5; i++)
+	{
+		EXPECT_NEAR(streams.get(ParticleStreams::VelocityY)[i], 7.5f, 1e-5f);
+		EXPECT_NEAR(streams.get(ParticleStreams::PositionY)[i], 1.875f, 1e-5f);
+		EXPECT_NEAR(streams.get(ParticleStreams::Size)[i], 10.f, 1e-5f);
+	}
+
+	group.tick(0.25f);
+	EXPECT_NEAR(streams.get(ParticleStreams::Size)[0], 7.5f, 1e-5f);
+
+	// all particles expire after one second
+	group.tick(0.6f);
+	EXPECT_EQ(group.getCount(), 0u);
+}
+
+TEST(Particle, large_group)
+{
+	const ui32 count = 100000;
+	ParticleGroup group;
+	group.getStreams().setCapacity(count);
+	group.getEmitter().m_rate = 0.f;
+	group.getEmitter().m_lifetimeMin = 100.f;
+	group.getEmitter().m_lifetimeMax = 200.f;
+	group.addModifier(EchoNew(ParticleGravityModifier));
+	group.addModifier(EchoNew(ParticleDragModifier));
+	group.addModifier(EchoNew(ParticleNoiseModifier));
+	group.addModifier(EchoNew(ParticleColorOverLifeModifier));
+	group.addModifier(EchoNew(ParticleSizeOverLifeModifier));
+	group.getEmitter().burst(group.getStreams(), count);
+
+	// large enough to be split across the workers
+	std::vector<ParticleGroup::Vertex> vertices(count * 4);
+	for (int i = 0; i < 20; i++)
+	{
+		group.tick(1.f / 60.f);
+		group.buildVertices(vertices.data());
+	}
+
+	EXPECT_EQ(group.getCount(), count);
+}
+
+// tick and vertex timing of 100k particles, run with --gtest_also_run_disabled_tests
+TEST(Particle, DISABLED_benchmark)
+{
+	const ui32 count = 100000;
+	ParticleGroup group;
+	group.getStreams().setCapacity(count);
+	group.getEmitter().m_rate = 0.f;
+	group.getEmitter().m_lifetimeMin = 100.f;
+	group.getEmitter().m_lifetimeMax = 200.f;
+	group.addModifier(EchoNew(ParticleGravityModifier));
+	group.addModifier(EchoNew(ParticleDragModifier));
+	group.addModifier(EchoNew(ParticleNoiseModifier));
+	group.addModifier(EchoNew(ParticleColorOverLifeModifier));
+	group.addModifier(EchoNew(ParticleSizeOverLifeModifier));
+	group.getEmitter().burst(group.getStreams(), count);
+
+	std::vector<ParticleGroup::Vertex> vertices(count * 4);
+	const int frames = 20;
+	auto begin = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < frames; i++)
+	{
+		group.tick(1.f / 60.f);
+		group.buildVertices(vertices.data());
+	}
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count() / frames;
+
+	EXPECT_EQ(group.getCount(), count);
+	printf("[ Particle ] %u particles, tick and vertices : %.3f ms per frame\n", count, ms);
+}
@@ -0,0 +1,137 @@
+#include <cmath>
+#include <random>
+#include <gtest/gtest.h>
+#include <engine/modules/hitproxy/hit_scene.h>
+
+using namespace Echo;
+
+static Matrix4 Translation(const Vector3& position)
+{
+	Matrix4 mat = Matrix4::IDENTITY;
+	mat.m30 = position.x;
+	mat.m31 = position.y;
+	mat.m32 = position.z;
+	return mat;
+}
+
+TEST(HitScene, triangleBvhMatchesBruteForce)
+{
+	// noisy grid surface
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> noise(-1.f, 1.f);
+	const ui32 size = 40;
+	vector<Vector3>::type positions;
+	vector<ui32>::type indices;
+	for (ui32 z = 0; z < size; z++)
+		for (ui32 x = 0; x < size; x++)
+			positions.emplace_back(float(x), noise(rng), float(z));
+
+	for (ui32 z = 0; z + 1 < size; z++)
+	{
+		for (ui32 x = 0; x + 1 < size; x++)
+		{
+			ui32 i = z * size + x;
+			indices.insert(indices.end(), { i, i + size, i + 1, i + 1, i + size, i + size + 1 });
+		}
+	}
+
+	HitTriangleBvh bvh;
+	bvh.build(positions.data(), ui32(positions.size()), indices.data(), ui32(indices.size()));
+	EXPECT_EQ(bvh.getTriangleCount(), ui32(indices.size() / 3));
+
+	std::uniform_real_distribution<float> coord(0.f, float(size));
+	for (i32 i = 0; i < 200; i++)
+	{
+		Vector3 origin(coord(rng), 5.f, coord(rng));
+		Vector3 dir(noise(rng), -1.f, noise(rng));
+
+		float expected = Math::MAX_REAL;
+		for (size_t j = 0; j < indices.size(); j += 3)
+		{
+			float t = 0.f;
+			if (HitShape::IntersectTriangle(origin, dir, positions[indices[j]], positions[indices[j + 1]], positions[indices[j + 2]], t))
+				expected = std::min<float>(expected, t);
+		}
+
+		float distance = 0.f;
+		i32 triangle = bvh.raycast(origin, dir, 100.f, distance);
+		EXPECT_EQ(triangle != -1, expected != Math::MAX_REAL);
+		if (triangle != -1)
+		{
+			EXPECT_NEAR(distance, expected, 1e-4f);
+		}
+
+		// closest point against every triangle
+		Vector3 point(coord(rng), noise(rng) * 3.f, coord(rng));
+		float nearestSqr = Math::MAX_REAL;
+		for (size_t j = 0; j < indices.size(); j += 3)
+			nearestSqr = std::min<float>(nearestSqr, (HitShape::ClosestPointOnTriangle(point, positions[indices[j]], positions[indices[j + 1]], positions[indices[j + 2]]) - point).lenSqr());
+
+		EXPECT_NEAR((bvh.closestPoint(point) - point).lenSqr(), nearestSqr, 1e-4f);
+	}
+}
+
+TEST(HitScene, queries)
+{
+	HitShapeSphere sphere(1.f);
+	HitShapeBox box(Vector3(1.f, 1.f, 1.f));
+	HitShapeCapsule capsule(0.5f, 1.f);
+	HitShapeCylinder cylinder(0.5f, 1.f);
+
+	HitScene scene;
+	scene.add(&sphere, Translation(Vector3(0.f, 0.f, -10.f)), 1, 1);
+	scene.add(&box, Translation(Vector3(0.f, 0.f, -20.f)), 2, 2);
+	scene.add(&capsule, Translation(Vector3(5.f, 0.f, 0.f)), 1, 3);
+	i32 cylinderHandle = scene.add(&cylinder, Translation(Vector3(-5.f, 0.f, 0.f)), 1, 4);
+
+	// closest hit and layer masks
+	HitScene::Hit hit;
+	EXPECT_TRUE(scene.raycast(Vector3::ZERO, Vector3::NEG_UNIT_Z, 100.f, HitScene::AllLayers, hit));
+	EXPECT_EQ(hit.m_userData, 1);
+	EXPECT_NEAR(hit.m_distance, 9.f, 1e-4f);
+	EXPECT_NEAR(hit.m_normal.z, 1.f, 1e-4f);
+
+	EXPECT_TRUE(scene.raycast(Vector3::ZERO, Vector3::NEG_UNIT_Z, 100.f, 2, hit));
+	EXPECT_EQ(hit.m_userData, 2);
+	EXPECT_NEAR(hit.m_distance, 19.f, 1e-4f);
+	EXPECT_FALSE(scene.raycast(Vector3::ZERO, Vector3::NEG_UNIT_Z, 5.f, HitScene::AllLayers, hit));
+
+	vector<HitScene::Hit>::type hits;
+	EXPECT_EQ(scene.raycastAll(Vector3::ZERO, Vector3::NEG_UNIT_Z, 100.f, HitScene::AllLayers, hits), 2u);
+	EXPECT_EQ(hits[0].m_userData, 1);
+	EXPECT_EQ(hits[1].m_userData, 2);
+
+	// capsule cap and cylinder cap from above
+	EXPECT_TRUE(scene.raycast(Vector3(5.f, 10.f, 0.f), Vector3::NEG_UNIT_Y, 100.f, HitScene::AllLayers, hit));
+	EXPECT_NEAR(hit.m_distance, 8.5f, 1e-4f);
+	EXPECT_TRUE(scene.raycast(Vector3(-5.2f, 10.f, 0.f), Vector3::NEG_UNIT_Y, 100.f, HitScene::AllLayers, hit));
+	EXPECT_NEAR(hit.m_distance, 9.f, 1e-4f);
+
+	// moved shapes are found at their new place
+	scene.move(cylinderHandle, Translation(Vector3(-5.f, 0.f, 50.f)));
+	EXPECT_FALSE(scene.raycast(Vector3(-5.f, 10.f, 0.f), Vector3::NEG_UNIT_Y, 100.f, HitScene::AllLayers, hit));
+
+	// overlaps
+	vector<i32>::type results;
+	EXPECT_EQ(scene.overlapSphere(Vector3(0.f, 0.f, -8.5f), 0.6f, HitScene::AllLayers, results), 1u);
+	EXPECT_EQ(scene.overlapSphere(Vector3(0.f, 0.f, -8.5f), 0.4f, HitScene::AllLayers, results), 0u);
+	EXPECT_EQ(scene.overlapBox(AABB(Vector3(0.8f, 0.8f, -10.f), Vector3(2.f, 2.f, -9.f)), HitScene::AllLayers, results), 0u);
+	EXPECT_EQ(scene.overlapBox(AABB(Vector3(0.5f, 0.5f, -10.f), Vector3(2.f, 2.f, -9.f)), HitScene::AllLayers, results), 1u);
+
+	// sweep, the spheres touch when their centers are 1.5 apart
+	EXPECT_TRUE(scene.sweepSphere(Vector3::ZERO, 0.5f, Vector3::NEG_UNIT_Z, 100.f, 1, hit));
+	EXPECT_EQ(hit.m_userData, 1);
+	EXPECT_NEAR(hit.m_distance, 8.5f, 1e-3f);
+	EXPECT_FALSE(scene.sweepSphere(Vector3(0.f, 1.6f, 0.f), 0.5f, Vector3::NEG_UNIT_Z, 100.f, 1, hit));
+
+	// batch
+	HitScene::RayQuery queries[2];
+	queries[0].m_origin = Vector3::ZERO;
+	queries[0].m_dir = Vector3::NEG_UNIT_Z;
+	queries[1].m_origin = Vector3::ZERO;
+	queries[1].m_dir = Vector3::UNIT_Y;
+	HitScene::Hit batchHits[2];
+	scene.raycastBatch(queries, batchHits, 2);
+	EXPECT_EQ(batchHits[0].m_userData, 1);
+	EXPECT_EQ(batchHits[1].m_userData, -1);
+}
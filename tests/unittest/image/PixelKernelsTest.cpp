@@ -0,0 +1,176 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <gtest/gtest.h>
+#include <engine/core/render/base/image/pixel_kernels.h>
+#include <engine/core/render/base/image/image_resampler.h>
+
+using namespace Echo;
+
+namespace
+{
+	typedef std::vector<Byte> Bytes;
+
+	struct KernelOutputs
+	{
+		Bytes				m_swizzle;
+		Bytes				m_rgb;
+		Bytes				m_premultiplied;
+		Bytes				m_mip;
+		Bytes				m_scaled;
+		std::vector<float>	m_floats;
+	};
+
+	// odd sizes so every simd loop also runs its scalar tail
+	const ui32 Width = 515;
+	const ui32 Height = 259;
+	const ui32 ScaledWidth = 300;
+	const ui32 ScaledHeight = 701;
+
+	Bytes makeSource()
+	{
+		std::mt19937 rng(7);
+		Bytes result(Width * Height * 4);
+		for (Byte& value : result)
+			value = Byte(rng());
+
+		return result;
+	}
+
+	void runKernels(const Bytes& src, KernelOutputs& out)
+	{
+		const ui32 count = Width * Height;
+		out.m_swizzle.assign(count * 4, 0);
+		out.m_rgb.assign(count * 3, 0);
+		out.m_premultiplied.assign(count * 4, 0);
+		out.m_mip.assign((Width / 2) * (Height / 2) * 4, 0);
+		out.m_scaled.assign(ScaledWidth * ScaledHeight * 4, 0);
+		out.m_floats.assign(count * 4, 0.f);
+
+		PixelKernels::swizzleRB(src.data(), out.m_swizzle.data(), count);
+		PixelKernels::rgba8ToRgb8(src.data(), out.m_rgb.data(), count);
+		PixelKernels::rgba8ToFloat(src.data(), out.m_floats.data(), count);
+		PixelKernels::premultiplyAlpha(src.data(), out.m_premultiplied.data(), count);
+		PixelKernels::mipReduce(src.data(), Width, Height, out.m_mip.data());
+		PixelKernels::bilinearScale(src.data(), Width, Height, out.m_scaled.data(), ScaledWidth, ScaledHeight);
+	}
+
+	std::vector<PixelKernels::Isa> supportedIsas()
+	{
+		std::vector<PixelKernels::Isa> result;
+		for (PixelKernels::Isa isa : { PixelKernels::Isa::Scalar, PixelKernels::Isa::SSE2, PixelKernels::Isa::AVX2, PixelKernels::Isa::NEON })
+		{
+			PixelKernels::setIsa(isa);
+			if (PixelKernels::getIsa() == isa)
+				result.push_back(isa);
+		}
+
+		PixelKernels::setIsa(PixelKernels::getBestIsa());
+		return result;
+	}
+}
+
+TEST(PixelKernels, simd_matches_scalar)
+{
+	Bytes src = makeSource();
+
+	KernelOutputs reference;
+	PixelKernels::setIsa(PixelKernels::Isa::Scalar);
+	runKernels(src, reference);
+
+	for (PixelKernels::Isa isa : supportedIsas())
+	{
+		KernelOutputs result;
+		PixelKernels::setIsa(isa);
+		runKernels(src, result);
+
+		EXPECT_EQ(reference.m_swizzle, result.m_swizzle) << PixelKernels::getIsaName(isa);
+		EXPECT_EQ(reference.m_rgb, result.m_rgb) << PixelKernels::getIsaName(isa);
+		EXPECT_EQ(reference.m_floats, result.m_floats) << PixelKernels::getIsaName(isa);
+		EXPECT_EQ(reference.m_premultiplied, result.m_premultiplied) << PixelKernels::getIsaName(isa);
+		EXPECT_EQ(reference.m_mip, result.m_mip) << PixelKernels::getIsaName(isa);
+		EXPECT_EQ(reference.m_scaled, result.m_scaled) << PixelKernels::getIsaName(isa);
+	}
+
+	PixelKernels::setIsa(PixelKernels::getBestIsa());
+}
+
+TEST(PixelKernels, scalar_matches_reference)
+{
+	Bytes src = makeSource();
+
+	KernelOutputs result;
+	PixelKernels::setIsa(PixelKernels::Isa::Scalar);
+	runKernels(src, result);
+	PixelKernels::setIsa(PixelKernels::getBestIsa());
+
+	for (ui32 i = 0; i < Width * Height; i++)
+	{
+		const Byte* px = &src[i * 4];
+		EXPECT_EQ(px[2], result.m_swizzle[i * 4 + 0]);
+		EXPECT_EQ(px[0], result.m_swizzle[i * 4 + 2]);
+		EXPECT_EQ(px[1], result.m_rgb[i * 3 + 1]);
+		EXPECT_NEAR(px[3] / 255.f, result.m_floats[i * 4 + 3], 1e-6f);
+		EXPECT_EQ(px[3], result.m_premultiplied[i * 4 + 3]);
+		for (ui32 c = 0; c < 3; c++)
+			EXPECT_EQ(Byte(px[c] * px[3] / 255.0 + 0.5), result.m_premultiplied[i * 4 + c]);
+	}
+
+	// the generic resampler is the reference for bilinear scale, the kernel uses 7 bit weights
+	Bytes generic(ScaledWidth * ScaledHeight * 4);
+	PixelBox srcBox(Width, Height, 1, PF_RGBA8_UNORM, src.data());
+	PixelBox dstBox(ScaledWidth, ScaledHeight, 1, PF_RGBA8_UNORM, generic.data());
+	LinearResamplerByte<4>::Scale(srcBox, dstBox);
+	for (size_t i = 0; i < generic.size(); i++)
+		EXPECT_NEAR(int(generic[i]), int(result.m_scaled[i]), 4);
+
+	// exact box filter for mip levels, odd edge is clamped
+	for (ui32 y = 0; y < Height / 2; y++)
+	{
+		for (ui32 x = 0; x < Width / 2; x++)
+		{
+			for (ui32 c = 0; c < 4; c++)
+			{
+				ui32 sum = src[((y * 2) * Width + x * 2) * 4 + c] + src[((y * 2) * Width + x * 2 + 1) * 4 + c] +
+						   src[((y * 2 + 1) * Width + x * 2) * 4 + c] + src[((y * 2 + 1) * Width + x * 2 + 1) * 4 + c];
+				EXPECT_EQ(Byte((sum + 2) / 4), result.m_mip[(y * (Width / 2) + x) * 4 + c]);
+			}
+		}
+	}
+}
+
+// timing per isa against the generic resampler, run with --gtest_also_run_disabled_tests
+TEST(PixelKernels, DISABLED_benchmark)
+{
+	Bytes src = makeSource();
+	const int iterations = 20;
+
+	// generic byte resampler, the path Image::Scale used before
+	Bytes generic(ScaledWidth * ScaledHeight * 4);
+	PixelBox srcBox(Width, Height, 1, PF_RGBA8_UNORM, src.data());
+	PixelBox dstBox(ScaledWidth, ScaledHeight, 1, PF_RGBA8_UNORM, generic.data());
+	auto begin = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < iterations; i++)
+		LinearResamplerByte<4>::Scale(srcBox, dstBox);
+	double genericMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count() / iterations;
+	printf("[ PixelKernels ] generic bilinear : %.3f ms\n", genericMs);
+
+	for (PixelKernels::Isa isa : supportedIsas())
+	{
+		KernelOutputs out;
+		PixelKernels::setIsa(isa);
+		begin = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; i++)
+			runKernels(src, out);
+		double allMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count() / iterations;
+
+		begin = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; i++)
+			PixelKernels::bilinearScale(src.data(), Width, Height, out.m_scaled.data(), ScaledWidth, ScaledHeight);
+		double scaleMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count() / iterations;
+
+		printf("[ PixelKernels ] %-6s all kernels : %.3f ms, bilinear : %.3f ms\n", PixelKernels::getIsaName(isa), allMs, scaleMs);
+	}
+
+	PixelKernels::setIsa(PixelKernels::getBestIsa());
+}
@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <engine/modules/light/light_cluster.h>
+
+using namespace Echo;
+
+// right handed look at, same layout as Camera::update
+static Matrix4 LookAt(const Vector3& eye, const Vector3& dir)
+{
+	Vector3 zAxis = -dir;
+	Vector3 xAxis = Vector3::UNIT_Y.cross(zAxis);	xAxis.normalize();
+	Vector3 yAxis = zAxis.cross(xAxis);				yAxis.normalize();
+	return Matrix4(
+		xAxis.x, yAxis.x, zAxis.x, 0.f,
+		xAxis.y, yAxis.y, zAxis.y, 0.f,
+		xAxis.z, yAxis.z, zAxis.z, 0.f,
+		-xAxis.dot(eye), -yAxis.dot(eye), -zAxis.dot(eye), 1.f);
+}
+
+static float Random(ui32& seed, float low, float high)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return low + (high - low) * float(seed >> 8) / float(1 << 24);
+}
+
+static vector<LightCluster::LightInfo>::type RandomLights(ui32 count, float extent, ui32 seed)
+{
+	vector<LightCluster::LightInfo>::type lights(count);
+	for (LightCluster::LightInfo& light : lights)
+	{
+		light.m_position = Vector3(Random(seed, -extent, extent), Random(seed, 0.f, 10.f), Random(seed, -extent, extent));
+		light.m_range = Random(seed, 1.f, 8.f);
+	}
+
+	return lights;
+}
+
+static float DistanceSqr(const Vector3& point, const AABB& box)
+{
+	float dx = std::max<float>(std::max<float>(box.vMin.x - point.x, point.x - box.vMax.x), 0.f);
+	float dy = std::max<float>(std::max<float>(box.vMin.y - point.y, point.y - box.vMax.y), 0.f);
+	float dz = std::max<float>(std::max<float>(box.vMin.z - point.z, point.z - box.vMax.z), 0.f);
+	return dx * dx + dy * dy + dz * dz;
+}
+
+TEST(LightCluster, binning)
+{
+	vector<LightCluster::LightInfo>::type lights = RandomLights(300, 60.f, 7);
+
+	LightCluster cluster;
+	Matrix4 view = LookAt(Vector3(0.f, 5.f, 40.f), Vector3(0.f, -0.1f, -1.f).normalizedCopy());
+	cluster.update(view, Math::PI_DIV4, 16.f / 9.f, 0.5f, 200.f, lights.data(), ui32(lights.size()));
+
+	// a froxel list never repeats a light and only holds lights that reach into the frustum
+	const vector<ui32>::type& ranges = cluster.getClusterRanges();
+	const vector<ui32>::type& indices = cluster.getLightIndices();
+	const vector<LightCluster::PackedLight>::type& packed = cluster.getPackedLights();
+	EXPECT_GT(packed.size(), 0u);
+	EXPECT_LT(packed.size(), lights.size());
+	for (ui32 c = 0; c < cluster.getClusterCount(); c++)
+	{
+		std::set<ui32> unique(indices.begin() + ranges[c * 2], indices.begin() + ranges[c * 2] + ranges[c * 2 + 1]);
+		EXPECT_EQ(unique.size(), ranges[c * 2 + 1]);
+	}
+
+	// a light is listed in the froxel holding its center
+	const Vector4& params = cluster.getClusterParams();
+	float tanHalfFovY = std::tan(Math::PI_DIV4 * 0.5f);
+	float tanHalfFovX = tanHalfFovY * 16.f / 9.f;
+	ui32 centered = 0;
+	for (ui32 l = 0; l < packed.size(); l++)
+	{
+		Vector3 center = Vector3(packed[l].m_positionRange.x, packed[l].m_positionRange.y, packed[l].m_positionRange.z) * view;
+		float depth = -center.z;
+		float ndcX = center.x / (depth * tanHalfFovX);
+		float ndcY = center.y / (depth * tanHalfFovY);
+		if (depth < 0.5f || depth > 200.f || std::abs(ndcX) >= 1.f || std::abs(ndcY) >= 1.f)
+			continue;
+
+		ui32 x = ui32((ndcX + 1.f) * 0.5f * params.x);
+		ui32 y = ui32((ndcY + 1.f) * 0.5f * params.y);
+		ui32 z = ui32(std::log(depth) * params.z + params.w);
+		ui32 c = (z * ui32(params.y) + y) * ui32(params.x) + x;
+		EXPECT_NE(std::find(indices.begin() + ranges[c * 2], indices.begin() + ranges[c * 2] + ranges[c * 2 + 1], l), indices.begin() + ranges[c * 2] + ranges[c * 2 + 1]);
+		centered++;
+	}
+	EXPECT_GT(centered, 10u);
+
+	// objects inside the frustum get exactly the lights whose sphere touches them
+	ui32 seed = 11;
+	ui32 gathered[256];
+	for (i32 i = 0; i < 200; i++)
+	{
+		Vector3 center(Random(seed, -5.f, 5.f), Random(seed, 2.f, 8.f), Random(seed, -20.f, 20.f));
+		AABB box(center - Vector3(0.5f, 0.5f, 0.5f), center + Vector3(0.5f, 0.5f, 0.5f));
+
+		std::set<ui32> expected;
+		for (ui32 l = 0; l < packed.size(); l++)
+		{
+			Vector3 position(packed[l].m_positionRange.x, packed[l].m_positionRange.y, packed[l].m_positionRange.z);
+			if (DistanceSqr(position, box) <= packed[l].m_positionRange.w * packed[l].m_positionRange.w)
+				expected.insert(l);
+		}
+
+		ui32 count = cluster.gatherLights(box, gathered, 256);
+		EXPECT_EQ(std::set<ui32>(gathered, gathered + count), expected);
+	}
+
+	// nothing behind the camera
+	AABB behind(Vector3(-1.f, 4.f, 60.f), Vector3(1.f, 6.f, 62.f));
+	EXPECT_EQ(cluster.gatherLights(behind, gathered, 256), 0u);
+}
+
+TEST(LightCluster, gather_capacity)
+{
+	// more lights touch the box than a draw can take, the list stops at the capacity
+	vector<LightCluster::LightInfo>::type lights = RandomLights(1000, 10.f, 3);
+	LightCluster cluster;
+	Matrix4 view = LookAt(Vector3(0.f, 20.f, 110.f), Vector3(0.f, -0.3f, -1.f).normalizedCopy());
+	cluster.update(view, Math::PI_DIV4, 16.f / 9.f, 0.5f, 300.f, lights.data(), ui32(lights.size()));
+
+	const ui32 capacity = 8;
+	ui32 gathered[capacity + 1] = { 0 };
+	gathered[capacity] = ~0u;
+	AABB box(Vector3(-2.f, 0.f, -2.f), Vector3(2.f, 4.f, 2.f));
+	ui32 count = cluster.gatherLights(box, gathered, capacity);
+	EXPECT_EQ(capacity, count);
+	EXPECT_EQ(~0u, gathered[capacity]);
+
+	for (ui32 i = 0; i < count; i++)
+	{
+		const Vector4& positionRange = cluster.getPackedLights()[gathered[i]].m_positionRange;
+		EXPECT_LE(DistanceSqr(Vector3(positionRange.x, positionRange.y, positionRange.z), box), positionRange.w * positionRange.w);
+	}
+}
+
+// timing of a 1k light scene, run with --gtest_also_run_disabled_tests
+TEST(LightCluster, DISABLED_benchmark)
+{
+	const ui32 lightCount = 1000;
+	const ui32 objectCount = 10000;
+	vector<LightCluster::LightInfo>::type lights = RandomLights(lightCount, 100.f, 3);
+
+	ui32 seed = 5;
+	vector<AABB>::type boxes(objectCount);
+	for (AABB& box : boxes)
+	{
+		Vector3 center(Random(seed, -100.f, 100.f), Random(seed, 0.f, 10.f), Random(seed, -100.f, 100.f));
+		box = AABB(center - Vector3(1.f, 1.f, 1.f), center + Vector3(1.f, 1.f, 1.f));
+	}
+
+	LightCluster cluster;
+	Matrix4 view = LookAt(Vector3(0.f, 20.f, 110.f), Vector3(0.f, -0.3f, -1.f).normalizedCopy());
+
+	const int frames = 20;
+	ui32 gathered[64];
+	ui32 assigned = 0;
+	double binMs = 0.0;
+	double gatherMs = 0.0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		auto begin = std::chrono::high_resolution_clock::now();
+		cluster.update(view, Math::PI_DIV4, 16.f / 9.f, 0.5f, 300.f, lights.data(), lightCount);
+		auto middle = std::chrono::high_resolution_clock::now();
+
+		assigned = 0;
+		for (const AABB& box : boxes)
+			assigned += cluster.gatherLights(box, gathered, 64);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		binMs += std::chrono::duration<double, std::milli>(middle - begin).count() / frames;
+		gatherMs += std::chrono::duration<double, std::milli>(end - middle).count() / frames;
+	}
+
+	EXPECT_GT(assigned, 0u);
+	printf("[ LightCluster ] %u lights, %u visible, %u froxel entries : %.3f ms per frame\n", lightCount, ui32(cluster.getPackedLights().size()), ui32(cluster.getLightIndices().size()), binMs);
+	printf("[ LightCluster ] %u objects, %u light assignments : %.3f ms per frame\n", objectCount, assigned, gatherMs);
+}
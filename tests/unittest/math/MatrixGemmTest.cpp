@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <gtest/gtest.h>
+#include <engine/core/math/matrix.h>
+
+using namespace Echo;
+
+namespace
+{
+	Matrix randomMatrix(int height, int width, std::mt19937& rng)
+	{
+		std::uniform_real_distribution<double> dist(-1.0, 1.0);
+		Matrix result(height, width);
+		for (int i = 0; i < result.getNumberElements(); i++)
+			result.data()[i] = dist(rng);
+
+		return result;
+	}
+
+	double element(const Matrix& m, bool transpose, int i, int j)
+	{
+		return transpose ? m[j][i] : m[i][j];
+	}
+
+	Matrix naiveGemm(const Matrix& a, bool transposeA, const Matrix& b, bool transposeB)
+	{
+		int m = transposeA ? a.getWidth() : a.getHeight();
+		int k = transposeA ? a.getHeight() : a.getWidth();
+		int n = transposeB ? b.getHeight() : b.getWidth();
+		Matrix result(m, n);
+		for (int i = 0; i < m; i++)
+		{
+			for (int j = 0; j < n; j++)
+			{
+				double sum = 0.0;
+				for (int h = 0; h < k; h++)
+					sum += element(a, transposeA, i, h) * element(b, transposeB, h, j);
+
+				result[i][j] = sum;
+			}
+		}
+
+		return result;
+	}
+}
+
+TEST(MatrixGemm, matches_naive)
+{
+	std::mt19937 rng(3);
+	const int shapes[][3] = { { 1, 7, 5 }, { 3, 300, 2 }, { 5, 3, 9 }, { 67, 33, 130 }, { 130, 270, 531 } };
+	for (const auto& shape : shapes)
+	{
+		int m = shape[0], k = shape[1], n = shape[2];
+		for (int flags = 0; flags < 4; flags++)
+		{
+			bool transposeA = (flags & 1) != 0;
+			bool transposeB = (flags & 2) != 0;
+			Matrix a = transposeA ? randomMatrix(k, m, rng) : randomMatrix(m, k, rng);
+			Matrix b = transposeB ? randomMatrix(n, k, rng) : randomMatrix(k, n, rng);
+
+			Matrix result;
+			Matrix::Gemm(result, a, transposeA, b, transposeB);
+			Matrix expected = naiveGemm(a, transposeA, b, transposeB);
+			ASSERT_EQ(expected.getHeight(), result.getHeight());
+			ASSERT_EQ(expected.getWidth(), result.getWidth());
+			for (int i = 0; i < expected.getNumberElements(); i++)
+				EXPECT_NEAR(expected.data()[i], result.data()[i], 1e-9);
+		}
+	}
+}
+
+TEST(MatrixGemm, dot_bias_activate)
+{
+	std::mt19937 rng(5);
+	Matrix input = randomMatrix(9, 6, rng);
+	Matrix weights = randomMatrix(6, 4, rng);
+	Matrix bias = randomMatrix(1, 4, rng);
+
+	Matrix output, preActivation;
+	Matrix::DotBiasActivate(output, &preActivation, input, weights, bias, [](Real x) { return x > 0.f ? x : 0.f; });
+
+	Matrix expected = input.dot(weights);
+	for (int i = 0; i < expected.getHeight(); i++)
+	{
+		for (int j = 0; j < expected.getWidth(); j++)
+		{
+			double z = expected[i][j] + bias[0][j];
+			EXPECT_NEAR(z, preActivation[i][j], 1e-9);
+			EXPECT_NEAR(z > 0.0 ? z : 0.0, output[i][j], 1e-6);
+		}
+	}
+}
+
+// naive against blocked timing, run with --gtest_also_run_disabled_tests
+TEST(MatrixGemm, DISABLED_benchmark)
+{
+	std::mt19937 rng(9);
+	const int size = 256;
+	Matrix a = randomMatrix(size, size, rng);
+	Matrix b = randomMatrix(size, size, rng);
+	Matrix result;
+
+	auto begin = std::chrono::high_resolution_clock::now();
+	Matrix expected = naiveGemm(a, false, b, false);
+	double naiveMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+
+	begin = std::chrono::high_resolution_clock::now();
+	Matrix::Gemm(result, a, false, b, false);
+	double gemmMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count();
+
+	printf("[ MatrixGemm ] %dx%d : naive %.3f ms, blocked %.3f ms\n", size, size, naiveMs, gemmMs);
+}
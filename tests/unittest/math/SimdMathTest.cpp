@@ -0,0 +1,236 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <engine/core/math/Transform.h>
+#include <engine/core/geom/AABB.h>
+
+using namespace Echo;
+
+namespace
+{
+	std::mt19937 g_rng(11);
+
+	Real randomReal(Real minValue = -10.f, Real maxValue = 10.f)
+	{
+		return std::uniform_real_distribution<Real>(minValue, maxValue)(g_rng);
+	}
+
+	Quaternion randomQuaternion()
+	{
+		Quaternion quat(randomReal(), randomReal(), randomReal(), randomReal());
+		quat.normalize();
+		return quat;
+	}
+
+	Transform randomTransform()
+	{
+		return Transform(Vector3(randomReal(), randomReal(), randomReal()), Vector3(randomReal(0.1f, 3.f), randomReal(0.1f, 3.f), randomReal(0.1f, 3.f)), randomQuaternion());
+	}
+
+	Matrix4 randomMatrix()
+	{
+		Matrix4 mat;
+		randomTransform().buildMatrix(mat);
+		return mat;
+	}
+
+	Matrix4 referenceMultiply(const Matrix4& a, const Matrix4& b)
+	{
+		Matrix4 result;
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+				result.m[i * 4 + j] = a.m[i * 4] * b.m[j] + a.m[i * 4 + 1] * b.m[4 + j] + a.m[i * 4 + 2] * b.m[8 + j] + a.m[i * 4 + 3] * b.m[12 + j];
+		}
+
+		return result;
+	}
+
+	AABB referenceTransform(const AABB& box, const Matrix4& mat)
+	{
+		AABB result;
+		for (int i = 0; i < 8; i++)
+		{
+			Vector3 corner((i & 1) ? box.vMax.x : box.vMin.x, (i & 2) ? box.vMax.y : box.vMin.y, (i & 4) ? box.vMax.z : box.vMin.z);
+			result.addPoint(corner * mat);
+		}
+
+		return result;
+	}
+
+	void expectNear(const Matrix4& a, const Matrix4& b, Real tolerance)
+	{
+		for (int i = 0; i < 16; i++)
+			EXPECT_NEAR(a.m[i], b.m[i], tolerance);
+	}
+
+	void expectNear(const Vector3& a, const Vector3& b, Real tolerance)
+	{
+		EXPECT_NEAR(a.x, b.x, tolerance);
+		EXPECT_NEAR(a.y, b.y, tolerance);
+		EXPECT_NEAR(a.z, b.z, tolerance);
+	}
+
+	template<typename Func> double measure(int iterations, Func func)
+	{
+		auto begin = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; i++)
+			func();
+
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - begin).count() / iterations;
+	}
+}
+
+TEST(SimdMath, matrix_multiply)
+{
+	for (int i = 0; i < 100; i++)
+	{
+		Matrix4 a = randomMatrix();
+		Matrix4 b = randomMatrix();
+		Matrix4 expected = referenceMultiply(a, b);
+		expectNear(a * b, expected, 1e-3f);
+
+		// in place
+		Matrix4 c = a;
+		c *= b;
+		expectNear(c, expected, 1e-3f);
+	}
+}
+
+TEST(SimdMath, quaternion_multiply)
+{
+	for (int i = 0; i < 100; i++)
+	{
+		Quaternion a = randomQuaternion();
+		Quaternion b = randomQuaternion();
+
+		// rotation composition must match the matrix product
+		Matrix4 matA, matB, matAB;
+		a.toMat4(matA);
+		b.toMat4(matB);
+		(a * b).toMat4(matAB);
+		expectNear(matAB, matB * matA, 1e-4f);
+
+		// operator *= keeps its original order, a *= b is b * a
+		Quaternion c = a;
+		c *= b;
+		Quaternion ba = b * a;
+		EXPECT_NEAR(c.x, ba.x, 1e-6f);
+		EXPECT_NEAR(c.y, ba.y, 1e-6f);
+		EXPECT_NEAR(c.z, ba.z, 1e-6f);
+		EXPECT_NEAR(c.w, ba.w, 1e-6f);
+	}
+}
+
+TEST(SimdMath, transform_build_matrix)
+{
+	for (int i = 0; i < 100; i++)
+	{
+		Transform transform = randomTransform();
+
+		Matrix4 scale, rotate, expected;
+		scale.makeScaling(transform.m_scale);
+		rotate.fromQuan(transform.m_quat);
+		expected = referenceMultiply(scale, rotate);
+		expected.translate(transform.m_pos);
+
+		Matrix4 mat;
+		transform.buildMatrix(mat);
+		expectNear(mat, expected, 1e-5f);
+	}
+}
+
+TEST(SimdMath, batches)
+{
+	const ui32 count = 257;
+	std::vector<Transform> transforms(count);
+	std::vector<Matrix4> a(count), b(count), results(count);
+	std::vector<Vector3> points(count), transformed(count);
+	std::vector<AABB> boxes(count), worldBoxes(count);
+	for (ui32 i = 0; i < count; i++)
+	{
+		transforms[i] = randomTransform();
+		a[i] = randomMatrix();
+		b[i] = randomMatrix();
+		points[i] = Vector3(randomReal(), randomReal(), randomReal());
+		boxes[i] = AABB(points[i], points[i] + Vector3(randomReal(0.f, 5.f), randomReal(0.f, 5.f), randomReal(0.f, 5.f)));
+	}
+	boxes[3].reset();
+
+	Transform::BuildMatrixBatch(results.data(), transforms.data(), count);
+	for (ui32 i = 0; i < count; i++)
+	{
+		Matrix4 expected;
+		transforms[i].buildMatrix(expected);
+		expectNear(results[i], expected, 0.f);
+	}
+
+	Matrix4::MultiplyBatch(results.data(), a.data(), b.data(), count);
+	for (ui32 i = 0; i < count; i++)
+		expectNear(results[i], referenceMultiply(a[i], b[i]), 1e-3f);
+
+	Matrix4::TransformVec3Batch(transformed.data(), points.data(), count, a[0]);
+	for (ui32 i = 0; i < count; i++)
+		expectNear(transformed[i], points[i] * a[0], 1e-4f);
+
+	// in place
+	Matrix4::TransformVec3Batch(points.data(), points.data(), count, a[0]);
+	for (ui32 i = 0; i < count; i++)
+		expectNear(points[i], transformed[i], 0.f);
+
+	AABB::TransformBatch(worldBoxes.data(), boxes.data(), a.data(), count);
+	for (ui32 i = 0; i < count; i++)
+	{
+		if (i == 3)
+		{
+			EXPECT_FALSE(worldBoxes[i].isValid());
+			continue;
+		}
+
+		AABB expected = referenceTransform(boxes[i], a[i]);
+		expectNear(worldBoxes[i].vMin, expected.vMin, 1e-3f);
+		expectNear(worldBoxes[i].vMax, expected.vMax, 1e-3f);
+		expectNear(boxes[i].transform(a[i]).vMin, expected.vMin, 1e-3f);
+	}
+}
+
+// scalar against batch timings, run with --gtest_also_run_disabled_tests
+TEST(SimdMath, DISABLED_benchmark)
+{
+	const ui32 count = 4096;
+	const int iterations = 50;
+	std::vector<Transform> transforms(count);
+	std::vector<Matrix4> a(count), b(count), results(count);
+	std::vector<Vector3> points(count), transformed(count);
+	std::vector<AABB> boxes(count), worldBoxes(count);
+	std::vector<Quaternion> quats(count), quatResults(count);
+	for (ui32 i = 0; i < count; i++)
+	{
+		transforms[i] = randomTransform();
+		a[i] = randomMatrix();
+		b[i] = randomMatrix();
+		quats[i] = randomQuaternion();
+		points[i] = Vector3(randomReal(), randomReal(), randomReal());
+		boxes[i] = AABB(points[i], points[i] + Vector3::ONE);
+	}
+
+	double referenceMs = measure(iterations, [&]() { for (ui32 i = 0; i < count; i++) results[i] = referenceMultiply(a[i], b[i]); });
+	double batchMs = measure(iterations, [&]() { Matrix4::MultiplyBatch(results.data(), a.data(), b.data(), count); });
+	printf("[ SimdMath ] matrix multiply x%u   : scalar %.3f ms, batch %.3f ms\n", count, referenceMs, batchMs);
+
+	referenceMs = measure(iterations, [&]() { for (ui32 i = 0; i < count; i++) Matrix4::TransformVec3(transformed[i], points[i], a[0]); });
+	batchMs = measure(iterations, [&]() { Matrix4::TransformVec3Batch(transformed.data(), points.data(), count, a[0]); });
+	printf("[ SimdMath ] transform point x%u   : scalar %.3f ms, batch %.3f ms\n", count, referenceMs, batchMs);
+
+	referenceMs = measure(iterations, [&]() { for (ui32 i = 0; i < count; i++) worldBoxes[i] = referenceTransform(boxes[i], a[i]); });
+	batchMs = measure(iterations, [&]() { AABB::TransformBatch(worldBoxes.data(), boxes.data(), a.data(), count); });
+	printf("[ SimdMath ] transform aabb x%u    : corners %.3f ms, batch %.3f ms\n", count, referenceMs, batchMs);
+
+	batchMs = measure(iterations, [&]() { Transform::BuildMatrixBatch(results.data(), transforms.data(), count); });
+	printf("[ SimdMath ] build matrix x%u      : %.3f ms\n", count, batchMs);
+
+	batchMs = measure(iterations, [&]() { for (ui32 i = 0; i < count; i++) quatResults[i] = quats[i] * quats[(i + 1) % count]; });
+	printf("[ SimdMath ] quaternion multiply x%u : %.3f ms\n", count, batchMs);
+}
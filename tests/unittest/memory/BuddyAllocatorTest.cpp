@@ -0,0 +1,81 @@
+#include <random>
+#include <gtest/gtest.h>
+#include <engine/core/memory/BuddyAllocator.h>
+
+using namespace Echo;
+
+TEST(BuddyAllocator, splitAndMerge)
+{
+	BuddyAllocator allocator(1024, 64);
+
+	ui32 a = allocator.allocate(100);
+	ui32 b = allocator.allocate(64);
+	ui32 c = allocator.allocate(300, 256);
+	EXPECT_EQ(a % 128, 0u);
+	EXPECT_EQ(c % 512, 0u);
+	EXPECT_NE(a, b);
+	EXPECT_EQ(allocator.getUsedSize(), 128u + 64u + 512u);
+
+	// 320 bytes are free but no block of 512 is left
+	EXPECT_EQ(allocator.allocate(512), BuddyAllocator::InvalidOffset);
+	EXPECT_EQ(allocator.allocate(2048), BuddyAllocator::InvalidOffset);
+	EXPECT_EQ(allocator.allocate(0), BuddyAllocator::InvalidOffset);
+
+	allocator.free(a);
+	allocator.free(b);
+	allocator.free(c);
+	EXPECT_TRUE(allocator.isEmpty());
+
+	// everything merged back into one block
+	EXPECT_EQ(allocator.allocate(1024), 0u);
+}
+
+TEST(BuddyAllocator, randomChurn)
+{
+	const ui32 size = 1 << 20;
+	BuddyAllocator allocator(size, 256);
+
+	struct Block { ui32 m_offset; ui32 m_size; };
+	vector<Block>::type blocks;
+	vector<ui8>::type used(size / 256, 0);
+
+	std::mt19937 rng(7);
+	for (ui32 i = 0; i < 20000; i++)
+	{
+		if (blocks.empty() || rng() % 3)
+		{
+			ui32 bytes = 1 + rng() % 20000;
+			ui32 offset = allocator.allocate(bytes, 256);
+			if (offset == BuddyAllocator::InvalidOffset)
+				continue;
+
+			// no overlap with live blocks
+			ASSERT_LE(offset + bytes, size);
+			for (ui32 j = offset / 256; j < (offset + bytes + 255) / 256; j++)
+			{
+				ASSERT_EQ(used[j], 0);
+				used[j] = 1;
+			}
+
+			blocks.push_back({ offset, bytes });
+		}
+		else
+		{
+			size_t index = rng() % blocks.size();
+			Block block = blocks[index];
+			blocks[index] = blocks.back();
+			blocks.pop_back();
+
+			for (ui32 j = block.m_offset / 256; j < (block.m_offset + block.m_size + 255) / 256; j++)
+				used[j] = 0;
+
+			allocator.free(block.m_offset);
+		}
+	}
+
+	for (Block& block : blocks)
+		allocator.free(block.m_offset);
+
+	EXPECT_TRUE(allocator.isEmpty());
+	EXPECT_EQ(allocator.allocate(size), 0u);
+}
@@ -0,0 +1,112 @@
+#include <array>
+#include <random>
+#include <gtest/gtest.h>
+#include <engine/core/render/base/mesh/mesh_optimizer.h>
+
+using namespace Echo;
+
+// gently curved grid, triangles shuffled
+static void BuildGrid(MeshVertexData& vertexData, vector<ui32>::type& indices, ui32 size)
+{
+	MeshVertexFormat format;
+	vertexData.set(format, size * size);
+	for (ui32 z = 0; z < size; z++)
+		for (ui32 x = 0; x < size; x++)
+			vertexData.setPosition(z * size + x, Vector3(float(x), std::sin(x * 0.05f) * std::cos(z * 0.05f), float(z)));
+
+	vector<ui32>::type triangles;
+	for (ui32 z = 0; z + 1 < size; z++)
+	{
+		for (ui32 x = 0; x + 1 < size; x++)
+		{
+			ui32 i = z * size + x;
+			triangles.push_back(i * 2);
+			triangles.push_back(i * 2 + 1);
+		}
+	}
+
+	std::mt19937 rng(5);
+	std::shuffle(triangles.begin(), triangles.end(), rng);
+	for (ui32 t : triangles)
+	{
+		ui32 i = t / 2;
+		if (t & 1)
+			indices.insert(indices.end(), { i + 1, i + size, i + size + 1 });
+		else
+			indices.insert(indices.end(), { i, i + size, i + 1 });
+	}
+}
+
+TEST(MeshOptimizer, vertexCacheAndFetch)
+{
+	MeshVertexData vertexData;
+	vector<ui32>::type indices;
+	BuildGrid(vertexData, indices, 40);
+
+	ui32 vertexCount = vertexData.getVertexCount();
+	float acmr = MeshOptimizer::calcAcmr(indices.data(), ui32(indices.size()), vertexCount);
+
+	vector<Vector3>::type triangles;
+	for (ui32 index : indices)
+		triangles.push_back(vertexData.getPosition(index));
+
+	MeshOptimizer::optimizeVertexCache(indices.data(), ui32(indices.size()), vertexCount);
+	float optimizedAcmr = MeshOptimizer::calcAcmr(indices.data(), ui32(indices.size()), vertexCount);
+	EXPECT_LT(optimizedAcmr, acmr * 0.5f);
+	EXPECT_LT(optimizedAcmr, 0.9f);
+
+	MeshOptimizer::optimizeOverdraw(indices.data(), ui32(indices.size()), vertexData);
+	MeshOptimizer::optimizeVertexFetch(vertexData, indices.data(), ui32(indices.size()));
+	EXPECT_EQ(vertexData.getVertexCount(), vertexCount);
+
+	// same triangle set, vertices in first use order
+	vector<Vector3>::type optimized;
+	ui32 maxIndex = 0;
+	for (ui32 index : indices)
+	{
+		EXPECT_LE(index, maxIndex);
+		maxIndex = std::max<ui32>(maxIndex, index + 1);
+		optimized.push_back(vertexData.getPosition(index));
+	}
+
+	auto sortTriangles = [](vector<Vector3>::type& points)
+	{
+		vector<std::array<float, 9>>::type result;
+		for (size_t i = 0; i < points.size(); i += 3)
+			result.push_back({ points[i].x, points[i].y, points[i].z, points[i + 1].x, points[i + 1].y, points[i + 1].z, points[i + 2].x, points[i + 2].y, points[i + 2].z });
+
+		std::sort(result.begin(), result.end());
+		return result;
+	};
+	EXPECT_TRUE(sortTriangles(triangles) == sortTriangles(optimized));
+}
+
+TEST(MeshOptimizer, simplify)
+{
+	MeshVertexData vertexData;
+	vector<ui32>::type indices;
+	BuildGrid(vertexData, indices, 40);
+
+	vector<ui32>::type result;
+	float error = MeshOptimizer::simplify(result, indices.data(), ui32(indices.size()), vertexData, ui32(indices.size() / 4), 0.05f);
+	EXPECT_LE(result.size(), indices.size() / 2);
+	EXPECT_LE(error, 0.05f);
+	EXPECT_EQ(result.size() % 3, 0u);
+
+	// borders are locked, so the covered area stays the same
+	auto area = [&vertexData](const vector<ui32>::type& list)
+	{
+		float total = 0.f;
+		for (size_t i = 0; i < list.size(); i += 3)
+		{
+			Vector3 p0 = vertexData.getPosition(list[i]);
+			Vector3 p1 = vertexData.getPosition(list[i + 1]);
+			Vector3 p2 = vertexData.getPosition(list[i + 2]);
+			Vector3 normal = (p1 - p0).cross(p2 - p0);
+			total += normal.y * 0.5f;
+		}
+
+		return total;
+	};
+	EXPECT_NEAR(area(result), area(indices), area(indices) * 1e-3f);
+}
@@ -0,0 +1,90 @@
+#include <random>
+#include <gtest/gtest.h>
+#include <engine/core/render/base/mesh/mesh_skinning.h>
+
+using namespace Echo;
+
+TEST(MeshSkinning, matchesScalarBlend)
+{
+	MeshVertexFormat format;
+	format.m_isUseNormal = true;
+	format.m_isUseUV = true;
+	format.m_isUseBlendingData = true;
+
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> coord(-5.f, 5.f);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+	std::uniform_int_distribution<ui32> jointIdx(0, 3);
+	std::uniform_int_distribution<ui32> anyJointIdx(0, 4);
+
+	// joint 4 is outside the palette and must be ignored, the first joint of a vertex is always valid
+	const ui32 jointCount = 4;
+	Matrix4 joints[jointCount];
+	for (ui32 j = 0; j < jointCount; j++)
+	{
+		Matrix4 rotation, scaling, translation;
+		Matrix4::RotateAxis(rotation, Vector3(unit(rng), unit(rng), unit(rng)).normalizedCopy(), unit(rng) * Math::PI);
+		scaling.makeScaling(1.f + j * 0.25f, 1.f + j * 0.25f, 1.f + j * 0.25f);
+		translation.makeTranslation(coord(rng), coord(rng), coord(rng));
+		joints[j] = scaling * rotation * translation;
+	}
+
+	const ui32 count = 200;
+	MeshVertexData vertexData;
+	vertexData.set(format, count);
+	for (ui32 i = 0; i < count; i++)
+	{
+		Vector4 weight(std::abs(unit(rng)), std::abs(unit(rng)), std::abs(unit(rng)), std::abs(unit(rng)));
+		weight /= weight.x + weight.y + weight.z + weight.w;
+
+		vertexData.setPosition(i, Vector3(coord(rng), coord(rng), coord(rng)));
+		vertexData.setNormal(i, Vector3(unit(rng), unit(rng), unit(rng)));
+		vertexData.setUV0(i, Vector2(unit(rng), unit(rng)));
+		vertexData.setJoint(i, jointIdx(rng) | (anyJointIdx(rng) << 8) | (anyJointIdx(rng) << 16) | (anyJointIdx(rng) << 24));
+		vertexData.setWeight(i, weight);
+	}
+
+	MeshVertexData skinned;
+	MeshSkinning::prepare(vertexData, skinned);
+	AABB box = MeshSkinning::skin(vertexData, joints, jointCount, skinned);
+
+	EXPECT_FALSE(skinned.isVertexUsage(VS_BLENDINDICES));
+	EXPECT_FALSE(skinned.isVertexUsage(VS_BLENDWEIGHTS));
+	EXPECT_EQ(count, skinned.getVertexCount());
+
+	for (ui32 i = 0; i < count; i++)
+	{
+		Dword packed = vertexData.getJoint(i);
+		Vector4 weight = vertexData.getWeight(i);
+		Vector3 position = vertexData.getPosition(i);
+		Vector3 normal = vertexData.getNormal(i);
+
+		Vector3 expectPosition = Vector3::ZERO;
+		Vector3 expectNormal = Vector3::ZERO;
+		for (ui32 k = 0; k < 4; k++)
+		{
+			ui32 joint = (packed >> (k * 8)) & 0xff;
+			if (joint < jointCount)
+			{
+				expectPosition += (position * joints[joint]) * weight.m[k];
+				expectNormal += joints[joint].transformNormal(normal) * weight.m[k];
+			}
+		}
+		expectNormal.normalize();
+
+		Vector3 skinnedPosition = skinned.getPosition(i);
+		EXPECT_NEAR(expectPosition.x, skinnedPosition.x, 1e-3f);
+		EXPECT_NEAR(expectPosition.y, skinnedPosition.y, 1e-3f);
+		EXPECT_NEAR(expectPosition.z, skinnedPosition.z, 1e-3f);
+		EXPECT_TRUE(box.vMin.x <= skinnedPosition.x && skinnedPosition.x <= box.vMax.x);
+		EXPECT_TRUE(box.vMin.y <= skinnedPosition.y && skinnedPosition.y <= box.vMax.y);
+		EXPECT_TRUE(box.vMin.z <= skinnedPosition.z && skinnedPosition.z <= box.vMax.z);
+
+		Vector3 skinnedNormal = skinned.getNormal(i);
+		EXPECT_GT(expectNormal.dot(skinnedNormal), 0.9999f);
+
+		Vector2 uv = skinned.getUV0(i);
+		EXPECT_EQ(vertexData.getUV0(i).x, uv.x);
+		EXPECT_EQ(vertexData.getUV0(i).y, uv.y);
+	}
+}
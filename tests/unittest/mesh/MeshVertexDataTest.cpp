@@ -0,0 +1,67 @@
+#include <random>
+#include <gtest/gtest.h>
+#include <engine/core/render/base/mesh/mesh_vertex_data.h>
+
+using namespace Echo;
+
+TEST(MeshVertexData, compactEncodings)
+{
+	MeshVertexFormat format;
+	format.m_isUseNormal = true;
+	format.m_isUseUV = true;
+
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> coord(-50.f, 50.f);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+	const ui32 count = 500;
+	MeshVertexData vertexData;
+	vertexData.set(format, count);
+	for (ui32 i = 0; i < count; i++)
+	{
+		vertexData.setPosition(i, Vector3(coord(rng), coord(rng) * 0.1f, coord(rng)));
+		vertexData.setNormal(i, Vector3(unit(rng), unit(rng), unit(rng)));
+		vertexData.setUV0(i, Vector2(unit(rng), unit(rng)));
+	}
+
+	MeshVertexData compact = vertexData;
+	MeshVertexFormat compactFormat = format;
+	compactFormat.useCompactEncodings();
+	compact.convert(compactFormat);
+	EXPECT_TRUE(compact.isQuantized());
+	EXPECT_EQ(vertexData.getVertexStride(), 32u);
+	EXPECT_EQ(compact.getVertexStride(), 16u);
+
+	// stored positions go back to local space through the dequantize matrix
+	Matrix4 dequantize = compact.getDequantizeMatrix();
+	const ui16* stored = (const ui16*)compact.getVertices();
+	Vector3 storedPosition(stored[0] / 65535.f, stored[1] / 65535.f, stored[2] / 65535.f);
+	EXPECT_NEAR(((storedPosition * dequantize) - compact.getPosition(0)).len(), 0.f, 1e-4f);
+
+	for (ui32 i = 0; i < count; i++)
+	{
+		Word index = Word(i);
+		EXPECT_NEAR((compact.getPosition(index) - vertexData.getPosition(index)).len(), 0.f, 100.f / 65535.f);
+		EXPECT_GT(compact.getNormal(index).dot(vertexData.getNormal(index)), 0.99999f);
+		EXPECT_NEAR((compact.getUV0(index) - vertexData.getUV0(index)).len(), 0.f, 1e-3f);
+	}
+}
+
+TEST(MeshVertexData, blendWeights)
+{
+	MeshVertexFormat format;
+	format.m_isUseBlendingData = true;
+	format.useCompactEncodings();
+
+	MeshVertexData vertexData;
+	vertexData.set(format, 1);
+	EXPECT_FALSE(vertexData.isQuantized());
+
+	// the bytes still sum to one after rounding
+	vertexData.setWeight(0, Vector4(0.333f, 0.333f, 0.334f, 0.f));
+	const Byte* weights = vertexData.getVertices() + vertexData.getFormat().m_boneWeightsOffset;
+	vertexData.setJoint(0, 0x03020100);
+	EXPECT_EQ(i32(weights[0]) + weights[1] + weights[2] + weights[3], 255);
+	EXPECT_NEAR(vertexData.getWeight(0).x, 0.333f, 1.f / 255.f);
+	EXPECT_EQ(vertexData.getJoint(0), 0x03020100u);
+}
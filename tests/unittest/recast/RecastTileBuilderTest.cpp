@@ -0,0 +1,161 @@
+#include <thread>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <engine/modules/recast/recast_tile_builder.h>
+#include "DetourAlloc.h"
+#include "DetourCommon.h"
+#include "DetourNavMesh.h"
+#include "DetourNavMeshQuery.h"
+
+using namespace Echo;
+
+// flat 42x42 ground split into quads
+static RecastNavGeometryPtr CreateGround(const RecastBuildSettings& settings)
+{
+	vector<float>::type vertices;
+	vector<i32>::type triangles;
+	const i32 size = 7;
+	for (i32 z = 0; z <= size; z++)
+		for (i32 x = 0; x <= size; x++)
+			vertices.insert(vertices.end(), { x * 6.f, 0.f, z * 6.f });
+
+	for (i32 z = 0; z < size; z++)
+	{
+		for (i32 x = 0; x < size; x++)
+		{
+			i32 i = z * (size + 1) + x;
+			triangles.insert(triangles.end(), { i, i + size + 1, i + 1, i + 1, i + size + 1, i + size + 2 });
+		}
+	}
+
+	return std::make_shared<RecastNavGeometry>(vertices, triangles, settings);
+}
+
+static dtNavMesh* CreateNavMesh(const RecastNavGeometry& geometry)
+{
+	dtNavMeshParams params;
+	memset(&params, 0, sizeof(params));
+	dtVcopy(params.orig, &geometry.getMin().x);
+	params.tileWidth = geometry.getTileWidth();
+	params.tileHeight = geometry.getTileWidth();
+	params.maxTiles = 64;
+	params.maxPolys = 1 << 16;
+
+	dtNavMesh* navMesh = dtAllocNavMesh();
+	navMesh->init(&params);
+	return navMesh;
+}
+
+static void AddTile(dtNavMesh* navMesh, i32 x, i32 z, unsigned char* data, i32 dataSize)
+{
+	dtTileRef ref = navMesh->getTileRefAt(x, z, 0);
+	if (ref)
+		navMesh->removeTile(ref, nullptr, nullptr);
+
+	if (data)
+		navMesh->addTile(data, dataSize, DT_TILE_FREE_DATA, 0, nullptr);
+}
+
+static i32 FindPath(dtNavMesh* navMesh, const Vector3& start, const Vector3& end, vector<Vector3>::type& path)
+{
+	dtNavMeshQuery* query = dtAllocNavMeshQuery();
+	query->init(navMesh, 2048);
+
+	dtQueryFilter filter;
+	const float halfExtents[3] = { 1.f, 2.f, 1.f };
+	dtPolyRef startRef = 0, endRef = 0;
+	float startPos[3], endPos[3];
+	query->findNearestPoly(&start.x, halfExtents, &filter, &startRef, startPos);
+	query->findNearestPoly(&end.x, halfExtents, &filter, &endRef, endPos);
+
+	dtPolyRef polys[256];
+	i32 polyCount = 0;
+	query->findPath(startRef, endRef, startPos, endPos, &filter, polys, &polyCount, 256);
+
+	float straight[256 * 3];
+	i32 straightCount = 0;
+	if (polyCount && polys[polyCount - 1] == endRef)
+		query->findStraightPath(startPos, endPos, polys, polyCount, straight, nullptr, nullptr, &straightCount, 256);
+
+	path.clear();
+	for (i32 i = 0; i < straightCount; i++)
+		path.emplace_back(straight[i * 3], straight[i * 3 + 1], straight[i * 3 + 2]);
+
+	dtFreeNavMeshQuery(query);
+	return straightCount;
+}
+
+TEST(RecastTileBuilder, buildTilesAndCarveObstacle)
+{
+	RecastBuildSettings settings;
+	RecastNavGeometryPtr geometry = CreateGround(settings);
+	EXPECT_EQ(geometry->getTilesX(), 3);
+	EXPECT_EQ(geometry->getTilesZ(), 3);
+
+	// every tile across the parallel workers, a few per collect
+	RecastTileBuilder builder;
+	RecastTileBuilder::Job job;
+	job.m_settings = settings;
+	job.m_geometry = geometry;
+	job.m_modifiers = std::make_shared<RecastNavModifiers>();
+	for (job.m_z = 0; job.m_z < 3; job.m_z++)
+		for (job.m_x = 0; job.m_x < 3; job.m_x++)
+			builder.request(job);
+
+	vector<RecastTileBuilder::Tile>::type tiles;
+	for (i32 i = 0; i < 10000 && tiles.size() < 9; i++)
+	{
+		builder.collect(tiles);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	ASSERT_EQ(tiles.size(), 9u);
+
+	dtNavMesh* navMesh = CreateNavMesh(*geometry);
+	for (RecastTileBuilder::Tile& tile : tiles)
+	{
+		EXPECT_TRUE(tile.m_data != nullptr);
+		AddTile(navMesh, tile.m_x, tile.m_z, tile.m_data, tile.m_dataSize);
+	}
+
+	// open ground walks straight across the tiles
+	Vector3 start(2.f, 0.f, 21.f);
+	Vector3 end(40.f, 0.f, 21.f);
+	vector<Vector3>::type path;
+	EXPECT_EQ(FindPath(navMesh, start, end, path), 2);
+
+	// an obstacle in the middle rebuilds only the tiles under it
+	RecastNavObstacle obstacle;
+	obstacle.m_position = Vector3(21.f, 0.f, 21.f);
+	obstacle.m_radius = 2.f;
+	std::shared_ptr<RecastNavModifiers> modifiers = std::make_shared<RecastNavModifiers>();
+	modifiers->m_obstacles.emplace_back(obstacle);
+	job.m_modifiers = modifiers;
+
+	i32 minX, minZ, maxX, maxZ;
+	float margin = obstacle.m_radius + settings.m_agentRadius + settings.getBorderSize() * settings.m_cellSize;
+	ASSERT_TRUE(geometry->getTileRange(AABB(obstacle.m_position - Vector3(margin, 0.f, margin), obstacle.m_position + Vector3(margin, 0.f, margin)), minX, minZ, maxX, maxZ));
+	EXPECT_EQ(minX, 1);
+	EXPECT_EQ(maxX, 1);
+	for (job.m_z = minZ; job.m_z <= maxZ; job.m_z++)
+	{
+		for (job.m_x = minX; job.m_x <= maxX; job.m_x++)
+		{
+			i32 dataSize = 0;
+			unsigned char* data = RecastTileBuilder::BuildTile(job, dataSize);
+			AddTile(navMesh, job.m_x, job.m_z, data, dataSize);
+		}
+	}
+
+	// the path bends around the carved cylinder
+	ASSERT_GT(FindPath(navMesh, start, end, path), 2);
+	for (size_t i = 0; i + 1 < path.size(); i++)
+	{
+		for (float t = 0.f; t <= 1.f; t += 0.05f)
+		{
+			Vector3 point = path[i] + (path[i + 1] - path[i]) * t;
+			EXPECT_GT(Vector3(point.x - 21.f, 0.f, point.z - 21.f).len(), obstacle.m_radius);
+		}
+	}
+
+	dtFreeNavMesh(navMesh);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <engine/core/render/base/pipeline/render_queue.h>
+#include <engine/core/scene/render_node.h>
+
+using namespace Echo;
+
+class InstanceTestRenderable : public Renderable
+{
+public:
+	InstanceTestRenderable(int identifier, Mesh* mesh, Material* material)
+		: Renderable(identifier)
+	{
+		m_mesh = mesh;
+		m_material = material;
+	}
+
+	virtual void setMesh(MeshPtr mesh) override { m_mesh = mesh; }
+};
+
+class PerDrawTestRender : public Render
+{
+public:
+	virtual bool hasPerDrawUniforms() override { return true; }
+};
+
+// draws the queue issues for renderables grouped the way RenderQueue::render does
+static ui32 countDraws(vector<Renderable*>::type& renderables)
+{
+	RenderQueue::sortByInstance(renderables);
+
+	ui32 draws = 0;
+	ui32 count = ui32(renderables.size());
+	for (ui32 i = 0; i < count; i += RenderQueue::getInstanceRun(&renderables[i], count - i))
+		draws++;
+
+	return draws;
+}
+
+TEST(RenderQueue, instancedDrawCount)
+{
+	Mesh tree, rock;
+	Material bark, stone;
+
+	// a forest of two props submitted interleaved, one draw each without instancing
+	const ui32 count = 64;
+	vector<InstanceTestRenderable*>::type props;
+	vector<Renderable*>::type renderables;
+	for (ui32 i = 0; i < count; i++)
+	{
+		props.emplace_back(i % 2 ? new InstanceTestRenderable(i, &tree, &bark) : new InstanceTestRenderable(i, &rock, &stone));
+		props.back()->setInstanceColor(Color(i / float(count), 1.f, 1.f, 1.f));
+		renderables.emplace_back(props.back());
+	}
+
+	EXPECT_EQ(2u, countDraws(renderables));
+
+	// lods of one mesh take separate draws
+	props[0]->setLod(1);
+	EXPECT_EQ(3u, countDraws(renderables));
+	props[0]->setLod(0);
+
+	// materials can opt out
+	stone.setInstancing(false);
+	EXPECT_EQ(1 + count / 2, countDraws(renderables));
+
+	for (InstanceTestRenderable* prop : props)
+		delete prop;
+}
+
+TEST(RenderQueue, perDrawUniformsBreakRuns)
+{
+	Mesh tree;
+	Material bark;
+	PerDrawTestRender lit;
+
+	const ui32 count = 8;
+	vector<InstanceTestRenderable*>::type props;
+	vector<Renderable*>::type renderables;
+	for (ui32 i = 0; i < count; i++)
+	{
+		props.emplace_back(new InstanceTestRenderable(i, &tree, &bark));
+		renderables.emplace_back(props.back());
+	}
+
+	EXPECT_EQ(1u, countDraws(renderables));
+
+	// a run binds the uniforms of its first renderable only
+	props[3]->setNode(&lit);
+	EXPECT_EQ(3u, countDraws(renderables));
+
+	for (InstanceTestRenderable* prop : props)
+		delete prop;
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <engine/core/render/base/render_state.h>
+#include <engine/core/render/base/renderer.h>
+
+using namespace Echo;
+
+TEST(RenderState, descHash)
+{
+	BlendState::BlendDesc blendA;
+	BlendState::BlendDesc blendB;
+	EXPECT_TRUE(blendA == blendB);
+	EXPECT_EQ(blendA.hash(), blendB.hash());
+
+	blendB.bBlendEnable = true;
+	blendB.srcBlend = BlendState::BF_SRC_ALPHA;
+	EXPECT_FALSE(blendA == blendB);
+	EXPECT_NE(blendA.hash(), blendB.hash());
+
+	DepthStencilState::DepthStencilDesc depthA;
+	DepthStencilState::DepthStencilDesc depthB;
+	depthB.bWriteDepth = false;
+	EXPECT_FALSE(depthA == depthB);
+	EXPECT_NE(depthA.hash(), depthB.hash());
+
+	RasterizerState::RasterizerDesc rasterA;
+	RasterizerState::RasterizerDesc rasterB;
+	EXPECT_EQ(rasterA.hash(), rasterB.hash());
+	rasterB.cullMode = RasterizerState::CULL_NONE;
+	EXPECT_FALSE(rasterA == rasterB);
+	EXPECT_NE(rasterA.hash(), rasterB.hash());
+
+	// every field takes part, not only the filters
+	SamplerState::SamplerDesc samplerA;
+	SamplerState::SamplerDesc samplerB;
+	samplerB.addrVMode = SamplerState::AM_CLAMP;
+	EXPECT_FALSE(samplerA == samplerB);
+	EXPECT_NE(samplerA.hash(), samplerB.hash());
+}
+
+
+// backends own the sampler constructor
+class RenderStateTestSampler : public SamplerState
+{
+public:
+	RenderStateTestSampler(const SamplerDesc& desc) : SamplerState(desc) {}
+};
+
+// interns states without a device, remembers one as current the way backends do
+class RenderStateTestRenderer : public Renderer
+{
+public:
+	virtual Type getType() override { return Type::OpenGLES; }
+	virtual bool initialize(const Settings& config) override { return true; }
+	virtual void setTexture(ui32 index, Texture* texture, bool needUpdate) override {}
+	virtual void scissor(ui32 left, ui32 top, ui32 width, ui32 height) override {}
+	virtual void endScissor() override {}
+	virtual void getDepthRange(Vector2& vec) override {}
+	virtual void convertMatOrho(Matrix4& mat, const Matrix4& matOrth, Real zn, Real zf) override {}
+	virtual void convertMatProj(Matrix4& mat, const Matrix4& matProj) override {}
+	virtual GPUBuffer* createVertexBuffer(Dword usage, const Buffer& buff) override { return nullptr; }
+	virtual GPUBuffer* createIndexBuffer(Dword usage, const Buffer& buff) override { return nullptr; }
+	virtual Texture* createTexture2D(const String& name) override { return nullptr; }
+	virtual TextureCube* createTextureCube(const String& name) override { return nullptr; }
+	virtual TextureRender* createTextureRender(const String& name) override { return nullptr; }
+	virtual ShaderProgram* createShaderProgram() override { return nullptr; }
+	virtual FrameBufferOffScreen* createFrameBufferOffScreen(ui32 width, ui32 height) override { return nullptr; }
+	virtual FrameBufferWindow* createFrameBufferWindow() override { return nullptr; }
+	virtual Renderable* createRenderable() override { return nullptr; }
+	virtual void onSize(int width, int height) override {}
+	virtual void draw(Renderable* renderable) override {}
+	virtual ui32 getWindowWidth() override { return 0; }
+	virtual ui32 getWindowHeight() override { return 0; }
+	virtual void getViewportReal(Viewport& pViewport) override {}
+	virtual bool present() override { return true; }
+
+public:
+	BlendState*	m_currentBlendState = nullptr;
+	ui32		m_destroyedStates = 0;
+
+protected:
+	virtual RasterizerState* createRasterizerState(const RasterizerState::RasterizerDesc& desc) override { return EchoNew(RasterizerState(desc)); }
+	virtual DepthStencilState* createDepthStencilState(const DepthStencilState::DepthStencilDesc& desc) override { return EchoNew(DepthStencilState(desc)); }
+	virtual BlendState* createBlendState(const BlendState::BlendDesc& desc) override { return EchoNew(BlendState(desc)); }
+	virtual MultisampleState* createMultisampleState() override { return EchoNew(MultisampleState); }
+	virtual SamplerState* createSamplerState(const SamplerState::SamplerDesc& desc) override { return EchoNew(RenderStateTestSampler(desc)); }
+
+	virtual void onRenderStateDestroyed(RenderState* state) override
+	{
+		m_destroyedStates++;
+		if (state == m_currentBlendState)
+			m_currentBlendState = nullptr;
+	}
+};
+
+TEST(RenderState, internAndRelease)
+{
+	RenderStateTestRenderer renderer;
+
+	// equal descs share one state
+	BlendState::BlendDesc opaque;
+	BlendState::BlendDesc alpha;
+	alpha.bBlendEnable = true;
+	alpha.srcBlend = BlendState::BF_SRC_ALPHA;
+
+	BlendState* opaqueA = renderer.getBlendState(opaque);
+	BlendState* opaqueB = renderer.getBlendState(opaque);
+	BlendState* alphaA = renderer.getBlendState(alpha);
+	EXPECT_EQ(opaqueA, opaqueB);
+	EXPECT_NE(opaqueA, alphaA);
+	EXPECT_NE(opaqueA->getId(), alphaA->getId());
+	EXPECT_NE(0u, opaqueA->getId());
+
+	// the state lives until its last reference is released
+	ui32 opaqueId = opaqueA->getId();
+	renderer.m_currentBlendState = opaqueA;
+	renderer.releaseRenderState(opaqueA);
+	EXPECT_EQ(0u, renderer.m_destroyedStates);
+	EXPECT_EQ(opaqueA, renderer.getBlendState(opaque));
+	renderer.releaseRenderState(opaqueA);
+	renderer.releaseRenderState(opaqueB);
+	EXPECT_EQ(1u, renderer.m_destroyedStates);
+	EXPECT_EQ(nullptr, renderer.m_currentBlendState);
+
+	// the next new state takes the released id
+	BlendState::BlendDesc additive = alpha;
+	additive.dstBlend = BlendState::BF_ONE;
+	BlendState* additiveA = renderer.getBlendState(additive);
+	EXPECT_EQ(opaqueId, additiveA->getId());
+
+	// ids are per state type
+	const SamplerState* sampler = renderer.getSamplerState(SamplerState::SamplerDesc());
+	EXPECT_EQ(1u, sampler->getId());
+
+	renderer.releaseRenderState(sampler);
+	renderer.releaseRenderState(additiveA);
+	renderer.releaseRenderState(alphaA);
+	EXPECT_EQ(4u, renderer.m_destroyedStates);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <engine/core/scene/node.h>
+#include <engine/core/scene/node_path.h>
+
+using namespace Echo;
+
+static void AddNamedChild(Node& parent, Node& child, const char* name)
+{
+	child.setName(name);
+	parent.addChild(&child);
+}
+
+TEST(NodeChildIndex, autoNaming)
+{
+	Node root;
+	Node a, b, c, d;
+	AddNamedChild(root, a, "box");
+	AddNamedChild(root, b, "box");
+	AddNamedChild(root, c, "box");
+	EXPECT_EQ("box", a.getName());
+	EXPECT_EQ("box2", b.getName());
+	EXPECT_EQ("box3", c.getName());
+
+	// a freed suffix is used again
+	b.remove();
+	AddNamedChild(root, d, "box");
+	EXPECT_EQ("box2", d.getName());
+	EXPECT_EQ(&d, root.getChild("box2"));
+
+	// suffixes skip names that are taken
+	Node e, f;
+	AddNamedChild(root, e, "box4");
+	AddNamedChild(root, f, "box");
+	EXPECT_EQ("box5", f.getName());
+}
+
+TEST(NodeChildIndex, rename)
+{
+	Node root;
+	Node a, b;
+	AddNamedChild(root, a, "light");
+	AddNamedChild(root, b, "camera");
+
+	a.setName("sun");
+	EXPECT_EQ(nullptr, root.getChild("light"));
+	EXPECT_EQ(&a, root.getChild("sun"));
+
+	// a duplicate name resolves to the remaining sibling
+	b.setName("sun");
+	EXPECT_EQ(&a, root.getChild("sun"));
+	a.setName("moon");
+	EXPECT_EQ(&b, root.getChild("sun"));
+	EXPECT_EQ(&a, root.getChild("moon"));
+}
+
+TEST(NodeChildIndex, reparentAndRemove)
+{
+	Node rootA, rootB;
+	Node child;
+	AddNamedChild(rootA, child, "player");
+	EXPECT_EQ(&child, rootA.getChild("player"));
+
+	child.setParent(&rootB);
+	EXPECT_EQ(nullptr, rootA.getChild("player"));
+	EXPECT_EQ(&child, rootB.getChild("player"));
+
+	child.remove();
+	EXPECT_EQ(nullptr, rootB.getChild("player"));
+}
+
+TEST(NodeChildIndex, nodePathCache)
+{
+	Node root;
+	Node level, player;
+	AddNamedChild(root, level, "level");
+	AddNamedChild(level, player, "player");
+
+	NodePath path("level/player");
+	EXPECT_EQ(&player, path.getNode(&root));
+	EXPECT_EQ(&player, path.getNode(&root));
+
+	// a rename invalidates the cached target
+	player.setName("hero");
+	EXPECT_EQ(nullptr, path.getNode(&root));
+	player.setName("player");
+	EXPECT_EQ(&player, path.getNode(&root));
+
+	// so does a reparent
+	player.setParent(&root);
+	EXPECT_EQ(nullptr, path.getNode(&root));
+	EXPECT_EQ(&player, NodePath("player").getNode(&root));
+
+	// and a remove
+	player.setParent(&level);
+	EXPECT_EQ(&player, path.getNode(&root));
+	player.remove();
+	EXPECT_EQ(nullptr, path.getNode(&root));
+}
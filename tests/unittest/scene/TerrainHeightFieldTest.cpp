@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <engine/modules/scene/terrain/terrain_height_field.h>
+
+using namespace Echo;
+
+// a bumpy field that is easy to evaluate at grid points
+static float TestHeight(i32 x, i32 z)
+{
+	return std::sin(x * 0.37f) * 8.f + std::cos(z * 0.21f) * 5.f + float((x * 7 + z * 13) % 5);
+}
+
+static TerrainHeightField* CreateTestField(i32 columns, i32 rows, float spacing)
+{
+	TerrainHeightField* heightField = new TerrainHeightField(columns, rows, spacing);
+	for (i32 z = 0; z < rows; z++)
+	{
+		for (i32 x = 0; x < columns; x++)
+			heightField->getHeights()[z * columns + x] = TestHeight(x, z);
+	}
+
+	heightField->buildMips();
+	return heightField;
+}
+
+TEST(TerrainHeightField, sample)
+{
+	TerrainHeightField* heightField = CreateTestField(37, 29, 2.f);
+
+	// grid points are exact, midpoints are the average of the corners
+	EXPECT_FLOAT_EQ(heightField->getHeightAt(10.f, 6.f), TestHeight(5, 3));
+	float center = (TestHeight(5, 3) + TestHeight(6, 3) + TestHeight(5, 4) + TestHeight(6, 4)) * 0.25f;
+	EXPECT_NEAR(heightField->getHeightAt(11.f, 7.f), center, 1e-4f);
+
+	// outside clamps to the border
+	EXPECT_FLOAT_EQ(heightField->getHeightAt(-50.f, 0.f), TestHeight(0, 0));
+	EXPECT_FLOAT_EQ(heightField->getHeightAt(1000.f, 1000.f), TestHeight(36, 28));
+
+	// every mip block bounds its cells
+	for (i32 level = 0; level < 7; level++)
+	{
+		for (i32 z = 0; z < 28; z++)
+		{
+			for (i32 x = 0; x < 36; x++)
+			{
+				TerrainHeightField::Bounds bounds = heightField->getBounds(level, x, z);
+				EXPECT_LE(bounds.m_min, TestHeight(x, z));
+				EXPECT_GE(bounds.m_max, TestHeight(x + 1, z + 1));
+			}
+		}
+	}
+
+	delete heightField;
+}
+
+// nearest hit over every triangle, same diagonal as the terrain tiles
+static bool BruteForceRaycast(const Ray& ray, i32 columns, i32 rows, float spacing, float& distance)
+{
+	bool isHit = false;
+	distance = 1e30f;
+	for (i32 z = 0; z < rows - 1; z++)
+	{
+		for (i32 x = 0; x < columns - 1; x++)
+		{
+			Vector3 v00(x * spacing, TestHeight(x, z), z * spacing);
+			Vector3 v10((x + 1) * spacing, TestHeight(x + 1, z), z * spacing);
+			Vector3 v01(x * spacing, TestHeight(x, z + 1), (z + 1) * spacing);
+			Vector3 v11((x + 1) * spacing, TestHeight(x + 1, z + 1), (z + 1) * spacing);
+			Triangle triangles[2] = { Triangle(v00, v11, v01), Triangle(v00, v10, v11) };
+			for (const Triangle& triangle : triangles)
+			{
+				Vector3 e1 = triangle.v1 - triangle.v0;
+				Vector3 e2 = triangle.v2 - triangle.v0;
+				Vector3 p = ray.m_dir.cross(e2);
+				float det = e1.dot(p);
+				if (std::abs(det) < 1e-12f)
+					continue;
+
+				Vector3 s = ray.m_origin - triangle.v0;
+				float u = s.dot(p) / det;
+				Vector3 q = s.cross(e1);
+				float v = ray.m_dir.dot(q) / det;
+				float t = e2.dot(q) / det;
+				if (u >= 0.f && v >= 0.f && u + v <= 1.f && t >= 0.f && t < distance)
+				{
+					distance = t;
+					isHit = true;
+				}
+			}
+		}
+	}
+
+	return isHit;
+}
+
+TEST(TerrainHeightField, raycast)
+{
+	TerrainHeightField* heightField = CreateTestField(65, 65, 1.5f);
+
+	// straight down lands on the bilinear height at grid points
+	float distance = 0.f;
+	EXPECT_TRUE(heightField->raycast(Ray(Vector3(12.f * 1.5f, 100.f, 20.f * 1.5f), Vector3(0.f, -1.f, 0.f)), 1000.f, distance));
+	EXPECT_NEAR(100.f - distance, TestHeight(12, 20), 1e-3f);
+
+	// too short, and pointing away
+	EXPECT_FALSE(heightField->raycast(Ray(Vector3(10.f, 100.f, 10.f), Vector3(0.f, -1.f, 0.f)), 10.f, distance));
+	EXPECT_FALSE(heightField->raycast(Ray(Vector3(10.f, 100.f, 10.f), Vector3(0.f, 1.f, 0.f)), 1000.f, distance));
+
+	// the mip walk finds the same nearest triangle as testing all of them
+	i32 hits = 0;
+	for (i32 i = 0; i < 64; i++)
+	{
+		Ray ray(Vector3(-5.f + i, 20.f, -3.f + (i % 7)), Vector3(1.f, -0.15f - (i % 5) * 0.02f, 0.6f + (i % 3) * 0.1f - (i % 2) * 1.4f));
+		float expected = 0.f;
+		bool isExpectedHit = BruteForceRaycast(ray, 65, 65, 1.5f, expected);
+		EXPECT_EQ(heightField->raycast(ray, 1000.f, distance), isExpectedHit);
+		if (isExpectedHit)
+		{
+			EXPECT_NEAR(distance, expected, 1e-3f);
+			hits++;
+		}
+	}
+	EXPECT_GT(hits, 16);
+
+	delete heightField;
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include <engine/core/render/base/glslcc/glsl_cross_compiler.h>
+#include <engine/core/render/base/glslcc/shader_cache.h>
+#include <engine/core/io/IO.h>
+#include <engine/core/util/PathUtil.h>
 
 // glsl vs for test
 static const char* glslVS =R"(#version 450
@@ -95,3 +98,37 @@ TEST(GLSLCrossCompiler, SPIRVToMSL)
     EXPECT_EQ(vs.empty(), false);
     EXPECT_EQ(fs.empty(), false);
 }
+
+// compiled once, read back from the user directory
+TEST(ShaderCache, roundTrip)
+{
+    Echo::String userPath = Echo::PathUtil::GetCurrentDir() + "/shader_cache_test/";
+    Echo::PathUtil::DelPath(userPath);
+    Echo::IO::instance()->setUserPath(userPath);
+
+    // a miss compiles and writes one file
+    Echo::ShaderCache::Entry compiled;
+    EXPECT_TRUE(Echo::ShaderCache::instance()->get(glslVS, glslPS, Echo::ShaderCache::GLES, compiled));
+
+    Echo::StringArray files;
+    Echo::PathUtil::EnumFilesInDir(files, userPath + "shader_cache");
+    EXPECT_EQ(files.size(), 1u);
+
+    // a hit reads the same output back
+    Echo::ShaderCache::Entry loaded;
+    EXPECT_TRUE(Echo::ShaderCache::instance()->get(glslVS, glslPS, Echo::ShaderCache::GLES, loaded));
+
+    Echo::GLSLCrossCompiler glslCompiler;
+    glslCompiler.setInput(glslVS, glslPS, nullptr);
+    for (int i = Echo::GLSLCrossCompiler::VS; i <= Echo::GLSLCrossCompiler::FS; i++)
+    {
+        Echo::GLSLCrossCompiler::ShaderType type = Echo::GLSLCrossCompiler::ShaderType(i);
+        EXPECT_FALSE(loaded.m_spirv[i].empty());
+        EXPECT_EQ(loaded.m_spirv[i], compiled.m_spirv[i]);
+        EXPECT_EQ(loaded.m_output[i], compiled.m_output[i]);
+        EXPECT_EQ(loaded.m_spirv[i], glslCompiler.getSPIRV(type));
+        EXPECT_EQ(loaded.m_output[i], Echo::String(glslCompiler.getOutput(Echo::GLSLCrossCompiler::ShaderLanguage::GLES, type)));
+    }
+
+    Echo::PathUtil::DelPath(userPath);
+}